@@ -1,10 +1,12 @@
 #pragma once
 
+#include "command_buffer.hpp"
 #include "visibility.hpp"
 
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <vector>
 
@@ -109,6 +111,35 @@ public:
     const std::vector<std::string>&
       sources) = 0; // Todo: Change sources to vector of string_views
 
+  // Performs the project or target operation of the kind, with arguments
+  // given as views, e.g. of strings stored in a list. By default, calls the
+  // corresponding member function with copies of the arguments. Facades that
+  // record operations store the viewed strings as they are.
+  virtual void apply_command(command_buffer::command_kind kind,
+                             const std::string& name, visibility v,
+                             const std::vector<std::string_view>& arguments)
+  {
+    const std::vector<std::string> strings(std::cbegin(arguments),
+                                           std::cend(arguments));
+    call_member_function(kind, name, v, strings);
+  }
+
+  // Applies project and target operations in the order they were recorded.
+  // Calls the corresponding member function for each of them by default.
+  virtual void apply_commands(const command_buffer& commands)
+  {
+    // Reused by all commands, so only strings longer than ones of previous
+    // commands allocate.
+    std::string name;
+    std::vector<std::string> arguments;
+
+    for (const auto& cmd : commands.commands()) {
+      name = commands.string(cmd.name);
+      commands.copy_arguments(cmd, arguments);
+      call_member_function(cmd.kind, name, cmd.v, arguments);
+    }
+  }
+
   virtual std::string current_directory() const = 0;
 
   virtual void add_subdirectory_with_old_script(const std::string& dir) = 0;
@@ -167,6 +198,41 @@ public:
     const std::string& name) const = 0;
 
   virtual std::string ctest_command() const = 0;
+
+private:
+  void call_member_function(command_buffer::command_kind kind,
+                            const std::string& name, visibility v,
+                            const std::vector<std::string>& arguments)
+  {
+    using command_kind = command_buffer::command_kind;
+
+    switch (kind) {
+      case command_kind::register_project:
+        register_project(name);
+        break;
+      case command_kind::add_executable:
+        add_executable(name, arguments);
+        break;
+      case command_kind::add_library:
+        add_library(name, arguments);
+        break;
+      case command_kind::target_link_library:
+        target_link_library(name, v, arguments.front());
+        break;
+      case command_kind::target_include_directories:
+        target_include_directories(name, v, arguments);
+        break;
+      case command_kind::target_compile_definitions:
+        target_compile_definitions(name, v, arguments);
+        break;
+      case command_kind::target_compile_options:
+        target_compile_options(name, v, arguments);
+        break;
+      case command_kind::target_sources:
+        target_sources(name, v, arguments);
+        break;
+    }
+  }
 };
 }
 }
@@ -0,0 +1,299 @@
+#pragma once
+
+#include "visibility.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cmsl::facade {
+// Compact record of project and target operations. Strings are stored one
+// after another in a single buffer of characters, so recording an operation
+// doesn't allocate per argument. Project and target names are stored once and
+// commands refer to them by id, so e.g. a target name used by many commands
+// is not copied for each of them and commands on the same target can be
+// recognized by comparing ids. Commands are applied to a cmake_facade in the
+// order they were recorded, see cmake_facade::apply_commands().
+class command_buffer
+{
+public:
+  using string_id = std::uint32_t;
+
+  enum class command_kind : std::uint8_t
+  {
+    register_project,
+    add_executable,
+    add_library,
+    target_link_library,
+    target_include_directories,
+    target_compile_definitions,
+    target_compile_options,
+    target_sources
+  };
+
+  struct command
+  {
+    command_kind kind;
+    visibility v;
+    // Project or target name.
+    string_id name;
+    // Range of arguments in the buffer.
+    std::uint32_t first_argument;
+    std::uint32_t arguments_count;
+  };
+
+  command_buffer() = default;
+
+  command_buffer(const command_buffer&) = delete;
+  command_buffer& operator=(const command_buffer&) = delete;
+  command_buffer(command_buffer&&) = default;
+  command_buffer& operator=(command_buffer&&) = default;
+
+  // Starts a new command. Arguments are added to the last started command.
+  void add_command(command_kind kind, std::string_view name,
+                   visibility v = visibility::private_)
+  {
+    const auto first_argument =
+      static_cast<std::uint32_t>(m_arguments.size());
+    // Consecutive commands usually operate on the same target.
+    const auto same_name =
+      !m_commands.empty() && string(m_commands.back().name) == name;
+    const auto name_id = same_name ? m_commands.back().name : intern(name);
+    m_commands.push_back(command{ kind, v, name_id, first_argument, 0u });
+  }
+
+  void add_argument(std::string_view argument)
+  {
+    m_arguments.push_back(store(argument));
+    ++m_commands.back().arguments_count;
+  }
+
+  template <typename Strings>
+  void add_command(command_kind kind, std::string_view name, visibility v,
+                   const Strings& arguments)
+  {
+    add_command(kind, name, v);
+    for (const auto& argument : arguments) {
+      add_argument(argument);
+    }
+  }
+
+  const std::vector<command>& commands() const { return m_commands; }
+
+  bool empty() const { return m_commands.empty(); }
+
+  std::string_view string(string_id id) const
+  {
+    const auto& str = m_strings[id];
+    return std::string_view{ m_characters.data() + str.offset, str.size };
+  }
+
+  std::string_view argument(const command& cmd, std::uint32_t index) const
+  {
+    return string(m_arguments[cmd.first_argument + index]);
+  }
+
+  std::vector<std::string_view> arguments(const command& cmd) const
+  {
+    std::vector<std::string_view> result;
+    result.reserve(cmd.arguments_count);
+    for (auto i = 0u; i < cmd.arguments_count; ++i) {
+      result.push_back(argument(cmd, i));
+    }
+    return result;
+  }
+
+  // Copies arguments of the command to the result, reusing its strings.
+  void copy_arguments(const command& cmd,
+                      std::vector<std::string>& result) const
+  {
+    result.resize(cmd.arguments_count);
+    for (auto i = 0u; i < cmd.arguments_count; ++i) {
+      result[i] = argument(cmd, i);
+    }
+  }
+
+  // Number of strings stored in the buffer.
+  std::size_t strings_count() const { return m_strings.size(); }
+
+  // Keeps the allocated memory, so a buffer that is cleared after applying
+  // recorded commands doesn't allocate when the next commands are recorded.
+  void clear()
+  {
+    m_commands.clear();
+    m_arguments.clear();
+    m_characters.clear();
+    m_strings.clear();
+    std::fill(std::begin(m_name_slots), std::end(m_name_slots),
+              name_slot{});
+    m_names_count = 0u;
+  }
+
+  // One command per line: kind, visibility, name, arguments count and the
+  // arguments. Strings are prefixed with their size, e.g. '3:foo'.
+  std::string serialize() const
+  {
+    std::string result;
+    for (const auto& cmd : m_commands) {
+      result += std::to_string(static_cast<unsigned>(cmd.kind));
+      result += ' ';
+      result += std::to_string(static_cast<unsigned>(cmd.v));
+      result += ' ';
+      append_serialized(result, string(cmd.name));
+      result += ' ';
+      result += std::to_string(cmd.arguments_count);
+      for (auto i = 0u; i < cmd.arguments_count; ++i) {
+        result += ' ';
+        append_serialized(result, argument(cmd, i));
+      }
+      result += '\n';
+    }
+    return result;
+  }
+
+  // Returns std::nullopt if the input was not created by serialize().
+  static std::optional<command_buffer> deserialize(std::string_view input)
+  {
+    command_buffer buffer;
+    std::istringstream in{ std::string{ input } };
+    unsigned kind;
+    while (in >> kind) {
+      unsigned v;
+      std::string name;
+      std::uint32_t count;
+      if (kind > static_cast<unsigned>(command_kind::target_sources) ||
+          !(in >> v) ||
+          v > static_cast<unsigned>(visibility::public_) ||
+          !read_serialized(in, name) || !(in >> count) ||
+          (static_cast<command_kind>(kind) ==
+             command_kind::target_link_library &&
+           count != 1u)) {
+        return std::nullopt;
+      }
+
+      buffer.add_command(static_cast<command_kind>(kind), name,
+                         static_cast<visibility>(v));
+      for (auto i = 0u; i < count; ++i) {
+        std::string argument;
+        if (!read_serialized(in, argument)) {
+          return std::nullopt;
+        }
+        buffer.add_argument(argument);
+      }
+    }
+
+    if (!in.eof()) {
+      return std::nullopt;
+    }
+
+    return std::move(buffer);
+  }
+
+private:
+  static constexpr auto k_no_string = ~string_id{ 0u };
+
+  // Location of a string in the buffer of characters.
+  struct stored_string
+  {
+    std::uint32_t offset;
+    std::uint32_t size;
+  };
+
+  // Slot of the open addressing table of names.
+  struct name_slot
+  {
+    string_id id{ k_no_string };
+    std::uint32_t hash{ 0u };
+  };
+
+  string_id store(std::string_view str)
+  {
+    const auto id = static_cast<string_id>(m_strings.size());
+    m_strings.push_back(
+      stored_string{ static_cast<std::uint32_t>(m_characters.size()),
+                     static_cast<std::uint32_t>(str.size()) });
+    m_characters += str;
+    return id;
+  }
+
+  string_id intern(std::string_view name)
+  {
+    const auto hash =
+      static_cast<std::uint32_t>(std::hash<std::string_view>{}(name));
+    if (!m_name_slots.empty()) {
+      const auto mask = m_name_slots.size() - 1u;
+      for (auto i = hash & mask; m_name_slots[i].id != k_no_string;
+           i = (i + 1u) & mask) {
+        const auto& slot = m_name_slots[i];
+        if (slot.hash == hash && string(slot.id) == name) {
+          return slot.id;
+        }
+      }
+    }
+
+    // At most half of the slots are used, so probing stays short.
+    if ((m_names_count + 1u) * 2u > m_name_slots.size()) {
+      grow_name_slots();
+    }
+
+    const auto id = store(name);
+    insert_name_slot(name_slot{ id, hash });
+    ++m_names_count;
+    return id;
+  }
+
+  void insert_name_slot(name_slot slot)
+  {
+    const auto mask = m_name_slots.size() - 1u;
+    auto i = slot.hash & mask;
+    while (m_name_slots[i].id != k_no_string) {
+      i = (i + 1u) & mask;
+    }
+    m_name_slots[i] = slot;
+  }
+
+  void grow_name_slots()
+  {
+    const auto old_slots = std::move(m_name_slots);
+    m_name_slots.assign(old_slots.empty() ? 16u : old_slots.size() * 2u,
+                        name_slot{});
+    for (const auto& slot : old_slots) {
+      if (slot.id != k_no_string) {
+        insert_name_slot(slot);
+      }
+    }
+  }
+
+  static void append_serialized(std::string& out, std::string_view str)
+  {
+    out += std::to_string(str.size());
+    out += ':';
+    out += str;
+  }
+
+  static bool read_serialized(std::istream& in, std::string& str)
+  {
+    std::size_t size;
+    if (!(in >> size) || in.get() != ':') {
+      return false;
+    }
+
+    str.resize(size);
+    return static_cast<bool>(in.read(str.data(), size));
+  }
+
+private:
+  std::vector<command> m_commands;
+  std::vector<string_id> m_arguments;
+  std::string m_characters;
+  std::vector<stored_string> m_strings;
+  // Size is a power of two.
+  std::vector<name_slot> m_name_slots;
+  std::size_t m_names_count{ 0u };
+};
+}
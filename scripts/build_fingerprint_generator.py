@@ -0,0 +1,53 @@
+import sys
+import os
+import hashlib
+
+# Usage: build_fingerprint_generator.py destination_header sources_dir...
+#
+# Generates a header with a fingerprint of the sources. Entries of the
+# compilation cache, written by a build with a different fingerprint, are not
+# used. The header is rewritten only if the fingerprint changes, so sources
+# that include it are not rebuilt needlessly.
+
+FILE_TEMPLATE = """#pragma once
+
+#define CMSL_BUILD_FINGERPRINT "%fingerprint%"
+"""
+
+SOURCE_EXTENSIONS = ('.cpp', '.hpp', '.cmsl')
+
+
+def generate_fingerprint(sources_dirs):
+    sha = hashlib.sha256()
+
+    for sources_dir in sources_dirs:
+        paths = []
+        for root, _, files in os.walk(sources_dir):
+            paths += [os.path.join(root, name) for name in files
+                      if name.endswith(SOURCE_EXTENSIONS)]
+
+        for path in sorted(paths):
+            sha.update(os.path.relpath(path, sources_dir).encode('utf-8'))
+            sha.update(b'\0')
+            with open(path, 'rb') as file:
+                sha.update(file.read())
+            sha.update(b'\0')
+
+    return sha.hexdigest()[:16]
+
+
+def main():
+    destination_path = sys.argv[1]
+    file_content = FILE_TEMPLATE. \
+        replace('%fingerprint%', generate_fingerprint(sys.argv[2:]))
+
+    if os.path.exists(destination_path):
+        with open(destination_path, 'r') as file:
+            if file.read() == file_content:
+                return
+
+    with open(destination_path, 'w') as file:
+        file.write(file_content)
+
+
+main()
@@ -5,6 +5,7 @@ import json
 FILE_TEMPLATE = """
 #pragma once
 
+#include <common/source_files.hpp>
 #include <common/string.hpp>
 #include <lexer/token.hpp>
 
@@ -25,21 +26,21 @@ class %type_name%_tokens_provider
 {
 public:
     explicit %type_name%_tokens_provider(std::optional<cmsl::string_view> path_to_documentation)
-        : m_path_to_documentation{ path_to_documentation }
+        : m_source_id{ source_files::add_static(get_source_view(path_to_documentation)) }
     {}
     
     %methods%
 
 private:
-    source_view get_source_view() const
+    static source_view get_source_view(std::optional<cmsl::string_view> path_to_documentation)
     {
-        return m_path_to_documentation.has_value()
-            ? source_view{ *m_path_to_documentation, %type_name%_documentation_source }
+        return path_to_documentation.has_value()
+            ? source_view{ *path_to_documentation, %type_name%_documentation_source }
             : source_view{ %type_name%_documentation_source };
     }
     
 private:
-    std::optional<cmsl::string_view> m_path_to_documentation;
+    source_files::id_t m_source_id;
 };
 """
 
@@ -47,9 +48,7 @@ TOKEN_PROVIDER_METHOD_TEMPLATE = """
     lexer::token %token_name%() const
     {
         // %token_value%
-        const auto src_range = source_range{ source_location{ %line%, %column%, %absolute_position% },
-                                             source_location{ %line%, %column% + %token_length%, %absolute_position% + %token_length% } };
-        return lexer::token{ lexer::token_type::%token_type%, src_range, get_source_view()};
+        return lexer::token{ lexer::token_type::%token_type%, %absolute_position%, %token_length%, m_source_id };
     }
 """
 
@@ -395,18 +394,6 @@ def find_absolute(documentation_content, to_search, to_skip):
     return token_absolute_position
 
 
-def find_line_and_column(documentation_content, to_search, to_skip):
-    lines = documentation_content.splitlines()
-    line_no = 0
-    for line in lines:
-        line_no = line_no + 1
-        if to_search in line:
-            column = line.find(to_search) + len(to_skip)
-            return line_no, column
-
-    return None
-
-
 def generate_providers():
     print('Generating providers...')
 
@@ -432,11 +419,8 @@ def generate_providers():
             token_value = token_search_info[2]
             token_type = token_search_info[3] if len(token_search_info) > 3 else 'identifier'
             token_absolute_position = find_absolute(type_documentation, to_search, to_skip)
-            token_line, token_column = find_line_and_column(type_documentation, to_search, to_skip)
             token_length = len(token_value)
             method_source = method_source.replace('%absolute_position%', str(token_absolute_position))
-            method_source = method_source.replace('%line%', str(token_line))
-            method_source = method_source.replace('%column%', str(token_column))
             method_source = method_source.replace('%token_length%', str(token_length))
             method_source = method_source.replace('%token_type%', str(token_type))
             method_source = method_source.replace('%token_value%', token_value)
@@ -1052,24 +1052,7 @@ parser::parse_top_level_nodes(StopCondition&& stop_condition)
   std::vector<std::unique_ptr<ast_node>> nodes;
 
   while (!stop_condition()) {
-    std::unique_ptr<ast_node> node;
-
-    auto export_kw = try_eat(token_type_t::kw_export);
-
-    if (function_declaration_starts()) {
-      node = parse_function(export_kw);
-    } else if (current_is(token_type_t::kw_class)) {
-      node = parse_class(export_kw);
-    } else if (current_is(token_type_t::kw_enum)) {
-      node = parse_enum(export_kw);
-    } else if (current_is(token_type_t::kw_namespace)) {
-      node = parse_namespace();
-    } else if (current_is(token_type_t::kw_import)) {
-      node = parse_import();
-    } else {
-      node = parse_standalone_variable_declaration(export_kw);
-    }
-
+    auto node = parse_top_level_node();
     if (!node) {
       return std::nullopt;
     }
@@ -1080,6 +1063,34 @@ parser::parse_top_level_nodes(StopCondition&& stop_condition)
   return std::move(nodes);
 }
 
+void parser::skip_to(token_it token)
+{
+  if (token != m_current) {
+    m_prev = std::prev(token);
+  }
+
+  adjust_current_iterator(token);
+}
+
+std::unique_ptr<ast_node> parser::parse_top_level_node()
+{
+  auto export_kw = try_eat(token_type_t::kw_export);
+
+  if (function_declaration_starts()) {
+    return parse_function(export_kw);
+  } else if (current_is(token_type_t::kw_class)) {
+    return parse_class(export_kw);
+  } else if (current_is(token_type_t::kw_enum)) {
+    return parse_enum(export_kw);
+  } else if (current_is(token_type_t::kw_namespace)) {
+    return parse_namespace();
+  } else if (current_is(token_type_t::kw_import)) {
+    return parse_import();
+  } else {
+    return parse_standalone_variable_declaration(export_kw);
+  }
+}
+
 std::vector<name_with_coloncolon> parser::parse_namespace_declaration_names()
 {
   std::vector<name_with_coloncolon> names;
@@ -38,6 +38,19 @@ public:
          const token_container_t& tokens);
 
   std::unique_ptr<ast_node> parse_translation_unit();
+
+  // Parses a single declaration of a translation unit, e.g. a function or a
+  // namespace. Lets a translation unit be parsed declaration by declaration,
+  // so declarations that have not changed can be skipped when it is
+  // reparsed.
+  std::unique_ptr<ast_node> parse_top_level_node();
+
+  // Skips tokens that precede the given one, as if they have been parsed,
+  // e.g. tokens of declarations that have not changed.
+  void skip_to(token_it token);
+  using parser_utils::current_iterator;
+  using parser_utils::is_at_end;
+
   std::unique_ptr<ast_node> parse_standalone_variable_declaration(
     std::optional<token_t> export_kw);
   std::unique_ptr<variable_declaration_node> parse_variable_declaration(
@@ -12,6 +12,11 @@ const translation_unit_node::nodes_t& translation_unit_node::nodes() const
   return m_nodes;
 }
 
+translation_unit_node::nodes_t translation_unit_node::release_nodes()
+{
+  return std::move(m_nodes);
+}
+
 void translation_unit_node::visit(ast_node_visitor& visitor) const
 {
   visitor.visit(*this);
@@ -15,6 +15,9 @@ public:
 
   const nodes_t& nodes() const;
 
+  // Moves the nodes out, e.g. to reuse them in a new translation unit.
+  nodes_t release_nodes();
+
   void visit(ast_node_visitor& visitor) const override;
   source_location begin_location() const override;
   source_location end_location() const override;
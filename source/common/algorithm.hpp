@@ -80,6 +80,19 @@ void remove_if(std::unordered_multimap<K, T, H, KE, A>& map, Pred&& predicate)
   }
 }
 
+template <typename K, typename T, typename H, typename KE, typename A,
+          typename Pred>
+void remove_if(std::unordered_map<K, T, H, KE, A>& map, Pred&& predicate)
+{
+  for (auto it = begin(map); it != end(map);) {
+    if (predicate(*it)) {
+      it = map.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
 inline std::string to_lower(const std::string& source)
 {
   std::string result;
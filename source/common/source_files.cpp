@@ -0,0 +1,249 @@
+#include "common/source_files.hpp"
+#include "common/assert.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace cmsl {
+namespace {
+struct source_file
+{
+  // Current view. Null if the file is not registered.
+  std::atomic<const source_view*> view{ nullptr };
+
+  // Set only for static sources.
+  std::string owned_path;
+
+  std::mutex mutex;
+  // Every view the file has had since it has been registered. Guarded by the
+  // mutex.
+  std::vector<std::unique_ptr<const source_view>> views;
+  bool new_lines_counted{ false };
+  // Offsets of new line chars. A new line at the very beginning of a source
+  // is not counted, same as in the lexer.
+  std::vector<std::uint32_t> new_lines;
+};
+
+// Files are stored in chunks that are never moved, so a file can be read
+// without locking, while other threads register new ones. Id of a file is
+// published only after the file is stored. Ids of removed files are reused,
+// so the number of chunks is bounded by the number of sources alive at the
+// same time.
+constexpr auto chunk_size = std::size_t{ 1024u };
+constexpr auto max_chunks = std::size_t{ 16384u };
+
+std::array<std::atomic<source_file*>, max_chunks> chunks{};
+std::mutex files_mutex;
+source_files::id_t files_count{ source_files::empty_source_id + 1u };
+// Guarded by files_mutex.
+std::vector<source_files::id_t> free_ids;
+
+using static_source_key =
+  std::tuple<const char*, std::size_t, std::string>;
+
+std::map<static_source_key, source_files::id_t>& static_sources()
+{
+  static std::map<static_source_key, source_files::id_t> sources;
+  return sources;
+}
+
+source_file& file_at(source_files::id_t id)
+{
+  const auto chunk = chunks[id / chunk_size].load(std::memory_order_acquire);
+  CMSL_ASSERT(chunk != nullptr);
+  return chunk[id % chunk_size];
+}
+
+// Has to be called with the file's mutex locked.
+void set_view(source_file& file, source_view source)
+{
+  file.views.emplace_back(std::make_unique<const source_view>(source));
+  file.view.store(file.views.back().get(), std::memory_order_release);
+  file.new_lines.clear();
+  file.new_lines_counted = false;
+}
+
+// Has to be called with files_mutex locked.
+source_files::id_t add_locked(source_view source)
+{
+  if (!free_ids.empty()) {
+    const auto id = free_ids.back();
+    free_ids.pop_back();
+    auto& file = file_at(id);
+    std::lock_guard<std::mutex> lock{ file.mutex };
+    set_view(file, source);
+    return id;
+  }
+
+  const auto id = files_count++;
+  CMSL_ASSERT_MSG(id < chunk_size * max_chunks, "Too many live sources");
+
+  auto& chunk = chunks[id / chunk_size];
+  auto files = chunk.load(std::memory_order_relaxed);
+  if (files == nullptr) {
+    // Chunks live till the end of the process.
+    files = new source_file[chunk_size];
+    chunk.store(files, std::memory_order_release);
+  }
+
+  auto& file = files[id % chunk_size];
+  std::lock_guard<std::mutex> lock{ file.mutex };
+  set_view(file, source);
+  return id;
+}
+
+void remove_file(source_files::id_t id)
+{
+  auto& file = file_at(id);
+  {
+    std::lock_guard<std::mutex> lock{ file.mutex };
+    file.view.store(nullptr, std::memory_order_release);
+    file.views.clear();
+    file.new_lines.clear();
+    file.new_lines_counted = false;
+  }
+
+  std::lock_guard<std::mutex> lock{ files_mutex };
+  free_ids.emplace_back(id);
+}
+
+void count_new_lines(source_file& file)
+{
+  const auto src = file.view.load(std::memory_order_relaxed)->source();
+  const auto data = src.data();
+  auto offset = std::size_t{ 1u };
+  while (offset < src.size()) {
+    const auto found = static_cast<const char*>(
+      std::memchr(data + offset, '\n', src.size() - offset));
+    if (found == nullptr) {
+      break;
+    }
+
+    const auto found_offset = static_cast<std::size_t>(found - data);
+    file.new_lines.emplace_back(static_cast<std::uint32_t>(found_offset));
+    offset = found_offset + 1u;
+  }
+}
+}
+
+source_files::registration::registration(source_view source)
+{
+  std::lock_guard<std::mutex> lock{ files_mutex };
+  m_id = add_locked(source);
+}
+
+source_files::registration::~registration()
+{
+  if (m_id != empty_source_id) {
+    remove_file(m_id);
+  }
+}
+
+source_files::registration::registration(registration&& other) noexcept
+  : m_id{ std::exchange(other.m_id, empty_source_id) }
+{
+}
+
+source_files::registration& source_files::registration::operator=(
+  registration&& other) noexcept
+{
+  if (this != &other) {
+    if (m_id != empty_source_id) {
+      remove_file(m_id);
+    }
+    m_id = std::exchange(other.m_id, empty_source_id);
+  }
+
+  return *this;
+}
+
+source_files::id_t source_files::registration::id() const
+{
+  return m_id;
+}
+
+source_files::id_t source_files::add_static(source_view source)
+{
+  const auto src = source.source();
+  auto key =
+    static_source_key{ src.data(), src.size(), std::string{ source.path() } };
+
+  std::lock_guard<std::mutex> lock{ files_mutex };
+  auto& sources = static_sources();
+  const auto found = sources.find(key);
+  if (found != std::end(sources)) {
+    return found->second;
+  }
+
+  const auto id = add_locked(source);
+  auto& file = file_at(id);
+  file.owned_path = std::get<2>(key);
+  std::lock_guard<std::mutex> file_lock{ file.mutex };
+  file.views.clear();
+  set_view(file, source_view{ file.owned_path, src });
+
+  sources.emplace(std::move(key), id);
+  return id;
+}
+
+void source_files::replace(id_t id, source_view source)
+{
+  CMSL_ASSERT(id != empty_source_id);
+  auto& file = file_at(id);
+  std::lock_guard<std::mutex> lock{ file.mutex };
+  set_view(file, source);
+}
+
+source_view source_files::view(id_t id)
+{
+  if (id == empty_source_id) {
+    return source_view{ "" };
+  }
+
+  const auto view = file_at(id).view.load(std::memory_order_acquire);
+  CMSL_ASSERT_MSG(view != nullptr, "Source has been removed");
+  return *view;
+}
+
+source_location source_files::location(id_t id, std::size_t offset)
+{
+  if (id == empty_source_id) {
+    return source_location{};
+  }
+
+  auto& file = file_at(id);
+  std::lock_guard<std::mutex> lock{ file.mutex };
+  CMSL_ASSERT_MSG(file.view.load(std::memory_order_relaxed) != nullptr,
+                  "Source has been removed");
+  if (!file.new_lines_counted) {
+    count_new_lines(file);
+    file.new_lines_counted = true;
+  }
+
+  const auto size =
+    file.view.load(std::memory_order_relaxed)->source().size();
+  const auto char_offset =
+    (offset == size && offset > 0u) ? offset - 1u : offset;
+
+  const auto& new_lines = file.new_lines;
+  const auto found = std::upper_bound(std::cbegin(new_lines),
+                                      std::cend(new_lines), char_offset);
+  const auto new_lines_before =
+    static_cast<unsigned>(std::distance(std::cbegin(new_lines), found));
+  const auto line_start =
+    found == std::cbegin(new_lines) ? std::size_t{ 0u } : *std::prev(found);
+
+  return source_location{ 1u + new_lines_before,
+                          static_cast<unsigned>(1u + char_offset - line_start),
+                          static_cast<unsigned>(offset) };
+}
+}
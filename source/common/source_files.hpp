@@ -0,0 +1,65 @@
+#pragma once
+
+#include "common/source_location.hpp"
+#include "common/source_view.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cmsl {
+// Process wide table of sources that tokens point into. A token keeps only
+// an id of its source. The source view, as well as lines and columns, are
+// recovered from here when they are needed, e.g. to report an error.
+//
+// A source is registered by the owner of its text, and removed when the text
+// is destroyed, so ids of removed sources are reused. Tokens must not be used
+// after their source is removed, same as with source_view.
+class source_files
+{
+public:
+  using id_t = std::uint32_t;
+
+  // Empty source, used by tokens that have not been lexed from any source.
+  static constexpr id_t empty_source_id{ 0u };
+
+  // Registers a new source, even if the same view is already registered, and
+  // removes it when destroyed. Memory of a destroyed source may be reused by
+  // another one, so views can't be told apart by their addresses.
+  class registration
+  {
+  public:
+    // Registers nothing, id is empty_source_id.
+    registration() = default;
+    explicit registration(source_view source);
+    ~registration();
+
+    registration(registration&& other) noexcept;
+    registration& operator=(registration&& other) noexcept;
+
+    id_t id() const;
+
+  private:
+    id_t m_id{ empty_source_id };
+  };
+
+  // Registers a source whose text lives till the end of the process, e.g. a
+  // string literal. Path is copied. A source is registered only once for a
+  // given text and path.
+  static id_t add_static(source_view source);
+
+  // Points the source to a new text, e.g. to an edited version of it. Tokens
+  // of the source, that are still in use, have to have the same text at
+  // their offsets in the new version. Views are never modified, so the source
+  // can be read on other threads meanwhile. Previous views are kept till the
+  // source is removed.
+  static void replace(id_t id, source_view source);
+
+  static source_view view(id_t id);
+
+  // Location of the given offset, following lexer's convention: a new line
+  // char is the first column of the next line, and the end of the
+  // source is placed at its last char. New lines are counted on the first
+  // call for the source.
+  static source_location location(id_t id, std::size_t offset);
+};
+}
@@ -8,4 +8,16 @@ cmsl::string_view strings_container_impl::store(std::string str)
   m_strings.emplace_back(std::move(str_ptr));
   return view;
 }
+
+std::size_t strings_container_impl::size() const
+{
+  return m_strings.size();
+}
+
+void strings_container_impl::truncate(std::size_t count)
+{
+  if (count < m_strings.size()) {
+    m_strings.resize(count);
+  }
+}
 }
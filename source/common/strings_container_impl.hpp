@@ -12,6 +12,12 @@ class strings_container_impl : public strings_container
 public:
   cmsl::string_view store(std::string str) override;
 
+  // Number of stored strings.
+  std::size_t size() const;
+
+  // Destroys strings stored after the first count ones.
+  void truncate(std::size_t count);
+
 private:
   std::vector<std::unique_ptr<std::string>> m_strings;
 };
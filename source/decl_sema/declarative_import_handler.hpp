@@ -12,10 +12,12 @@ class declarative_import_handler
 public:
   virtual ~declarative_import_handler() = default;
 
+  // Both members are shared by all importers of the module and live as long
+  // as the handler.
   struct result
   {
-    sema::qualified_contextes qualified_contexts;
-    cmsl::string_view_map<const decl_sema::component_declaration_node*>
+    const sema::qualified_contextes* qualified_contexts;
+    const cmsl::string_view_map<const decl_sema::component_declaration_node*>*
       component_declarations;
   };
 
@@ -378,14 +378,14 @@ void sema_builder_ast_visitor::visit(const decl_ast::import_node& node)
   }
 
   const auto enums_succeed = m_.qualified_ctxs.enums.merge_imported_stuff(
-    *import_result->qualified_contexts.enums, m_.errs);
+    *import_result->qualified_contexts->enums, m_.errs);
   const auto functions_succeed =
     m_.qualified_ctxs.functions.merge_imported_stuff(
-      *import_result->qualified_contexts.functions, m_.errs);
+      *import_result->qualified_contexts->functions, m_.errs);
   const auto ids_succeed = m_.qualified_ctxs.ids.merge_imported_stuff(
-    *import_result->qualified_contexts.ids, m_.errs);
+    *import_result->qualified_contexts->ids, m_.errs);
   const auto types_succeed = m_.qualified_ctxs.types.merge_imported_stuff(
-    *import_result->qualified_contexts.types, m_.errs);
+    *import_result->qualified_contexts->types, m_.errs);
 
   const auto all_succeed =
     enums_succeed && functions_succeed && ids_succeed && types_succeed;
@@ -394,7 +394,7 @@ void sema_builder_ast_visitor::visit(const decl_ast::import_node& node)
     return;
   }
 
-  for (const auto& pair : import_result->component_declarations) {
+  for (const auto& pair : *import_result->component_declarations) {
     m_.component_declarations.insert(pair);
   }
 
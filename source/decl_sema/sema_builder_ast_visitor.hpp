@@ -40,7 +40,7 @@ struct sema_builder_ast_visitor_members
   sema::sema_context& generic_types_context;
   sema::sema_context& ctx;
   sema::factories_provider& factories;
-  sema::builtin_token_provider& builtin_tokens;
+  const sema::builtin_token_provider& builtin_tokens;
   sema::builtin_types_accessor builtin_types;
   sema::qualified_contextes_refs qualified_ctxs;
   strings_container& strings;
@@ -40,8 +40,20 @@ errors_observer::errors_observer(std::ostream& out)
 {
 }
 
+errors_observer::errors_observer(error_callback_t callback)
+  : m_callback{ std::move(callback) }
+{
+}
+
 void errors_observer::notify_error(const error& error)
 {
+  ++m_notified_count;
+
+  if (m_callback) {
+    m_callback(error);
+    return;
+  }
+
   const auto str = format_error(error);
   if (m_facade != nullptr) {
     m_facade->error(str);
@@ -50,6 +62,11 @@ void errors_observer::notify_error(const error& error)
   }
 }
 
+std::size_t errors_observer::notified_count() const
+{
+  return m_notified_count;
+}
+
 std::string errors_observer::format_error(const error& err) const
 {
   std::stringstream ss;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <functional>
 #include <string>
 
 namespace cmsl {
@@ -13,17 +15,26 @@ struct error;
 class errors_observer
 {
 public:
+  // Called instead of printing an error.
+  using error_callback_t = std::function<void(const error&)>;
+
   explicit errors_observer(std::ostream& out);
   explicit errors_observer(facade::cmake_facade* facade = nullptr);
+  explicit errors_observer(error_callback_t callback);
 
   void notify_error(const error& error);
 
+  // Number of errors, warnings and notes notified so far.
+  std::size_t notified_count() const;
+
 private:
   std::string format_error(const error& err) const;
 
 private:
   facade::cmake_facade* m_facade{ nullptr };
   std::ostream* m_out{ nullptr };
+  error_callback_t m_callback;
+  std::size_t m_notified_count{ 0u };
 };
 }
 }
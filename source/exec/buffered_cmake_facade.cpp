@@ -0,0 +1,303 @@
+#include "exec/buffered_cmake_facade.hpp"
+
+namespace cmsl::exec {
+buffered_cmake_facade::buffered_cmake_facade(facade::cmake_facade& facade)
+  : m_facade{ facade }
+{
+}
+
+void buffered_cmake_facade::flush()
+{
+  flush_commands();
+}
+
+const facade::command_buffer& buffered_cmake_facade::commands() const
+{
+  return m_commands;
+}
+
+void buffered_cmake_facade::flush_commands() const
+{
+  if (m_commands.empty()) {
+    return;
+  }
+
+  m_facade.apply_commands(m_commands);
+  m_commands.clear();
+}
+
+void buffered_cmake_facade::flush_if_full()
+{
+  if (m_commands.commands().size() >= k_max_recorded_commands) {
+    flush_commands();
+  }
+}
+
+facade::cmake_facade::version buffered_cmake_facade::get_cmake_version()
+  const
+{
+  return m_facade.get_cmake_version();
+}
+
+void buffered_cmake_facade::message(const std::string& what) const
+{
+  m_facade.message(what);
+}
+
+void buffered_cmake_facade::warning(const std::string& what) const
+{
+  m_facade.warning(what);
+}
+
+void buffered_cmake_facade::error(const std::string& what) const
+{
+  flush_commands();
+  m_facade.error(what);
+}
+
+void buffered_cmake_facade::fatal_error(const std::string& what)
+{
+  flush_commands();
+  m_facade.fatal_error(what);
+}
+
+bool buffered_cmake_facade::did_fatal_error_occure() const
+{
+  return m_facade.did_fatal_error_occure();
+}
+
+void buffered_cmake_facade::register_project(const std::string& name)
+{
+  m_commands.add_command(
+    facade::command_buffer::command_kind::register_project, name);
+  flush_if_full();
+}
+
+void buffered_cmake_facade::install(const std::string& target_name,
+                                    const std::string& destination)
+{
+  flush_commands();
+  m_facade.install(target_name, destination);
+}
+
+std::string buffered_cmake_facade::get_current_binary_dir() const
+{
+  return m_facade.get_current_binary_dir();
+}
+
+std::string buffered_cmake_facade::get_current_source_dir() const
+{
+  return m_facade.get_current_source_dir();
+}
+
+std::string buffered_cmake_facade::get_root_source_dir() const
+{
+  return m_facade.get_root_source_dir();
+}
+
+void buffered_cmake_facade::add_custom_command(
+  const std::vector<std::string>& command, const std::string& output) const
+{
+  flush_commands();
+  m_facade.add_custom_command(command, output);
+}
+
+void buffered_cmake_facade::add_custom_target(
+  const std::string& name, const std::vector<std::string>& command) const
+{
+  flush_commands();
+  m_facade.add_custom_target(name, command);
+}
+
+void buffered_cmake_facade::make_directory(const std::string& dir) const
+{
+  m_facade.make_directory(dir);
+}
+
+void buffered_cmake_facade::add_executable(
+  const std::string& name, const std::vector<std::string>& sources)
+{
+  m_commands.add_command(facade::command_buffer::command_kind::add_executable,
+                         name, facade::visibility::private_, sources);
+  flush_if_full();
+}
+
+void buffered_cmake_facade::add_library(
+  const std::string& name, const std::vector<std::string>& sources)
+{
+  m_commands.add_command(facade::command_buffer::command_kind::add_library,
+                         name, facade::visibility::private_, sources);
+  flush_if_full();
+}
+
+void buffered_cmake_facade::target_link_library(
+  const std::string& target_name, facade::visibility v,
+  const std::string& library_name)
+{
+  m_commands.add_command(
+    facade::command_buffer::command_kind::target_link_library, target_name,
+    v);
+  m_commands.add_argument(library_name);
+  flush_if_full();
+}
+
+void buffered_cmake_facade::target_include_directories(
+  const std::string& target_name, facade::visibility v,
+  const std::vector<std::string>& dirs)
+{
+  m_commands.add_command(
+    facade::command_buffer::command_kind::target_include_directories,
+    target_name, v, dirs);
+  flush_if_full();
+}
+
+void buffered_cmake_facade::target_compile_definitions(
+  const std::string& target_name, facade::visibility v,
+  const std::vector<std::string>& definitions)
+{
+  m_commands.add_command(
+    facade::command_buffer::command_kind::target_compile_definitions,
+    target_name, v, definitions);
+  flush_if_full();
+}
+
+void buffered_cmake_facade::target_compile_options(
+  const std::string& target_name, facade::visibility v,
+  const std::vector<std::string>& options)
+{
+  m_commands.add_command(
+    facade::command_buffer::command_kind::target_compile_options, target_name,
+    v, options);
+  flush_if_full();
+}
+
+void buffered_cmake_facade::target_sources(
+  const std::string& target_name, facade::visibility v,
+  const std::vector<std::string>& sources)
+{
+  m_commands.add_command(facade::command_buffer::command_kind::target_sources,
+                         target_name, v, sources);
+  flush_if_full();
+}
+
+void buffered_cmake_facade::apply_command(
+  facade::command_buffer::command_kind kind, const std::string& name,
+  facade::visibility v, const std::vector<std::string_view>& arguments)
+{
+  m_commands.add_command(kind, name, v, arguments);
+  flush_if_full();
+}
+
+void buffered_cmake_facade::apply_commands(
+  const facade::command_buffer& commands)
+{
+  flush_commands();
+  m_facade.apply_commands(commands);
+}
+
+std::string buffered_cmake_facade::current_directory() const
+{
+  return m_facade.current_directory();
+}
+
+void buffered_cmake_facade::add_subdirectory_with_old_script(
+  const std::string& dir)
+{
+  flush_commands();
+  m_facade.add_subdirectory_with_old_script(dir);
+}
+
+void buffered_cmake_facade::go_into_subdirectory(const std::string& dir)
+{
+  flush_commands();
+  m_facade.go_into_subdirectory(dir);
+}
+
+void buffered_cmake_facade::go_directory_up()
+{
+  flush_commands();
+  m_facade.go_directory_up();
+}
+
+void buffered_cmake_facade::prepare_for_add_subdirectory_with_cmakesl_script(
+  const std::string& dir)
+{
+  flush_commands();
+  m_facade.prepare_for_add_subdirectory_with_cmakesl_script(dir);
+}
+
+void buffered_cmake_facade::
+  finalize_after_add_subdirectory_with_cmakesl_script()
+{
+  flush_commands();
+  m_facade.finalize_after_add_subdirectory_with_cmakesl_script();
+}
+
+void buffered_cmake_facade::enable_ctest() const
+{
+  flush_commands();
+  m_facade.enable_ctest();
+}
+
+void buffered_cmake_facade::add_test(const std::string& test_executable_name)
+{
+  flush_commands();
+  m_facade.add_test(test_executable_name);
+}
+
+facade::cmake_facade::cxx_compiler_info
+buffered_cmake_facade::get_cxx_compiler_info() const
+{
+  return m_facade.get_cxx_compiler_info();
+}
+
+facade::cmake_facade::system_info buffered_cmake_facade::get_system_info()
+  const
+{
+  return m_facade.get_system_info();
+}
+
+std::optional<std::string> buffered_cmake_facade::try_get_extern_define(
+  const std::string& name) const
+{
+  return m_facade.try_get_extern_define(name);
+}
+
+void buffered_cmake_facade::set_property(
+  const std::string& property_name, const std::string& property_value) const
+{
+  flush_commands();
+  m_facade.set_property(property_name, property_value);
+}
+
+std::optional<bool> buffered_cmake_facade::get_option_value(
+  const std::string& name) const
+{
+  return m_facade.get_option_value(name);
+}
+
+void buffered_cmake_facade::register_option(const std::string& name,
+                                            const std::string& description,
+                                            bool value) const
+{
+  m_facade.register_option(name, description, value);
+}
+
+void buffered_cmake_facade::set_old_style_variable(
+  const std::string& name, const std::string& value) const
+{
+  flush_commands();
+  m_facade.set_old_style_variable(name, value);
+}
+
+std::optional<std::string> buffered_cmake_facade::get_old_style_variable(
+  const std::string& name) const
+{
+  return m_facade.get_old_style_variable(name);
+}
+
+std::string buffered_cmake_facade::ctest_command() const
+{
+  return m_facade.ctest_command();
+}
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "cmake_facade.hpp"
+
+namespace cmsl::exec {
+// Records project and target operations instead of forwarding them one by
+// one. Recorded commands are applied to the underlying facade with a single
+// apply_commands() call, when leaving or entering a directory, before an
+// operation that may depend on them, when the buffer is full and on flush().
+// Other operations are forwarded as they are.
+//
+// Errors are forwarded after recorded commands are applied, so errors raised
+// by the commands are reported first. An error raised by a recorded command
+// is reported only when the command is applied, so e.g.
+// did_fatal_error_occure() returns true from that point, not right after the
+// command was recorded.
+class buffered_cmake_facade : public facade::cmake_facade
+{
+public:
+  // Recorded commands are applied when the buffer holds that many of them.
+  static constexpr auto k_max_recorded_commands = 1024u;
+
+  explicit buffered_cmake_facade(facade::cmake_facade& facade);
+
+  void flush();
+
+  const facade::command_buffer& commands() const;
+
+  version get_cmake_version() const override;
+
+  void message(const std::string& what) const override;
+  void warning(const std::string& what) const override;
+  void error(const std::string& what) const override;
+  void fatal_error(const std::string& what) override;
+  bool did_fatal_error_occure() const override;
+
+  void register_project(const std::string& name) override;
+
+  void install(const std::string& target_name,
+               const std::string& destination) override;
+
+  std::string get_current_binary_dir() const override;
+  std::string get_current_source_dir() const override;
+  std::string get_root_source_dir() const override;
+
+  void add_custom_command(const std::vector<std::string>& command,
+                          const std::string& output) const override;
+
+  void add_custom_target(
+    const std::string& name,
+    const std::vector<std::string>& command) const override;
+
+  void make_directory(const std::string& dir) const override;
+
+  void add_executable(const std::string& name,
+                      const std::vector<std::string>& sources) override;
+  void add_library(const std::string& name,
+                   const std::vector<std::string>& sources) override;
+
+  void target_link_library(const std::string& target_name,
+                           facade::visibility v,
+                           const std::string& library_name) override;
+
+  void target_include_directories(
+    const std::string& target_name, facade::visibility v,
+    const std::vector<std::string>& dirs) override;
+
+  void target_compile_definitions(
+    const std::string& target_name, facade::visibility v,
+    const std::vector<std::string>& definitions) override;
+
+  void target_compile_options(
+    const std::string& target_name, facade::visibility v,
+    const std::vector<std::string>& options) override;
+
+  void target_sources(const std::string& target_name, facade::visibility v,
+                      const std::vector<std::string>& sources) override;
+
+  void apply_command(facade::command_buffer::command_kind kind,
+                     const std::string& name, facade::visibility v,
+                     const std::vector<std::string_view>& arguments) override;
+  void apply_commands(const facade::command_buffer& commands) override;
+
+  std::string current_directory() const override;
+
+  void add_subdirectory_with_old_script(const std::string& dir) override;
+  void go_into_subdirectory(const std::string& dir) override;
+  void go_directory_up() override;
+
+  void prepare_for_add_subdirectory_with_cmakesl_script(
+    const std::string& dir) override;
+  void finalize_after_add_subdirectory_with_cmakesl_script() override;
+
+  void enable_ctest() const override;
+
+  void add_test(const std::string& test_executable_name) override;
+
+  cxx_compiler_info get_cxx_compiler_info() const override;
+
+  system_info get_system_info() const override;
+
+  std::optional<std::string> try_get_extern_define(
+    const std::string& name) const override;
+
+  void set_property(const std::string& property_name,
+                    const std::string& property_value) const override;
+
+  std::optional<bool> get_option_value(
+    const std::string& name) const override;
+  void register_option(const std::string& name,
+                       const std::string& description,
+                       bool value) const override;
+
+  void set_old_style_variable(const std::string& name,
+                              const std::string& value) const override;
+
+  std::optional<std::string> get_old_style_variable(
+    const std::string& name) const override;
+
+  std::string ctest_command() const override;
+
+private:
+  // Const, because some operations that depend on recorded commands are
+  // const in the facade interface.
+  void flush_commands() const;
+  // Applies recorded commands if the buffer is full, so its memory is reused
+  // instead of growing with the script.
+  void flush_if_full();
+
+private:
+  facade::cmake_facade& m_facade;
+  mutable facade::command_buffer m_commands;
+};
+}
@@ -718,7 +718,7 @@ inst::instance* builtin_function_caller::string_size(
 inst::instance* builtin_function_caller::string_ctor(
   inst::instance& instance, const builtin_function_caller::params_t&)
 {
-  instance.value_accessor().access().set_string(std::string{});
+  instance.value_accessor().access().set_string(inst::string_value{});
   return &instance;
 }
 
@@ -783,7 +783,12 @@ inst::instance* builtin_function_caller::string_operator_plus(
 {
   const auto& lhs = instance.value_cref().get_string_cref();
   const auto& [rhs] = get_params<alternative_t::string>(params);
-  return m_instances.create(lhs + rhs);
+
+  std::string result;
+  result.reserve(lhs.size() + rhs.size());
+  result += lhs.view();
+  result += rhs.view();
+  return m_instances.create(std::move(result));
 }
 
 inst::instance* builtin_function_caller::string_operator_plus_equal(
@@ -792,7 +797,7 @@ inst::instance* builtin_function_caller::string_operator_plus_equal(
   auto& lhs = instance.value_accessor().access().get_string_ref();
   const auto& [rhs] = get_params<alternative_t::string>(params);
 
-  lhs += rhs;
+  lhs.modify([&rhs = rhs](std::string& str) { str += rhs.view(); });
   return m_instances.create_reference(instance);
 }
 
@@ -801,7 +806,13 @@ inst::instance* builtin_function_caller::string_operator_slash(
 {
   const auto& lhs = instance.value_cref().get_string_cref();
   const auto& [rhs] = get_params<alternative_t::string>(params);
-  return m_instances.create(lhs + "/" + rhs);
+
+  std::string result;
+  result.reserve(lhs.size() + 1u + rhs.size());
+  result += lhs.view();
+  result += '/';
+  result += rhs.view();
+  return m_instances.create(std::move(result));
 }
 
 inst::instance* builtin_function_caller::string_operator_slash_equal(
@@ -810,8 +821,10 @@ inst::instance* builtin_function_caller::string_operator_slash_equal(
   auto& lhs = instance.value_accessor().access().get_string_ref();
   const auto& [rhs] = get_params<alternative_t::string>(params);
 
-  lhs += "/";
-  lhs += rhs;
+  lhs.modify([&rhs = rhs](std::string& str) {
+    str += '/';
+    str += rhs.view();
+  });
   return m_instances.create_reference(instance);
 }
 
@@ -822,13 +835,14 @@ inst::instance* builtin_function_caller::string_ctor_string_count(
   const auto& [value, count] =
     get_params<alternative_t::string, alternative_t::int_>(params);
 
-  str.clear();
-  str.reserve(value.size() * count);
+  std::string result;
+  result.reserve(value.size() * count);
 
   for (auto i = 0u; i < count; ++i) {
-    str += value;
+    result += value.view();
   }
 
+  str = inst::string_value{ std::move(result) };
   return &instance;
 }
 
@@ -836,7 +850,7 @@ inst::instance* builtin_function_caller::string_clear(
   inst::instance& instance, const builtin_function_caller::params_t&)
 {
   auto& str = instance.value_accessor().access().get_string_ref();
-  str.clear();
+  str = inst::string_value{};
   return m_instances.create_reference(instance);
 }
 
@@ -847,7 +861,9 @@ inst::instance* builtin_function_caller::string_insert_pos_str(
   const auto& [position, value] =
     get_params<alternative_t::int_, alternative_t::string>(params);
 
-  str.insert(position, value);
+  str.modify([position = position, &value = value](std::string& s) {
+    s.insert(position, value.view());
+  });
 
   return m_instances.create_reference(instance);
 }
@@ -857,7 +873,7 @@ inst::instance* builtin_function_caller::string_erase_pos(
 {
   auto& str = instance.value_accessor().access().get_string_ref();
   const auto& [position] = get_params<alternative_t::int_>(params);
-  str.erase(position);
+  str.modify([position = position](std::string& s) { s.erase(position); });
   return m_instances.create_reference(instance);
 }
 
@@ -867,22 +883,22 @@ inst::instance* builtin_function_caller::string_erase_pos_count(
   auto& str = instance.value_accessor().access().get_string_ref();
   const auto& [position, count] =
     get_params<alternative_t::int_, alternative_t::int_>(params);
-  str.erase(position, count);
+  str.modify([position = position, count = count](std::string& s) {
+    s.erase(position, count);
+  });
   return m_instances.create_reference(instance);
 }
 
 inst::instance* builtin_function_caller::string_starts_with(
   inst::instance& instance, const builtin_function_caller::params_t& params)
 {
-  const auto& str = instance.value_cref().get_string_cref();
-  const auto& [value] = get_params<alternative_t::string>(params);
+  const auto str = instance.value_cref().get_string_cref().view();
+  const auto& [value_param] = get_params<alternative_t::string>(params);
+  const auto value = value_param.view();
 
   // Todo: extract to common function with ends_with
-  const auto starts_with =
-    [&str, &value = value] // Workaround for capturing variables introduced by
-                           // structured bindings.
-  {
-    if (&value == &str) {
+  const auto starts_with = [str, value] {
+    if (value.data() == str.data() && value.size() == str.size()) {
       return true; // Very same string.
     }
     if (value.length() > str.length()) {
@@ -899,14 +915,12 @@ inst::instance* builtin_function_caller::string_starts_with(
 inst::instance* builtin_function_caller::string_ends_with(
   inst::instance& instance, const builtin_function_caller::params_t& params)
 {
-  const auto& str = instance.value_cref().get_string_cref();
-  const auto& [value] = get_params<alternative_t::string>(params);
+  const auto str = instance.value_cref().get_string_cref().view();
+  const auto& [value_param] = get_params<alternative_t::string>(params);
+  const auto value = value_param.view();
 
-  const auto ends_with =
-    [&str, &value = value] // Workaround for capturing variables introduced by
-                           // structured bindings.
-  {
-    if (&value == &str) {
+  const auto ends_with = [str, value] {
+    if (value.data() == str.data() && value.size() == str.size()) {
       return true; // Very same string.
     }
     if (value.length() > str.length()) {
@@ -928,25 +942,29 @@ inst::instance* builtin_function_caller::string_replace_pos_count_str(
   const auto& [position, count, value] =
     get_params<alternative_t::int_, alternative_t::int_,
                alternative_t::string>(params);
-  str.replace(position, count, value);
+  str.modify(
+    [position = position, count = count, &value = value](std::string& s) {
+      s.replace(position, count, value.view());
+    });
   return m_instances.create_reference(instance);
 }
 
 inst::instance* builtin_function_caller::string_substr_pos(
   inst::instance& instance, const builtin_function_caller::params_t& params)
 {
-  const auto& str = instance.value_cref().get_string_cref();
+  const auto str = instance.value_cref().get_string_cref().view();
   const auto& [position] = get_params<alternative_t::int_>(params);
-  return m_instances.create(str.substr(position));
+  return m_instances.create(inst::string_value{ str.substr(position) });
 }
 
 inst::instance* builtin_function_caller::string_substr_pos_count(
   inst::instance& instance, const builtin_function_caller::params_t& params)
 {
-  const auto& str = instance.value_cref().get_string_cref();
+  const auto str = instance.value_cref().get_string_cref().view();
   const auto& [position, count] =
     get_params<alternative_t::int_, alternative_t::int_>(params);
-  return m_instances.create(str.substr(position, count));
+  return m_instances.create(
+    inst::string_value{ str.substr(position, count) });
 }
 
 inst::instance* builtin_function_caller::string_resize_newsize(
@@ -954,7 +972,7 @@ inst::instance* builtin_function_caller::string_resize_newsize(
 {
   auto& str = instance.value_accessor().access().get_string_ref();
   const auto& [new_size] = get_params<alternative_t::int_>(params);
-  str.resize(new_size);
+  str.modify([new_size = new_size](std::string& s) { s.resize(new_size); });
   return m_instances.create_reference(instance);
 }
 
@@ -962,18 +980,22 @@ inst::instance* builtin_function_caller::string_resize_newsize_fill(
   inst::instance& instance, const builtin_function_caller::params_t& params)
 {
   auto& str = instance.value_accessor().access().get_string_ref();
-  const auto& [new_size, fill] =
+  const auto& [new_size, fill_param] =
     get_params<alternative_t::int_, alternative_t::string>(params);
-  const auto previous_size = str.length();
-  str.resize(new_size);
-
-  if (new_size > static_cast<int_t>(previous_size)) {
-    const auto difference = new_size - previous_size;
-    const auto fill_length = fill.length();
-    for (auto i = 0u; i < difference; ++i) {
-      str[previous_size + i] = fill[i % fill_length];
+  const auto fill = fill_param.view();
+
+  str.modify([new_size = new_size, fill](std::string& s) {
+    const auto previous_size = s.length();
+    s.resize(new_size);
+
+    if (new_size > static_cast<int_t>(previous_size)) {
+      const auto difference = new_size - previous_size;
+      const auto fill_length = fill.length();
+      for (auto i = 0u; i < difference; ++i) {
+        s[previous_size + i] = fill[i % fill_length];
+      }
     }
-  }
+  });
 
   return m_instances.create_reference(instance);
 }
@@ -983,7 +1005,7 @@ inst::instance* builtin_function_caller::string_find_str(
 {
   const auto& str = instance.value_cref().get_string_cref();
   const auto& [value] = get_params<alternative_t::string>(params);
-  const auto found_pos = str.find(value);
+  const auto found_pos = str.view().find(value.view());
   const auto pos = string_pos_to_int(found_pos);
   return m_instances.create(pos);
 }
@@ -994,7 +1016,7 @@ inst::instance* builtin_function_caller::string_find_str_pos(
   const auto& str = instance.value_cref().get_string_cref();
   const auto& [value, start_pos] =
     get_params<alternative_t::string, alternative_t::int_>(params);
-  const auto found_pos = str.find(value, start_pos);
+  const auto found_pos = str.view().find(value.view(), start_pos);
   const auto pos = string_pos_to_int(found_pos);
   return m_instances.create(pos);
 }
@@ -1004,7 +1026,7 @@ inst::instance* builtin_function_caller::string_find_not_of_str(
 {
   const auto& str = instance.value_cref().get_string_cref();
   const auto& [value] = get_params<alternative_t::string>(params);
-  const auto found_pos = str.find_first_not_of(value);
+  const auto found_pos = str.view().find_first_not_of(value.view());
   const auto pos = string_pos_to_int(found_pos);
   return m_instances.create(pos);
 }
@@ -1015,7 +1037,7 @@ inst::instance* builtin_function_caller::string_find_not_of_str_pos(
   const auto& str = instance.value_cref().get_string_cref();
   const auto& [value, start_pos] =
     get_params<alternative_t::string, alternative_t::int_>(params);
-  const auto found_pos = str.find_first_not_of(value, start_pos);
+  const auto found_pos = str.view().find_first_not_of(value.view(), start_pos);
   const auto pos = string_pos_to_int(found_pos);
   return m_instances.create(pos);
 }
@@ -1025,7 +1047,7 @@ inst::instance* builtin_function_caller::string_find_last_str(
 {
   const auto& str = instance.value_cref().get_string_cref();
   const auto& [value] = get_params<alternative_t::string>(params);
-  const auto found_pos = str.rfind(value);
+  const auto found_pos = str.view().rfind(value.view());
   const auto pos = string_pos_to_int(found_pos);
   return m_instances.create(pos);
 }
@@ -1041,7 +1063,7 @@ inst::instance* builtin_function_caller::string_find_last_not_of_str(
 {
   const auto& str = instance.value_cref().get_string_cref();
   const auto& [value] = get_params<alternative_t::string>(params);
-  const auto found_pos = str.find_last_not_of(value);
+  const auto found_pos = str.view().find_last_not_of(value.view());
   const auto pos = string_pos_to_int(found_pos);
   return m_instances.create(pos);
 }
@@ -1051,7 +1073,7 @@ inst::instance* builtin_function_caller::string_contains(
 {
   const auto& str = instance.value_cref().get_string_cref();
   const auto& [value] = get_params<alternative_t::string>(params);
-  const auto found_pos = str.find(value);
+  const auto found_pos = str.view().find(value.view());
   const auto contains = found_pos != std::string::npos;
   return m_instances.create(contains);
 }
@@ -1061,9 +1083,11 @@ inst::instance* builtin_function_caller::string_lower(
 {
   auto& str = instance.value_accessor().access().get_string_ref();
 
-  for (auto& c : str) {
-    c = std::tolower(c);
-  }
+  str.modify([](std::string& s) {
+    for (auto& c : s) {
+      c = std::tolower(c);
+    }
+  });
 
   return m_instances.create_reference(instance);
 }
@@ -1071,7 +1095,7 @@ inst::instance* builtin_function_caller::string_lower(
 inst::instance* builtin_function_caller::string_make_lower(
   inst::instance& instance, const builtin_function_caller::params_t&)
 {
-  const auto& str = instance.value_cref().get_string_cref();
+  const auto str = instance.value_cref().get_string_cref().view();
   std::string result;
   result.reserve(str.length());
 
@@ -1086,9 +1110,11 @@ inst::instance* builtin_function_caller::string_upper(
 {
   auto& str = instance.value_accessor().access().get_string_ref();
 
-  for (auto& c : str) {
-    c = std::toupper(c);
-  }
+  str.modify([](std::string& s) {
+    for (auto& c : s) {
+      c = std::toupper(c);
+    }
+  });
 
   return m_instances.create_reference(instance);
 }
@@ -1096,7 +1122,7 @@ inst::instance* builtin_function_caller::string_upper(
 inst::instance* builtin_function_caller::string_make_upper(
   inst::instance& instance, const builtin_function_caller::params_t&)
 {
-  const auto& str = instance.value_cref().get_string_cref();
+  const auto str = instance.value_cref().get_string_cref().view();
   std::string result;
   result.reserve(str.length());
 
@@ -1233,7 +1259,7 @@ inst::instance* builtin_function_caller::extern_constructor_name(
   inst::instance& instance, const builtin_function_caller::params_t& params)
 {
   const auto& [name] = get_params<alternative_t ::string>(params);
-  const auto got_value = m_cmake_facade.try_get_extern_define(name);
+  const auto got_value = m_cmake_facade.try_get_extern_define(name.str());
 
   std::unique_ptr<inst::instance> extern_instance;
 
@@ -1321,7 +1347,7 @@ inst::instance* builtin_function_caller::list_ctor_value(
   inst::instance& instance, const builtin_function_caller::params_t& params)
 {
   auto& list = instance.value_accessor().access().get_list_ref();
-  list.push_back(params[0]->copy());
+  list.push_back(*params[0]);
   return m_instances.create_reference(instance);
 }
 
@@ -1332,7 +1358,7 @@ inst::instance* builtin_function_caller::list_ctor_value_count(
   const auto count = params[1]->value_cref().get_int();
 
   for (auto i = 0u; i < count; ++i) {
-    list.push_back(params[0]->copy());
+    list.push_back(*params[0]);
   }
 
   return m_instances.create_reference(instance);
@@ -1342,7 +1368,7 @@ inst::instance* builtin_function_caller::list_push_back_value(
   inst::instance& instance, const builtin_function_caller::params_t& params)
 {
   auto& list = instance.value_accessor().access().get_list_ref();
-  list.push_back(params[0]->copy());
+  list.push_back(*params[0]);
   return m_instances.create_void();
 }
 
@@ -1586,8 +1612,7 @@ inst::instance* builtin_function_caller::list_operator_plus_value(
   inst::instance& instance, const builtin_function_caller::params_t& params)
 {
   auto list_copy = instance.value_cref().get_list_cref();
-  auto value = params[0]->copy();
-  list_copy.push_back(std::move(value));
+  list_copy.push_back(*params[0]);
   return m_instances.create(instance.type(), std::move(list_copy));
 }
 
@@ -1604,8 +1629,7 @@ inst::instance* builtin_function_caller::list_operator_plus_equal_value(
   inst::instance& instance, const builtin_function_caller::params_t& params)
 {
   auto& list = instance.value_accessor().access().get_list_ref();
-  auto value = params[0]->copy();
-  list.push_back(std::move(value));
+  list.push_back(*params[0]);
   return m_instances.create_reference(instance);
 }
 
@@ -1646,8 +1670,8 @@ inst::instance* builtin_function_caller::project_ctor_name(
 {
   auto& project = instance.value_accessor().access().get_project_ref();
   const auto& [name] = get_params<alternative_t::string>(params);
-  project = inst::project_value{ name };
-  m_cmake_facade.register_project(name);
+  project = inst::project_value{ name.str() };
+  m_cmake_facade.register_project(name.str());
   return &instance;
 }
 
@@ -1664,8 +1688,8 @@ inst::instance* builtin_function_caller::project_add_executable(
   auto& project = instance.value_accessor().access().get_project_ref();
   const auto& [name, sources] =
     get_params<alternative_t::string, alternative_t::list>(params);
-  project.add_executable(m_cmake_facade, name, sources);
-  return m_instances.create(inst::executable_value{ name });
+  project.add_executable(m_cmake_facade, name.str(), sources);
+  return m_instances.create(inst::executable_value{ name.str() });
 }
 
 inst::instance* builtin_function_caller::project_add_library(
@@ -1674,15 +1698,15 @@ inst::instance* builtin_function_caller::project_add_library(
   auto& project = instance.value_accessor().access().get_project_ref();
   const auto& [name, sources] =
     get_params<alternative_t::string, alternative_t::list>(params);
-  project.add_library(m_cmake_facade, name, sources);
-  return m_instances.create(inst::library_value{ name });
+  project.add_library(m_cmake_facade, name.str(), sources);
+  return m_instances.create(inst::library_value{ name.str() });
 }
 
 inst::instance* builtin_function_caller::project_find_library(
   inst::instance& instance, const builtin_function_caller::params_t& params)
 {
   const auto& [name] = get_params<alternative_t::string>(params);
-  return m_instances.create(inst::library_value{ name });
+  return m_instances.create(inst::library_value{ name.str() });
 }
 
 inst::instance* builtin_function_caller::library_name(
@@ -1975,16 +1999,16 @@ inst::instance* builtin_function_caller::option_ctor_description(
 {
   const auto& [name, description] =
     get_params<alternative_t::string, alternative_t::string>(params);
-  const auto existing_value = m_cmake_facade.get_option_value(name);
+  const auto existing_value = m_cmake_facade.get_option_value(name.str());
   bool value = false;
   if (existing_value) {
     value = *existing_value;
   } else {
-    m_cmake_facade.register_option(name, description, value);
+    m_cmake_facade.register_option(name.str(), description.str(), value);
   }
 
   instance.value_accessor().access().set_option(
-    inst::option_value{ description, value });
+    inst::option_value{ description.str(), value });
   return &instance;
 }
 
@@ -1994,16 +2018,16 @@ inst::instance* builtin_function_caller::option_ctor_description_value(
   const auto& [name, description, param_value] =
     get_params<alternative_t::string, alternative_t::string,
                alternative_t::bool_>(params);
-  const auto existing_value = m_cmake_facade.get_option_value(name);
+  const auto existing_value = m_cmake_facade.get_option_value(name.str());
   bool value = param_value;
   if (existing_value) {
     value = *existing_value;
   } else {
-    m_cmake_facade.register_option(name, description, value);
+    m_cmake_facade.register_option(name.str(), description.str(), value);
   }
 
   instance.value_accessor().access().set_option(
-    inst::option_value{ description, value });
+    inst::option_value{ description.str(), value });
   return &instance;
 }
 
@@ -2018,7 +2042,7 @@ inst::instance* builtin_function_caller::cmake_message(
   const builtin_function_caller::params_t& params)
 {
   const auto& [message] = get_params<alternative_t::string>(params);
-  m_cmake_facade.message(message);
+  m_cmake_facade.message(message.str());
   return m_instances.create_void();
 }
 
@@ -2026,7 +2050,7 @@ inst::instance* builtin_function_caller::cmake_warning(
   const builtin_function_caller::params_t& params)
 {
   const auto& [message] = get_params<alternative_t::string>(params);
-  m_cmake_facade.warning(message);
+  m_cmake_facade.warning(message.str());
   return m_instances.create_void();
 }
 
@@ -2034,7 +2058,7 @@ inst::instance* builtin_function_caller::cmake_error(
   const builtin_function_caller::params_t& params)
 {
   const auto& [message] = get_params<alternative_t::string>(params);
-  m_cmake_facade.error(message);
+  m_cmake_facade.error(message.str());
   return m_instances.create_void();
 }
 
@@ -2042,7 +2066,7 @@ inst::instance* builtin_function_caller::cmake_fatal_error(
   const builtin_function_caller::params_t& params)
 {
   const auto& [message] = get_params<alternative_t::string>(params);
-  m_cmake_facade.fatal_error(message);
+  m_cmake_facade.fatal_error(message.str());
   return m_instances.create_void();
 }
 
@@ -2076,7 +2100,7 @@ inst::instance* builtin_function_caller::cmake_install_executable_destination(
 {
   const auto& [exe, destination] =
     get_params<alternative_t::executable, alternative_t ::string>(params);
-  m_cmake_facade.install(exe.name(), destination);
+  m_cmake_facade.install(exe.name(), destination.str());
   return m_instances.create_void();
 }
 
@@ -2093,7 +2117,7 @@ inst::instance* builtin_function_caller::cmake_install_library_destination(
 {
   const auto& [lib, destination] =
     get_params<alternative_t::library, alternative_t ::string>(params);
-  m_cmake_facade.install(lib.name(), destination);
+  m_cmake_facade.install(lib.name(), destination.str());
   return m_instances.create_void();
 }
 
@@ -2125,7 +2149,7 @@ inst::instance* builtin_function_caller::cmake_add_custom_command(
   const auto& [command_list, output] =
     get_params<alternative_t::list, alternative_t ::string>(params);
   const auto command = inst::list_value_utils{ command_list }.strings();
-  m_cmake_facade.add_custom_command(command, output);
+  m_cmake_facade.add_custom_command(command, output.str());
   return m_instances.create_void();
 }
 
@@ -2147,7 +2171,7 @@ inst::instance* builtin_function_caller::cmake_make_directory(
   const builtin_function_caller::params_t& params)
 {
   const auto& [dir] = get_params<alternative_t ::string>(params);
-  m_cmake_facade.make_directory(dir);
+  m_cmake_facade.make_directory(dir.str());
   return m_instances.create_void();
 }
 
@@ -2156,7 +2180,7 @@ inst::instance* builtin_function_caller::cmake_set_old_style_variable(
 {
   const auto& [name, value] =
     get_params<alternative_t ::string, alternative_t ::string>(params);
-  m_cmake_facade.set_old_style_variable(name, value);
+  m_cmake_facade.set_old_style_variable(name.str(), value.str());
   return m_instances.create_void();
 }
 
@@ -2164,9 +2188,9 @@ inst::instance* builtin_function_caller::cmake_get_old_style_variable(
   const builtin_function_caller::params_t& params)
 {
   const auto& [name] = get_params<alternative_t ::string>(params);
-  auto value = m_cmake_facade.get_old_style_variable(name);
+  auto value = m_cmake_facade.get_old_style_variable(name.str());
   if (!value) {
-    m_cmake_facade.warning("Getting not existing variable: " + name);
+    m_cmake_facade.warning("Getting not existing variable: " + name.str());
     return m_instances.create(std::string{});
   }
   return m_instances.create(std::move(*value));
@@ -2195,7 +2219,7 @@ inst::instance* builtin_function_caller::cmake_add_custom_target(
   const auto& [name, command_list] =
     get_params<alternative_t ::string, alternative_t ::list>(params);
   const auto command = inst::list_value_utils{ command_list }.strings();
-  m_cmake_facade.add_custom_target(name, command);
+  m_cmake_facade.add_custom_target(name.str(), command);
   return m_instances.create_void();
 }
 
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "exec/instance/instance_value_variant.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace cmsl {
+namespace sema {
+class sema_function;
+class sema_node;
+class sema_type;
+}
+
+namespace exec {
+// Operands of an instruction are named dst, a and b. Their meaning depends on
+// the opcode. Registers hold non-owning pointers to instances. Temporaries
+// are owned by the instances holder of the currently executed full
+// expression.
+enum class bytecode_opcode : std::uint8_t
+{
+  // dst = constants[a]
+  load_constant,
+  // dst = identifier with index a
+  load_identifier,
+  // dst = local variable or parameter in frame slot a
+  load_local,
+  // dst = call functions[a] with arguments from argument_lists[b]
+  call,
+  // dst = call functions[a] on the first register of argument_lists[b],
+  // with the rest of the list as arguments
+  call_member,
+  // dst = call functions[a] on the current class instance, with arguments
+  // from argument_lists[b]
+  call_implicit_member,
+  // dst = construct nodes[a] with arguments from argument_lists[b]
+  construct,
+  // dst = member with index b of register a
+  access_member,
+  // dst = reference to register a
+  make_reference,
+  // dst = reference to base type of nodes[b], referencing register a
+  make_reference_to_base,
+  // dst = copy of register a, cast to value
+  copy_value,
+  // dst = copy of register a, cast to base type of nodes[b]
+  copy_to_base,
+  // dst = nodes[a] evaluated by the tree walker, with types[b - 1] as the
+  // expected type. b == 0 means no expected type.
+  evaluate_tree,
+  // Continue at instruction a
+  jump,
+  // Continue at instruction b if bool in register a is false
+  jump_if_false,
+  // Continue at instruction b if nodes[a], evaluated by the
+  // unboxed_evaluator, is false
+  jump_if_unboxed_false,
+  // dst = nodes[a] evaluated by the unboxed_evaluator
+  evaluate_unboxed,
+  // Evaluate nodes[a] by the unboxed_evaluator and discard the result
+  execute_unboxed,
+  enter_scope,
+  // Leave a scopes
+  leave_scope,
+  // Declare variable of nodes[a], initialized with register b if the
+  // declaration has an initialization.
+  declare_variable,
+  // Return copy of register a
+  return_value,
+  return_void,
+  // Destroy temporaries of the current full expression
+  end_full_expression,
+  // Old-style add_subdirectory of nodes[a]
+  add_subdirectory_with_old_script
+};
+
+struct bytecode_instruction
+{
+  bytecode_opcode opcode;
+  unsigned dst{ 0u };
+  unsigned a{ 0u };
+  unsigned b{ 0u };
+};
+
+struct bytecode_constant
+{
+  inst::instance_value_variant value;
+  // Null for builtin values, that know their type.
+  const sema::sema_type* type{ nullptr };
+};
+
+// Linear form of a function body.
+struct bytecode_chunk
+{
+  std::vector<bytecode_instruction> instructions;
+  std::vector<bytecode_constant> constants;
+  std::vector<const sema::sema_node*> nodes;
+  std::vector<const sema::sema_function*> functions;
+  std::vector<const sema::sema_type*> types;
+  std::vector<std::vector<unsigned>> argument_lists;
+  // Line of the statement that starts at the instruction with the same
+  // index, or 0. See sema::sema_node::statement_line().
+  std::vector<unsigned> statement_lines;
+  unsigned registers_count{ 0u };
+};
+}
+}
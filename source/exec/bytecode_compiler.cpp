@@ -0,0 +1,486 @@
+#include "exec/bytecode_compiler.hpp"
+
+#include "common/assert.hpp"
+#include "exec/instance/enum_constant_value.hpp"
+#include "exec/unboxed_evaluator.hpp"
+#include "sema/sema_nodes.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+
+namespace cmsl::exec {
+bytecode_chunk bytecode_compiler::compile(const sema::block_node& body)
+{
+  compile_statement(body);
+  return std::move(m_chunk);
+}
+
+void bytecode_compiler::compile_statement(const sema::sema_node& node)
+{
+  // Registers live only within a single statement.
+  m_next_register = 0u;
+
+  if (const auto line = node.statement_line(); line != 0u) {
+    m_statement_line = line;
+  }
+
+  if (dynamic_cast<const sema::expression_node*>(&node) != nullptr &&
+      dynamic_cast<const sema::return_node*>(&node) == nullptr &&
+      dynamic_cast<const sema::implicit_return_node*>(&node) == nullptr &&
+      dynamic_cast<const sema::add_subdirectory_with_old_script_node*>(
+        &node) == nullptr) {
+    // A stand alone infix expression.
+    if (unboxed_evaluator::is_unboxed_operation(node)) {
+      emit(bytecode_opcode::execute_unboxed, 0u, add_node(node));
+    } else {
+      compile_expression(node);
+    }
+    emit(bytecode_opcode::end_full_expression);
+    return;
+  }
+
+  node.visit(*this);
+}
+
+void bytecode_compiler::compile_block(const sema::block_node& block)
+{
+  enter_scope();
+  for (const auto& node : block.nodes()) {
+    compile_statement(*node);
+  }
+  leave_scope();
+}
+
+unsigned bytecode_compiler::compile_expression(const sema::sema_node& node)
+{
+  const auto dst = allocate_register();
+  compile_expression_to(node, dst);
+  return dst;
+}
+
+void bytecode_compiler::compile_expression_to(const sema::sema_node& node,
+                                              unsigned dst)
+{
+  m_dst = dst;
+  node.visit(*this);
+}
+
+unsigned bytecode_compiler::compile_call_arguments(
+  const sema::sema_function& function,
+  const std::vector<std::unique_ptr<sema::expression_node>>& params,
+  std::vector<unsigned> arguments)
+{
+  const auto& declared_params = function.signature().params;
+  for (auto i = 0u; i < params.size(); ++i) {
+    m_expected_types.push_back(&declared_params[i].ty);
+    arguments.push_back(compile_expression(*params[i]));
+    m_expected_types.pop_back();
+  }
+
+  m_chunk.argument_lists.emplace_back(std::move(arguments));
+  return static_cast<unsigned>(m_chunk.argument_lists.size() - 1u);
+}
+
+void bytecode_compiler::compile_evaluate_tree(const sema::sema_node& node)
+{
+  const auto expected_type =
+    m_expected_types.empty() ? 0u : add_type(*m_expected_types.back()) + 1u;
+  emit(bytecode_opcode::evaluate_tree, m_dst, add_node(node), expected_type);
+}
+
+unsigned bytecode_compiler::compile_condition_jump(
+  const sema::sema_node& condition)
+{
+  if (unboxed_evaluator::is_unboxed_operation(condition)) {
+    return emit(bytecode_opcode::jump_if_unboxed_false, 0u,
+                add_node(condition));
+  }
+
+  m_next_register = 0u;
+  const auto condition_register = compile_expression(condition);
+  return emit(bytecode_opcode::jump_if_false, 0u, condition_register);
+}
+
+void bytecode_compiler::visit(
+  const sema::add_subdirectory_with_old_script_node& node)
+{
+  emit(bytecode_opcode::add_subdirectory_with_old_script, 0u, add_node(node));
+}
+
+void bytecode_compiler::visit(const sema::block_node& node)
+{
+  compile_block(node);
+}
+
+void bytecode_compiler::visit(const sema::break_node&)
+{
+  CMSL_ASSERT(!m_loops.empty());
+  auto& loop = m_loops.back();
+
+  const auto scopes_to_leave = m_scope_depth - loop.scope_depth;
+  if (scopes_to_leave > 0u) {
+    emit(bytecode_opcode::leave_scope, 0u, scopes_to_leave);
+  }
+
+  loop.break_jumps.emplace_back(emit(bytecode_opcode::jump));
+}
+
+void bytecode_compiler::visit(const sema::for_node& node)
+{
+  enter_scope();
+
+  if (const auto init = node.init()) {
+    compile_statement(*init);
+  }
+
+  const auto loop_begin = current_position();
+  m_loops.emplace_back(loop_info{ m_scope_depth });
+
+  std::optional<unsigned> exit_jump;
+  if (const auto condition = node.condition()) {
+    exit_jump = compile_condition_jump(*condition);
+    emit(bytecode_opcode::end_full_expression);
+  }
+
+  compile_block(node.body());
+
+  if (const auto iteration = node.iteration()) {
+    compile_statement(*iteration);
+  }
+
+  emit(bytecode_opcode::jump, 0u, loop_begin);
+
+  const auto loop_end = current_position();
+  if (exit_jump) {
+    patch_jump_target(*exit_jump, loop_end);
+    emit(bytecode_opcode::end_full_expression);
+  }
+  for (const auto break_jump : m_loops.back().break_jumps) {
+    patch_jump_target(break_jump, loop_end);
+  }
+  m_loops.pop_back();
+
+  leave_scope();
+}
+
+void bytecode_compiler::visit(const sema::if_else_node& node)
+{
+  std::vector<unsigned> end_jumps;
+
+  for (const auto& if_ : node.ifs()) {
+    const auto next_jump = compile_condition_jump(if_->get_condition());
+    emit(bytecode_opcode::end_full_expression);
+
+    compile_block(if_->get_body());
+    end_jumps.emplace_back(emit(bytecode_opcode::jump));
+
+    patch_jump_target(next_jump, current_position());
+    emit(bytecode_opcode::end_full_expression);
+  }
+
+  if (const auto else_body = node.else_body()) {
+    compile_block(*else_body);
+  }
+
+  const auto end = current_position();
+  for (const auto jump : end_jumps) {
+    patch_jump_target(jump, end);
+  }
+}
+
+void bytecode_compiler::visit(const sema::implicit_return_node&)
+{
+  emit(bytecode_opcode::return_void);
+}
+
+void bytecode_compiler::visit(const sema::return_node& node)
+{
+  const auto value = compile_expression(node.expression());
+  emit(bytecode_opcode::return_value, 0u, value);
+}
+
+void bytecode_compiler::visit(const sema::variable_declaration_node& node)
+{
+  auto value = 0u;
+  if (const auto initialization = node.initialization()) {
+    m_expected_types.push_back(&node.type());
+    value = compile_expression(*initialization);
+    m_expected_types.pop_back();
+  }
+
+  emit(bytecode_opcode::declare_variable, 0u, add_node(node), value);
+  emit(bytecode_opcode::end_full_expression);
+}
+
+void bytecode_compiler::visit(const sema::while_node& node)
+{
+  const auto loop_begin = current_position();
+  m_loops.emplace_back(loop_info{ m_scope_depth });
+
+  const auto exit_jump = compile_condition_jump(node.condition());
+  emit(bytecode_opcode::end_full_expression);
+
+  compile_block(node.body());
+  emit(bytecode_opcode::jump, 0u, loop_begin);
+
+  const auto loop_end = current_position();
+  patch_jump_target(exit_jump, loop_end);
+  emit(bytecode_opcode::end_full_expression);
+  for (const auto break_jump : m_loops.back().break_jumps) {
+    patch_jump_target(break_jump, loop_end);
+  }
+  m_loops.pop_back();
+}
+
+void bytecode_compiler::visit(const sema::add_declarative_file_node& node)
+{
+  compile_evaluate_tree(node);
+}
+
+void bytecode_compiler::visit(const sema::add_subdirectory_node& node)
+{
+  compile_evaluate_tree(node);
+}
+
+void bytecode_compiler::visit(
+  const sema::add_subdirectory_with_declarative_script_node& node)
+{
+  compile_evaluate_tree(node);
+}
+
+void bytecode_compiler::visit(const sema::binary_operator_node& node)
+{
+  if (node.unboxed_operation()) {
+    emit(bytecode_opcode::evaluate_unboxed, m_dst, add_node(node));
+    return;
+  }
+
+  const auto dst = m_dst;
+  const auto lhs = compile_expression(node.lhs());
+  const auto rhs = compile_expression(node.rhs());
+  m_chunk.argument_lists.emplace_back(std::vector<unsigned>{ lhs, rhs });
+  const auto arguments =
+    static_cast<unsigned>(m_chunk.argument_lists.size() - 1u);
+  emit(bytecode_opcode::call_member, dst,
+       add_function(node.operator_function()), arguments);
+}
+
+void bytecode_compiler::visit(const sema::bool_value_node& node)
+{
+  emit(bytecode_opcode::load_constant, m_dst, add_constant(node.value()));
+}
+
+void bytecode_compiler::visit(const sema::cast_to_base_value_node& node)
+{
+  const auto dst = m_dst;
+  const auto value = compile_expression(node.expression());
+  emit(bytecode_opcode::copy_to_base, dst, value, add_node(node));
+}
+
+void bytecode_compiler::visit(const sema::cast_to_reference_node& node)
+{
+  const auto dst = m_dst;
+  const auto value = compile_expression(node.expression());
+  emit(bytecode_opcode::make_reference, dst, value);
+}
+
+void bytecode_compiler::visit(const sema::cast_to_reference_to_base_node& node)
+{
+  const auto dst = m_dst;
+  const auto value = compile_expression(node.expression());
+  emit(bytecode_opcode::make_reference_to_base, dst, value, add_node(node));
+}
+
+void bytecode_compiler::visit(const sema::cast_to_value_node& node)
+{
+  const auto dst = m_dst;
+  const auto value = compile_expression(node.expression());
+  emit(bytecode_opcode::copy_value, dst, value);
+}
+
+void bytecode_compiler::visit(const sema::class_member_access_node& node)
+{
+  const auto dst = m_dst;
+  const auto lhs = compile_expression(node.lhs());
+  emit(bytecode_opcode::access_member, dst, lhs, node.member_index());
+}
+
+void bytecode_compiler::visit(const sema::constructor_call_node& node)
+{
+  const auto dst = m_dst;
+  const auto arguments =
+    compile_call_arguments(node.function(), node.param_expressions());
+  emit(bytecode_opcode::construct, dst, add_node(node), arguments);
+}
+
+void bytecode_compiler::visit(const sema::designated_initializers_node& node)
+{
+  compile_evaluate_tree(node);
+}
+
+void bytecode_compiler::visit(const sema::double_value_node& node)
+{
+  emit(bytecode_opcode::load_constant, m_dst, add_constant(node.value()));
+}
+
+void bytecode_compiler::visit(const sema::enum_constant_access_node& node)
+{
+  const auto constant =
+    add_constant(inst::enum_constant_value{ node.value() }, &node.type());
+  emit(bytecode_opcode::load_constant, m_dst, constant);
+}
+
+void bytecode_compiler::visit(const sema::function_call_node& node)
+{
+  const auto dst = m_dst;
+  const auto arguments =
+    compile_call_arguments(node.function(), node.param_expressions());
+  emit(bytecode_opcode::call, dst, add_function(node.function()), arguments);
+}
+
+void bytecode_compiler::visit(const sema::id_node& node)
+{
+  if (const auto& slot = node.slot()) {
+    emit(bytecode_opcode::load_local, m_dst, slot->index);
+  } else {
+    emit(bytecode_opcode::load_identifier, m_dst, node.index());
+  }
+}
+
+void bytecode_compiler::visit(
+  const sema::implicit_member_function_call_node& node)
+{
+  const auto dst = m_dst;
+  const auto arguments =
+    compile_call_arguments(node.function(), node.param_expressions());
+  emit(bytecode_opcode::call_implicit_member, dst,
+       add_function(node.function()), arguments);
+}
+
+void bytecode_compiler::visit(const sema::initializer_list_node& node)
+{
+  compile_evaluate_tree(node);
+}
+
+void bytecode_compiler::visit(const sema::int_value_node& node)
+{
+  emit(bytecode_opcode::load_constant, m_dst, add_constant(node.value()));
+}
+
+void bytecode_compiler::visit(const sema::member_function_call_node& node)
+{
+  const auto dst = m_dst;
+  const auto lhs = compile_expression(node.lhs());
+  const auto arguments = compile_call_arguments(
+    node.function(), node.param_expressions(), std::vector<unsigned>{ lhs });
+  emit(bytecode_opcode::call_member, dst, add_function(node.function()),
+       arguments);
+}
+
+void bytecode_compiler::visit(const sema::string_value_node& node)
+{
+  emit(bytecode_opcode::load_constant, m_dst,
+       add_constant(inst::string_value{ node.value() }));
+}
+
+void bytecode_compiler::visit(const sema::ternary_operator_node& node)
+{
+  // Both branches write to the same register.
+  const auto dst = m_dst;
+  const auto condition = compile_expression(node.condition());
+  const auto false_jump = emit(bytecode_opcode::jump_if_false, 0u, condition);
+
+  compile_expression_to(node.true_(), dst);
+  const auto end_jump = emit(bytecode_opcode::jump);
+
+  patch_jump_target(false_jump, current_position());
+  compile_expression_to(node.false_(), dst);
+
+  patch_jump_target(end_jump, current_position());
+}
+
+void bytecode_compiler::visit(const sema::unary_operator_node& node)
+{
+  if (node.unboxed_operation()) {
+    emit(bytecode_opcode::evaluate_unboxed, m_dst, add_node(node));
+    return;
+  }
+
+  const auto dst = m_dst;
+  const auto lhs = compile_expression(node.expression());
+  m_chunk.argument_lists.emplace_back(std::vector<unsigned>{ lhs });
+  const auto arguments =
+    static_cast<unsigned>(m_chunk.argument_lists.size() - 1u);
+  emit(bytecode_opcode::call_member, dst, add_function(node.function()),
+       arguments);
+}
+
+unsigned bytecode_compiler::emit(bytecode_opcode opcode, unsigned dst,
+                                 unsigned a, unsigned b)
+{
+  m_chunk.instructions.emplace_back(bytecode_instruction{ opcode, dst, a, b });
+  m_chunk.statement_lines.emplace_back(std::exchange(m_statement_line, 0u));
+  return static_cast<unsigned>(m_chunk.instructions.size() - 1u);
+}
+
+unsigned bytecode_compiler::current_position() const
+{
+  return static_cast<unsigned>(m_chunk.instructions.size());
+}
+
+void bytecode_compiler::patch_jump_target(unsigned instruction_position,
+                                          unsigned target)
+{
+  auto& instruction = m_chunk.instructions[instruction_position];
+  if (instruction.opcode == bytecode_opcode::jump) {
+    instruction.a = target;
+  } else {
+    instruction.b = target;
+  }
+}
+
+unsigned bytecode_compiler::allocate_register()
+{
+  const auto reg = m_next_register++;
+  m_chunk.registers_count = std::max(m_chunk.registers_count, m_next_register);
+  return reg;
+}
+
+unsigned bytecode_compiler::add_constant(inst::instance_value_variant value,
+                                         const sema::sema_type* type)
+{
+  m_chunk.constants.emplace_back(bytecode_constant{ std::move(value), type });
+  return static_cast<unsigned>(m_chunk.constants.size() - 1u);
+}
+
+unsigned bytecode_compiler::add_node(const sema::sema_node& node)
+{
+  m_chunk.nodes.emplace_back(&node);
+  return static_cast<unsigned>(m_chunk.nodes.size() - 1u);
+}
+
+unsigned bytecode_compiler::add_function(const sema::sema_function& function)
+{
+  m_chunk.functions.emplace_back(&function);
+  return static_cast<unsigned>(m_chunk.functions.size() - 1u);
+}
+
+unsigned bytecode_compiler::add_type(const sema::sema_type& type)
+{
+  m_chunk.types.emplace_back(&type);
+  return static_cast<unsigned>(m_chunk.types.size() - 1u);
+}
+
+void bytecode_compiler::enter_scope()
+{
+  emit(bytecode_opcode::enter_scope);
+  ++m_scope_depth;
+}
+
+void bytecode_compiler::leave_scope()
+{
+  emit(bytecode_opcode::leave_scope, 0u, 1u);
+  --m_scope_depth;
+}
+}
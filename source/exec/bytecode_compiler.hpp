@@ -0,0 +1,114 @@
+#pragma once
+
+#include "exec/bytecode.hpp"
+#include "sema/sema_node_visitor.hpp"
+
+#include <vector>
+
+namespace cmsl {
+namespace sema {
+class expression_node;
+}
+
+namespace exec {
+// Lowers a function body to a bytecode_chunk. Control flow becomes jumps,
+// expressions become register instructions. Expressions that are rarely
+// executed in loops (designated initializers, initializer lists,
+// add_subdirectory calls etc.) are delegated to the tree walker.
+class bytecode_compiler : public sema::sema_node_visitor
+{
+public:
+  bytecode_chunk compile(const sema::block_node& body);
+
+  // Statements.
+  void visit(const sema::add_subdirectory_with_old_script_node& node) override;
+  void visit(const sema::block_node& node) override;
+  void visit(const sema::break_node& node) override;
+  void visit(const sema::for_node& node) override;
+  void visit(const sema::if_else_node& node) override;
+  void visit(const sema::implicit_return_node& node) override;
+  void visit(const sema::return_node& node) override;
+  void visit(const sema::variable_declaration_node& node) override;
+  void visit(const sema::while_node& node) override;
+
+  // Expressions.
+  void visit(const sema::add_declarative_file_node& node) override;
+  void visit(const sema::add_subdirectory_node& node) override;
+  void visit(
+    const sema::add_subdirectory_with_declarative_script_node& node) override;
+  void visit(const sema::binary_operator_node& node) override;
+  void visit(const sema::bool_value_node& node) override;
+  void visit(const sema::cast_to_base_value_node& node) override;
+  void visit(const sema::cast_to_reference_node& node) override;
+  void visit(const sema::cast_to_reference_to_base_node& node) override;
+  void visit(const sema::cast_to_value_node& node) override;
+  void visit(const sema::class_member_access_node& node) override;
+  void visit(const sema::constructor_call_node& node) override;
+  void visit(const sema::designated_initializers_node& node) override;
+  void visit(const sema::double_value_node& node) override;
+  void visit(const sema::enum_constant_access_node& node) override;
+  void visit(const sema::function_call_node& node) override;
+  void visit(const sema::id_node& node) override;
+  void visit(const sema::implicit_member_function_call_node& node) override;
+  void visit(const sema::initializer_list_node& node) override;
+  void visit(const sema::int_value_node& node) override;
+  void visit(const sema::member_function_call_node& node) override;
+  void visit(const sema::string_value_node& node) override;
+  void visit(const sema::ternary_operator_node& node) override;
+  void visit(const sema::unary_operator_node& node) override;
+
+  // Not present in function bodies.
+  void visit(const sema::class_node&) override {}
+  void visit(const sema::conditional_node&) override {}
+  void visit(const sema::enum_node&) override {}
+  void visit(const sema::function_node&) override {}
+  void visit(const sema::import_node&) override {}
+  void visit(const sema::namespace_node&) override {}
+  void visit(const sema::translation_unit_node&) override {}
+
+private:
+  void compile_statement(const sema::sema_node& node);
+  void compile_block(const sema::block_node& block);
+  unsigned compile_expression(const sema::sema_node& node);
+  void compile_expression_to(const sema::sema_node& node, unsigned dst);
+  unsigned compile_call_arguments(const sema::sema_function& function,
+                                  const std::vector<std::unique_ptr<
+                                    sema::expression_node>>& params,
+                                  std::vector<unsigned> arguments = {});
+  void compile_evaluate_tree(const sema::sema_node& node);
+  // Returns position of the jump, that is taken if condition is false.
+  unsigned compile_condition_jump(const sema::sema_node& condition);
+
+  unsigned emit(bytecode_opcode opcode, unsigned dst = 0u, unsigned a = 0u,
+                unsigned b = 0u);
+  unsigned current_position() const;
+  void patch_jump_target(unsigned instruction_position, unsigned target);
+
+  unsigned allocate_register();
+  unsigned add_constant(inst::instance_value_variant value,
+                        const sema::sema_type* type = nullptr);
+  unsigned add_node(const sema::sema_node& node);
+  unsigned add_function(const sema::sema_function& function);
+  unsigned add_type(const sema::sema_type& type);
+
+  void enter_scope();
+  void leave_scope();
+
+private:
+  struct loop_info
+  {
+    unsigned scope_depth;
+    std::vector<unsigned> break_jumps;
+  };
+
+  bytecode_chunk m_chunk;
+  unsigned m_dst{ 0u };
+  unsigned m_next_register{ 0u };
+  unsigned m_scope_depth{ 0u };
+  // Line of the statement, that is assigned to the next emitted instruction.
+  unsigned m_statement_line{ 0u };
+  std::vector<loop_info> m_loops;
+  std::vector<const sema::sema_type*> m_expected_types;
+};
+}
+}
@@ -0,0 +1,310 @@
+#include "exec/bytecode_interpreter.hpp"
+
+#include "common/assert.hpp"
+#include "exec/execution_context.hpp"
+#include "exec/expression_evaluation_context.hpp"
+#include "exec/expression_evaluation_visitor.hpp"
+#include "exec/function_caller.hpp"
+#include "exec/identifiers_context.hpp"
+#include "exec/instance/instance.hpp"
+#include "exec/script_profiler.hpp"
+#include "exec/unboxed_evaluator.hpp"
+#include "sema/sema_nodes.hpp"
+
+#include "cmake_facade.hpp"
+
+namespace cmsl::exec {
+bytecode_interpreter::bytecode_interpreter(
+  const bytecode_chunk& chunk, function_caller& caller,
+  identifiers_context& ids_context, execution_context& exec_ctx,
+  facade::cmake_facade& cmake_facade,
+  sema::builtin_types_accessor builtin_types,
+  script_profiler* script_profiler)
+  : m_chunk{ chunk }
+  , m_caller{ caller }
+  , m_ids_context{ ids_context }
+  , m_exec_ctx{ exec_ctx }
+  , m_cmake_facade{ cmake_facade }
+  , m_builtin_types{ builtin_types }
+  , m_script_profiler{ script_profiler }
+  , m_registers(chunk.registers_count, nullptr)
+{
+  m_temporaries.emplace(m_builtin_types);
+}
+
+std::unique_ptr<inst::instance> bytecode_interpreter::run()
+{
+  const auto& instructions = m_chunk.instructions;
+  auto pc = 0u;
+
+  while (pc < instructions.size()) {
+    if (m_script_profiler != nullptr && m_chunk.statement_lines[pc] != 0u) {
+      m_script_profiler->enter_line(m_chunk.statement_lines[pc]);
+    }
+
+    const auto& instruction = instructions[pc++];
+    auto& dst = m_registers[instruction.dst];
+
+    switch (instruction.opcode) {
+      case bytecode_opcode::load_constant: {
+        const auto& constant = m_chunk.constants[instruction.a];
+        dst = constant.type != nullptr
+          ? temporaries().create(*constant.type, constant.value)
+          : temporaries().create(constant.value);
+      } break;
+
+      case bytecode_opcode::load_identifier: {
+        dst = m_ids_context.lookup_identifier(instruction.a);
+      } break;
+
+      case bytecode_opcode::load_local: {
+        dst = m_exec_ctx.get_variable(instruction.a);
+      } break;
+
+      case bytecode_opcode::call: {
+        const auto& function = *m_chunk.functions[instruction.a];
+        const auto params = collect_arguments(instruction.b);
+        auto result = m_caller.call(function, params, temporaries());
+        if (m_cmake_facade.did_fatal_error_occure()) {
+          return nullptr;
+        }
+        dst = result.get();
+        temporaries().store(std::move(result));
+      } break;
+
+      case bytecode_opcode::call_member: {
+        const auto& function = *m_chunk.functions[instruction.a];
+        const auto& arguments = m_chunk.argument_lists[instruction.b];
+        auto& class_instance = *m_registers[arguments.front()];
+        const auto params = collect_arguments(instruction.b, 1u);
+        auto result = m_caller.call_member(class_instance, function, params,
+                                           temporaries());
+        if (m_cmake_facade.did_fatal_error_occure()) {
+          return nullptr;
+        }
+        dst = result.get();
+        temporaries().store(std::move(result));
+      } break;
+
+      case bytecode_opcode::call_implicit_member: {
+        const auto& function = *m_chunk.functions[instruction.a];
+        const auto params = collect_arguments(instruction.b);
+        auto& class_instance = *m_ids_context.get_class_instance();
+        auto result = m_caller.call_member(class_instance, function, params,
+                                           temporaries());
+        if (m_cmake_facade.did_fatal_error_occure()) {
+          return nullptr;
+        }
+        dst = result.get();
+        temporaries().store(std::move(result));
+      } break;
+
+      case bytecode_opcode::construct: {
+        const auto& node = static_cast<const sema::constructor_call_node&>(
+          *m_chunk.nodes[instruction.a]);
+        const auto params = collect_arguments(instruction.b);
+        auto class_instance = temporaries().create(node.type());
+        auto result = m_caller.call_member(*class_instance, node.function(),
+                                           params, temporaries());
+        if (m_cmake_facade.did_fatal_error_occure()) {
+          return nullptr;
+        }
+        dst = result.get();
+        temporaries().store(std::move(result));
+      } break;
+
+      case bytecode_opcode::access_member: {
+        dst = m_registers[instruction.a]->find_member(instruction.b);
+      } break;
+
+      case bytecode_opcode::make_reference: {
+        dst = temporaries().create_reference(*m_registers[instruction.a]);
+      } break;
+
+      case bytecode_opcode::make_reference_to_base: {
+        const auto& node = static_cast<const sema::expression_node&>(
+          *m_chunk.nodes[instruction.b]);
+        dst = temporaries().create_reference_to_base(
+          *m_registers[instruction.a], node.type());
+      } break;
+
+      case bytecode_opcode::copy_value: {
+        const auto evaluated = m_registers[instruction.a];
+        const auto& value_type = evaluated->type();
+
+        if (!value_type.is_complex() && value_type.is_builtin()) {
+          dst = temporaries().create(value_type, evaluated->value());
+          break;
+        }
+
+        auto created_value = temporaries().create(value_type);
+        for (const auto& member_info : value_type.members()) {
+          auto copied = evaluated->find_cmember(member_info.index)->copy();
+          created_value->assign_member(member_info.index, std::move(copied));
+        }
+        dst = created_value;
+      } break;
+
+      case bytecode_opcode::copy_to_base: {
+        const auto evaluated = m_registers[instruction.a];
+        const auto& base_type = static_cast<const sema::expression_node&>(
+                                  *m_chunk.nodes[instruction.b])
+                                  .type();
+        auto base_instance = temporaries().create(base_type);
+        for (const auto& member_info : base_type.members()) {
+          auto copied = evaluated->find_cmember(member_info.index)->copy();
+          base_instance->assign_member(member_info.index, std::move(copied));
+        }
+        dst = base_instance;
+      } break;
+
+      case bytecode_opcode::evaluate_tree: {
+        dst = evaluate_tree(instruction);
+        if (m_cmake_facade.did_fatal_error_occure()) {
+          return nullptr;
+        }
+      } break;
+
+      case bytecode_opcode::jump: {
+        pc = instruction.a;
+      } break;
+
+      case bytecode_opcode::jump_if_false: {
+        if (!m_registers[instruction.a]->value_cref().get_bool()) {
+          pc = instruction.b;
+        }
+      } break;
+
+      case bytecode_opcode::jump_if_unboxed_false: {
+        auto ctx = evaluation_context();
+        const auto value =
+          unboxed_evaluator{ ctx }.evaluate(*m_chunk.nodes[instruction.a]);
+        if (m_cmake_facade.did_fatal_error_occure()) {
+          return nullptr;
+        }
+        if (!std::get<bool>(value)) {
+          pc = instruction.b;
+        }
+      } break;
+
+      case bytecode_opcode::evaluate_unboxed: {
+        auto ctx = evaluation_context();
+        dst = unboxed_evaluator{ ctx }.evaluate_to_instance(
+          *m_chunk.nodes[instruction.a]);
+        if (m_cmake_facade.did_fatal_error_occure()) {
+          return nullptr;
+        }
+      } break;
+
+      case bytecode_opcode::execute_unboxed: {
+        auto ctx = evaluation_context();
+        unboxed_evaluator{ ctx }.execute(*m_chunk.nodes[instruction.a]);
+        if (m_cmake_facade.did_fatal_error_occure()) {
+          return nullptr;
+        }
+      } break;
+
+      case bytecode_opcode::enter_scope: {
+        auto guard = m_exec_ctx.enter_scope();
+        // Scope is explicitly left by leave_scope instruction.
+        guard.dismiss();
+      } break;
+
+      case bytecode_opcode::leave_scope: {
+        for (auto i = 0u; i < instruction.a; ++i) {
+          m_exec_ctx.leave_scope();
+        }
+      } break;
+
+      case bytecode_opcode::declare_variable: {
+        declare_variable(instruction);
+      } break;
+
+      case bytecode_opcode::return_value: {
+        return m_registers[instruction.a]->copy();
+      }
+
+      case bytecode_opcode::return_void: {
+        auto void_val = temporaries().create_void();
+        return temporaries().gather_ownership(void_val);
+      }
+
+      case bytecode_opcode::end_full_expression: {
+        end_full_expression();
+      } break;
+
+      case bytecode_opcode::add_subdirectory_with_old_script: {
+        const auto& node =
+          static_cast<const sema::add_subdirectory_with_old_script_node&>(
+            *m_chunk.nodes[instruction.a]);
+        m_cmake_facade.add_subdirectory_with_old_script(
+          std::string{ node.dir_name().value() });
+      } break;
+    }
+  }
+
+  return nullptr;
+}
+
+std::vector<inst::instance*> bytecode_interpreter::collect_arguments(
+  unsigned arguments_index, unsigned first) const
+{
+  const auto& arguments = m_chunk.argument_lists[arguments_index];
+
+  std::vector<inst::instance*> params;
+  params.reserve(arguments.size() - first);
+  for (auto i = first; i < arguments.size(); ++i) {
+    params.emplace_back(m_registers[arguments[i]]);
+  }
+
+  return params;
+}
+
+inst::instance* bytecode_interpreter::evaluate_tree(
+  const bytecode_instruction& instruction)
+{
+  expression_evaluation_context::expected_types_t types;
+  if (instruction.b != 0u) {
+    types.push(*m_chunk.types[instruction.b - 1u]);
+  }
+
+  auto ctx = evaluation_context();
+  ctx.expected_types = std::move(types);
+  expression_evaluation_visitor visitor{ ctx };
+  m_chunk.nodes[instruction.a]->visit(visitor);
+  return visitor.result;
+}
+
+void bytecode_interpreter::declare_variable(
+  const bytecode_instruction& instruction)
+{
+  const auto& node = static_cast<const sema::variable_declaration_node&>(
+    *m_chunk.nodes[instruction.a]);
+
+  std::unique_ptr<inst::instance> created_instance;
+  if (node.initialization()) {
+    created_instance = m_registers[instruction.b]->copy();
+  } else {
+    auto variable_instance_ptr = temporaries().create(node.type());
+    created_instance = temporaries().gather_ownership(variable_instance_ptr);
+  }
+
+  m_exec_ctx.add_variable(node.slot()->index, std::move(created_instance));
+}
+
+void bytecode_interpreter::end_full_expression()
+{
+  m_temporaries.emplace(m_builtin_types);
+}
+
+expression_evaluation_context bytecode_interpreter::evaluation_context()
+{
+  return expression_evaluation_context{ m_caller, temporaries(),
+                                        m_ids_context, m_cmake_facade };
+}
+
+inst::instances_holder& bytecode_interpreter::temporaries()
+{
+  return *m_temporaries;
+}
+}
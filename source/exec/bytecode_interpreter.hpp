@@ -0,0 +1,69 @@
+#pragma once
+
+#include "exec/bytecode.hpp"
+#include "exec/expression_evaluation_context.hpp"
+#include "exec/instance/instances_holder.hpp"
+#include "sema/builtin_types_accessor.hpp"
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace cmsl {
+namespace facade {
+class cmake_facade;
+}
+
+namespace exec {
+class execution_context;
+class function_caller;
+class identifiers_context;
+class script_profiler;
+
+namespace inst {
+class instance;
+}
+
+// Runs a bytecode_chunk of a single function call. Registers and
+// temporaries live as long as the interpreter.
+class bytecode_interpreter
+{
+public:
+  explicit bytecode_interpreter(const bytecode_chunk& chunk,
+                                function_caller& caller,
+                                identifiers_context& ids_context,
+                                execution_context& exec_ctx,
+                                facade::cmake_facade& cmake_facade,
+                                sema::builtin_types_accessor builtin_types,
+                                script_profiler* script_profiler = nullptr);
+
+  // Returns the function result, or nullptr if a fatal error occurred.
+  std::unique_ptr<inst::instance> run();
+
+private:
+  std::vector<inst::instance*> collect_arguments(unsigned arguments_index,
+                                                 unsigned first = 0u) const;
+
+  inst::instance* evaluate_tree(const bytecode_instruction& instruction);
+  void declare_variable(const bytecode_instruction& instruction);
+  void end_full_expression();
+
+  expression_evaluation_context evaluation_context();
+
+  inst::instances_holder& temporaries();
+
+private:
+  const bytecode_chunk& m_chunk;
+  function_caller& m_caller;
+  identifiers_context& m_ids_context;
+  execution_context& m_exec_ctx;
+  facade::cmake_facade& m_cmake_facade;
+  sema::builtin_types_accessor m_builtin_types;
+  // Null if lines are not profiled.
+  script_profiler* m_script_profiler;
+
+  std::vector<inst::instance*> m_registers;
+  std::optional<inst::instances_holder> m_temporaries;
+};
+}
+}
@@ -0,0 +1,385 @@
+#include "exec/compilation_cache.hpp"
+
+#include "common/assert.hpp"
+#include "common/source_files.hpp"
+#include "common/source_view.hpp"
+#include "lexer/lexer.hpp"
+
+#if __has_include("generated/build_fingerprint.hpp")
+#include "generated/build_fingerprint.hpp"
+#else
+#define CMSL_BUILD_FINGERPRINT "unknown"
+#endif
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <random>
+
+namespace cmsl::exec {
+namespace {
+// Bump when the entry format or lexer output changes. Builds without the
+// generated fingerprint rely only on this version.
+constexpr auto cache_format_version = std::uint32_t{ 3u };
+constexpr char tokens_entry_magic[8] = { 'c', 'm', 's', 'l',
+                                         't', 'o', 'k', '\0' };
+constexpr char checked_entry_magic[8] = { 'c', 'm', 's', 'l',
+                                          'c', 'h', 'k', '\0' };
+constexpr cmsl::string_view build_fingerprint = CMSL_BUILD_FINGERPRINT;
+
+std::uint64_t fnv1a(cmsl::string_view data,
+                    std::uint64_t hash = 14695981039346656037ull)
+{
+  for (const auto c : data) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= std::uint64_t{ 1099511628211ull };
+  }
+  return hash;
+}
+
+// Entries of different builds do not overwrite each other.
+std::uint64_t entry_key(std::uint64_t source_hash)
+{
+  return fnv1a(build_fingerprint, source_hash);
+}
+
+std::uint32_t token_types_count()
+{
+  return static_cast<std::uint32_t>(lexer::token_type::_keywords_end);
+}
+
+std::optional<std::string> read_file(const std::string& path)
+{
+  std::ifstream in{ path, std::ios::binary | std::ios::ate };
+  if (!in) {
+    return std::nullopt;
+  }
+
+  std::string content(static_cast<std::size_t>(in.tellg()), '\0');
+  in.seekg(0);
+  in.read(content.data(), static_cast<std::streamsize>(content.size()));
+  if (!in) {
+    return std::nullopt;
+  }
+
+  return content;
+}
+
+template <typename T>
+void write_value(std::string& out, T value)
+{
+  out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Reads values of an entry loaded to memory. Every read fails, if the entry
+// is too short.
+class entry_reader
+{
+public:
+  explicit entry_reader(cmsl::string_view data)
+    : m_data{ data }
+  {
+  }
+
+  template <typename T>
+  bool read(T& value)
+  {
+    if (m_data.size() < sizeof(T)) {
+      return false;
+    }
+
+    std::memcpy(&value, m_data.data(), sizeof(T));
+    m_data.remove_prefix(sizeof(T));
+    return true;
+  }
+
+  bool read(cmsl::string_view& str, std::uint64_t size)
+  {
+    if (m_data.size() < size) {
+      return false;
+    }
+
+    str = m_data.substr(0u, static_cast<std::size_t>(size));
+    m_data.remove_prefix(static_cast<std::size_t>(size));
+    return true;
+  }
+
+  bool read_expected(cmsl::string_view expected)
+  {
+    cmsl::string_view str;
+    return read(str, expected.size()) && str == expected;
+  }
+
+  bool at_end() const { return m_data.empty(); }
+
+private:
+  cmsl::string_view m_data;
+};
+
+void write_header(std::string& out, const char (&magic)[8],
+                  cmsl::string_view src, std::uint64_t hash)
+{
+  out.append(magic, sizeof(magic));
+  write_value(out, cache_format_version);
+  out.append(build_fingerprint.data(), build_fingerprint.size());
+  write_value(out, std::uint64_t{ src.size() });
+  write_value(out, hash);
+}
+
+bool read_header(entry_reader& reader, const char (&magic)[8],
+                 cmsl::string_view src, std::uint64_t hash)
+{
+  std::uint32_t version;
+  std::uint64_t source_size, source_hash;
+  return reader.read_expected(cmsl::string_view{ magic, sizeof(magic) }) &&
+    reader.read(version) && version == cache_format_version &&
+    reader.read_expected(build_fingerprint) && reader.read(source_size) &&
+    source_size == src.size() && reader.read(source_hash) &&
+    source_hash == hash;
+}
+}
+
+compilation_cache::compilation_cache(std::string directory)
+  : m_directory{ std::move(directory) }
+{
+}
+
+std::uint64_t compilation_cache::hash(cmsl::string_view source)
+{
+  return fnv1a(source);
+}
+
+std::optional<lexer::token_container_t> compilation_cache::load(
+  source_view source, source_files::id_t source_id)
+{
+  const auto src = source.source();
+  const auto source_hash = hash(src);
+
+  auto result = [&]() -> std::optional<lexer::token_container_t> {
+    const auto entry = read_file(entry_path(source_hash, ".cmsltok"));
+    if (!entry) {
+      return std::nullopt;
+    }
+
+    entry_reader reader{ *entry };
+    std::uint32_t types_count;
+    std::uint64_t tokens_count;
+    if (!read_header(reader, tokens_entry_magic, src, source_hash) ||
+        !reader.read(types_count) || types_count != token_types_count() ||
+        !reader.read(tokens_count) || tokens_count > src.size()) {
+      return std::nullopt;
+    }
+
+    lexer::token_container_t tokens;
+    tokens.reserve(tokens_count);
+    for (auto i = std::uint64_t{ 0u }; i < tokens_count; ++i) {
+      std::uint32_t type, offset, length;
+      if (!reader.read(type) || type >= types_count || !reader.read(offset) ||
+          !reader.read(length) || offset > src.size() ||
+          length > src.size() - offset) {
+        return std::nullopt;
+      }
+
+      tokens.emplace_back(static_cast<lexer::token_type>(type), offset,
+                          length, source_id);
+    }
+
+    if (!reader.at_end()) {
+      return std::nullopt;
+    }
+
+    return tokens;
+  }();
+
+  add_lookup(source, result ? lookup_result::hit : lookup_result::miss);
+  return result;
+}
+
+void compilation_cache::store(source_view source,
+                              const lexer::token_container_t& tokens)
+{
+  const auto src = source.source();
+  const auto source_hash = hash(src);
+
+  std::string content;
+  content.reserve(64u + tokens.size() * 3u * sizeof(std::uint32_t));
+  write_header(content, tokens_entry_magic, src, source_hash);
+  write_value(content, token_types_count());
+  write_value(content, std::uint64_t{ tokens.size() });
+  for (const auto& token : tokens) {
+    const auto str = token.str();
+    write_value(content, static_cast<std::uint32_t>(token.get_type()));
+    write_value(content, static_cast<std::uint32_t>(str.data() - src.data()));
+    write_value(content, static_cast<std::uint32_t>(str.size()));
+  }
+
+  write_entry(entry_path(source_hash, ".cmsltok"), content);
+}
+
+bool compilation_cache::is_checked(source_view source)
+{
+  const auto src = source.source();
+  const auto source_hash = hash(src);
+
+  const auto checked = [&] {
+    const auto entry = read_file(entry_path(source_hash, ".cmslchk"));
+    if (!entry) {
+      return false;
+    }
+
+    entry_reader reader{ *entry };
+    std::uint64_t imports_count;
+    if (!read_header(reader, checked_entry_magic, src, source_hash) ||
+        !reader.read(imports_count)) {
+      return false;
+    }
+
+    for (auto i = std::uint64_t{ 0u }; i < imports_count; ++i) {
+      std::uint64_t path_size, import_hash;
+      cmsl::string_view path;
+      if (!reader.read(path_size) || !reader.read(path, path_size) ||
+          !reader.read(import_hash)) {
+        return false;
+      }
+
+      const auto import_source = read_file(std::string{ path });
+      if (!import_source || hash(*import_source) != import_hash) {
+        return false;
+      }
+    }
+
+    return reader.at_end();
+  }();
+
+  add_lookup(source,
+             checked ? lookup_result::checked : lookup_result::not_checked);
+  return checked;
+}
+
+void compilation_cache::store_checked(source_view source,
+                                      const std::vector<import_entry>& imports)
+{
+  const auto src = source.source();
+  const auto source_hash = hash(src);
+
+  std::string content;
+  write_header(content, checked_entry_magic, src, source_hash);
+  write_value(content, std::uint64_t{ imports.size() });
+  for (const auto& import : imports) {
+    write_value(content, std::uint64_t{ import.path.size() });
+    content += import.path;
+    write_value(content, import.hash);
+  }
+
+  write_entry(entry_path(source_hash, ".cmslchk"), content);
+}
+
+void compilation_cache::write_entry(const std::string& path,
+                                    const std::string& content)
+{
+  // Write to a temporary file first, so other processes never see a partially
+  // written entry.
+  const auto tmp_path =
+    path + ".tmp." + std::to_string(std::random_device{}());
+
+  {
+    std::ofstream out{ tmp_path, std::ios::binary | std::ios::trunc };
+    if (!out) {
+      return;
+    }
+
+    out.write(content.data(), static_cast<std::streamsize>(content.size()));
+    if (!out) {
+      out.close();
+      std::remove(tmp_path.c_str());
+      return;
+    }
+  }
+
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+  }
+}
+
+void compilation_cache::add_lookup(source_view source, lookup_result result)
+{
+  std::lock_guard<std::mutex> lock{ m_mutex };
+  m_lookups.emplace_back(lookup{ std::string{ source.path() }, result });
+  switch (result) {
+    case lookup_result::hit:
+      ++m_stats.hits;
+      break;
+    case lookup_result::miss:
+      ++m_stats.misses;
+      break;
+    case lookup_result::checked:
+      ++m_stats.checked;
+      break;
+    case lookup_result::not_checked:
+      break;
+  }
+}
+
+compilation_cache::stats compilation_cache::get_stats() const
+{
+  std::lock_guard<std::mutex> lock{ m_mutex };
+  return m_stats;
+}
+
+void compilation_cache::dump(std::ostream& out) const
+{
+  std::lock_guard<std::mutex> lock{ m_mutex };
+  for (const auto& l : m_lookups) {
+    out << lookup_result_name(l.result) << ": " << l.path << '\n';
+  }
+
+  out << "compilation cache: " << m_stats.hits << " hits, " << m_stats.misses
+      << " misses, " << m_stats.checked << " checked\n";
+}
+
+const char* compilation_cache::lookup_result_name(lookup_result result)
+{
+  switch (result) {
+    case lookup_result::hit:
+      return "hit";
+    case lookup_result::miss:
+      return "miss";
+    case lookup_result::checked:
+      return "checked";
+    case lookup_result::not_checked:
+      return "not checked";
+  }
+
+  CMSL_UNREACHABLE("Unknown lookup result");
+  return "";
+}
+
+std::string compilation_cache::entry_path(std::uint64_t source_hash,
+                                          const char* extension) const
+{
+  char name[17];
+  std::snprintf(name, sizeof(name), "%016llx",
+                static_cast<unsigned long long>(entry_key(source_hash)));
+  return m_directory + '/' + name + extension;
+}
+
+lexer::token_container_t lex(errors::errors_observer& errs,
+                             source_view source, source_files::id_t source_id,
+                             compilation_cache* cache)
+{
+  if (cache != nullptr) {
+    if (auto tokens = cache->load(source, source_id)) {
+      return std::move(*tokens);
+    }
+  }
+
+  lexer::lexer lex{ errs, source, source_id };
+  auto tokens = lex.lex();
+  if (cache != nullptr && !lex.has_errors()) {
+    cache->store(source, tokens);
+  }
+
+  return tokens;
+}
+}
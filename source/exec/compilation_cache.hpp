@@ -0,0 +1,106 @@
+#pragma once
+
+#include "common/string.hpp"
+#include "lexer/token.hpp"
+
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace cmsl {
+class source_view;
+
+namespace errors {
+class errors_observer;
+}
+
+namespace exec {
+// Persistent cache of lexed and checked translation units. Every entry is a
+// file in the cache directory, named after a hash of the cmakesl build and of
+// the source. An entry is used only if it was written by the same build and
+// cache format version for a source of the same size and hash, so a modified
+// source or a new cmakesl build result in a miss. Can be used from multiple
+// threads.
+//
+// Token entries are written for sources without lexing errors, so the errors
+// are reported on every run. Check entries are written for sources that
+// compiled without any diagnostics, together with hashes of all sources they
+// import, directly or not. A checked source does not have to be checked
+// again, as long as none of the imports changed, e.g. bodies of its
+// functions can be built only when they are used.
+class compilation_cache
+{
+public:
+  struct stats
+  {
+    unsigned hits{ 0u };
+    unsigned misses{ 0u };
+    // Sources found checked.
+    unsigned checked{ 0u };
+  };
+
+  struct import_entry
+  {
+    std::string path;
+    std::uint64_t hash;
+  };
+
+  // Directory has to exist.
+  explicit compilation_cache(std::string directory);
+
+  // Loaded tokens point into the source registered with the given id.
+  std::optional<lexer::token_container_t> load(source_view source,
+                                               source_files::id_t source_id);
+  void store(source_view source, const lexer::token_container_t& tokens);
+
+  // Imported sources are read from disk, to find out whether they changed.
+  bool is_checked(source_view source);
+  void store_checked(source_view source,
+                     const std::vector<import_entry>& imports);
+
+  // Hash of the source, as stored in entries.
+  static std::uint64_t hash(cmsl::string_view source);
+
+  stats get_stats() const;
+
+  // Prints every lookup, followed by the summary.
+  void dump(std::ostream& out) const;
+
+private:
+  enum class lookup_result
+  {
+    hit,
+    miss,
+    checked,
+    not_checked
+  };
+
+  std::string entry_path(std::uint64_t source_hash,
+                         const char* extension) const;
+  void write_entry(const std::string& path, const std::string& content);
+  void add_lookup(source_view source, lookup_result result);
+  static const char* lookup_result_name(lookup_result result);
+
+private:
+  struct lookup
+  {
+    std::string path;
+    lookup_result result;
+  };
+
+  std::string m_directory;
+  mutable std::mutex m_mutex;
+  stats m_stats;
+  std::vector<lookup> m_lookups;
+};
+
+// Lexes the source registered with the given id, going through the cache if
+// it is not null.
+lexer::token_container_t lex(errors::errors_observer& errs,
+                             source_view source, source_files::id_t source_id,
+                             compilation_cache* cache);
+}
+}
@@ -43,6 +43,11 @@ const sema::sema_node& compiled_source::sema_tree() const
   return *m_sema_tree;
 }
 
+const source_view& compiled_source::source() const
+{
+  return m_source;
+}
+
 sema::builtin_types_accessor compiled_source::builtin_types() const
 {
   return m_builtin_types;
@@ -46,6 +46,7 @@ public:
   const sema::sema_context& get_global_context() const;
 
   const sema::sema_node& sema_tree() const;
+  const source_view& source() const;
 
   sema::builtin_types_accessor builtin_types() const;
 
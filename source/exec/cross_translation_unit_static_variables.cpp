@@ -107,7 +107,7 @@ cross_translation_unit_static_variables::create_observer(
           result = enum_type.enumerator(value.get_enum_constant().value).str();
         } break;
         case inst::instance_value_alternative::string: {
-          result = value.get_string_cref();
+          result = value.get_string_cref().str();
         } break;
         case inst::instance_value_alternative::version: {
         } break;
@@ -76,9 +76,9 @@ declarative_component_instance_creator::register_in_facade(
     }
       .strings();
 
-  const auto name_str = name_prefix_instance->value_cref().get_string_cref() +
-    name_instance->value_cref().get_string_cref() +
-    name_suffix_instance->value_cref().get_string_cref();
+  auto name_str = name_prefix_instance->value_cref().get_string_cref().str();
+  name_str += name_instance->value_cref().get_string_cref().view();
+  name_str += name_suffix_instance->value_cref().get_string_cref().view();
 
   // Todo: it probably should be done somewhere else
   if (m_facade.get_root_source_dir() == m_facade.get_current_source_dir()) {
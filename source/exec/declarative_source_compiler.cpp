@@ -8,7 +8,7 @@
 #include "decl_sema/sema_builder_ast_visitor.hpp"
 #include "decl_sema/sema_nodes.hpp"
 #include "exec/compiled_source.hpp"
-#include "lexer/lexer.hpp"
+#include "exec/profiler.hpp"
 #include "sema/builtin_sema_context.hpp"
 #include "sema/cmake_namespace_types_accessor.hpp"
 #include "sema/factories.hpp"
@@ -19,10 +19,11 @@ declarative_source_compiler::declarative_source_compiler(
   errors::errors_observer& errs, strings_container& strings,
   sema::factories_provider& factories_provider,
   sema::qualified_contextes_refs qualified_contextes,
-  sema::builtin_sema_context& builtin_context,
+  const sema::builtin_sema_context& builtin_context,
   decl_sema::builtin_decl_namespace_context& decl_context,
-  sema::builtin_token_provider& builtin_tokens,
-  decl_sema::declarative_import_handler& import_handler)
+  const sema::builtin_token_provider& builtin_tokens,
+  decl_sema::declarative_import_handler& import_handler,
+  profiler* profiler)
   : m_errs{ errs }
   , m_strings{ strings }
   , m_factories_provider{ factories_provider }
@@ -31,27 +32,37 @@ declarative_source_compiler::declarative_source_compiler(
   , m_decl_context{ decl_context }
   , m_builtin_tokens{ builtin_tokens }
   , m_import_handler{ import_handler }
+  , m_profiler{ profiler }
 {
 }
 
 std::unique_ptr<compiled_declarative_source>
-declarative_source_compiler::compile(source_view source)
+declarative_source_compiler::compile(source_view source,
+                                     const lexer::token_container_t& tokens)
 {
-  lexer::lexer lex{ m_errs, source };
-  const auto tokens = lex.lex();
-  decl_ast::parser parser{ m_errs, m_strings, source, tokens };
-  auto ast_tree = parser.parse_translation_unit();
+  auto ast_tree = [&] {
+    const profile_scope profile{ m_profiler, phase::parse, source.path() };
+    decl_ast::parser parser{ m_errs, m_strings, source, tokens };
+    return parser.parse_translation_unit();
+  }();
   if (!ast_tree) {
     return nullptr;
   }
 
+  const profile_scope profile{ m_profiler, phase::sema, source.path() };
+
   const auto builtin_types = m_builtin_context.builtin_types();
 
+  // Generic types are created in the global context of the source. The
+  // builtin context is shared, so it is never modified.
+  auto& global_context =
+    m_factories_provider.context_factory().create("", &m_builtin_context);
+
   cmsl::string_view_map<const decl_sema::component_declaration_node*>
     component_declarations;
 
   decl_sema::sema_builder_ast_visitor_members members{ m_errs,
-                                                       m_builtin_context,
+                                                       global_context,
                                                        m_decl_context,
                                                        m_factories_provider,
                                                        m_builtin_tokens,
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "lexer/token.hpp"
 #include "sema/qualified_contextes_refs.hpp"
 
 #include <memory>
@@ -27,6 +28,7 @@ class sema_function;
 
 namespace exec {
 class compiled_declarative_source;
+class profiler;
 
 class declarative_source_compiler
 {
@@ -35,12 +37,14 @@ public:
     errors::errors_observer& errs, strings_container& strings,
     sema::factories_provider& factories_provider,
     sema::qualified_contextes_refs qualified_contextes,
-    sema::builtin_sema_context& builtin_context,
+    const sema::builtin_sema_context& builtin_context,
     decl_sema::builtin_decl_namespace_context& decl_context,
-    sema::builtin_token_provider& builtin_tokens,
-    decl_sema::declarative_import_handler& import_handler);
+    const sema::builtin_token_provider& builtin_tokens,
+    decl_sema::declarative_import_handler& import_handler,
+    profiler* profiler = nullptr);
 
-  std::unique_ptr<compiled_declarative_source> compile(source_view source);
+  std::unique_ptr<compiled_declarative_source> compile(
+    source_view source, const lexer::token_container_t& tokens);
 
 private:
   const sema::sema_function& create_component_creation_function(
@@ -54,10 +58,12 @@ private:
   strings_container& m_strings;
   sema::factories_provider& m_factories_provider;
   sema::qualified_contextes_refs m_qualified_contextes;
-  sema::builtin_sema_context& m_builtin_context;
+  const sema::builtin_sema_context& m_builtin_context;
   decl_sema::builtin_decl_namespace_context& m_decl_context;
-  sema::builtin_token_provider& m_builtin_tokens;
+  const sema::builtin_token_provider& m_builtin_tokens;
   decl_sema::declarative_import_handler& m_import_handler;
+  // Null if compilation is not profiled.
+  profiler* m_profiler;
 };
 
 }
@@ -1,25 +1,43 @@
 #include "exec/execution.hpp"
 #include "decl_sema/component_creation_sema_function.hpp"
+#include "exec/bytecode_compiler.hpp"
+#include "exec/bytecode_interpreter.hpp"
 #include "exec/cross_translation_unit_static_variables_accessor.hpp"
 #include "exec/declarative_component_instance_creator.hpp"
 #include "exec/instance/target_value.hpp"
+#include "exec/profiler.hpp"
+#include "exec/script_profiler.hpp"
 #include "exec/static_variables_initializer.hpp"
+#include "exec/unboxed_evaluator.hpp"
 #include "sema/cmake_namespace_types_accessor.hpp"
 
 namespace cmsl::exec {
+namespace {
+unsigned frame_size(const sema::sema_function& fun)
+{
+  const auto user_function =
+    dynamic_cast<const sema::user_sema_function*>(&fun);
+  return user_function != nullptr ? user_function->frame_size() : 0u;
+}
+}
+
 execution::execution(
   facade::cmake_facade& cmake_facade,
   sema::builtin_types_accessor builtin_types,
   decl_sema::decl_namespace_types_accessor decl_types,
   cross_translation_unit_static_variables_accessor& static_variables_accessor,
   const sema::generic_type_creation_utils& generic_types,
-  errors::errors_observer& errors_observer)
+  errors::errors_observer& errors_observer, execution_engine engine,
+  profiler* profiler, script_profiler* script_profiler)
   : m_cmake_facade{ cmake_facade }
   , m_builtin_types{ builtin_types }
   , m_decl_types{ decl_types }
   , m_static_variables_accessor{ static_variables_accessor }
   , m_generic_types{ generic_types }
   , m_errs{ errors_observer }
+  , m_engine{ engine }
+  , m_profiler{ profiler }
+  , m_script_profiler{ script_profiler }
 {
 }
 
@@ -27,12 +45,12 @@ std::unique_ptr<inst::instance> execution::call(
   const sema::sema_function& fun, const std::vector<inst::instance*>& params,
   inst::instances_holder_interface& instances)
 {
+  const profile_scope scope{ m_profiler, fun };
   std::unique_ptr<inst::instance> result;
   if (auto user_function =
         dynamic_cast<const sema::user_sema_function*>(&fun)) {
     enter_function_scope(fun, params);
-    execute_block(user_function->body());
-    result = std::move(m_function_return_value);
+    result = execute_function_body(*user_function);
     leave_function_scope();
   } else if (auto component_creation = dynamic_cast<
                const decl_sema::component_creation_sema_function*>(&fun)) {
@@ -53,12 +71,13 @@ std::unique_ptr<inst::instance> execution::call_member(
   const std::vector<inst::instance*>& params,
   inst::instances_holder_interface& instances)
 {
+  const profile_scope scope{ m_profiler, fun };
   if (auto user_function =
         dynamic_cast<const sema::user_sema_function*>(&fun)) {
     enter_function_scope(fun, class_instance, params);
-    execute_block(user_function->body());
+    auto result = execute_function_body(*user_function);
     leave_function_scope();
-    return std::move(m_function_return_value);
+    return result;
   } else {
     auto builtin_function =
       dynamic_cast<const sema::builtin_sema_function*>(&fun);
@@ -76,15 +95,63 @@ inst::instance* execution::lookup_identifier(unsigned index)
   } else if (auto found = m_static_variables_accessor.access_variable(index)) {
     return found;
   } else {
-    return m_callstack.top().exec_ctx.get_variable(index);
+    return m_callstack.top().exec_ctx.get_class_member(index);
   }
 }
 
+inst::instance* execution::lookup_local_variable(unsigned slot)
+{
+  return m_callstack.top().exec_ctx.get_variable(slot);
+}
+
 inst::instance* execution::get_class_instance()
 {
   return m_callstack.top().exec_ctx.get_this();
 }
 
+std::unique_ptr<inst::instance> execution::execute_function_body(
+  const sema::user_sema_function& function)
+{
+  if (m_script_profiler != nullptr) {
+    m_script_profiler->enter_function(function);
+  }
+
+  std::unique_ptr<inst::instance> result;
+  if (m_engine == execution_engine::bytecode) {
+    result = execute_bytecode(function);
+  } else {
+    execute_block(function.body());
+    result = std::move(m_function_return_value);
+  }
+
+  if (m_script_profiler != nullptr) {
+    m_script_profiler->leave_function();
+  }
+
+  return result;
+}
+
+std::unique_ptr<inst::instance> execution::execute_bytecode(
+  const sema::user_sema_function& function)
+{
+  const auto& body = function.body();
+  auto found = m_compiled_bodies.find(&body);
+  if (found == std::end(m_compiled_bodies)) {
+    auto chunk =
+      std::make_unique<bytecode_chunk>(bytecode_compiler{}.compile(body));
+    found = m_compiled_bodies.emplace(&body, std::move(chunk)).first;
+  }
+
+  bytecode_interpreter interpreter{ *found->second,
+                                    *this,
+                                    *this,
+                                    m_callstack.top().exec_ctx,
+                                    m_cmake_facade,
+                                    m_builtin_types,
+                                    m_script_profiler };
+  return interpreter.run();
+}
+
 void execution::execute_block(const sema::block_node& block)
 {
   auto guard = m_callstack.top().exec_ctx.enter_scope();
@@ -101,22 +168,28 @@ void execution::execute_variable_declaration(
   const sema::variable_declaration_node& node)
 {
   auto& exec_ctx = m_callstack.top().exec_ctx;
-  inst::instances_holder instances{ m_builtin_types };
   std::unique_ptr<inst::instance> created_instance;
 
   if (auto initialization = node.initialization()) {
     created_instance = execute_infix_expression(node.type(), *initialization);
   } else {
     // Todo: create variable without instances holder
+    inst::instances_holder instances{ m_builtin_types };
     auto variable_instance_ptr = instances.create(node.type());
     created_instance = instances.gather_ownership(variable_instance_ptr);
   }
 
-  exec_ctx.add_variable(node.index(), std::move(created_instance));
+  exec_ctx.add_variable(node.slot()->index, std::move(created_instance));
 }
 
 void execution::execute_node(const sema::sema_node& node)
 {
+  if (m_script_profiler != nullptr) {
+    if (const auto line = node.statement_line(); line != 0u) {
+      m_script_profiler->enter_line(line);
+    }
+  }
+
   // Todo: consider introducing a visitor for such execution, instead of
   // dynamic casts.
   if (dynamic_cast<const sema::return_node*>(&node) != nullptr) {
@@ -145,7 +218,7 @@ void execution::execute_node(const sema::sema_node& node)
     execute_add_subdirectory_with_old_script(*add_subdirectory_old);
   } else {
     // A stand alone infix expression.
-    (void)execute_infix_expression(node);
+    execute_expression_statement(node);
   }
 }
 
@@ -163,16 +236,16 @@ const sema::sema_context& execution::current_context() const
 void execution::enter_function_scope(
   const sema::sema_function& fun, const std::vector<inst::instance*>& params)
 {
-  m_callstack.push(callstack_frame{ fun });
+  m_callstack.push(
+    callstack_frame{ fun, execution_context{ frame_size(fun) } });
   auto guard = m_callstack.top().exec_ctx.enter_scope();
   // Scope is explicitly left in leave_function_scope() method.
   guard.dismiss();
   auto& exec_ctx = m_callstack.top().exec_ctx;
-  const auto& declared_params = fun.signature().params;
 
   for (auto i = 0u; i < params.size(); ++i) {
     auto param = params[i]->copy();
-    exec_ctx.add_variable(declared_params[i].index, std::move(param));
+    exec_ctx.add_variable(i, std::move(param));
   }
 }
 
@@ -180,17 +253,17 @@ void execution::enter_function_scope(
   const sema::sema_function& fun, inst::instance& class_instance,
   const std::vector<inst::instance*>& params)
 {
-  m_callstack.push(callstack_frame{ fun });
+  m_callstack.push(
+    callstack_frame{ fun, execution_context{ frame_size(fun) } });
   auto guard =
     m_callstack.top().exec_ctx.enter_member_function_scope(&class_instance);
   // Scope is explicitly left in leave_function_scope() method.
   guard.dismiss();
   auto& exec_ctx = m_callstack.top().exec_ctx;
-  const auto& declared_params = fun.signature().params;
 
   for (auto i = 0u; i < params.size(); ++i) {
     auto param = params[i]->copy();
-    exec_ctx.add_variable(declared_params[i].index, std::move(param));
+    exec_ctx.add_variable(i, std::move(param));
   }
 }
 
@@ -230,13 +303,30 @@ std::unique_ptr<inst::instance> execution::execute_infix_expression(
   return execute_infix_expression(std::move(ctx), node);
 }
 
+bool execution::execute_condition(const sema::sema_node& node)
+{
+  inst::instances_holder instances{ m_builtin_types };
+  expression_evaluation_context ctx{ *this, instances, *this, m_cmake_facade };
+  const auto value = unboxed_evaluator{ ctx }.evaluate(node);
+  if (m_cmake_facade.did_fatal_error_occure()) {
+    return false;
+  }
+
+  return std::get<bool>(value);
+}
+
+void execution::execute_expression_statement(const sema::sema_node& node)
+{
+  inst::instances_holder instances{ m_builtin_types };
+  expression_evaluation_context ctx{ *this, instances, *this, m_cmake_facade };
+  unboxed_evaluator{ ctx }.execute(node);
+}
+
 void execution::execute_if_else_node(const sema::if_else_node& node)
 {
   for (const auto& if_ : node.ifs()) {
     const auto& condition = if_->get_condition();
-    auto condition_value = execute_infix_expression(condition);
-
-    if (condition_value->value().get_bool()) {
+    if (execute_condition(condition)) {
       execute_block(if_->get_body());
       return;
     }
@@ -251,16 +341,13 @@ void execution::execute_while_node(const sema::while_node& node)
 {
   const auto& condition = node.condition();
   const auto& body = node.body();
-  auto condition_result = execute_infix_expression(condition);
-  while (condition_result->value_cref().get_bool()) {
+  while (execute_condition(condition)) {
     execute_block(body);
 
     if (returning_from_function() || m_breaking_from_loop) {
       m_breaking_from_loop = false;
       break;
     }
-
-    condition_result = execute_infix_expression(condition);
   }
 }
 
@@ -273,7 +360,7 @@ void execution::execute_for_node(const sema::for_node& node)
           dynamic_cast<const sema::variable_declaration_node*>(node.init())) {
       execute_variable_declaration(*var_decl);
     } else {
-      execute_infix_expression(*node.init());
+      execute_expression_statement(*node.init());
     }
   }
 
@@ -282,8 +369,7 @@ void execution::execute_for_node(const sema::for_node& node)
       return true;
     }
 
-    auto condition_result = execute_infix_expression(*node.condition());
-    return condition_result->value_cref().get_bool();
+    return execute_condition(*node.condition());
   };
 
   while (should_continue()) {
@@ -297,7 +383,7 @@ void execution::execute_for_node(const sema::for_node& node)
     }
 
     if (node.iteration()) {
-      execute_infix_expression(*node.iteration());
+      execute_expression_statement(*node.iteration());
     }
   }
 }
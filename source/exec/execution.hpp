@@ -2,6 +2,8 @@
 
 #include "decl_sema/decl_namespace_types_accessor.hpp"
 #include "exec/builtin_function_caller.hpp"
+#include "exec/bytecode.hpp"
+#include "exec/execution_engine.hpp"
 #include "exec/expression_evaluation_context.hpp"
 #include "exec/expression_evaluation_visitor.hpp"
 #include "exec/function_caller.hpp"
@@ -35,6 +37,8 @@ namespace exec {
 class cross_translation_unit_static_variables_accessor;
 class module_sema_tree_provider;
 class module_static_variables_initializer;
+class profiler;
+class script_profiler;
 
 class execution
   : public identifiers_context
@@ -47,7 +51,10 @@ public:
                      cross_translation_unit_static_variables_accessor&
                        static_variables_accessor,
                      const sema::generic_type_creation_utils& generic_types,
-                     errors::errors_observer& errors_observer);
+                     errors::errors_observer& errors_observer,
+                     execution_engine engine = execution_engine::tree_walker,
+                     profiler* profiler = nullptr,
+                     script_profiler* script_profiler = nullptr);
 
   void initialize_static_variables(
     const sema::translation_unit_node& node,
@@ -67,9 +74,15 @@ public:
     inst::instances_holder_interface& instances) override;
 
   inst::instance* lookup_identifier(unsigned index) override;
+  inst::instance* lookup_local_variable(unsigned slot) override;
   inst::instance* get_class_instance() override;
 
 private:
+  std::unique_ptr<inst::instance> execute_function_body(
+    const sema::user_sema_function& function);
+  std::unique_ptr<inst::instance> execute_bytecode(
+    const sema::user_sema_function& function);
+
   void execute_block(const sema::block_node& block);
   void execute_variable_declaration(
     const sema::variable_declaration_node& node);
@@ -101,6 +114,11 @@ private:
   std::unique_ptr<inst::instance> execute_infix_expression(
     const sema::sema_type& expected_type, const sema::sema_node& node);
 
+  // Evaluate int, double and bool operators without creating instances,
+  // where possible.
+  bool execute_condition(const sema::sema_node& node);
+  void execute_expression_statement(const sema::sema_node& node);
+
   std::unique_ptr<inst::instance> handle_component_creation_function(
     const decl_sema::component_creation_sema_function& function);
 
@@ -118,12 +136,19 @@ private:
     m_static_variables_accessor;
   const sema::generic_type_creation_utils& m_generic_types;
   errors::errors_observer& m_errs;
+  const execution_engine m_engine;
+  // Null if calls are not profiled.
+  profiler* m_profiler;
+  // Null if user functions are not profiled.
+  script_profiler* m_script_profiler;
 
   std::unique_ptr<inst::instance> m_function_return_value;
   std::stack<callstack_frame> m_callstack;
   std::unordered_map<unsigned, std::unique_ptr<inst::instance>>
     m_global_variables;
   bool m_breaking_from_loop{ false };
+  std::unordered_map<const sema::block_node*, std::unique_ptr<bytecode_chunk>>
+    m_compiled_bodies;
 };
 }
 }
\ No newline at end of file
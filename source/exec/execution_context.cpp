@@ -1,64 +1,66 @@
 #include "exec/execution_context.hpp"
 
 #include "common/assert.hpp"
-#include "exec/instance/instance_reference.hpp"
 
 namespace cmsl::exec {
-void execution_context::add_variable(unsigned index,
-                                     std::unique_ptr<instance_t> inst)
+execution_context::execution_context(unsigned frame_size)
+  : m_slots(frame_size)
 {
-  current_scope().add_variable(index, std::move(inst));
+  m_declared_slots.reserve(frame_size);
 }
 
-execution_context::instance_t* execution_context::get_variable(unsigned index)
+void execution_context::add_variable(unsigned slot,
+                                     std::unique_ptr<instance_t> inst)
 {
-  return current_scope().get_variable(index);
+  if (m_scopes.empty()) {
+    CMSL_UNREACHABLE("No scope");
+  }
+
+  if (slot >= m_slots.size()) {
+    m_slots.resize(slot + 1u);
+  }
+
+  m_slots[slot] = std::move(inst);
+  m_declared_slots.emplace_back(slot);
 }
 
-bool execution_context::variable_exists(unsigned index) const
+execution_context::instance_t* execution_context::get_class_member(
+  unsigned index)
 {
-  return current_scope().variable_exists(index);
+  return m_class_instance != nullptr ? m_class_instance->find_member(index)
+                                     : nullptr;
 }
 
-execution_context::scope_leaving_guard execution_context::enter_scope()
+bool execution_context::variable_exists(unsigned slot) const
 {
-  auto current = m_scopes.empty() ? nullptr : &current_scope();
-  m_scopes.push(scope_context{ current });
-  return scope_leaving_guard{ m_scopes };
+  return slot < m_slots.size() && m_slots[slot] != nullptr;
 }
 
-void execution_context::leave_scope()
+execution_context::scope_leaving_guard execution_context::enter_scope()
 {
-  m_scopes.pop();
+  m_scopes.emplace_back(static_cast<unsigned>(m_declared_slots.size()));
+  return scope_leaving_guard{ *this };
 }
 
-scope_context& execution_context::current_scope()
+void execution_context::leave_scope()
 {
   if (m_scopes.empty()) {
     CMSL_UNREACHABLE("No scope");
   }
-  return m_scopes.top();
-}
 
-const scope_context& execution_context::current_scope() const
-{
-  if (m_scopes.empty()) {
-    CMSL_UNREACHABLE("No scope");
+  const auto declared_before = m_scopes.back();
+  m_scopes.pop_back();
+
+  while (m_declared_slots.size() > declared_before) {
+    m_slots[m_declared_slots.back()].reset();
+    m_declared_slots.pop_back();
   }
-  return m_scopes.top();
 }
 
 execution_context::scope_leaving_guard
 execution_context::enter_member_function_scope(instance_t* class_instance)
 {
-  m_scopes.push(scope_context{ class_instance });
-  add_variable(k_this_index,
-               std::make_unique<inst::instance_reference>(*class_instance));
-  return scope_leaving_guard{ m_scopes };
-}
-
-execution_context::instance_t* execution_context::get_this()
-{
-  return get_variable(k_this_index);
+  m_class_instance = class_instance;
+  return enter_scope();
 }
 }
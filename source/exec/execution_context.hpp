@@ -1,44 +1,55 @@
 #pragma once
 
-#include "exec/scope_context.hpp"
+#include "exec/instance/instance.hpp"
 
-#include <stack>
+#include <memory>
+#include <vector>
 
 namespace cmsl::exec {
+// Local variables and parameters of a function call. They live in frame
+// slots assigned by sema, so they are addressed by index instead of being
+// looked up by identifier.
 class execution_context
 {
 private:
   using instance_t = inst::instance;
-  static constexpr unsigned k_this_index = static_cast<unsigned>(-1);
 
 public:
   class scope_leaving_guard
   {
   public:
-    explicit scope_leaving_guard(std::stack<scope_context>& scopes)
-      : m_scopes{ scopes }
+    explicit scope_leaving_guard(execution_context& ctx)
+      : m_ctx{ ctx }
     {
     }
 
     ~scope_leaving_guard()
     {
       if (!m_dismissed) {
-        m_scopes.pop();
+        m_ctx.leave_scope();
       }
     }
 
     void dismiss() { m_dismissed = true; }
 
   private:
-    std::stack<scope_context>& m_scopes;
+    execution_context& m_ctx;
     bool m_dismissed{ false };
   };
 
-  void add_variable(unsigned index, std::unique_ptr<instance_t> inst);
-  instance_t* get_variable(unsigned index);
-  instance_t* get_this();
+  explicit execution_context(unsigned frame_size = 0u);
 
-  bool variable_exists(unsigned index) const;
+  void add_variable(unsigned slot, std::unique_ptr<instance_t> inst);
+  instance_t* get_variable(unsigned slot)
+  {
+    return slot < m_slots.size() ? m_slots[slot].get() : nullptr;
+  }
+
+  // Null if not executing a member function.
+  instance_t* get_this() { return m_class_instance; }
+  instance_t* get_class_member(unsigned index);
+
+  bool variable_exists(unsigned slot) const;
 
   [[nodiscard]] scope_leaving_guard enter_scope();
   [[nodiscard]] scope_leaving_guard enter_member_function_scope(
@@ -46,10 +57,11 @@ public:
   void leave_scope();
 
 private:
-  scope_context& current_scope();
-  const scope_context& current_scope() const;
-
-private:
-  std::stack<scope_context> m_scopes;
+  std::vector<std::unique_ptr<instance_t>> m_slots;
+  // Slots of variables in order of declaration and, for every entered scope,
+  // number of variables declared before the scope.
+  std::vector<unsigned> m_declared_slots;
+  std::vector<unsigned> m_scopes;
+  instance_t* m_class_instance{ nullptr };
 };
 }
@@ -0,0 +1,13 @@
+#pragma once
+
+namespace cmsl::exec {
+// Selects how user function bodies are executed.
+enum class execution_engine
+{
+  // Walks the sema tree node by node.
+  tree_walker,
+  // Lowers function bodies to a linear instruction stream once and runs it
+  // on a register machine.
+  bytecode
+};
+}
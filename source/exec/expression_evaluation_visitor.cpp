@@ -1,5 +1,7 @@
 #include "exec/expression_evaluation_visitor.hpp"
 
+#include "exec/unboxed_evaluator.hpp"
+
 namespace cmsl::exec {
 expression_evaluation_visitor::expression_evaluation_visitor(
   expression_evaluation_context& ctx)
@@ -23,7 +25,7 @@ void expression_evaluation_visitor::visit(const sema::double_value_node& node)
 
 void expression_evaluation_visitor::visit(const sema::string_value_node& node)
 {
-  result = m_ctx.instances.create(std::string{ node.value() });
+  result = m_ctx.instances.create(inst::string_value{ node.value() });
 }
 
 void expression_evaluation_visitor::visit(
@@ -35,12 +37,21 @@ void expression_evaluation_visitor::visit(
 
 void expression_evaluation_visitor::visit(const sema::id_node& node)
 {
-  result = m_ctx.ids_context.lookup_identifier(node.index());
+  if (const auto& slot = node.slot()) {
+    result = m_ctx.ids_context.lookup_local_variable(slot->index);
+  } else {
+    result = m_ctx.ids_context.lookup_identifier(node.index());
+  }
 }
 
 void expression_evaluation_visitor::visit(
   const sema::binary_operator_node& node)
 {
+  if (node.unboxed_operation()) {
+    result = unboxed_evaluator{ m_ctx }.evaluate_to_instance(node);
+    return;
+  }
+
   auto lhs_result = evaluate_child(node.lhs());
   if (m_ctx.cmake_facade.did_fatal_error_occure()) {
     return;
@@ -338,6 +349,11 @@ void expression_evaluation_visitor::visit(
 void expression_evaluation_visitor::visit(
   const sema::unary_operator_node& node)
 {
+  if (node.unboxed_operation()) {
+    result = unboxed_evaluator{ m_ctx }.evaluate_to_instance(node);
+    return;
+  }
+
   auto lhs_result = evaluate_child(node.expression());
   const auto& operator_function = node.function();
 
@@ -0,0 +1,405 @@
+#include "exec/facade_trace.hpp"
+
+#include "cmake_facade.hpp"
+
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <tuple>
+#include <unordered_map>
+
+namespace cmsl::exec {
+facade_trace_writer::facade_trace_writer(std::ostream& out)
+  : m_out{ out }
+{
+}
+
+void facade_trace_writer::write_function_name(std::string_view name) const
+{
+  m_out << name;
+}
+
+void facade_trace_writer::write_argument(std::string_view str) const
+{
+  m_out << ' ' << str.size() << ':' << str;
+}
+
+void facade_trace_writer::write_argument(const std::string& str) const
+{
+  write_argument(std::string_view{ str });
+}
+
+void facade_trace_writer::write_argument(
+  const std::vector<std::string>& strings) const
+{
+  m_out << ' ' << strings.size();
+  for (const auto& str : strings) {
+    write_argument(str);
+  }
+}
+
+void facade_trace_writer::write_argument(
+  const std::vector<std::string_view>& strings) const
+{
+  m_out << ' ' << strings.size();
+  for (const auto str : strings) {
+    write_argument(str);
+  }
+}
+
+void facade_trace_writer::write_argument(facade::visibility v) const
+{
+  m_out << ' ' << static_cast<unsigned>(v);
+}
+
+void facade_trace_writer::write_argument(bool value) const
+{
+  m_out << ' ' << (value ? 1u : 0u);
+}
+
+void facade_trace_writer::end_call() const
+{
+  m_out << '\n';
+}
+
+namespace {
+class trace_reader
+{
+public:
+  explicit trace_reader(std::istream& in)
+    : m_in{ in }
+  {
+  }
+
+  // Sizes are read from the trace, so memory is allocated as the data is
+  // read, not up front. A size that exceeds the trace fails at its end.
+  bool read(std::string& str)
+  {
+    std::size_t size;
+    if (!(m_in >> size) || m_in.get() != ':') {
+      return false;
+    }
+
+    str.clear();
+    char buffer[k_read_chunk_size];
+    while (size > 0u) {
+      const auto chunk_size = std::min(size, sizeof(buffer));
+      if (!m_in.read(buffer, chunk_size)) {
+        return false;
+      }
+      str.append(buffer, chunk_size);
+      size -= chunk_size;
+    }
+
+    return true;
+  }
+
+  bool read(std::vector<std::string>& strings)
+  {
+    std::size_t count;
+    if (!(m_in >> count)) {
+      return false;
+    }
+
+    strings.clear();
+    for (auto i = std::size_t{ 0u }; i < count; ++i) {
+      std::string str;
+      if (!read(str)) {
+        return false;
+      }
+      strings.emplace_back(std::move(str));
+    }
+
+    return true;
+  }
+
+  bool read(facade::visibility& v)
+  {
+    unsigned value;
+    if (!(m_in >> value) ||
+        value > static_cast<unsigned>(facade::visibility::public_)) {
+      return false;
+    }
+
+    v = static_cast<facade::visibility>(value);
+    return true;
+  }
+
+  bool read(bool& value)
+  {
+    unsigned read_value;
+    if (!(m_in >> read_value) || read_value > 1u) {
+      return false;
+    }
+
+    value = read_value == 1u;
+    return true;
+  }
+
+private:
+  static constexpr auto k_read_chunk_size = std::size_t{ 4096u };
+
+  std::istream& m_in;
+};
+
+// Reads arguments of the given types and passes them to the call.
+template <typename... Args, typename Call>
+bool replay(trace_reader& reader, Call&& call)
+{
+  std::tuple<Args...> args;
+  const auto all_read = std::apply(
+    [&reader](auto&... arg) { return (reader.read(arg) && ...); }, args);
+  if (!all_read) {
+    return false;
+  }
+
+  std::apply(call, args);
+  return true;
+}
+
+using replayer_t = bool (*)(trace_reader&, facade::cmake_facade&);
+
+const std::unordered_map<std::string_view, replayer_t>& replayers()
+{
+  using facade_t = facade::cmake_facade;
+  using strings_t = std::vector<std::string>;
+  using facade::visibility;
+
+  static const std::unordered_map<std::string_view, replayer_t> result = {
+    { "get_cmake_version",
+      [](trace_reader& r, facade_t& f) {
+        return replay<>(r, [&f] { f.get_cmake_version(); });
+      } },
+    { "message",
+      [](trace_reader& r, facade_t& f) {
+        return replay<std::string>(r,
+                                   [&f](const auto& s) { f.message(s); });
+      } },
+    { "warning",
+      [](trace_reader& r, facade_t& f) {
+        return replay<std::string>(r,
+                                   [&f](const auto& s) { f.warning(s); });
+      } },
+    { "error",
+      [](trace_reader& r, facade_t& f) {
+        return replay<std::string>(r, [&f](const auto& s) { f.error(s); });
+      } },
+    { "fatal_error",
+      [](trace_reader& r, facade_t& f) {
+        return replay<std::string>(r,
+                                   [&f](const auto& s) { f.fatal_error(s); });
+      } },
+    { "did_fatal_error_occure",
+      [](trace_reader& r, facade_t& f) {
+        return replay<>(r, [&f] { f.did_fatal_error_occure(); });
+      } },
+    { "register_project",
+      [](trace_reader& r, facade_t& f) {
+        return replay<std::string>(
+          r, [&f](const auto& name) { f.register_project(name); });
+      } },
+    { "install",
+      [](trace_reader& r, facade_t& f) {
+        return replay<std::string, std::string>(
+          r, [&f](const auto& target, const auto& destination) {
+            f.install(target, destination);
+          });
+      } },
+    { "get_current_binary_dir",
+      [](trace_reader& r, facade_t& f) {
+        return replay<>(r, [&f] { f.get_current_binary_dir(); });
+      } },
+    { "get_current_source_dir",
+      [](trace_reader& r, facade_t& f) {
+        return replay<>(r, [&f] { f.get_current_source_dir(); });
+      } },
+    { "get_root_source_dir",
+      [](trace_reader& r, facade_t& f) {
+        return replay<>(r, [&f] { f.get_root_source_dir(); });
+      } },
+    { "add_custom_command",
+      [](trace_reader& r, facade_t& f) {
+        return replay<strings_t, std::string>(
+          r, [&f](const auto& command, const auto& output) {
+            f.add_custom_command(command, output);
+          });
+      } },
+    { "add_custom_target",
+      [](trace_reader& r, facade_t& f) {
+        return replay<std::string, strings_t>(
+          r, [&f](const auto& name, const auto& command) {
+            f.add_custom_target(name, command);
+          });
+      } },
+    { "make_directory",
+      [](trace_reader& r, facade_t& f) {
+        return replay<std::string>(
+          r, [&f](const auto& dir) { f.make_directory(dir); });
+      } },
+    { "add_executable",
+      [](trace_reader& r, facade_t& f) {
+        return replay<std::string, strings_t>(
+          r, [&f](const auto& name, const auto& sources) {
+            f.add_executable(name, sources);
+          });
+      } },
+    { "add_library",
+      [](trace_reader& r, facade_t& f) {
+        return replay<std::string, strings_t>(
+          r, [&f](const auto& name, const auto& sources) {
+            f.add_library(name, sources);
+          });
+      } },
+    { "target_link_library",
+      [](trace_reader& r, facade_t& f) {
+        return replay<std::string, visibility, std::string>(
+          r, [&f](const auto& target, auto v, const auto& library) {
+            f.target_link_library(target, v, library);
+          });
+      } },
+    { "target_include_directories",
+      [](trace_reader& r, facade_t& f) {
+        return replay<std::string, visibility, strings_t>(
+          r, [&f](const auto& target, auto v, const auto& dirs) {
+            f.target_include_directories(target, v, dirs);
+          });
+      } },
+    { "target_compile_definitions",
+      [](trace_reader& r, facade_t& f) {
+        return replay<std::string, visibility, strings_t>(
+          r, [&f](const auto& target, auto v, const auto& definitions) {
+            f.target_compile_definitions(target, v, definitions);
+          });
+      } },
+    { "target_compile_options",
+      [](trace_reader& r, facade_t& f) {
+        return replay<std::string, visibility, strings_t>(
+          r, [&f](const auto& target, auto v, const auto& options) {
+            f.target_compile_options(target, v, options);
+          });
+      } },
+    { "target_sources",
+      [](trace_reader& r, facade_t& f) {
+        return replay<std::string, visibility, strings_t>(
+          r, [&f](const auto& target, auto v, const auto& sources) {
+            f.target_sources(target, v, sources);
+          });
+      } },
+    { "current_directory",
+      [](trace_reader& r, facade_t& f) {
+        return replay<>(r, [&f] { f.current_directory(); });
+      } },
+    { "add_subdirectory_with_old_script",
+      [](trace_reader& r, facade_t& f) {
+        return replay<std::string>(r, [&f](const auto& dir) {
+          f.add_subdirectory_with_old_script(dir);
+        });
+      } },
+    { "go_into_subdirectory",
+      [](trace_reader& r, facade_t& f) {
+        return replay<std::string>(
+          r, [&f](const auto& dir) { f.go_into_subdirectory(dir); });
+      } },
+    { "go_directory_up",
+      [](trace_reader& r, facade_t& f) {
+        return replay<>(r, [&f] { f.go_directory_up(); });
+      } },
+    { "prepare_for_add_subdirectory_with_cmakesl_script",
+      [](trace_reader& r, facade_t& f) {
+        return replay<std::string>(r, [&f](const auto& dir) {
+          f.prepare_for_add_subdirectory_with_cmakesl_script(dir);
+        });
+      } },
+    { "finalize_after_add_subdirectory_with_cmakesl_script",
+      [](trace_reader& r, facade_t& f) {
+        return replay<>(r, [&f] {
+          f.finalize_after_add_subdirectory_with_cmakesl_script();
+        });
+      } },
+    { "enable_ctest",
+      [](trace_reader& r, facade_t& f) {
+        return replay<>(r, [&f] { f.enable_ctest(); });
+      } },
+    { "add_test",
+      [](trace_reader& r, facade_t& f) {
+        return replay<std::string>(
+          r, [&f](const auto& executable) { f.add_test(executable); });
+      } },
+    { "get_cxx_compiler_info",
+      [](trace_reader& r, facade_t& f) {
+        return replay<>(r, [&f] { f.get_cxx_compiler_info(); });
+      } },
+    { "get_system_info",
+      [](trace_reader& r, facade_t& f) {
+        return replay<>(r, [&f] { f.get_system_info(); });
+      } },
+    { "try_get_extern_define",
+      [](trace_reader& r, facade_t& f) {
+        return replay<std::string>(
+          r, [&f](const auto& name) { f.try_get_extern_define(name); });
+      } },
+    { "set_property",
+      [](trace_reader& r, facade_t& f) {
+        return replay<std::string, std::string>(
+          r, [&f](const auto& name, const auto& value) {
+            f.set_property(name, value);
+          });
+      } },
+    { "get_option_value",
+      [](trace_reader& r, facade_t& f) {
+        return replay<std::string>(
+          r, [&f](const auto& name) { f.get_option_value(name); });
+      } },
+    { "register_option",
+      [](trace_reader& r, facade_t& f) {
+        return replay<std::string, std::string, bool>(
+          r, [&f](const auto& name, const auto& description, bool value) {
+            f.register_option(name, description, value);
+          });
+      } },
+    { "set_old_style_variable",
+      [](trace_reader& r, facade_t& f) {
+        return replay<std::string, std::string>(
+          r, [&f](const auto& name, const auto& value) {
+            f.set_old_style_variable(name, value);
+          });
+      } },
+    { "get_old_style_variable",
+      [](trace_reader& r, facade_t& f) {
+        return replay<std::string>(
+          r, [&f](const auto& name) { f.get_old_style_variable(name); });
+      } },
+    { "ctest_command",
+      [](trace_reader& r, facade_t& f) {
+        return replay<>(r, [&f] { f.ctest_command(); });
+      } },
+  };
+
+  return result;
+}
+}
+
+std::optional<std::size_t> replay_facade_trace(std::istream& trace,
+                                               facade::cmake_facade& facade)
+{
+  const auto& all_replayers = replayers();
+  trace_reader reader{ trace };
+
+  auto replayed = std::size_t{ 0u };
+  std::string function_name;
+  while (trace >> function_name) {
+    const auto found = all_replayers.find(function_name);
+    if (found == std::cend(all_replayers) ||
+        !found->second(reader, facade)) {
+      return std::nullopt;
+    }
+    ++replayed;
+  }
+
+  if (!trace.eof()) {
+    return std::nullopt;
+  }
+
+  return replayed;
+}
+}
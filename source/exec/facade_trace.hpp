@@ -0,0 +1,56 @@
+#pragma once
+
+#include "visibility.hpp"
+
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cmsl {
+namespace facade {
+class cmake_facade;
+}
+
+namespace exec {
+// Writes a trace of cmake_facade calls. Every call is written in a separate
+// line, as the name of the called member function followed by its
+// arguments. Strings are prefixed with their size, e.g. '3:foo', lists with
+// the number of their elements. Visibilities and bools are written as
+// numbers.
+class facade_trace_writer
+{
+public:
+  explicit facade_trace_writer(std::ostream& out);
+
+  template <typename... Args>
+  void write(std::string_view function_name, const Args&... args) const
+  {
+    write_function_name(function_name);
+    (write_argument(args), ...);
+    end_call();
+  }
+
+private:
+  void write_function_name(std::string_view name) const;
+  void write_argument(std::string_view str) const;
+  void write_argument(const std::string& str) const;
+  void write_argument(const std::vector<std::string>& strings) const;
+  void write_argument(const std::vector<std::string_view>& strings) const;
+  void write_argument(facade::visibility v) const;
+  void write_argument(bool value) const;
+  void end_call() const;
+
+private:
+  std::ostream& m_out;
+};
+
+// Calls member functions of the facade, as recorded in the trace. Results
+// of the calls are dropped. Returns number of replayed calls, or
+// std::nullopt if the trace is malformed. Calls that precede the malformed
+// one are replayed anyway.
+std::optional<std::size_t> replay_facade_trace(std::istream& trace,
+                                               facade::cmake_facade& facade);
+}
+}
@@ -1,15 +1,21 @@
 #include "exec/global_executor.hpp"
+#include "ast/ast_node.hpp"
 #include "common/assert.hpp"
 #include "decl_sema/builtin_decl_namespace_context.hpp"
+#include "exec/buffered_cmake_facade.hpp"
 #include "exec/compiled_source.hpp"
 #include "exec/declarative_source_compiler.hpp"
+#include "exec/compilation_cache.hpp"
 #include "exec/execution.hpp"
+#include "exec/profiler.hpp"
 #include "exec/source_compiler.hpp"
+#include "exec/source_prefetcher.hpp"
 #include "sema/builtin_sema_context.hpp"
-#include "sema/builtin_token_provider.hpp"
+#include "sema/builtin_sema_environment.hpp"
 #include "sema/enum_values_context.hpp"
 #include "sema/functions_context.hpp"
 #include "sema/identifiers_context.hpp"
+#include "sema/lazy_function_bodies.hpp"
 #include "sema/qualified_contextes_refs.hpp"
 #include "sema/types_context.hpp"
 #include "sema/user_sema_function.hpp"
@@ -19,6 +25,7 @@
 #include <errors/error.hpp>
 #include <fstream>
 #include <iterator>
+#include <unordered_set>
 
 namespace cmsl::exec {
 global_executor::directory_guard::directory_guard(
@@ -33,22 +40,69 @@ global_executor::directory_guard::~directory_guard()
   m_cmake_facade.go_directory_up();
 }
 
+global_executor::commands_flush_guard::commands_flush_guard(
+  buffered_cmake_facade* buffered_facade)
+  : m_buffered_facade{ buffered_facade }
+{
+}
+
+global_executor::commands_flush_guard::~commands_flush_guard()
+{
+  if (m_buffered_facade != nullptr) {
+    m_buffered_facade->flush();
+  }
+}
+
 global_executor::global_executor(const std::string& root_path,
                                  facade::cmake_facade& cmake_facade,
                                  errors::errors_observer& errors_observer)
+  : global_executor{ root_path, cmake_facade, errors_observer, options{} }
+{
+}
+
+global_executor::global_executor(const std::string& root_path,
+                                 facade::cmake_facade& cmake_facade,
+                                 errors::errors_observer& errors_observer,
+                                 const options& opts)
   : m_root_path{ root_path }
-  , m_cmake_facade{ cmake_facade }
+  , m_buffered_facade{ opts.batch_facade_calls
+                         ? std::make_unique<buffered_cmake_facade>(
+                             cmake_facade)
+                         : nullptr }
+  , m_cmake_facade{ m_buffered_facade ? *m_buffered_facade : cmake_facade }
   , m_errors_observer{ errors_observer }
+  , m_engine{ opts.engine }
+  , m_cache{ opts.cache }
+  , m_profiler{ opts.profiler }
+  , m_script_profiler{ opts.script_profiler }
+  , m_dump_optimized{ opts.dump_optimized }
+  , m_prefetcher{ opts.prefetch_threads > 0u
+                    ? std::make_unique<source_prefetcher>(
+                        root_path, opts.prefetch_threads, opts.cache)
+                    : nullptr }
+  , m_lazy_imports{ opts.lazy_imports }
+  , m_lazy_bodies{ opts.lazy_imports || opts.cache != nullptr
+                     ? std::make_unique<sema::lazy_function_bodies>(
+                         m_strings_container)
+                     : nullptr }
+  , m_builtin_environment{ sema::builtin_sema_environment::shared() }
   , m_builtin_qualified_contexts{ create_qualified_contextes() }
   , m_builtin_identifiers_observer{ m_cmake_facade }
-  , m_builtin_tokens{ std::make_unique<sema::builtin_token_provider>("") }
-  , m_builtin_context{ create_builtin_context() }
+  , m_builtin_types{ m_builtin_environment.builtin_types() }
+  , m_generic_types_context{ m_factories.context_factory().create(
+      "", &m_builtin_environment.context()) }
+  , m_generic_creation_utils{ m_generic_types_context,
+                              m_factories,
+                              m_errors_observer,
+                              m_builtin_environment.tokens(),
+                              m_builtin_types,
+                              *m_builtin_qualified_contexts.types }
   , m_decl_namespace_context{ create_decl_namespace_context() }
   , m_static_variables{ m_cmake_facade,
-                        m_builtin_context->builtin_types(),
+                        m_builtin_types,
                         m_decl_namespace_context->types_accessor(),
                         *this,
-                        m_builtin_context->generic_creation_utils(),
+                        m_generic_creation_utils,
                         m_errors_observer }
 {
   m_cmake_facade.go_into_subdirectory(m_root_path);
@@ -58,6 +112,7 @@ global_executor::~global_executor() = default;
 
 int global_executor::execute(std::string source)
 {
+  const commands_flush_guard flush_guard{ m_buffered_facade.get() };
   const auto compiled =
     compile_source(std::move(source), m_root_path + "/CMakeLists.cmsl");
   if (!compiled) {
@@ -65,10 +120,14 @@ int global_executor::execute(std::string source)
   }
 
   const auto builtin_identifiers_info =
-    m_builtin_context->builtin_identifiers_info();
+    m_builtin_environment.context().builtin_identifiers_info();
 
-  m_static_variables.initialize_builtin_variables(
-    builtin_identifiers_info, m_builtin_identifiers_observer);
+  {
+    const profile_scope profile{ m_profiler, phase::execute, {},
+                                 "builtin variables initialization" };
+    m_static_variables.initialize_builtin_variables(
+      builtin_identifiers_info, m_builtin_identifiers_observer);
+  }
 
   auto result = execute(*compiled);
 
@@ -79,26 +138,26 @@ int global_executor::execute(std::string source)
   return result->value_cref().get_int();
 }
 
-int global_executor::execute_based_on_root_path()
+bool global_executor::build_all_function_bodies()
 {
-  const auto script_path_creator = [this] {
-    std::string result = m_cmake_facade.current_directory();
-
-    std::string separator;
-
-    for (const auto& dir : m_directories) {
-      result += '/' + dir;
-    }
+  if (!m_lazy_bodies) {
+    return true;
+  }
 
-    return result;
-  };
+  const profile_scope profile{ m_profiler, phase::sema, {},
+                               "deferred function bodies" };
+  return m_lazy_bodies->build_all();
+}
 
-  auto dcmakesl_script_path = script_path_creator() + "/CMakeLists.dcmsl";
+int global_executor::execute_based_on_root_path()
+{
+  const commands_flush_guard flush_guard{ m_buffered_facade.get() };
+  auto dcmakesl_script_path = current_script_directory() + "/CMakeLists.dcmsl";
   if (file_exists(dcmakesl_script_path)) {
     const auto compiled =
       compile_declarative_file(std::move(dcmakesl_script_path));
     if (!compiled) {
-      raise_unsuccessful_compilation_error(script_path_creator());
+      raise_unsuccessful_compilation_error(current_script_directory());
       return -1;
     }
 
@@ -107,25 +166,29 @@ int global_executor::execute_based_on_root_path()
     return 0;
   }
 
-  auto cmakesl_script_path = script_path_creator() + "/CMakeLists.cmsl";
+  auto cmakesl_script_path = current_script_directory() + "/CMakeLists.cmsl";
   if (file_exists(cmakesl_script_path)) {
     const auto compiled = compile_file(std::move(cmakesl_script_path));
     if (!compiled) {
-      raise_unsuccessful_compilation_error(script_path_creator());
+      raise_unsuccessful_compilation_error(current_script_directory());
       return -1;
     }
 
     const auto main_function = compiled->get_main();
     if (!main_function) {
-      raise_no_main_function_error(script_path_creator());
+      raise_no_main_function_error(current_script_directory());
       return -1;
     }
 
     const auto builtin_identifiers_info =
-      m_builtin_context->builtin_identifiers_info();
+      m_builtin_environment.context().builtin_identifiers_info();
 
-    m_static_variables.initialize_builtin_variables(
-      builtin_identifiers_info, m_builtin_identifiers_observer);
+    {
+      const profile_scope profile{ m_profiler, phase::execute, {},
+                                   "builtin variables initialization" };
+      m_static_variables.initialize_builtin_variables(
+        builtin_identifiers_info, m_builtin_identifiers_observer);
+    }
 
     auto result = execute(*compiled);
     if (result == nullptr) {
@@ -145,25 +208,15 @@ global_executor::handle_add_subdirectory(
   const std::vector<std::unique_ptr<sema::expression_node>>&)
 {
   m_directories.emplace_back(std::string{ name });
+  const profile_scope profile{ m_profiler, "add_subdirectory", "subdirectory",
+                               current_script_directory() };
 
-  const auto script_path_creator = [this] {
-    std::string result = m_cmake_facade.current_directory();
-
-    std::string separator;
-
-    for (const auto& dir : m_directories) {
-      result += '/' + dir;
-    }
-
-    return result;
-  };
-
-  auto dcmakesl_script_path = script_path_creator() + "/CMakeLists.dcmsl";
+  auto dcmakesl_script_path = current_script_directory() + "/CMakeLists.dcmsl";
   if (file_exists(dcmakesl_script_path)) {
     const auto compiled =
       compile_declarative_file(std::move(dcmakesl_script_path));
     if (!compiled) {
-      raise_unsuccessful_compilation_error(script_path_creator());
+      raise_unsuccessful_compilation_error(current_script_directory());
       return add_subdirectory_semantic_handler::compilation_failed{};
     }
 
@@ -173,9 +226,9 @@ global_executor::handle_add_subdirectory(
       contains_declarative_cmakesl_script{ creation_function };
   }
 
-  auto cmakesl_script_path = script_path_creator() + "/CMakeLists.cmsl";
+  auto cmakesl_script_path = current_script_directory() + "/CMakeLists.cmsl";
   if (!file_exists(cmakesl_script_path)) {
-    if (file_exists(script_path_creator() + "/CMakeLists.txt")) {
+    if (file_exists(current_script_directory() + "/CMakeLists.txt")) {
       m_directories.pop_back();
       return contains_old_cmake_script{};
     }
@@ -185,13 +238,13 @@ global_executor::handle_add_subdirectory(
 
   const auto compiled = compile_file(std::move(cmakesl_script_path));
   if (!compiled) {
-    raise_unsuccessful_compilation_error(script_path_creator());
+    raise_unsuccessful_compilation_error(current_script_directory());
     return add_subdirectory_semantic_handler::compilation_failed{};
   }
 
   const auto main_function = compiled->get_main();
   if (!main_function) {
-    raise_no_main_function_error(script_path_creator());
+    raise_no_main_function_error(current_script_directory());
     return contains_cmakesl_script{ nullptr };
   }
 
@@ -200,17 +253,20 @@ global_executor::handle_add_subdirectory(
   return contains_cmakesl_script{ main_function };
 }
 
-std::unique_ptr<sema::qualified_contextes> global_executor::handle_import(
+const sema::qualified_contextes* global_executor::handle_import(
   cmsl::string_view path)
 {
   auto import_path = build_full_import_path(path);
+  if (!m_importing.empty()) {
+    m_imports[m_importing.back()].emplace_back(import_path);
+  }
 
   if (const auto found = m_exported_qualified_contextes.find(import_path);
       found != std::cend(m_exported_qualified_contextes)) {
-    const auto& ctxs = found->second;
-    return std::make_unique<sema::qualified_contextes>(ctxs.clone());
+    return &found->second;
   }
 
+  const profile_scope profile{ m_profiler, "import", "import", import_path };
   const auto src_view = load_source(std::move(import_path));
   if (!src_view) {
     //     Todo: file not found
@@ -218,27 +274,46 @@ std::unique_ptr<sema::qualified_contextes> global_executor::handle_import(
   }
 
   auto contexts = m_builtin_qualified_contexts.clone();
-  auto compiler = create_compiler(contexts);
-  auto compiled = compiler.compile(*src_view);
+  // Bodies of a module, that is known to compile without errors, do not have
+  // to be built till they are used.
+  const auto defer_function_bodies = m_lazy_imports ||
+    (m_cache != nullptr && m_cache->is_checked(*src_view));
+  auto compiler = create_compiler(contexts, defer_function_bodies);
+  const auto notified_count = m_errors_observer.notified_count();
+  m_importing.emplace_back(src_view->path());
+  auto compiled = compile_script(compiler, *src_view);
+  m_importing.pop_back();
   if (!compiled) {
     // Todo: compilation failed
     return nullptr;
   }
 
-  m_static_variables.initialize_module(compiled->sema_tree());
+  if (m_cache != nullptr && !defer_function_bodies &&
+      m_errors_observer.notified_count() == notified_count) {
+    store_checked_import(*src_view);
+  }
+
+  {
+    const profile_scope profile{ m_profiler, phase::execute,
+                                 src_view->path(),
+                                 "static variables initialization" };
+    m_static_variables.initialize_module(compiled->sema_tree());
+  }
 
   const auto& sema_tree = compiled->sema_tree();
 
   m_sema_trees.emplace(src_view->path(), sema_tree);
   m_compiled_sources.emplace(src_view->path(), std::move(compiled));
 
-  auto exported_stuff = contexts.collect_exported_stuff();
-
-  m_exported_qualified_contextes.emplace(src_view->path(),
-                                         exported_stuff.clone());
-
-  return std::make_unique<sema::qualified_contextes>(
-    std::move(exported_stuff));
+  // Exported stuff is collected once and shared by all importers.
+  const auto [it, inserted] = m_exported_qualified_contextes.emplace(
+    src_view->path(), contexts.collect_exported_stuff());
+  (void)inserted;
+  if (defer_function_bodies) {
+    m_lazily_imported_qualified_contextes.emplace(src_view->path(),
+                                                  std::move(contexts));
+  }
+  return &it->second;
 }
 
 std::optional<decl_sema::declarative_import_handler::result>
@@ -248,17 +323,16 @@ global_executor::handle_declarative_import(cmsl::string_view path)
 
   if (const auto found = m_exported_qualified_contextes.find(import_path);
       found != std::cend(m_exported_qualified_contextes)) {
-    const auto& ctxs = found->second;
-
     const auto found_compiled =
       m_compiled_declarative_sources.find(import_path);
     CMSL_ASSERT(found_compiled != std::cend(m_compiled_declarative_sources));
 
     return decl_sema::declarative_import_handler::result{
-      ctxs.clone(), found_compiled->second->component_declarations()
+      &found->second, &found_compiled->second->component_declarations()
     };
   }
 
+  const profile_scope profile{ m_profiler, "import", "import", import_path };
   const auto src_view = load_source(std::move(import_path));
   if (!src_view) {
     //     Todo: file not found
@@ -268,24 +342,23 @@ global_executor::handle_declarative_import(cmsl::string_view path)
   auto contexts = m_builtin_qualified_contexts.clone();
 
   auto compiler = create_declarative_compiler(contexts);
-  auto compiled = compiler.compile(*src_view);
+  auto compiled = compiler.compile(*src_view, lex_source(*src_view));
   if (!compiled) {
     // Todo: compilation failed
     return std::nullopt;
   }
 
-  auto component_declarations_copy = compiled->component_declarations();
+  const auto& component_declarations = compiled->component_declarations();
 
   m_compiled_declarative_sources.emplace(src_view->path(),
                                          std::move(compiled));
 
-  auto exported_stuff = contexts.collect_exported_stuff();
-
-  m_exported_qualified_contextes.emplace(src_view->path(),
-                                         exported_stuff.clone());
+  const auto [it, inserted] = m_exported_qualified_contextes.emplace(
+    src_view->path(), contexts.collect_exported_stuff());
+  (void)inserted;
 
   return decl_sema::declarative_import_handler::result{
-    std::move(exported_stuff), std::move(component_declarations_copy)
+    &it->second, &component_declarations
   };
 }
 
@@ -313,20 +386,15 @@ void global_executor::raise_unsuccessful_compilation_error(
 
 sema::qualified_contextes global_executor::create_qualified_contextes() const
 {
-  return sema::qualified_contextes{
+  auto contexts = sema::qualified_contextes{
     std::make_unique<sema::enum_values_context_impl>(),
     std::make_unique<sema::functions_context_impl>(),
     std::make_unique<sema::identifiers_context_impl>(),
     std::make_unique<sema::types_context_impl>()
   };
-}
-
-std::unique_ptr<sema::builtin_sema_context>
-global_executor::create_builtin_context()
-{
-  auto refs = sema::qualified_contextes_refs{ m_builtin_qualified_contexts };
-  return std::make_unique<sema::builtin_sema_context>(
-    m_factories, m_errors_observer, *m_builtin_tokens, refs);
+  auto refs = sema::qualified_contextes_refs{ contexts };
+  m_builtin_environment.add_builtins_to(refs, m_errors_observer);
+  return contexts;
 }
 
 std::unique_ptr<decl_sema::builtin_decl_namespace_context>
@@ -334,9 +402,9 @@ global_executor::create_decl_namespace_context()
 {
   auto refs = sema::qualified_contextes_refs{ m_builtin_qualified_contexts };
   return std::make_unique<decl_sema::builtin_decl_namespace_context>(
-    *m_builtin_context, refs, m_factories, *m_builtin_tokens,
-    m_builtin_context->builtin_types(),
-    m_builtin_context->generic_creation_utils());
+    m_builtin_environment.context(), refs, m_factories,
+    m_builtin_environment.tokens(), m_builtin_types,
+    m_generic_creation_utils);
 }
 
 const sema::sema_node& global_executor::get_sema_tree(
@@ -353,46 +421,59 @@ std::string global_executor::build_full_import_path(
 }
 
 source_compiler global_executor::create_compiler(
-  sema::qualified_contextes& ctxs)
+  sema::qualified_contextes& ctxs, bool defer_function_bodies)
 {
   auto refs = sema::qualified_contextes_refs{ ctxs };
+  source_compiler::options opts;
+  opts.profiler = m_profiler;
+  opts.lazy_bodies = m_lazy_bodies.get();
+  opts.defer_function_bodies = defer_function_bodies;
+  opts.dump_optimized = m_dump_optimized;
   return source_compiler{ m_errors_observer,
                           m_factories,
                           *this,
                           *this,
                           *this,
                           refs,
-                          *m_builtin_context,
-                          *m_builtin_tokens,
-                          m_strings_container };
+                          m_builtin_environment.context(),
+                          m_builtin_environment.tokens(),
+                          m_strings_container,
+                          opts };
 }
 
 declarative_source_compiler global_executor::create_declarative_compiler(
   sema::qualified_contextes& ctxs)
 {
   auto refs = sema::qualified_contextes_refs{ ctxs };
-  return declarative_source_compiler{
-    m_errors_observer,  m_strings_container,       m_factories,       refs,
-    *m_builtin_context, *m_decl_namespace_context, *m_builtin_tokens, *this
-  };
+  return declarative_source_compiler{ m_errors_observer,
+                                      m_strings_container,
+                                      m_factories,
+                                      refs,
+                                      m_builtin_environment.context(),
+                                      *m_decl_namespace_context,
+                                      m_builtin_environment.tokens(),
+                                      *this,
+                                      m_profiler };
 }
 
 cmsl::string_view global_executor::store_path(std::string path)
 {
-  auto view = cmsl::string_view{ path };
-  m_paths.emplace_back(std::move(path));
-  return view;
+  return m_paths.emplace_back(std::move(path));
 }
 
 cmsl::string_view global_executor::store_source(std::string source)
 {
-  auto view = cmsl::string_view{ source };
-  m_sources.emplace_back(std::move(source));
-  return view;
+  return m_sources.emplace_back(std::move(source));
 }
 
 std::optional<source_view> global_executor::load_source(std::string path)
 {
+  if (m_prefetcher != nullptr) {
+    if (const auto prefetched = m_prefetcher->take(path)) {
+      return source_view{ prefetched->path, prefetched->source };
+    }
+  }
+
   const auto path_view = store_path(std::move(path));
   std::ifstream file{ path_view.data() };
   if (!file.is_open()) {
@@ -405,6 +486,91 @@ std::optional<source_view> global_executor::load_source(std::string path)
   return source_view{ path_view, source_content_view };
 }
 
+std::string global_executor::current_script_directory() const
+{
+  std::string result = m_cmake_facade.current_directory();
+
+  for (const auto& dir : m_directories) {
+    result += '/' + dir;
+  }
+
+  return result;
+}
+
+void global_executor::store_checked_import(source_view source)
+{
+  std::vector<compilation_cache::import_entry> imports;
+  std::unordered_set<std::string> visited{ std::string{ source.path() } };
+  std::vector<std::string> pending{ std::string{ source.path() } };
+  while (!pending.empty()) {
+    const auto found = m_imports.find(pending.back());
+    pending.pop_back();
+    if (found == std::cend(m_imports)) {
+      continue;
+    }
+
+    for (const auto& import : found->second) {
+      if (!visited.emplace(import).second) {
+        continue;
+      }
+
+      const auto compiled = m_compiled_sources.find(import);
+      if (compiled == std::cend(m_compiled_sources)) {
+        return;
+      }
+
+      const auto import_source = compiled->second->source().source();
+      imports.emplace_back(compilation_cache::import_entry{
+        import, compilation_cache::hash(import_source) });
+      pending.emplace_back(import);
+    }
+  }
+
+  m_cache->store_checked(source, imports);
+}
+
+lexer::token_container_t global_executor::lex_source(source_view source)
+{
+  const profile_scope profile{ m_profiler, phase::lex, source.path() };
+  if (m_prefetcher != nullptr) {
+    const auto prefetched =
+      m_prefetcher->take(std::string{ source.path() });
+    if (prefetched != nullptr &&
+        prefetched->source.data() == source.source().data()) {
+      return prefetched->tokens;
+    }
+  }
+
+  auto& registration = m_source_registrations[source.source().data()];
+  if (registration.id() == source_files::empty_source_id) {
+    registration = source_files::registration{ source };
+  }
+
+  auto tokens = lex(m_errors_observer, source, registration.id(), m_cache);
+  if (m_prefetcher != nullptr) {
+    m_prefetcher->prefetch_referenced(tokens, current_script_directory());
+  }
+
+  return tokens;
+}
+
+std::unique_ptr<compiled_source> global_executor::compile_script(
+  source_compiler& compiler, source_view source)
+{
+  if (m_prefetcher != nullptr) {
+    const auto path = std::string{ source.path() };
+    const auto prefetched = m_prefetcher->take(path);
+    if (prefetched != nullptr &&
+        prefetched->source.data() == source.source().data()) {
+      if (auto ast_tree = m_prefetcher->take_ast(path)) {
+        return compiler.compile(source, std::move(ast_tree));
+      }
+    }
+  }
+
+  return compiler.compile(source, lex_source(source));
+}
+
 bool global_executor::file_exists(const std::string& path) const
 {
   return std::ifstream{ path }.good();
@@ -422,7 +588,7 @@ const compiled_source* global_executor::compile_file(std::string path)
 
   auto contexts = m_builtin_qualified_contexts.clone();
   auto compiler = create_compiler(contexts);
-  auto compiled = compiler.compile(*src_view);
+  auto compiled = compile_script(compiler, *src_view);
   if (!compiled) {
     raise_unsuccessful_compilation_error(src_view->path());
     return nullptr;
@@ -449,10 +615,10 @@ const compiled_source* global_executor::compile_source(std::string source,
   auto compiler = create_compiler(contexts);
 
   const auto source_path_view = store_path(std::move(path));
-  const auto src_view = source_view{ source_path_view, source };
+  const auto src_view =
+    source_view{ source_path_view, store_source(std::move(source)) };
 
-  m_sources.emplace_back(std::move(source));
-  auto compiled = compiler.compile(src_view);
+  auto compiled = compiler.compile(src_view, lex_source(src_view));
   if (!compiled) {
     raise_unsuccessful_compilation_error(source_path_view);
     return nullptr;
@@ -486,7 +652,7 @@ const compiled_declarative_source* global_executor::compile_declarative_file(
 
   auto contexts = m_builtin_qualified_contexts.clone();
   auto compiler = create_declarative_compiler(contexts);
-  auto compiled = compiler.compile(*src_view);
+  auto compiled = compiler.compile(*src_view, lex_source(*src_view));
   if (!compiled) {
     raise_unsuccessful_compilation_error(src_view->path());
     return nullptr;
@@ -506,8 +672,13 @@ std::unique_ptr<inst::instance> global_executor::execute(
 
   const auto translation_unit =
     dynamic_cast<const sema::translation_unit_node*>(&compiled.sema_tree());
-  m_execution->initialize_static_variables(*translation_unit,
-                                           m_static_variables);
+  {
+    const profile_scope profile{ m_profiler, phase::execute,
+                                 compiled.source().path(),
+                                 "static variables initialization" };
+    m_execution->initialize_static_variables(*translation_unit,
+                                             m_static_variables);
+  }
 
   return execute(*compiled.get_main());
 }
@@ -515,8 +686,9 @@ std::unique_ptr<inst::instance> global_executor::execute(
 std::unique_ptr<inst::instance> global_executor::execute(
   const sema::sema_function& function)
 {
+  const profile_scope profile{ m_profiler, phase::execute };
   initialize_execution_if_need();
-  inst::instances_holder instances{ m_builtin_context->builtin_types() };
+  inst::instances_holder instances{ m_builtin_types };
 
   auto main_result = m_execution->call(function, {}, instances);
 
@@ -534,27 +706,16 @@ void global_executor::initialize_execution_if_need()
   }
 
   m_execution = std::make_unique<execution>(
-    m_cmake_facade, m_builtin_context->builtin_types(),
+    m_cmake_facade, m_builtin_types,
     m_decl_namespace_context->types_accessor(), m_static_variables,
-    m_builtin_context->generic_creation_utils(), m_errors_observer);
+    m_generic_creation_utils, m_errors_observer,
+    m_engine, m_profiler, m_script_profiler);
 }
 
 sema::add_declarative_file_semantic_handler::add_declarative_file_result_t
 global_executor::handle_add_declarative_file(cmsl::string_view name)
 {
-  const auto script_path_creator = [this] {
-    std::string result = m_cmake_facade.current_directory();
-
-    std::string separator;
-
-    for (const auto& dir : m_directories) {
-      result += '/' + dir;
-    }
-
-    return result;
-  };
-
-  auto full_path = script_path_creator() + "/" + std::string{ name };
+  auto full_path = current_script_directory() + "/" + std::string{ name };
   if (!file_exists(full_path)) {
 
     return add_declarative_file_semantic_handler::no_script_found{};
@@ -562,7 +723,7 @@ global_executor::handle_add_declarative_file(cmsl::string_view name)
 
   const auto compiled = compile_declarative_file(std::move(full_path));
   if (!compiled) {
-    raise_unsuccessful_compilation_error(script_path_creator());
+    raise_unsuccessful_compilation_error(current_script_directory());
     return add_declarative_file_semantic_handler::compilation_failed{};
   }
 
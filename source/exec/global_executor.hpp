@@ -5,15 +5,21 @@
 #include "errors/errors_observer.hpp"
 #include "exec/builtin_identifiers_observer.hpp"
 #include "exec/cross_translation_unit_static_variables.hpp"
+#include "exec/execution_engine.hpp"
 #include "exec/module_sema_tree_provider.hpp"
+#include "lexer/token.hpp"
 #include "sema/add_declarative_file_semantic_handler.hpp"
 #include "sema/add_subdirectory_semantic_handler.hpp"
+#include "sema/builtin_types_accessor.hpp"
 #include "sema/factories.hpp"
 #include "sema/factories_provider.hpp"
+#include "sema/generic_type_creation_utils.hpp"
 #include "sema/import_handler.hpp"
 #include "sema/qualified_contextes.hpp"
 
+#include <deque>
 #include <memory>
+#include <ostream>
 #include <vector>
 
 namespace cmsl {
@@ -26,15 +32,21 @@ class cmake_facade;
 }
 
 namespace sema {
-class builtin_sema_context;
+class builtin_sema_environment;
+class lazy_function_bodies;
 }
 
 namespace exec {
+class buffered_cmake_facade;
+class compilation_cache;
 class compiled_declarative_source;
 class compiled_source;
 class declarative_source_compiler;
 class execution;
+class profiler;
+class script_profiler;
 class source_compiler;
+class source_prefetcher;
 
 class global_executor
   : public sema::add_subdirectory_semantic_handler
@@ -44,14 +56,51 @@ class global_executor
   , public module_sema_tree_provider
 {
 public:
+  struct options
+  {
+    execution_engine engine{ execution_engine::tree_walker };
+    // Caches tokens of sources and whether imported modules compile without
+    // errors. Bodies of functions of such modules are built when they are
+    // used for the first time, like with lazy_imports. Null if caching is
+    // disabled.
+    compilation_cache* cache{ nullptr };
+    // Number of threads prefetching scripts of subdirectories and imports.
+    // Zero disables prefetching.
+    unsigned prefetch_threads{ 0u };
+    // If true, project and target operations are passed to the facade in
+    // batches, see buffered_cmake_facade.
+    bool batch_facade_calls{ false };
+    // Records nested scopes of compilation phases, imports and function
+    // calls. Null if profiling is disabled.
+    exec::profiler* profiler{ nullptr };
+    // Collects statistics of user functions and their lines. Null if user
+    // functions are not profiled.
+    exec::script_profiler* script_profiler{ nullptr };
+    // If true, bodies of functions of imported modules are built when they
+    // are used for the first time, see sema::lazy_function_bodies.
+    bool lazy_imports{ false };
+    // Sema trees of compiled sources are dumped to the stream right after
+    // constant folding, before they are executed. See
+    // source_compiler::options. Null if trees are not dumped.
+    std::ostream* dump_optimized{ nullptr };
+  };
+
   explicit global_executor(const std::string& root_path,
                            facade::cmake_facade& cmake_facade,
                            errors::errors_observer& errors_observer);
+  explicit global_executor(const std::string& root_path,
+                           facade::cmake_facade& cmake_facade,
+                           errors::errors_observer& errors_observer,
+                           const options& opts);
   ~global_executor();
 
   int execute(std::string source);
   int execute_based_on_root_path();
 
+  // Builds bodies of lazily imported functions, that have not been used, to
+  // report their errors. Returns false if any of the bodies is not valid.
+  bool build_all_function_bodies();
+
   add_subdirectory_result_t handle_add_subdirectory(
     cmsl::string_view name,
     const std::vector<std::unique_ptr<sema::expression_node>>& params)
@@ -60,7 +109,7 @@ public:
   add_declarative_file_result_t handle_add_declarative_file(
     cmsl::string_view name) override;
 
-  std::unique_ptr<sema::qualified_contextes> handle_import(
+  const sema::qualified_contextes* handle_import(
     cmsl::string_view path) override;
 
   std::optional<decl_sema::declarative_import_handler::result>
@@ -74,21 +123,32 @@ private:
   void raise_unsuccessful_compilation_error(const cmsl::string_view& path);
 
   sema::qualified_contextes create_qualified_contextes() const;
-  std::unique_ptr<sema::builtin_sema_context> create_builtin_context();
   std::unique_ptr<decl_sema::builtin_decl_namespace_context>
   create_decl_namespace_context();
 
   std::string build_full_import_path(cmsl::string_view import_path) const;
 
-  source_compiler create_compiler(sema::qualified_contextes& ctxs);
+  source_compiler create_compiler(sema::qualified_contextes& ctxs,
+                                  bool defer_function_bodies = false);
   declarative_source_compiler create_declarative_compiler(
     sema::qualified_contextes& ctxs);
 
   std::optional<source_view> load_source(std::string path);
+  // Stores in the cache that the imported module compiles without
+  // diagnostics, with hashes of its imports. Does nothing if any of the
+  // imports is not compiled.
+  void store_checked_import(source_view source);
   cmsl::string_view store_source(std::string path);
   cmsl::string_view store_path(std::string path);
 
   bool file_exists(const std::string& path) const;
+  std::string current_script_directory() const;
+
+  // Returns prefetched tokens or lexes the source.
+  lexer::token_container_t lex_source(source_view source);
+  // Takes the tree parsed by the prefetcher, if there is one.
+  std::unique_ptr<compiled_source> compile_script(source_compiler& compiler,
+                                                  source_view source);
 
   const compiled_source* compile_file(std::string path);
   const compiled_declarative_source* compile_declarative_file(
@@ -112,26 +172,65 @@ private:
     facade::cmake_facade& m_cmake_facade;
   };
 
+  // Applies operations recorded during execution, when it ends.
+  class commands_flush_guard
+  {
+  public:
+    explicit commands_flush_guard(buffered_cmake_facade* buffered_facade);
+    ~commands_flush_guard();
+
+  private:
+    buffered_cmake_facade* m_buffered_facade;
+  };
+
   std::string m_root_path;
+  // Null if facade calls are not batched.
+  std::unique_ptr<buffered_cmake_facade> m_buffered_facade;
+  // Buffered facade, if calls are batched.
   facade::cmake_facade& m_cmake_facade;
   errors::errors_observer& m_errors_observer;
+  const execution_engine m_engine;
+  // Null if caching is disabled.
+  compilation_cache* m_cache;
+  // Null if profiling is disabled.
+  profiler* m_profiler;
+  // Null if user functions are not profiled.
+  script_profiler* m_script_profiler;
+  // Null if sema trees are not dumped.
+  std::ostream* m_dump_optimized;
+  // Null if prefetching is disabled. Sources of compiled translation units
+  // may be owned by the prefetcher, so it is declared before them.
+  std::unique_ptr<source_prefetcher> m_prefetcher;
   strings_container_impl m_strings_container;
-  // Contextes are going to be initialized with builtin stuff at builtin
-  // context creation.
+  const bool m_lazy_imports;
+  // Null if bodies of imported functions are built eagerly.
+  std::unique_ptr<sema::lazy_function_bodies> m_lazy_bodies;
+  // Shared by all executors in the process.
+  const sema::builtin_sema_environment& m_builtin_environment;
+  // Contextes look builtin stuff up in the environment. Declarative builtin
+  // stuff is added to them at decl namespace context creation.
   sema::qualified_contextes m_builtin_qualified_contexts;
   builtin_identifiers_observer m_builtin_identifiers_observer;
 
   sema::factories_provider m_factories;
 
-  std::unique_ptr<sema::builtin_token_provider> m_builtin_tokens;
-  std::unique_ptr<sema::builtin_sema_context> m_builtin_context;
+  const sema::builtin_types_accessor m_builtin_types;
+  // Generic types that are not builtin, are created in this context, so the
+  // shared environment is not modified.
+  sema::sema_context& m_generic_types_context;
+  sema::generic_type_creation_utils m_generic_creation_utils;
+
   std::unique_ptr<decl_sema::builtin_decl_namespace_context>
     m_decl_namespace_context;
 
   cross_translation_unit_static_variables m_static_variables;
 
-  std::vector<std::string> m_sources;
-  std::vector<std::string> m_paths;
+  // Deques, so stored strings are never moved.
+  std::deque<std::string> m_sources;
+  std::deque<std::string> m_paths;
+  // Registrations of the stored sources, by their texts.
+  std::unordered_map<const char*, source_files::registration>
+    m_source_registrations;
   std::unordered_map<cmsl::string_view, std::unique_ptr<compiled_source>>
     m_compiled_sources;
   std::unordered_map<cmsl::string_view,
@@ -143,6 +242,15 @@ private:
 
   std::unordered_map<cmsl::string_view, sema::qualified_contextes>
     m_exported_qualified_contextes;
+  // Contextes of lazily imported modules, that their deferred function bodies
+  // are built in.
+  std::unordered_map<cmsl::string_view, sema::qualified_contextes>
+    m_lazily_imported_qualified_contextes;
+
+  // Imports of every imported module, by full paths.
+  std::unordered_map<std::string, std::vector<std::string>> m_imports;
+  // Imported modules that are being compiled, the innermost last.
+  std::vector<std::string> m_importing;
 
   std::unique_ptr<execution> m_execution;
   std::vector<std::string> m_directories;
@@ -12,6 +12,8 @@ class identifiers_context
 public:
   virtual ~identifiers_context() = default;
   virtual inst::instance* lookup_identifier(unsigned index) = 0;
+  // Local variable or parameter of the currently executed function.
+  virtual inst::instance* lookup_local_variable(unsigned slot) = 0;
   virtual inst::instance* get_class_instance() = 0;
 };
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common/string.hpp"
+#include "exec/instance/instance_allocator.hpp"
 #include "exec/instance/instance_value_accessor.hpp"
 #include "exec/instance/instance_value_variant.hpp"
 #include "sema/function_lookup_result.hpp"
@@ -30,6 +31,16 @@ public:
 
   virtual ~instance() = default;
 
+  static void* operator new(std::size_t size)
+  {
+    return instance_allocator::allocate(size);
+  }
+
+  static void operator delete(void* ptr, std::size_t size)
+  {
+    instance_allocator::deallocate(ptr, size);
+  }
+
   virtual std::unique_ptr<instance> copy() const = 0;
 
   virtual instance_value_variant value() const = 0;
@@ -0,0 +1,94 @@
+#include "exec/instance/instance_allocator.hpp"
+
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace cmsl::exec::inst {
+namespace {
+constexpr auto slot_granularity = alignof(std::max_align_t);
+constexpr auto max_arena_allocation = std::size_t{ 256u };
+constexpr auto size_classes_count = max_arena_allocation / slot_granularity;
+constexpr auto block_size = std::size_t{ 16u * 1024u };
+
+struct free_slot
+{
+  free_slot* next;
+};
+
+// All thread locals are trivially destructible, so they can be safely used
+// during destruction of other thread locals and statics.
+thread_local free_slot* t_free_slots[size_classes_count] = {};
+thread_local char* t_block_current = nullptr;
+thread_local char* t_block_end = nullptr;
+thread_local allocation_stats t_stats;
+
+std::size_t size_class(std::size_t size)
+{
+  return (size + slot_granularity - 1u) / slot_granularity - 1u;
+}
+
+void register_block(char* block)
+{
+  // Blocks are intentionally never freed. Instances can be destroyed as late
+  // as during destruction of statics.
+  static std::mutex blocks_mutex;
+  static auto blocks = new std::vector<char*>;
+  std::lock_guard<std::mutex> lock{ blocks_mutex };
+  blocks->emplace_back(block);
+}
+}
+
+void* instance_allocator::allocate(std::size_t size)
+{
+  ++t_stats.instances_allocated;
+
+  if (size > max_arena_allocation) {
+    ++t_stats.heap_allocations;
+    return ::operator new(size);
+  }
+
+  const auto cls = size_class(size);
+  if (auto slot = t_free_slots[cls]) {
+    t_free_slots[cls] = slot->next;
+    return slot;
+  }
+
+  const auto slot_size = (cls + 1u) * slot_granularity;
+  if (t_block_current == nullptr ||
+      static_cast<std::size_t>(t_block_end - t_block_current) < slot_size) {
+    ++t_stats.heap_allocations;
+    t_block_current = static_cast<char*>(::operator new(block_size));
+    t_block_end = t_block_current + block_size;
+    register_block(t_block_current);
+  }
+
+  auto ptr = t_block_current;
+  t_block_current += slot_size;
+  return ptr;
+}
+
+void instance_allocator::deallocate(void* ptr, std::size_t size)
+{
+  if (ptr == nullptr) {
+    return;
+  }
+
+  ++t_stats.instances_freed;
+
+  if (size > max_arena_allocation) {
+    ::operator delete(ptr);
+    return;
+  }
+
+  const auto cls = size_class(size);
+  auto slot = static_cast<free_slot*>(ptr);
+  slot->next = t_free_slots[cls];
+  t_free_slots[cls] = slot;
+}
+
+allocation_stats& instance_allocator::stats()
+{
+  return t_stats;
+}
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+
+namespace cmsl::exec::inst {
+// Allocation counters of the current thread.
+struct allocation_stats
+{
+  std::size_t instances_allocated{ 0u };
+  std::size_t instances_freed{ 0u };
+  // Arena blocks and instances too big for the arena.
+  std::size_t heap_allocations{ 0u };
+  // Number of destroyed instances holders.
+  std::size_t full_expressions{ 0u };
+};
+
+// Allocates memory for instances. Instances are placed in arena blocks and
+// freed memory is kept in per-size free lists, so temporaries of a full
+// expression reuse memory of temporaries of the previous full expressions
+// instead of going to the heap. Instances that outlive their full expression
+// (see instances_holder::gather_ownership) stay where they are.
+// Arena blocks are never released. An instance can be freed on any thread.
+class instance_allocator
+{
+public:
+  static void* allocate(std::size_t size);
+  static void deallocate(void* ptr, std::size_t size);
+
+  static allocation_stats& stats();
+};
+}
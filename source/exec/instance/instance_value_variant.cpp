@@ -31,12 +31,17 @@ instance_value_variant::instance_value_variant(enum_constant_value val)
 
 // Prevent conversion from const char* to bool.
 instance_value_variant::instance_value_variant(const char* value)
-  : instance_value_variant{ std::string{ value } }
+  : instance_value_variant{ string_value{ value } }
 {
 }
 
 instance_value_variant::instance_value_variant(std::string val)
-  : m_value{ val }
+  : instance_value_variant{ string_value{ std::move(val) } }
+{
+}
+
+instance_value_variant::instance_value_variant(string_value val)
+  : m_value{ std::move(val) }
 {
 }
 
@@ -51,7 +56,7 @@ instance_value_variant::instance_value_variant(extern_value val)
 }
 
 instance_value_variant::instance_value_variant(list_value val)
-  : m_value{ val }
+  : m_value{ std::move(val) }
 {
 }
 
@@ -120,17 +125,17 @@ void instance_value_variant::set_enum_constant(enum_constant_value value)
   m_value = value;
 }
 
-const std::string& instance_value_variant::get_string_cref() const
+const string_value& instance_value_variant::get_string_cref() const
 {
-  return std::get<std::string>(m_value);
+  return std::get<string_value>(m_value);
 }
 
-std::string& instance_value_variant::get_string_ref()
+string_value& instance_value_variant::get_string_ref()
 {
-  return std::get<std::string>(m_value);
+  return std::get<string_value>(m_value);
 }
 
-void instance_value_variant::set_string(std::string value)
+void instance_value_variant::set_string(string_value value)
 {
   m_value = std::move(value);
 }
@@ -7,6 +7,7 @@
 #include "exec/instance/list_value.hpp"
 #include "exec/instance/option_value.hpp"
 #include "exec/instance/project_value.hpp"
+#include "exec/instance/string_value.hpp"
 #include "exec/instance/target_value.hpp"
 #include "exec/instance/version_value.hpp"
 
@@ -21,7 +22,7 @@ class instance_value_variant
 {
 private:
   using value_t =
-    std::variant<bool, int_t, double, enum_constant_value, std::string,
+    std::variant<bool, int_t, double, enum_constant_value, string_value,
                  version_value, extern_value, list_value, project_value,
                  library_value, executable_value, option_value>;
 
@@ -42,6 +43,7 @@ public:
   // Prevent conversion from const char* to bool.
   instance_value_variant(const char* value);
   instance_value_variant(std::string val);
+  instance_value_variant(string_value val);
   instance_value_variant(version_value val);
   instance_value_variant(extern_value val);
   instance_value_variant(list_value val);
@@ -64,9 +66,9 @@ public:
   enum_constant_value get_enum_constant() const;
   void set_enum_constant(enum_constant_value value);
 
-  const std::string& get_string_cref() const;
-  std::string& get_string_ref();
-  void set_string(std::string value);
+  const string_value& get_string_cref() const;
+  string_value& get_string_ref();
+  void set_string(string_value value);
 
   const version_value& get_version_cref() const;
   version_value& get_version_ref();
@@ -1,5 +1,6 @@
 #include "instances_holder.hpp"
 #include "exec/instance/instance.hpp"
+#include "exec/instance/instance_allocator.hpp"
 #include "instance_factory.hpp"
 
 #include "common/assert.hpp"
@@ -12,6 +13,11 @@ instances_holder::instances_holder(sema::builtin_types_accessor builtin_types)
 {
 }
 
+instances_holder::~instances_holder()
+{
+  ++instance_allocator::stats().full_expressions;
+}
+
 std::unique_ptr<instance> instances_holder::gather_ownership(
   inst::instance* instance_ptr)
 {
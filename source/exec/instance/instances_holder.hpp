@@ -24,6 +24,10 @@ class instances_holder : public instances_holder_interface
 {
 public:
   explicit instances_holder(sema::builtin_types_accessor builtin_types);
+  ~instances_holder() override;
+
+  instances_holder(instances_holder&&) = default;
+  instances_holder& operator=(instances_holder&&) = default;
 
   void store(std::unique_ptr<instance> i) override;
 
@@ -1,11 +1,67 @@
 #include "exec/instance/list_value.hpp"
 
+#include "common/assert.hpp"
 #include "exec/instance/instance.hpp"
-#include "list_value.hpp"
+#include "exec/instance/simple_unnamed_instance.hpp"
 
 #include <algorithm>
+#include <functional>
 
 namespace cmsl::exec::inst {
+namespace {
+using which_t = instance_value_variant::which_t;
+
+template <typename Elements>
+constexpr bool stores_instances_v =
+  std::is_same_v<Elements, std::deque<std::unique_ptr<instance>>>;
+
+// Returns value of an element, that can be compared with values of other
+// elements of the same list.
+const instance_value_variant& element_value(
+  const std::unique_ptr<instance>& element)
+{
+  return element->value_cref();
+}
+
+template <typename T>
+const T& element_value(const T& value)
+{
+  return value;
+}
+
+template <typename T>
+bool holds(const instance_value_variant& value)
+{
+  if constexpr (std::is_same_v<T, bool>) {
+    return value.which() == which_t::bool_;
+  } else if constexpr (std::is_same_v<T, int_t>) {
+    return value.which() == which_t::int_;
+  } else if constexpr (std::is_same_v<T, double>) {
+    return value.which() == which_t::double_;
+  } else {
+    return value.which() == which_t::string;
+  }
+}
+
+template <typename T>
+decltype(auto) typed_value(const instance_value_variant& value)
+{
+  if constexpr (std::is_same_v<T, bool>) {
+    return value.get_bool();
+  } else if constexpr (std::is_same_v<T, int_t>) {
+    return value.get_int();
+  } else if constexpr (std::is_same_v<T, double>) {
+    return value.get_double();
+  } else {
+    return value.get_string_cref();
+  }
+}
+
+const auto element_less = [](const auto& lhs, const auto& rhs) {
+  return element_value(lhs) < element_value(rhs);
+};
+}
+
 list_value& list_value::operator=(list_value&&) = default;
 list_value::list_value(list_value&&) = default;
 
@@ -14,13 +70,29 @@ list_value::~list_value()
 }
 
 list_value::list_value(container_t values)
-  : m_list{ std::move(values) }
+  : m_storage{ std::move(values) }
 {
 }
 
 list_value::list_value(const list_value& other)
 {
-  append_with_copy(other);
+  if (other.holds_values()) {
+    std::visit(
+      [this](const auto& elements) {
+        using elements_t = std::decay_t<decltype(elements)>;
+        if constexpr (!stores_instances_v<elements_t>) {
+          m_storage.emplace<elements_t>(elements);
+        }
+      },
+      other.m_storage);
+    m_element_type = other.m_element_type;
+    return;
+  }
+
+  // Elements of the copy are not referenced, so they can be stored as values.
+  for (const auto& element : std::get<container_t>(other.m_storage)) {
+    insert_copy(size(), *element);
+  }
 }
 
 list_value& list_value::operator=(const list_value& other)
@@ -29,20 +101,35 @@ list_value& list_value::operator=(const list_value& other)
     return *this;
   }
 
-  m_list.clear();
-  append_with_copy(other);
+  auto copied = other;
+  *this = std::move(copied);
 
   return *this;
 }
 
-bool list_value::operator==(const list_value& other) const
+template <typename Compare>
+bool list_value::compare(const list_value& other, Compare&& cmp) const
 {
-  const auto pred = [](const auto& lhs_instance, const auto& rhs_instance) {
-    return lhs_instance->value_cref() == rhs_instance->value_cref();
+  // Vectors of the same value type are compared directly.
+  if (holds_values() && m_storage.index() == other.m_storage.index()) {
+    return cmp(m_storage, other.m_storage);
+  }
+
+  const auto values = [](const list_value& list) {
+    std::vector<instance_value_variant> result;
+    result.reserve(list.size());
+    for (auto i = 0; i < list.size(); ++i) {
+      result.emplace_back(list.value_at(i));
+    }
+    return result;
   };
 
-  return std::equal(std::cbegin(m_list), std::cend(m_list),
-                    std::cbegin(other.m_list), std::cend(other.m_list), pred);
+  return cmp(values(*this), values(other));
+}
+
+bool list_value::operator==(const list_value& other) const
+{
+  return compare(other, std::equal_to<>{});
 }
 
 bool list_value::operator!=(const list_value& other) const
@@ -52,12 +139,7 @@ bool list_value::operator!=(const list_value& other) const
 
 bool list_value::operator<(const list_value& other) const
 {
-  const auto pred = [](const auto& lhs_instance, const auto& rhs_instance) {
-    return lhs_instance->value_cref() < rhs_instance->value_cref();
-  };
-
-  return std::lexicographical_compare(cbegin(), cend(), other.cbegin(),
-                                      other.cend(), pred);
+  return compare(other, std::less<>{});
 }
 
 bool list_value::operator<=(const list_value& other) const
@@ -75,103 +157,245 @@ bool list_value::operator>=(const list_value& other) const
   return *this == other || *this > other;
 }
 
-void list_value::append_with_copy(const list_value& other)
+bool list_value::holds_values() const
 {
-  append_with_copy_to(other, m_list);
+  return !std::holds_alternative<container_t>(m_storage);
 }
 
-void list_value::append_with_copy_to(const list_value& other,
-                                     container_t& container) const
+bool list_value::store_as_value(const instance& value)
 {
-  std::transform(std::cbegin(other.m_list), std::cend(other.m_list),
-                 std::back_inserter(container),
-                 [](const auto& element) { return element->copy(); });
+  // Only values can be stored, not references or instances of classes.
+  const auto is_value =
+    dynamic_cast<const simple_unnamed_instance*>(&value) != nullptr;
+
+  if (holds_values()) {
+    if (is_value && &value.type() == m_element_type) {
+      return true;
+    }
+
+    store_instances();
+    return false;
+  }
+
+  // Instances of a list that is not empty can be referenced.
+  if (!is_value || !std::get<container_t>(m_storage).empty()) {
+    return false;
+  }
+
+  switch (value.value_cref().which()) {
+    case which_t::bool_:
+      m_storage.emplace<std::vector<bool>>();
+      break;
+    case which_t::int_:
+      m_storage.emplace<std::vector<int_t>>();
+      break;
+    case which_t::double_:
+      m_storage.emplace<std::vector<double>>();
+      break;
+    case which_t::string:
+      m_storage.emplace<std::vector<string_value>>();
+      break;
+    default:
+      return false;
+  }
+
+  m_element_type = &value.type();
+  return true;
+}
+
+void list_value::store_instances()
+{
+  if (!holds_values()) {
+    return;
+  }
+
+  container_t instances;
+  std::visit(
+    [this, &instances](const auto& elements) {
+      using elements_t = std::decay_t<decltype(elements)>;
+      if constexpr (!stores_instances_v<elements_t>) {
+        for (const auto& value : elements) {
+          instances.emplace_back(std::make_unique<simple_unnamed_instance>(
+            *m_element_type, instance_value_variant{ value }));
+        }
+      }
+    },
+    m_storage);
+
+  m_storage = std::move(instances);
+  m_element_type = nullptr;
 }
 
 void list_value::push_back(list_value::element_t element)
 {
-  m_list.emplace_back(std::move(element));
+  insert(size(), std::move(element));
+}
+
+void list_value::push_back(const instance& value)
+{
+  insert_copy(size(), value);
 }
 
 void list_value::push_back(const list_value& other)
 {
-  append_with_copy(other);
+  insert(size(), other);
 }
 
 void list_value::push_front(element_t element)
 {
-  m_list.emplace(std::begin(m_list), std::move(element));
+  insert(0, std::move(element));
 }
 
 void list_value::push_front(const list_value& other)
 {
-  auto copied = copy(other);
-  m_list.insert(std::begin(m_list),
-                std::make_move_iterator(std::begin(copied)),
-                std::make_move_iterator(std::end(copied)));
+  insert(0, other);
 }
 
 void list_value::pop_back()
 {
-  m_list.pop_back();
+  std::visit([](auto& elements) { elements.pop_back(); }, m_storage);
 }
 
 void list_value::pop_front()
 {
-  m_list.pop_front();
+  std::visit([](auto& elements) { elements.erase(std::begin(elements)); },
+             m_storage);
 }
 
 instance& list_value::at(int_t index)
 {
-  auto& instance_ptr = m_list.at(static_cast<unsigned>(index));
-  return *instance_ptr;
-}
-
-const instance& list_value::at(int_t index) const
-{
-  auto& instance_ptr = m_list.at(static_cast<unsigned>(index));
+  store_instances();
+  auto& instances = std::get<container_t>(m_storage);
+  auto& instance_ptr = instances.at(static_cast<unsigned>(index));
   return *instance_ptr;
 }
 
 instance& list_value::front()
 {
-  auto& instance_ptr = m_list.front();
+  store_instances();
+  auto& instance_ptr = std::get<container_t>(m_storage).front();
   return *instance_ptr;
 }
 
 instance& list_value::back()
 {
-  auto& instance_ptr = m_list.back();
+  store_instances();
+  auto& instance_ptr = std::get<container_t>(m_storage).back();
   return *instance_ptr;
 }
 
+instance_value_variant list_value::value_at(int_t index) const
+{
+  return std::visit(
+    [index](const auto& elements) -> instance_value_variant {
+      using elements_t = std::decay_t<decltype(elements)>;
+      const auto& element = elements.at(static_cast<unsigned>(index));
+      if constexpr (stores_instances_v<elements_t>) {
+        return element->value();
+      } else {
+        return instance_value_variant{ element };
+      }
+    },
+    m_storage);
+}
+
+cmsl::string_view list_value::string_view_at(int_t index) const
+{
+  return std::visit(
+    [index](const auto& elements) -> cmsl::string_view {
+      using elements_t = std::decay_t<decltype(elements)>;
+      if constexpr (stores_instances_v<elements_t>) {
+        const auto& element = elements.at(static_cast<unsigned>(index));
+        return element->value_cref().get_string_cref().view();
+      } else if constexpr (std::is_same_v<elements_t,
+                                          std::vector<string_value>>) {
+        return elements.at(static_cast<unsigned>(index)).view();
+      } else {
+        CMSL_UNREACHABLE("List doesn't store strings");
+        return {};
+      }
+    },
+    m_storage);
+}
+
 void list_value::insert(int_t pos, element_t element)
 {
-  const auto where = place(pos);
-  m_list.emplace(where, std::move(element));
+  if (store_as_value(*element)) {
+    insert_value(pos, element->value_cref());
+    return;
+  }
+
+  auto& instances = std::get<container_t>(m_storage);
+  instances.emplace(std::next(std::begin(instances), pos),
+                    std::move(element));
 }
 
 void list_value::insert(int_t pos, const list_value& other)
 {
-  auto copied = copy(other);
-  const auto where = place(pos);
-  m_list.insert(where, std::make_move_iterator(std::begin(copied)),
-                std::make_move_iterator(std::end(copied)));
+  auto copied = other;
+
+  if (empty()) {
+    *this = std::move(copied);
+    return;
+  }
+
+  if (holds_values() && m_storage.index() == copied.m_storage.index() &&
+      m_element_type == copied.m_element_type) {
+    std::visit(
+      [pos, &copied](auto& elements) {
+        using elements_t = std::decay_t<decltype(elements)>;
+        auto& copied_elements = std::get<elements_t>(copied.m_storage);
+        elements.insert(std::next(std::begin(elements), pos),
+                        std::make_move_iterator(std::begin(copied_elements)),
+                        std::make_move_iterator(std::end(copied_elements)));
+      },
+      m_storage);
+    return;
+  }
+
+  store_instances();
+  copied.store_instances();
+  auto& instances = std::get<container_t>(m_storage);
+  auto& copied_instances = std::get<container_t>(copied.m_storage);
+  instances.insert(std::next(std::begin(instances), pos),
+                   std::make_move_iterator(std::begin(copied_instances)),
+                   std::make_move_iterator(std::end(copied_instances)));
 }
 
-list_value::container_t list_value::copy(const list_value& other) const
+void list_value::insert_copy(int_t pos, const instance& value)
 {
-  container_t copied;
-  append_with_copy_to(other, copied);
-  return copied;
+  if (store_as_value(value)) {
+    insert_value(pos, value.value_cref());
+    return;
+  }
+
+  auto& instances = std::get<container_t>(m_storage);
+  instances.emplace(std::next(std::begin(instances), pos), value.copy());
+}
+
+void list_value::insert_value(int_t pos, const instance_value_variant& value)
+{
+  std::visit(
+    [pos, &value](auto& elements) {
+      using elements_t = std::decay_t<decltype(elements)>;
+      if constexpr (!stores_instances_v<elements_t>) {
+        using value_t = typename elements_t::value_type;
+        elements.insert(std::next(std::begin(elements), pos),
+                        typed_value<value_t>(value));
+      }
+    },
+    m_storage);
 }
 
 void list_value::erase(int_t pos, int_t count)
 {
   count = interpret_special_value(count, 1);
-  const auto where = place(pos);
-  const auto end = place(pos + count);
-  m_list.erase(where, end);
+  std::visit(
+    [pos, count](auto& elements) {
+      const auto where = std::next(std::begin(elements), pos);
+      elements.erase(where, std::next(where, count));
+    },
+    m_storage);
 }
 
 int_t list_value::interpret_special_value(int_t value,
@@ -180,9 +404,21 @@ int_t list_value::interpret_special_value(int_t value,
   return value == k_special_value ? special_value : value;
 }
 
-list_value::container_t::const_iterator list_value::place(int_t pos) const
+bool list_value::element_equals(int_t index,
+                                const instance_value_variant& value) const
 {
-  return std::next(cbegin(), pos);
+  return std::visit(
+    [index, &value](const auto& elements) {
+      using elements_t = std::decay_t<decltype(elements)>;
+      if constexpr (stores_instances_v<elements_t>) {
+        return elements[index]->value_cref() == value;
+      } else {
+        using value_t = typename elements_t::value_type;
+        return holds<value_t>(value) &&
+          elements[index] == typed_value<value_t>(value);
+      }
+    },
+    m_storage);
 }
 
 int_t list_value::remove(const instance& value, int_t count)
@@ -192,9 +428,8 @@ int_t list_value::remove(const instance& value, int_t count)
 
 int_t list_value::remove_last(const instance& value, int_t count)
 {
-  return remove_impl(value, count, [&list = m_list](const auto i) {
-    return list.size() - 1 - i;
-  });
+  return remove_impl(value, count,
+                     [this](const auto i) { return size() - 1 - i; });
 }
 
 template <typename IndexCalculator>
@@ -202,11 +437,12 @@ int_t list_value::remove_impl(const instance& value, int_t count,
                               IndexCalculator&& indexCalculator)
 {
   int_t erased_counter{ 0 };
-  count = interpret_special_value(count, m_list.size());
-  auto i{ 0u };
-  while (i < m_list.size() && count != 0) {
+  count = interpret_special_value(count, size());
+  const auto& removed_value = value.value_cref();
+  auto i{ 0 };
+  while (i < size() && count != 0) {
     const auto check_index = indexCalculator(i);
-    if (m_list[check_index]->value_cref() != value.value_cref()) {
+    if (!element_equals(check_index, removed_value)) {
       ++i;
       continue;
     }
@@ -221,113 +457,150 @@ int_t list_value::remove_impl(const instance& value, int_t count,
 
 void list_value::clear()
 {
-  m_list.clear();
+  m_storage = container_t{};
+  m_element_type = nullptr;
 }
 
 void list_value::resize(int_t new_size, const instance* fill)
 {
   const auto old_size = size();
-  m_list.resize(static_cast<unsigned>(new_size));
+  if (new_size <= old_size) {
+    erase(new_size, old_size - new_size);
+    return;
+  }
 
-  if (old_size < new_size) {
-    std::generate(std::next(begin(), old_size), end(),
-                  [fill] { return fill->copy(); });
+  if (store_as_value(*fill)) {
+    std::visit(
+      [new_size, fill](auto& elements) {
+        using elements_t = std::decay_t<decltype(elements)>;
+        if constexpr (!stores_instances_v<elements_t>) {
+          using value_t = typename elements_t::value_type;
+          elements.resize(static_cast<unsigned>(new_size),
+                          typed_value<value_t>(fill->value_cref()));
+        }
+      },
+      m_storage);
+    return;
   }
+
+  auto& instances = std::get<container_t>(m_storage);
+  std::generate_n(std::back_inserter(instances), new_size - old_size,
+                  [fill] { return fill->copy(); });
 }
 
 void list_value::sort()
 {
-  const auto pred = [](const auto& lhs, const auto& rhs) {
-    return lhs->value_cref() < rhs->value_cref();
-  };
-
-  std::sort(begin(), end(), pred);
+  std::visit(
+    [](auto& elements) {
+      std::sort(std::begin(elements), std::end(elements), element_less);
+    },
+    m_storage);
 }
 
 void list_value::reverse()
 {
-  std::reverse(begin(), end());
+  std::visit(
+    [](auto& elements) {
+      std::reverse(std::begin(elements), std::end(elements));
+    },
+    m_storage);
 }
 
 int_t list_value::min() const
 {
-  const auto pred = [](const auto& lhs, const auto& rhs) {
-    return lhs->value_cref() < rhs->value_cref();
-  };
-  const auto min_it = std::min_element(cbegin(), cend(), pred);
-  if (min_it == cend()) {
-    return -1;
-  }
+  return std::visit(
+    [](const auto& elements) -> int_t {
+      const auto min_it = std::min_element(
+        std::cbegin(elements), std::cend(elements), element_less);
+      if (min_it == std::cend(elements)) {
+        return -1;
+      }
 
-  const auto index = std::distance(cbegin(), min_it);
-  return static_cast<int_t>(index);
+      return std::distance(std::cbegin(elements), min_it);
+    },
+    m_storage);
 }
 
 int_t list_value::max() const
 {
-  const auto pred = [](const auto& lhs, const auto& rhs) {
-    return lhs->value_cref() < rhs->value_cref();
-  };
-  const auto max_it = std::max_element(cbegin(), cend(), pred);
-  if (max_it == cend()) {
-    return -1;
-  }
-
-  const auto index = std::distance(cbegin(), max_it);
-  return static_cast<int_t>(index);
-}
-
-list_value::container_t::iterator list_value::begin()
-{
-  return std::begin(m_list);
-}
-
-list_value::container_t::iterator list_value::end()
-{
-  return std::end(m_list);
-}
+  return std::visit(
+    [](const auto& elements) -> int_t {
+      const auto max_it = std::max_element(
+        std::cbegin(elements), std::cend(elements), element_less);
+      if (max_it == std::cend(elements)) {
+        return -1;
+      }
 
-list_value::container_t::const_iterator list_value::cbegin() const
-{
-  return std::cbegin(m_list);
-}
-
-list_value::container_t::const_iterator list_value::cend() const
-{
-  return std::cend(m_list);
+      return std::distance(std::cbegin(elements), max_it);
+    },
+    m_storage);
 }
 
 list_value list_value::sublist(int_t pos, int_t count) const
 {
-  count = interpret_special_value(count, m_list.size() - pos);
-  const auto from = place(pos);
-  const auto to = place(pos + count);
-  container_t copied;
-  std::transform(from, to, std::back_inserter(copied),
-                 [](const auto& element) { return element->copy(); });
+  count = interpret_special_value(count, size() - pos);
+  list_value result;
 
-  return list_value{ std::move(copied) };
+  std::visit(
+    [this, pos, count, &result](const auto& elements) {
+      using elements_t = std::decay_t<decltype(elements)>;
+      const auto from = std::next(std::cbegin(elements), pos);
+      const auto to = std::next(from, count);
+      if constexpr (stores_instances_v<elements_t>) {
+        std::for_each(from, to, [&result](const auto& element) {
+          result.insert_copy(result.size(), *element);
+        });
+      } else {
+        result.m_storage = elements_t(from, to);
+        result.m_element_type = m_element_type;
+      }
+    },
+    m_storage);
+
+  return result;
 }
 
 int_t list_value::size() const
 {
-  return static_cast<int_t>(m_list.size());
+  return std::visit(
+    [](const auto& elements) { return static_cast<int_t>(elements.size()); },
+    m_storage);
 }
 
 bool list_value::empty() const
 {
-  return m_list.empty();
+  return std::visit([](const auto& elements) { return elements.empty(); },
+                    m_storage);
 }
 
 int_t list_value::find(const instance& value, int_t pos) const
 {
   pos = interpret_special_value(pos, 0);
-  const auto start = place(pos);
-  const auto found =
-    std::find_if(start, cend(), [&value](const auto& element) {
-      return element->value_cref() == value.value_cref();
-    });
-
-  return found == cend() ? -1 : std::distance(cbegin(), found);
+  const auto& searched_value = value.value_cref();
+
+  return std::visit(
+    [pos, &searched_value](const auto& elements) -> int_t {
+      using elements_t = std::decay_t<decltype(elements)>;
+      const auto start = std::next(std::cbegin(elements), pos);
+      auto found = std::cend(elements);
+
+      if constexpr (stores_instances_v<elements_t>) {
+        found = std::find_if(start, std::cend(elements),
+                             [&searched_value](const auto& element) {
+                               return element->value_cref() == searched_value;
+                             });
+      } else {
+        using value_t = typename elements_t::value_type;
+        if (holds<value_t>(searched_value)) {
+          found = std::find(start, std::cend(elements),
+                            typed_value<value_t>(searched_value));
+        }
+      }
+
+      return found == std::cend(elements)
+        ? -1
+        : std::distance(std::cbegin(elements), found);
+    },
+    m_storage);
 }
 }
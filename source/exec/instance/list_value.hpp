@@ -1,18 +1,35 @@
 #pragma once
 
 #include "common/int_alias.hpp"
+#include "exec/instance/string_value.hpp"
 
 #include <deque>
 #include <memory>
+#include <variant>
+#include <vector>
 
-namespace cmsl::exec::inst {
+namespace cmsl {
+namespace sema {
+class sema_type;
+}
+
+namespace exec::inst {
 class instance;
+class instance_value_variant;
 
+// Lists of bools, ints, doubles and strings store their values in a vector
+// of the value type, without an instance per element. Instances of elements
+// are created when a reference to an element is requested. From that point,
+// the list stores instances, so the references stay valid. A copy of such a
+// list stores values again.
 class list_value
 {
 private:
   using element_t = std::unique_ptr<instance>;
   using container_t = std::deque<element_t>;
+  using storage_t =
+    std::variant<container_t, std::vector<bool>, std::vector<int_t>,
+                 std::vector<double>, std::vector<string_value>>;
 
   static constexpr int_t k_special_value{ -1 };
 
@@ -36,17 +53,22 @@ public:
   bool operator>=(const list_value& other) const;
 
   void push_back(element_t element);
+  void push_back(const instance& value);
   void push_back(const list_value& other);
   void push_front(element_t element);
   void push_front(const list_value& other);
   void pop_back();
   void pop_front();
 
+  // Create instances of all elements, if the list stores values.
   instance& at(int_t index);
-  const instance& at(int_t index) const;
   instance& front();
   instance& back();
 
+  instance_value_variant value_at(int_t index) const;
+  // View of the element of a list of strings, without a copy of the value.
+  cmsl::string_view string_view_at(int_t index) const;
+
   void insert(int_t pos, element_t element);
   void insert(int_t pos, const list_value& other);
 
@@ -73,24 +95,31 @@ public:
   // list_value find_all(const instance& value, int_t pos = k_special_value);
 
 private:
-  void append_with_copy(const list_value& other);
-  void append_with_copy_to(const list_value& other,
-                           container_t& container) const;
-
-  container_t copy(const list_value& other) const;
+  void insert_copy(int_t pos, const instance& value);
+  // Inserts a value to a list that stores values.
+  void insert_value(int_t pos, const instance_value_variant& value);
+
+  // Prepares the storage for the value to be inserted. Returns true if the
+  // value is going to be stored as a value, or false if the list stores
+  // instances.
+  bool store_as_value(const instance& value);
+  bool holds_values() const;
+  void store_instances();
+
+  bool element_equals(int_t index, const instance_value_variant& value) const;
   int_t interpret_special_value(int_t value, int_t special_value) const;
-  container_t::const_iterator place(int_t pos) const;
 
   template <typename IndexCalculator>
   int_t remove_impl(const instance& value, int_t count,
                     IndexCalculator&& indexCalculator);
 
-  container_t::iterator begin();
-  container_t::iterator end();
-  container_t::const_iterator cbegin() const;
-  container_t::const_iterator cend() const;
+  template <typename Compare>
+  bool compare(const list_value& other, Compare&& cmp) const;
 
 private:
-  container_t m_list;
+  storage_t m_storage;
+  // Type of elements, if the list stores values.
+  const sema::sema_type* m_element_type{ nullptr };
 };
 }
+}
@@ -15,12 +15,23 @@ std::vector<std::string> list_value_utils::strings(
   collected.reserve(m_list.size());
 
   for (auto i = 0u; i < m_list.size(); ++i) {
-    const auto& instance = m_list.at(i);
-    const auto& source = instance.value_cref().get_string_cref();
-    const auto full_source_path = prefix + source;
-    collected.emplace_back(full_source_path);
+    auto full_source_path = prefix;
+    full_source_path += m_list.string_view_at(i);
+    collected.emplace_back(std::move(full_source_path));
   }
 
   return collected;
 }
+
+std::vector<cmsl::string_view> list_value_utils::string_views() const
+{
+  std::vector<cmsl::string_view> views;
+  views.reserve(m_list.size());
+
+  for (int_t i = 0; i < m_list.size(); ++i) {
+    views.push_back(m_list.string_view_at(i));
+  }
+
+  return views;
+}
 }
@@ -16,6 +16,8 @@ public:
   explicit list_value_utils(const list_value& list);
 
   std::vector<std::string> strings(const std::string& prefix = "") const;
+  // Views of the stored strings, valid as long as the list is not modified.
+  std::vector<cmsl::string_view> string_views() const;
 
 private:
   const list_value& m_list;
@@ -30,7 +30,7 @@ instance_value_variant simple_unnamed_instance::create_init_data() const
   } else if (name == "double") {
     return 0.0;
   } else if (name == "string") {
-    return std::string{};
+    return string_value{};
   } else if (name == "version") {
     return version_value{ 0u };
   } else if (starts_with(name, "list")) {
@@ -73,7 +73,7 @@ const instance_value_variant& simple_unnamed_instance::value_cref() const
 
 void simple_unnamed_instance::assign(instance_value_variant val)
 {
-  m_data = val;
+  m_data = std::move(val);
 }
 
 void simple_unnamed_instance::assign_member(unsigned,
@@ -0,0 +1,153 @@
+#include "exec/instance/string_value.hpp"
+
+#include <cstring>
+
+namespace cmsl::exec::inst {
+string_value::string_value(const char* str)
+  : string_value{ cmsl::string_view{ str } }
+{
+}
+
+string_value::string_value(cmsl::string_view str)
+{
+  if (str.size() <= k_inline_capacity) {
+    m_inline_size = static_cast<std::uint8_t>(str.size());
+    std::memcpy(m_inline, str.data(), str.size());
+    return;
+  }
+
+  m_buffer = new shared_buffer{ { 1u }, std::string{ str } };
+}
+
+string_value::string_value(std::string str)
+{
+  if (str.size() <= k_inline_capacity) {
+    m_inline_size = static_cast<std::uint8_t>(str.size());
+    std::memcpy(m_inline, str.data(), str.size());
+    return;
+  }
+
+  // Take over the allocated string, instead of copying it.
+  m_buffer = new shared_buffer{ { 1u }, std::move(str) };
+}
+
+string_value::string_value(const string_value& other)
+  : m_buffer{ other.m_buffer }
+  , m_inline_size{ other.m_inline_size }
+{
+  if (m_buffer != nullptr) {
+    m_buffer->references.fetch_add(1u, std::memory_order_relaxed);
+  } else {
+    std::memcpy(m_inline, other.m_inline, m_inline_size);
+  }
+}
+
+string_value& string_value::operator=(const string_value& other)
+{
+  if (this != &other) {
+    auto copy = other;
+    *this = std::move(copy);
+  }
+
+  return *this;
+}
+
+string_value::string_value(string_value&& other) noexcept
+  : m_buffer{ other.m_buffer }
+  , m_inline_size{ other.m_inline_size }
+{
+  std::memcpy(m_inline, other.m_inline, m_inline_size);
+  other.m_buffer = nullptr;
+  other.m_inline_size = 0u;
+}
+
+string_value& string_value::operator=(string_value&& other) noexcept
+{
+  if (this != &other) {
+    release();
+    m_buffer = other.m_buffer;
+    m_inline_size = other.m_inline_size;
+    std::memcpy(m_inline, other.m_inline, m_inline_size);
+    other.m_buffer = nullptr;
+    other.m_inline_size = 0u;
+  }
+
+  return *this;
+}
+
+string_value::~string_value()
+{
+  release();
+}
+
+cmsl::string_view string_value::view() const
+{
+  if (m_buffer != nullptr) {
+    return m_buffer->str;
+  }
+
+  return cmsl::string_view{ m_inline, m_inline_size };
+}
+
+std::string string_value::str() const
+{
+  return std::string{ view() };
+}
+
+std::size_t string_value::size() const
+{
+  return view().size();
+}
+
+bool string_value::empty() const
+{
+  return size() == 0u;
+}
+
+bool string_value::operator==(const string_value& rhs) const
+{
+  // Copies of a value are equal without comparing their characters.
+  if (m_buffer != nullptr && m_buffer == rhs.m_buffer) {
+    return true;
+  }
+
+  return view() == rhs.view();
+}
+
+bool string_value::operator!=(const string_value& rhs) const
+{
+  return !(*this == rhs);
+}
+
+bool string_value::operator<(const string_value& rhs) const
+{
+  return view() < rhs.view();
+}
+
+bool string_value::operator<=(const string_value& rhs) const
+{
+  return view() <= rhs.view();
+}
+
+bool string_value::operator>(const string_value& rhs) const
+{
+  return view() > rhs.view();
+}
+
+bool string_value::operator>=(const string_value& rhs) const
+{
+  return view() >= rhs.view();
+}
+
+void string_value::release()
+{
+  if (m_buffer == nullptr) {
+    return;
+  }
+
+  if (m_buffer->references.fetch_sub(1u, std::memory_order_acq_rel) == 1u) {
+    delete m_buffer;
+  }
+  m_buffer = nullptr;
+}
+}
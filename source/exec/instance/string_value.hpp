@@ -0,0 +1,76 @@
+#pragma once
+
+#include "common/string.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace cmsl::exec::inst {
+// Value of a string instance.
+//
+// Short strings are stored inline. Longer ones are stored in a reference
+// counted buffer, that is shared by copies of the value and copied only when
+// a value that shares it is modified. Thus, copying a string, e.g. as a part
+// of a list of source files passed by value, never allocates.
+class string_value
+{
+public:
+  string_value() = default;
+  string_value(const char* str);
+  string_value(cmsl::string_view str);
+  string_value(std::string str);
+
+  string_value(const string_value& other);
+  string_value& operator=(const string_value& other);
+  string_value(string_value&& other) noexcept;
+  string_value& operator=(string_value&& other) noexcept;
+
+  ~string_value();
+
+  cmsl::string_view view() const;
+  std::string str() const;
+  std::size_t size() const;
+  bool empty() const;
+
+  // Calls modifier with a std::string that holds the value and is not
+  // shared with other values, and stores the modified string.
+  template <typename Modifier>
+  void modify(Modifier&& modifier)
+  {
+    if (m_buffer != nullptr && m_buffer->references.load() == 1u) {
+      modifier(m_buffer->str);
+      return;
+    }
+
+    auto modified = str();
+    modifier(modified);
+    *this = string_value{ std::move(modified) };
+  }
+
+  bool operator==(const string_value& rhs) const;
+  bool operator!=(const string_value& rhs) const;
+  bool operator<(const string_value& rhs) const;
+  bool operator<=(const string_value& rhs) const;
+  bool operator>(const string_value& rhs) const;
+  bool operator>=(const string_value& rhs) const;
+
+private:
+  struct shared_buffer
+  {
+    std::atomic<std::size_t> references;
+    std::string str;
+  };
+
+  // Makes the value fit in 32 bytes, like a std::string.
+  static constexpr auto k_inline_capacity = std::size_t{ 23u };
+
+  void release();
+
+private:
+  // Null if the value is stored inline.
+  shared_buffer* m_buffer{ nullptr };
+  std::uint8_t m_inline_size{ 0u };
+  char m_inline[k_inline_capacity];
+};
+}
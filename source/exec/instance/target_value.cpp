@@ -1,9 +1,14 @@
 #include "exec/instance/target_value.hpp"
+#include "exec/instance/list_value.hpp"
 #include "exec/instance/list_value_utils.hpp"
 
 #include "cmake_facade.hpp"
 
 namespace cmsl::exec::inst {
+namespace {
+using command_kind = facade::command_buffer::command_kind;
+}
+
 target_value::target_value(std::string name)
   : m_name{ std::move(name) }
 {
@@ -25,34 +30,25 @@ void target_value::include_directories(facade::cmake_facade& cmake_facade,
                                        facade::visibility v,
                                        const list_value& dirs) const
 {
-  const auto dir_values = list_value_utils{ dirs }.strings();
-  if (dir_values.empty()) {
-    return;
-  }
-
-  cmake_facade.target_include_directories(m_name, v, dir_values);
+  apply_list_operation(cmake_facade,
+                       command_kind::target_include_directories, v, dirs);
 }
 
 void target_value::compile_definitions(facade::cmake_facade& cmake_facade,
                                        const list_value& definitions_list,
                                        facade::visibility v) const
 {
-  const auto definitions = list_value_utils{ definitions_list }.strings();
-  if (definitions.empty()) {
-    return;
-  }
-  cmake_facade.target_compile_definitions(m_name, v, definitions);
+  apply_list_operation(cmake_facade,
+                       command_kind::target_compile_definitions, v,
+                       definitions_list);
 }
 
 void target_value::compile_options(facade::cmake_facade& cmake_facade,
                                    const list_value& options_list,
                                    facade::visibility v) const
 {
-  const auto options = list_value_utils{ options_list }.strings();
-  if (options.empty()) {
-    return;
-  }
-  cmake_facade.target_compile_options(m_name, v, options);
+  apply_list_operation(cmake_facade, command_kind::target_compile_options, v,
+                       options_list);
 }
 
 void target_value::link_to(facade::cmake_facade& cmake_facade,
@@ -66,10 +62,22 @@ void target_value::add_sources(facade::cmake_facade& cmake_facade,
                                const list_value& sources_list,
                                facade::visibility v) const
 {
-  const auto sources = list_value_utils{ sources_list }.strings();
-  if (sources.empty()) {
+  apply_list_operation(cmake_facade, command_kind::target_sources, v,
+                       sources_list);
+}
+
+void target_value::apply_list_operation(facade::cmake_facade& cmake_facade,
+                                        command_kind kind,
+                                        facade::visibility v,
+                                        const list_value& list) const
+{
+  if (list.empty()) {
     return;
   }
-  cmake_facade.target_sources(m_name, v, sources);
+
+  // Strings are passed as views of the list elements, so a facade that
+  // records the operation copies them only once, into its own storage.
+  cmake_facade.apply_command(kind, m_name, v,
+                             list_value_utils{ list }.string_views());
 }
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "command_buffer.hpp"
 #include "visibility.hpp"
 
 #include <string>
@@ -39,6 +40,12 @@ public:
   void add_sources(facade::cmake_facade& cmake_facade,
                    const list_value& sources_list, facade::visibility v) const;
 
+private:
+  void apply_list_operation(facade::cmake_facade& cmake_facade,
+                            facade::command_buffer::command_kind kind,
+                            facade::visibility v,
+                            const list_value& list) const;
+
 private:
   std::string m_name;
 };
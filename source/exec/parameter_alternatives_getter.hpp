@@ -4,6 +4,7 @@
 #include "exec/instance/instance.hpp"
 #include "exec/instance/instance_value_alternative.hpp"
 #include "exec/instance/list_value.hpp"
+#include "exec/instance/string_value.hpp"
 #include "exec/instance/version_value.hpp"
 
 #include <tuple>
@@ -13,8 +14,9 @@ namespace cmsl::exec {
 using index_t = inst::instance_value_alternative;
 
 namespace details {
-using alternatives_tuple_t = std::tuple<bool, int_t, double, std::string,
-                                        inst::version_value, inst::list_value>;
+using alternatives_tuple_t =
+  std::tuple<bool, int_t, double, inst::string_value, inst::version_value,
+             inst::list_value>;
 
 template <inst::instance_value_alternative Alternative>
 using alternative_type_t =
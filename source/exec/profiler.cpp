@@ -0,0 +1,340 @@
+#include "exec/profiler.hpp"
+
+#include "common/assert.hpp"
+#include "common/source_view.hpp"
+#include "sema/builtin_sema_function.hpp"
+#include "sema/sema_context.hpp"
+#include "sema/user_sema_function.hpp"
+
+#include <ostream>
+
+namespace cmsl::exec {
+namespace {
+// Whole microseconds, so long traces are not written in the exponent
+// notation, that would round timestamps and break nesting of events.
+long long microseconds(profiler::clock::duration duration)
+{
+  return static_cast<long long>(
+    std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+}
+}
+
+void write_json_string(std::ostream& out, std::string_view str)
+{
+  out << '"';
+  for (const auto c : str) {
+    switch (c) {
+      case '"':
+        out << "\\\"";
+        break;
+      case '\\':
+        out << "\\\\";
+        break;
+      case '\n':
+        out << "\\n";
+        break;
+      case '\t':
+        out << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20u) {
+          constexpr auto digits = "0123456789abcdef";
+          out << "\\u00" << digits[(c >> 4) & 0xf] << digits[c & 0xf];
+        } else {
+          out << c;
+        }
+    }
+  }
+  out << '"';
+}
+
+profiler::profiler(bool record_function_calls)
+  : m_record_function_calls{ record_function_calls }
+{
+}
+
+profiler::frame_id profiler::intern_frame(std::string_view name,
+                                          std::string_view category,
+                                          std::string_view file,
+                                          unsigned line)
+{
+  return intern_frame(name, category, file, line, k_no_phase);
+}
+
+profiler::frame_id profiler::intern_frame(std::string_view name,
+                                          std::string_view category,
+                                          std::string_view file,
+                                          unsigned line, unsigned phase_index)
+{
+  auto key = std::string{ name };
+  key += '\0';
+  key += category;
+  key += '\0';
+  key += file;
+  key += '\0';
+  key += std::to_string(line);
+  key += '\0';
+  key += std::to_string(phase_index);
+
+  const auto id = static_cast<frame_id>(m_frames.size());
+  const auto [it, inserted] = m_frame_ids.emplace(std::move(key), id);
+  if (inserted) {
+    m_frames.push_back(frame{ std::string{ name }, std::string{ category },
+                              std::string{ file }, line, phase_index });
+  }
+
+  return it->second;
+}
+
+profiler::frame_id profiler::phase_frame(phase p, std::string_view file,
+                                         std::string_view name)
+{
+  return intern_frame(name.empty() ? phase_name(p) : name, "phase", file, 0u,
+                      static_cast<unsigned>(p));
+}
+
+profiler::frame_id profiler::function_frame(
+  const sema::sema_function& function)
+{
+  if (const auto found = m_function_frames.find(&function);
+      found != std::cend(m_function_frames)) {
+    return found->second;
+  }
+
+  const auto name = function_name(function);
+  frame_id id;
+  if (dynamic_cast<const sema::user_sema_function*>(&function) != nullptr) {
+    const auto& name_token = function.signature().name;
+    id = intern_frame(name, "function", name_token.source().path(),
+                      name_token.src_range().begin.line);
+  } else if (dynamic_cast<const sema::builtin_sema_function*>(&function) !=
+             nullptr) {
+    id = intern_frame(name, "builtin");
+  } else {
+    id = intern_frame(name, "component creation");
+  }
+
+  m_function_frames.emplace(&function, id);
+  return id;
+}
+
+bool profiler::records_function_calls() const
+{
+  return m_record_function_calls;
+}
+
+void profiler::enter(frame_id frame)
+{
+  const auto parent =
+    m_active.empty() ? k_no_parent : m_active.back().node;
+  const auto key = (std::uint64_t{ parent } << 32u) | frame;
+  const auto [it, inserted] = m_node_ids.emplace(
+    key, static_cast<std::uint32_t>(m_nodes.size()));
+  if (inserted) {
+    const auto frame_phase = m_frames[frame].phase_index;
+    const auto phase_index = frame_phase != k_no_phase || parent == k_no_parent
+      ? frame_phase
+      : m_nodes[parent].phase_index;
+    m_nodes.push_back(node{ frame, parent, phase_index });
+  }
+
+  m_active.push_back(active_scope{ it->second, clock::now() });
+}
+
+void profiler::leave()
+{
+  CMSL_ASSERT(!m_active.empty());
+  const auto active = m_active.back();
+  m_active.pop_back();
+
+  const auto duration = clock::now() - active.begin;
+  auto& n = m_nodes[active.node];
+  ++n.calls;
+  n.total += duration;
+  if (n.parent != k_no_parent) {
+    m_nodes[n.parent].children_total += duration;
+  }
+}
+
+const profiler::frame& profiler::get_frame(frame_id id) const
+{
+  return m_frames[id];
+}
+
+profiler::clock::duration profiler::phase_total(phase p) const
+{
+  clock::duration result{};
+  for (const auto& n : m_nodes) {
+    if (n.phase_index == static_cast<unsigned>(p)) {
+      result += n.total - n.children_total;
+    }
+  }
+  return result;
+}
+
+const char* profiler::phase_name(phase p)
+{
+  switch (p) {
+    case phase::lex:
+      return "lex";
+    case phase::parse:
+      return "parse";
+    case phase::sema:
+      return "sema";
+    case phase::execute:
+      return "execute";
+    case phase::facade:
+      return "facade";
+  }
+
+  CMSL_UNREACHABLE("Unknown phase");
+  return "";
+}
+
+std::string profiler::function_name(const sema::sema_function& function)
+{
+  auto name = function.context().fully_qualified_name();
+  name += "::";
+  name += function.signature().name.str();
+
+  // Global contexts have no names.
+  const auto first_name_char = name.find_first_not_of(':');
+  return first_name_char == std::string::npos ? name
+                                              : name.substr(first_name_char);
+}
+
+std::string profiler::frame_label(frame_id id) const
+{
+  const auto& f = m_frames[id];
+  if (f.file.empty()) {
+    return f.name;
+  }
+
+  auto label = f.name + " (" + f.file;
+  if (f.line != 0u) {
+    label += ':' + std::to_string(f.line);
+  }
+  return label + ')';
+}
+
+std::vector<std::vector<std::uint32_t>> profiler::children() const
+{
+  std::vector<std::vector<std::uint32_t>> result(m_nodes.size() + 1u);
+  // Roots are children of the last, artificial node.
+  for (auto i = 0u; i < m_nodes.size(); ++i) {
+    const auto parent = m_nodes[i].parent;
+    result[parent == k_no_parent ? m_nodes.size() : parent].push_back(i);
+  }
+  return result;
+}
+
+void profiler::write_chrome_trace(std::ostream& out) const
+{
+  const auto nodes_children = children();
+
+  struct pending_node
+  {
+    std::uint32_t node;
+    clock::duration begin;
+  };
+
+  // Siblings are placed one after another, starting where the parent
+  // starts.
+  std::vector<pending_node> pending;
+  const auto push_children = [&](std::size_t parent, clock::duration begin) {
+    const auto& c = nodes_children[parent];
+    std::vector<pending_node> placed;
+    for (const auto child : c) {
+      placed.push_back(pending_node{ child, begin });
+      begin += m_nodes[child].total;
+    }
+    pending.insert(std::end(pending), placed.rbegin(), placed.rend());
+  };
+  push_children(m_nodes.size(), clock::duration{});
+
+  out << "{\"traceEvents\":[";
+  auto first = true;
+  while (!pending.empty()) {
+    const auto current = pending.back();
+    pending.pop_back();
+    const auto& n = m_nodes[current.node];
+    const auto& f = m_frames[n.frame];
+    out << (first ? "\n" : ",\n");
+    first = false;
+
+    out << "{\"name\":";
+    write_json_string(out, f.name);
+    out << ",\"cat\":";
+    write_json_string(out, f.category);
+    out << ",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":"
+        << microseconds(current.begin) << ",\"dur\":" << microseconds(n.total)
+        << ",\"args\":{\"calls\":" << n.calls;
+    if (!f.file.empty()) {
+      out << ",\"file\":";
+      write_json_string(out, f.file);
+      if (f.line != 0u) {
+        out << ",\"line\":" << f.line;
+      }
+    }
+    out << "}}";
+
+    push_children(current.node, current.begin);
+  }
+  out << "\n]}\n";
+}
+
+void profiler::write_folded_stacks(std::ostream& out) const
+{
+  std::vector<frame_id> stack;
+  for (const auto& n : m_nodes) {
+    stack.clear();
+    for (auto current = &n;;) {
+      stack.push_back(current->frame);
+      if (current->parent == k_no_parent) {
+        break;
+      }
+      current = &m_nodes[current->parent];
+    }
+
+    for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
+      out << (it == stack.rbegin() ? "" : ";") << frame_label(*it);
+    }
+    out << ' ' << microseconds(n.total - n.children_total) << '\n';
+  }
+}
+
+profile_scope::profile_scope(profiler* p, std::string_view name,
+                             std::string_view category,
+                             std::string_view file, unsigned line)
+  : m_profiler{ p }
+{
+  if (m_profiler != nullptr) {
+    m_profiler->enter(m_profiler->intern_frame(name, category, file, line));
+  }
+}
+
+profile_scope::profile_scope(profiler* p, phase ph, std::string_view file,
+                             std::string_view name)
+  : m_profiler{ p }
+{
+  if (m_profiler != nullptr) {
+    m_profiler->enter(m_profiler->phase_frame(ph, file, name));
+  }
+}
+
+profile_scope::profile_scope(profiler* p,
+                             const sema::sema_function& function)
+  : m_profiler{ p != nullptr && p->records_function_calls() ? p : nullptr }
+{
+  if (m_profiler != nullptr) {
+    m_profiler->enter(m_profiler->function_frame(function));
+  }
+}
+
+profile_scope::~profile_scope()
+{
+  if (m_profiler != nullptr) {
+    m_profiler->leave();
+  }
+}
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace cmsl {
+namespace sema {
+class sema_function;
+}
+
+namespace exec {
+enum class phase
+{
+  lex,
+  parse,
+  sema,
+  execute,
+  facade
+};
+
+// Records nested scopes of the whole pipeline: compilation phases of every
+// file, imports, static variables initialization, facade and function calls.
+// Every scope is attributed to a frame, that has a name and optionally a
+// script file and line. Scopes with the same stack of frames are merged, so
+// memory does not grow with number of calls. The merged call tree can be
+// exported as Chrome trace events, to be viewed in chrome://tracing or
+// Perfetto, and as folded stacks, for flame graph tools.
+//
+// Frames of phases also accumulate time of the phases. Phases nest, e.g. an
+// imported module is compiled during sema of the importing file and facade
+// is called during execution. Time of a nested phase is accounted only to
+// that phase, not to the outer one.
+class profiler
+{
+public:
+  using clock = std::chrono::steady_clock;
+  using frame_id = std::uint32_t;
+
+  static constexpr auto k_phases_count = 5u;
+
+  struct frame
+  {
+    std::string name;
+    std::string category;
+    std::string file;
+    unsigned line;
+    // Index of the phase the time of the frame, and of frames nested in it,
+    // is accounted to. k_no_phase if the frame inherits the phase of the
+    // outer frame.
+    unsigned phase_index;
+  };
+
+  static constexpr auto k_no_phase = ~0u;
+
+  // If record_function_calls is false, function calls are not recorded, so
+  // measuring phases costs nearly nothing.
+  explicit profiler(bool record_function_calls = true);
+
+  frame_id intern_frame(std::string_view name, std::string_view category,
+                        std::string_view file = {}, unsigned line = 0u);
+  // Frame of the phase, named after the phase if the name is empty.
+  frame_id phase_frame(phase p, std::string_view file = {},
+                       std::string_view name = {});
+  // Frame of a user or builtin function. Frames of functions are cached, so
+  // this is cheap enough to be called for every function call.
+  frame_id function_frame(const sema::sema_function& function);
+
+  bool records_function_calls() const;
+
+  void enter(frame_id frame);
+  void leave();
+
+  const frame& get_frame(frame_id id) const;
+
+  // Time spent in the phase, without phases nested in it, in scopes that
+  // have been left.
+  clock::duration phase_total(phase p) const;
+
+  static const char* phase_name(phase p);
+
+  // Fully qualified name of the function, e.g. foo::bar.
+  static std::string function_name(const sema::sema_function& function);
+
+  // Writes every node of the call tree as a complete ('X') event, with
+  // timestamps in microseconds. Nodes are laid out one after another, in
+  // order they have been entered for the first time, so an event lasts as
+  // long as all merged scopes and the number of the scopes is written in its
+  // args.
+  void write_chrome_trace(std::ostream& out) const;
+  // Writes a line per distinct stack, with frames separated by ';' and
+  // followed by the time spent in the last frame, in microseconds.
+  void write_folded_stacks(std::ostream& out) const;
+
+private:
+  static constexpr auto k_no_parent = ~std::uint32_t{ 0u };
+
+  // Scopes with the same stack of frames.
+  struct node
+  {
+    frame_id frame;
+    std::uint32_t parent;
+    // Phase of the frame or of the closest outer frame that has one.
+    unsigned phase_index;
+    std::uint64_t calls{ 0u };
+    clock::duration total{};
+    clock::duration children_total{};
+  };
+
+  struct active_scope
+  {
+    std::uint32_t node;
+    clock::time_point begin;
+  };
+
+  frame_id intern_frame(std::string_view name, std::string_view category,
+                        std::string_view file, unsigned line,
+                        unsigned phase_index);
+  std::string frame_label(frame_id id) const;
+
+  // Children of every node, in order of creation.
+  std::vector<std::vector<std::uint32_t>> children() const;
+
+private:
+  bool m_record_function_calls;
+  std::deque<frame> m_frames;
+  std::unordered_map<std::string, frame_id> m_frame_ids;
+  std::unordered_map<const sema::sema_function*, frame_id> m_function_frames;
+  std::vector<node> m_nodes;
+  // Node of a frame entered from a parent node, keyed by both ids.
+  std::unordered_map<std::uint64_t, std::uint32_t> m_node_ids;
+  std::vector<active_scope> m_active;
+};
+
+// Records a scope till the end of the C++ scope, if profiling is enabled.
+class profile_scope
+{
+public:
+  explicit profile_scope(profiler* p, std::string_view name,
+                         std::string_view category,
+                         std::string_view file = {}, unsigned line = 0u);
+  // Scope of a phase, named after the phase if the name is empty.
+  explicit profile_scope(profiler* p, phase ph, std::string_view file = {},
+                         std::string_view name = {});
+  // Does nothing if the profiler does not record function calls.
+  explicit profile_scope(profiler* p, const sema::sema_function& function);
+  ~profile_scope();
+
+  profile_scope(const profile_scope&) = delete;
+  profile_scope& operator=(const profile_scope&) = delete;
+
+private:
+  profiler* m_profiler;
+};
+
+// Writes the string as a quoted and escaped JSON string.
+void write_json_string(std::ostream& out, std::string_view str);
+}
+}
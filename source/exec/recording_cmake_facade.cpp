@@ -0,0 +1,364 @@
+#include "exec/recording_cmake_facade.hpp"
+#include "exec/profiler.hpp"
+
+namespace cmsl::exec {
+recording_cmake_facade::recording_cmake_facade(facade::cmake_facade& facade,
+                                               std::ostream& trace,
+                                               profiler* profiler)
+  : m_facade{ facade }
+  , m_trace{ trace }
+  , m_profiler{ profiler }
+{
+}
+
+facade::cmake_facade::version recording_cmake_facade::get_cmake_version()
+  const
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("get_cmake_version");
+  return m_facade.get_cmake_version();
+}
+
+void recording_cmake_facade::message(const std::string& what) const
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("message", what);
+  m_facade.message(what);
+}
+
+void recording_cmake_facade::warning(const std::string& what) const
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("warning", what);
+  m_facade.warning(what);
+}
+
+void recording_cmake_facade::error(const std::string& what) const
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("error", what);
+  m_facade.error(what);
+}
+
+void recording_cmake_facade::fatal_error(const std::string& what)
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("fatal_error", what);
+  m_facade.fatal_error(what);
+}
+
+bool recording_cmake_facade::did_fatal_error_occure() const
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("did_fatal_error_occure");
+  return m_facade.did_fatal_error_occure();
+}
+
+void recording_cmake_facade::register_project(const std::string& name)
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("register_project", name);
+  m_facade.register_project(name);
+}
+
+void recording_cmake_facade::install(const std::string& target_name,
+                                    const std::string& destination)
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("install", target_name, destination);
+  m_facade.install(target_name, destination);
+}
+
+std::string recording_cmake_facade::get_current_binary_dir() const
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("get_current_binary_dir");
+  return m_facade.get_current_binary_dir();
+}
+
+std::string recording_cmake_facade::get_current_source_dir() const
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("get_current_source_dir");
+  return m_facade.get_current_source_dir();
+}
+
+std::string recording_cmake_facade::get_root_source_dir() const
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("get_root_source_dir");
+  return m_facade.get_root_source_dir();
+}
+
+void recording_cmake_facade::add_custom_command(
+  const std::vector<std::string>& command, const std::string& output) const
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("add_custom_command", command, output);
+  m_facade.add_custom_command(command, output);
+}
+
+void recording_cmake_facade::add_custom_target(
+  const std::string& name, const std::vector<std::string>& command) const
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("add_custom_target", name, command);
+  m_facade.add_custom_target(name, command);
+}
+
+void recording_cmake_facade::make_directory(const std::string& dir) const
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("make_directory", dir);
+  m_facade.make_directory(dir);
+}
+
+void recording_cmake_facade::add_executable(
+  const std::string& name, const std::vector<std::string>& sources)
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("add_executable", name, sources);
+  m_facade.add_executable(name, sources);
+}
+
+void recording_cmake_facade::add_library(
+  const std::string& name, const std::vector<std::string>& sources)
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("add_library", name, sources);
+  m_facade.add_library(name, sources);
+}
+
+void recording_cmake_facade::target_link_library(
+  const std::string& target_name, facade::visibility v,
+  const std::string& library_name)
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("target_link_library", target_name, v, library_name);
+  m_facade.target_link_library(target_name, v, library_name);
+}
+
+void recording_cmake_facade::target_include_directories(
+  const std::string& target_name, facade::visibility v,
+  const std::vector<std::string>& dirs)
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("target_include_directories", target_name, v, dirs);
+  m_facade.target_include_directories(target_name, v, dirs);
+}
+
+void recording_cmake_facade::target_compile_definitions(
+  const std::string& target_name, facade::visibility v,
+  const std::vector<std::string>& definitions)
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("target_compile_definitions", target_name, v, definitions);
+  m_facade.target_compile_definitions(target_name, v, definitions);
+}
+
+void recording_cmake_facade::target_compile_options(
+  const std::string& target_name, facade::visibility v,
+  const std::vector<std::string>& options)
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("target_compile_options", target_name, v, options);
+  m_facade.target_compile_options(target_name, v, options);
+}
+
+void recording_cmake_facade::target_sources(
+  const std::string& target_name, facade::visibility v,
+  const std::vector<std::string>& sources)
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("target_sources", target_name, v, sources);
+  m_facade.target_sources(target_name, v, sources);
+}
+
+void recording_cmake_facade::apply_command(
+  facade::command_buffer::command_kind kind, const std::string& name,
+  facade::visibility v, const std::vector<std::string_view>& arguments)
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  trace_command(kind, name, v, arguments);
+  m_facade.apply_command(kind, name, v, arguments);
+}
+
+void recording_cmake_facade::apply_commands(
+  const facade::command_buffer& commands)
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+
+  // Commands are recorded as separate calls, so a trace doesn't depend on
+  // whether calls were batched.
+  for (const auto& cmd : commands.commands()) {
+    trace_command(cmd.kind, commands.string(cmd.name), cmd.v,
+                  commands.arguments(cmd));
+  }
+
+  m_facade.apply_commands(commands);
+}
+
+void recording_cmake_facade::trace_command(
+  facade::command_buffer::command_kind kind, std::string_view name,
+  facade::visibility v, const std::vector<std::string_view>& arguments) const
+{
+  using command_kind = facade::command_buffer::command_kind;
+  switch (kind) {
+    case command_kind::register_project:
+      m_trace.write("register_project", name);
+      break;
+    case command_kind::add_executable:
+      m_trace.write("add_executable", name, arguments);
+      break;
+    case command_kind::add_library:
+      m_trace.write("add_library", name, arguments);
+      break;
+    case command_kind::target_link_library:
+      m_trace.write("target_link_library", name, v, arguments.front());
+      break;
+    case command_kind::target_include_directories:
+      m_trace.write("target_include_directories", name, v, arguments);
+      break;
+    case command_kind::target_compile_definitions:
+      m_trace.write("target_compile_definitions", name, v, arguments);
+      break;
+    case command_kind::target_compile_options:
+      m_trace.write("target_compile_options", name, v, arguments);
+      break;
+    case command_kind::target_sources:
+      m_trace.write("target_sources", name, v, arguments);
+      break;
+  }
+}
+
+std::string recording_cmake_facade::current_directory() const
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("current_directory");
+  return m_facade.current_directory();
+}
+
+void recording_cmake_facade::add_subdirectory_with_old_script(
+  const std::string& dir)
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("add_subdirectory_with_old_script", dir);
+  m_facade.add_subdirectory_with_old_script(dir);
+}
+
+void recording_cmake_facade::go_into_subdirectory(const std::string& dir)
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("go_into_subdirectory", dir);
+  m_facade.go_into_subdirectory(dir);
+}
+
+void recording_cmake_facade::go_directory_up()
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("go_directory_up");
+  m_facade.go_directory_up();
+}
+
+void recording_cmake_facade::prepare_for_add_subdirectory_with_cmakesl_script(
+  const std::string& dir)
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("prepare_for_add_subdirectory_with_cmakesl_script", dir);
+  m_facade.prepare_for_add_subdirectory_with_cmakesl_script(dir);
+}
+
+void recording_cmake_facade::
+  finalize_after_add_subdirectory_with_cmakesl_script()
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("finalize_after_add_subdirectory_with_cmakesl_script");
+  m_facade.finalize_after_add_subdirectory_with_cmakesl_script();
+}
+
+void recording_cmake_facade::enable_ctest() const
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("enable_ctest");
+  m_facade.enable_ctest();
+}
+
+void recording_cmake_facade::add_test(const std::string& test_executable_name)
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("add_test", test_executable_name);
+  m_facade.add_test(test_executable_name);
+}
+
+facade::cmake_facade::cxx_compiler_info
+recording_cmake_facade::get_cxx_compiler_info() const
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("get_cxx_compiler_info");
+  return m_facade.get_cxx_compiler_info();
+}
+
+facade::cmake_facade::system_info recording_cmake_facade::get_system_info()
+  const
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("get_system_info");
+  return m_facade.get_system_info();
+}
+
+std::optional<std::string> recording_cmake_facade::try_get_extern_define(
+  const std::string& name) const
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("try_get_extern_define", name);
+  return m_facade.try_get_extern_define(name);
+}
+
+void recording_cmake_facade::set_property(
+  const std::string& property_name, const std::string& property_value) const
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("set_property", property_name, property_value);
+  m_facade.set_property(property_name, property_value);
+}
+
+std::optional<bool> recording_cmake_facade::get_option_value(
+  const std::string& name) const
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("get_option_value", name);
+  return m_facade.get_option_value(name);
+}
+
+void recording_cmake_facade::register_option(const std::string& name,
+                                            const std::string& description,
+                                            bool value) const
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("register_option", name, description, value);
+  m_facade.register_option(name, description, value);
+}
+
+void recording_cmake_facade::set_old_style_variable(
+  const std::string& name, const std::string& value) const
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("set_old_style_variable", name, value);
+  m_facade.set_old_style_variable(name, value);
+}
+
+std::optional<std::string> recording_cmake_facade::get_old_style_variable(
+  const std::string& name) const
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("get_old_style_variable", name);
+  return m_facade.get_old_style_variable(name);
+}
+
+std::string recording_cmake_facade::ctest_command() const
+{
+  const profile_scope scope{ m_profiler, phase::facade };
+  m_trace.write("ctest_command");
+  return m_facade.ctest_command();
+}
+}
@@ -0,0 +1,246 @@
+#include "exec/script_profiler.hpp"
+
+#include "common/assert.hpp"
+#include "common/source_view.hpp"
+#include "exec/instance/instance_allocator.hpp"
+#include "exec/profiler.hpp"
+#include "sema/user_sema_function.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <string>
+
+namespace cmsl::exec {
+namespace {
+std::size_t allocated_instances()
+{
+  return inst::instance_allocator::stats().instances_allocated;
+}
+
+double milliseconds(script_profiler::clock::duration duration)
+{
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+double microseconds(script_profiler::clock::duration duration)
+{
+  return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+std::string function_label(const sema::user_sema_function& function)
+{
+  const auto& name = function.signature().name;
+  return profiler::function_name(function) + " (" +
+    std::string{ name.source().path() } + ':' +
+    std::to_string(name.src_range().begin.line) + ')';
+}
+
+std::vector<std::pair<unsigned, const script_profiler::line_stats*>>
+sorted_lines(
+  const std::unordered_map<unsigned, script_profiler::line_stats>& lines)
+{
+  std::vector<std::pair<unsigned, const script_profiler::line_stats*>> result;
+  result.reserve(lines.size());
+  for (const auto& [line, stats] : lines) {
+    result.emplace_back(line, &stats);
+  }
+  std::sort(std::begin(result), std::end(result));
+  return result;
+}
+}
+
+void script_profiler::enter_function(const sema::user_sema_function& function)
+{
+  const auto now = clock::now();
+  const auto allocations = allocated_instances();
+
+  // The line of the caller is resumed when the callee returns.
+  if (!m_callstack.empty()) {
+    account_line(m_callstack.back(), now, allocations);
+  }
+
+  auto& record = m_records[&function];
+  ++record.stats.calls;
+  ++record.active_calls;
+
+  call_frame frame;
+  frame.record = &record;
+  frame.begin = now;
+  frame.begin_allocations = allocations;
+  m_callstack.emplace_back(frame);
+}
+
+void script_profiler::leave_function()
+{
+  CMSL_ASSERT(!m_callstack.empty());
+
+  const auto now = clock::now();
+  const auto allocations = allocated_instances();
+
+  auto& frame = m_callstack.back();
+  leave_line(frame, now, allocations);
+
+  const auto time = now - frame.begin;
+  const auto allocated = allocations - frame.begin_allocations;
+
+  auto& record = *frame.record;
+  auto& stats = record.stats;
+  stats.exclusive_time += time - frame.callees_time;
+  stats.exclusive_allocations += allocated - frame.callees_allocations;
+  // Outer recursive calls already contain this one.
+  if (--record.active_calls == 0u) {
+    stats.inclusive_time += time;
+    stats.inclusive_allocations += allocated;
+  }
+
+  m_callstack.pop_back();
+  if (!m_callstack.empty()) {
+    auto& caller = m_callstack.back();
+    caller.callees_time += time;
+    caller.callees_allocations += allocated;
+    caller.line_begin = now;
+    caller.line_begin_allocations = allocations;
+  }
+}
+
+void script_profiler::enter_line(unsigned line)
+{
+  CMSL_ASSERT(!m_callstack.empty());
+
+  const auto now = clock::now();
+  const auto allocations = allocated_instances();
+
+  auto& frame = m_callstack.back();
+  leave_line(frame, now, allocations);
+
+  frame.line = &frame.record->lines[line];
+  ++frame.line->hits;
+  frame.line_begin = now;
+  frame.line_begin_allocations = allocations;
+}
+
+void script_profiler::account_line(call_frame& frame, clock::time_point now,
+                                   std::size_t allocations)
+{
+  if (frame.line == nullptr) {
+    return;
+  }
+
+  frame.line->time += now - frame.line_begin;
+  frame.line->allocations += allocations - frame.line_begin_allocations;
+  frame.line_begin = now;
+  frame.line_begin_allocations = allocations;
+}
+
+void script_profiler::leave_line(call_frame& frame, clock::time_point now,
+                                 std::size_t allocations)
+{
+  account_line(frame, now, allocations);
+  frame.line = nullptr;
+}
+
+std::vector<std::pair<const sema::user_sema_function*,
+                      const script_profiler::function_record*>>
+script_profiler::sorted_records() const
+{
+  std::vector<
+    std::pair<const sema::user_sema_function*, const function_record*>>
+    result;
+  result.reserve(m_records.size());
+  for (const auto& [function, record] : m_records) {
+    result.emplace_back(function, &record);
+  }
+
+  std::sort(std::begin(result), std::end(result),
+            [](const auto& lhs, const auto& rhs) {
+              return lhs.second->stats.exclusive_time >
+                rhs.second->stats.exclusive_time;
+            });
+  return result;
+}
+
+void script_profiler::write_report(std::ostream& out) const
+{
+  const auto records = sorted_records();
+
+  std::vector<std::string> labels;
+  auto label_width = std::string_view{ "function" }.size();
+  for (const auto& [function, record] : records) {
+    labels.emplace_back(function_label(*function));
+    label_width = std::max(label_width, labels.back().size());
+  }
+  label_width += 2u;
+
+  const auto flags = out.flags();
+  const auto precision = out.precision();
+  out << std::fixed << std::setprecision(3);
+
+  out << std::left << std::setw(label_width) << "function" << std::right
+      << std::setw(10) << "calls" << std::setw(12) << "incl ms"
+      << std::setw(12) << "excl ms" << std::setw(14) << "incl allocs"
+      << std::setw(14) << "excl allocs" << '\n';
+  for (auto i = 0u; i < records.size(); ++i) {
+    const auto& stats = records[i].second->stats;
+    out << std::left << std::setw(label_width) << labels[i] << std::right
+        << std::setw(10) << stats.calls << std::setw(12)
+        << milliseconds(stats.inclusive_time) << std::setw(12)
+        << milliseconds(stats.exclusive_time) << std::setw(14)
+        << stats.inclusive_allocations << std::setw(14)
+        << stats.exclusive_allocations << '\n';
+  }
+
+  out << '\n'
+      << std::left << std::setw(label_width) << "line" << std::right
+      << std::setw(10) << "hits" << std::setw(12) << "ms" << std::setw(14)
+      << "allocs" << '\n';
+  for (const auto& [function, record] : records) {
+    const auto path = function->signature().name.source().path();
+    for (const auto& [line, stats] : sorted_lines(record->lines)) {
+      const auto label = std::string{ path } + ':' + std::to_string(line);
+      out << std::left << std::setw(label_width) << label << std::right
+          << std::setw(10) << stats->hits << std::setw(12)
+          << milliseconds(stats->time) << std::setw(14) << stats->allocations
+          << '\n';
+    }
+  }
+
+  out.flags(flags);
+  out.precision(precision);
+}
+
+void script_profiler::write_json(std::ostream& out) const
+{
+  out << "{\"functions\":[";
+  auto first_function = true;
+  for (const auto& [function, record] : sorted_records()) {
+    out << (first_function ? "\n" : ",\n");
+    first_function = false;
+
+    const auto& name = function->signature().name;
+    const auto& stats = record->stats;
+    out << "{\"name\":";
+    write_json_string(out, profiler::function_name(*function));
+    out << ",\"file\":";
+    write_json_string(out, name.source().path());
+    out << ",\"line\":" << name.src_range().begin.line
+        << ",\"calls\":" << stats.calls
+        << ",\"inclusive_us\":" << microseconds(stats.inclusive_time)
+        << ",\"exclusive_us\":" << microseconds(stats.exclusive_time)
+        << ",\"inclusive_allocations\":" << stats.inclusive_allocations
+        << ",\"exclusive_allocations\":" << stats.exclusive_allocations
+        << ",\"lines\":[";
+
+    auto first_line = true;
+    for (const auto& [line, line_record] : sorted_lines(record->lines)) {
+      out << (first_line ? "" : ",");
+      first_line = false;
+      out << "{\"line\":" << line << ",\"hits\":" << line_record->hits
+          << ",\"time_us\":" << microseconds(line_record->time)
+          << ",\"allocations\":" << line_record->allocations << '}';
+    }
+    out << "]}";
+  }
+  out << "\n]}\n";
+}
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <iosfwd>
+#include <unordered_map>
+#include <vector>
+
+namespace cmsl {
+namespace sema {
+class user_sema_function;
+}
+
+namespace exec {
+// Collects execution statistics of user functions and lines of their
+// bodies: number of calls, time and number of allocated instances.
+// Inclusive statistics of a function contain its callees, exclusive do not.
+// Lines are exclusive: time and allocations of a line last till the next
+// line of the same function call starts, including nested statements, like
+// bodies of loops, but calls made in the line are accounted to lines of the
+// callees. So lines of a function sum up to nearly its exclusive statistics.
+// Recursive calls are accounted to the inclusive statistics only once.
+// Functions are
+// referenced, so statistics have to be written before the executor, that
+// owns them, is destroyed.
+class script_profiler
+{
+public:
+  using clock = std::chrono::steady_clock;
+
+  struct function_stats
+  {
+    std::size_t calls{ 0u };
+    clock::duration inclusive_time{};
+    clock::duration exclusive_time{};
+    std::size_t inclusive_allocations{ 0u };
+    std::size_t exclusive_allocations{ 0u };
+  };
+
+  struct line_stats
+  {
+    std::size_t hits{ 0u };
+    clock::duration time{};
+    std::size_t allocations{ 0u };
+  };
+
+  void enter_function(const sema::user_sema_function& function);
+  void leave_function();
+  // Starts a line of the currently executed function. See
+  // sema::sema_node::statement_line().
+  void enter_line(unsigned line);
+
+  // Writes a table of functions, sorted by exclusive time, followed by a
+  // table of their lines.
+  void write_report(std::ostream& out) const;
+  void write_json(std::ostream& out) const;
+
+private:
+  struct function_record
+  {
+    function_stats stats;
+    std::unordered_map<unsigned, line_stats> lines;
+    // Number of calls that are currently executed.
+    unsigned active_calls{ 0u };
+  };
+
+  struct call_frame
+  {
+    function_record* record;
+    clock::time_point begin;
+    std::size_t begin_allocations;
+    clock::duration callees_time{};
+    std::size_t callees_allocations{ 0u };
+    // Null if no line of the call has started yet.
+    line_stats* line{ nullptr };
+    clock::time_point line_begin;
+    std::size_t line_begin_allocations{ 0u };
+  };
+
+  // Accounts the line of the frame till now, without leaving it.
+  void account_line(call_frame& frame, clock::time_point now,
+                    std::size_t allocations);
+  void leave_line(call_frame& frame, clock::time_point now,
+                  std::size_t allocations);
+
+  // Records sorted by exclusive time, the most expensive first.
+  std::vector<std::pair<const sema::user_sema_function*,
+                        const function_record*>>
+  sorted_records() const;
+
+private:
+  std::unordered_map<const sema::user_sema_function*, function_record>
+    m_records;
+  std::vector<call_frame> m_callstack;
+};
+}
+}
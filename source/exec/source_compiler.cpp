@@ -3,13 +3,16 @@
 #include "ast/parser.hpp"
 #include "common/source_view.hpp"
 #include "exec/compiled_source.hpp"
-#include "lexer/lexer.hpp"
+#include "exec/profiler.hpp"
 #include "sema/builtin_sema_context.hpp"
 #include "sema/builtin_token_provider.hpp"
+#include "sema/constant_folder.hpp"
+#include "sema/dumper.hpp"
 #include "sema/enum_values_context.hpp"
 #include "sema/factories.hpp"
 #include "sema/factories_provider.hpp"
 #include "sema/identifiers_context.hpp"
+#include "sema/lazy_function_bodies.hpp"
 #include "sema/qualified_contextes_refs.hpp"
 #include "sema/sema_builder.hpp"
 #include "sema/sema_node.hpp"
@@ -23,9 +26,9 @@ source_compiler::source_compiler(
   sema::add_declarative_file_semantic_handler& add_declarative_file_handler,
   sema::import_handler& imports_handler,
   sema::qualified_contextes_refs qualified_contextes,
-  sema::builtin_sema_context& builtin_context,
-  sema::builtin_token_provider& builtin_tokens,
-  strings_container& strings_container)
+  const sema::builtin_sema_context& builtin_context,
+  const sema::builtin_token_provider& builtin_tokens,
+  strings_container& strings_container, const options& opts)
   : m_errors_observer{ errors_observer }
   , m_factories_provider{ factories_provider }
   , m_add_subdirectory_handler{ add_subdirectory_handler }
@@ -35,19 +38,34 @@ source_compiler::source_compiler(
   , m_builtin_context{ builtin_context }
   , m_builtin_tokens{ builtin_tokens }
   , m_strings_container{ strings_container }
+  , m_profiler{ opts.profiler }
+  , m_lazy_bodies{ opts.lazy_bodies }
+  , m_defer_function_bodies{ opts.defer_function_bodies }
+  , m_dump_optimized{ opts.dump_optimized }
 {
 }
 
-std::unique_ptr<compiled_source> source_compiler::compile(source_view source)
+std::unique_ptr<compiled_source> source_compiler::compile(
+  source_view source, const lexer::token_container_t& tokens)
 {
-  lexer::lexer lex{ m_errors_observer, source };
-  const auto tokens = lex.lex();
-  ast::parser parser{ m_errors_observer, m_strings_container, source, tokens };
-  auto ast_tree = parser.parse_translation_unit();
+  auto ast_tree = [&] {
+    const profile_scope profile{ m_profiler, phase::parse, source.path() };
+    ast::parser parser{ m_errors_observer, m_strings_container, source,
+                        tokens };
+    return parser.parse_translation_unit();
+  }();
   if (!ast_tree) {
     return nullptr;
   }
 
+  return compile(source, std::move(ast_tree));
+}
+
+std::unique_ptr<compiled_source> source_compiler::compile(
+  source_view source, std::unique_ptr<ast::ast_node> ast_tree)
+{
+  const profile_scope profile{ m_profiler, phase::sema, source.path() };
+
   const auto builtin_types = m_builtin_context.builtin_types();
 
   auto& global_context =
@@ -60,9 +78,28 @@ std::unique_ptr<compiled_source> source_compiler::compile(source_view source)
                                    m_add_declarative_file_handler,
                                    m_imports_handler,
                                    m_builtin_tokens,
-                                   builtin_types };
+                                   builtin_types,
+                                   m_lazy_bodies,
+                                   m_defer_function_bodies };
   auto sema_tree = sema_builder.build(*ast_tree);
   if (!sema_tree) {
+    if (m_lazy_bodies != nullptr) {
+      m_lazy_bodies->discard(global_context);
+    }
+    return nullptr;
+  }
+
+  sema::constant_folder folder{ m_strings_container };
+  folder.fold(*sema_tree);
+
+  if (m_dump_optimized != nullptr) {
+    *m_dump_optimized << source.path() << '\n';
+    sema::dumper dumper{ *m_dump_optimized };
+    sema_tree->visit(dumper);
+  }
+
+  if (m_lazy_bodies != nullptr && !m_lazy_bodies->build_required()) {
+    m_lazy_bodies->discard(global_context);
     return nullptr;
   }
 
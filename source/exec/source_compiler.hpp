@@ -1,13 +1,19 @@
 #pragma once
 
+#include "lexer/token.hpp"
 #include "sema/qualified_contextes_refs.hpp"
 
+#include <iosfwd>
 #include <memory>
 
 namespace cmsl {
 class source_view;
 class strings_container;
 
+namespace ast {
+class ast_node;
+}
+
 namespace errors {
 class errors_observer;
 }
@@ -19,15 +25,33 @@ class builtin_sema_context;
 class builtin_token_provider;
 class factories_provider;
 class import_handler;
+class lazy_function_bodies;
 struct qualified_contextes_refs;
 }
 
 namespace exec {
 class compiled_source;
+class profiler;
 
 class source_compiler
 {
 public:
+  struct options
+  {
+    // Null if compilation is not profiled.
+    exec::profiler* profiler{ nullptr };
+    // Null if all function bodies are built eagerly.
+    sema::lazy_function_bodies* lazy_bodies{ nullptr };
+    // If set, bodies of functions of the compiled source are built only when
+    // they are required. See sema::lazy_function_bodies.
+    bool defer_function_bodies{ false };
+    // The sema tree is dumped to the stream, after the path of the source,
+    // right after constant folding. Bodies of functions that are built
+    // lazily are not dumped. Null if the tree is not dumped.
+    std::ostream* dump_optimized{ nullptr };
+  };
+
+  // Bodies required by the compiled source are built before it is returned.
   explicit source_compiler(
     errors::errors_observer& errors_observer,
     sema::factories_provider& factories_provider,
@@ -35,11 +59,15 @@ public:
     sema::add_declarative_file_semantic_handler& add_declarative_file_handler,
     sema::import_handler& imports_handler,
     sema::qualified_contextes_refs qualified_contextes,
-    sema::builtin_sema_context& builtin_context,
-    sema::builtin_token_provider& builtin_tokens,
-    strings_container& strings_container);
+    const sema::builtin_sema_context& builtin_context,
+    const sema::builtin_token_provider& builtin_tokens,
+    strings_container& strings_container, const options& opts);
 
-  std::unique_ptr<compiled_source> compile(source_view source);
+  std::unique_ptr<compiled_source> compile(
+    source_view source, const lexer::token_container_t& tokens);
+  // Compiles a source that has already been parsed.
+  std::unique_ptr<compiled_source> compile(
+    source_view source, std::unique_ptr<ast::ast_node> ast_tree);
 
 private:
   errors::errors_observer& m_errors_observer;
@@ -48,9 +76,16 @@ private:
   sema::add_declarative_file_semantic_handler& m_add_declarative_file_handler;
   sema::import_handler& m_imports_handler;
   sema::qualified_contextes_refs m_qualified_contextes;
-  sema::builtin_sema_context& m_builtin_context;
-  sema::builtin_token_provider& m_builtin_tokens;
+  const sema::builtin_sema_context& m_builtin_context;
+  const sema::builtin_token_provider& m_builtin_tokens;
   strings_container& m_strings_container;
+  // Null if compilation is not profiled.
+  profiler* m_profiler;
+  // Null if all function bodies are built eagerly.
+  sema::lazy_function_bodies* m_lazy_bodies;
+  bool m_defer_function_bodies;
+  // Null if the tree is not dumped.
+  std::ostream* m_dump_optimized;
 };
 }
 }
@@ -0,0 +1,213 @@
+#include "exec/source_prefetcher.hpp"
+
+#include "ast/ast_node.hpp"
+#include "ast/parser.hpp"
+#include "common/source_view.hpp"
+#include "errors/errors_observer.hpp"
+#include "exec/compilation_cache.hpp"
+#include "lexer/lexer.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace cmsl::exec {
+namespace {
+std::string string_literal_value(const lexer::token& token)
+{
+  // Token contains the quotation marks.
+  const auto str = token.str();
+  return std::string{ str.substr(1u, str.size() - 2u) };
+}
+
+bool is_declarative(const std::string& path)
+{
+  const auto extension = cmsl::string_view{ ".dcmsl" };
+  return path.size() >= extension.size() &&
+    path.compare(path.size() - extension.size(), extension.size(),
+                 extension.data()) == 0;
+}
+}
+
+source_prefetcher::source_prefetcher(std::string imports_root_dir,
+                                     unsigned threads_count,
+                                     compilation_cache* cache)
+  : m_imports_root_dir{ std::move(imports_root_dir) }
+  , m_cache{ cache }
+{
+  for (auto i = 0u; i < threads_count; ++i) {
+    m_workers.emplace_back([this] { work(); });
+  }
+}
+
+source_prefetcher::~source_prefetcher()
+{
+  {
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    m_stopping = true;
+  }
+  m_jobs_available.notify_all();
+
+  for (auto& worker : m_workers) {
+    worker.join();
+  }
+}
+
+void source_prefetcher::prefetch_referenced(
+  const lexer::token_container_t& tokens, const std::string& directory)
+{
+  using token_type_t = lexer::token_type;
+
+  for (auto i = 0u; i + 1u < tokens.size(); ++i) {
+    const auto& token = tokens[i];
+    if (token.get_type() == token_type_t::kw_import &&
+        tokens[i + 1u].get_type() == token_type_t::string) {
+      const auto path =
+        m_imports_root_dir + '/' + string_literal_value(tokens[i + 1u]);
+      schedule({ path }, m_imports_root_dir);
+    } else if (token.get_type() == token_type_t::identifier &&
+               token.str() == "add_subdirectory" && i + 2u < tokens.size() &&
+               tokens[i + 1u].get_type() == token_type_t::open_paren &&
+               tokens[i + 2u].get_type() == token_type_t::string) {
+      const auto subdirectory =
+        directory + '/' + string_literal_value(tokens[i + 2u]);
+      // Same precedence as in global_executor::handle_add_subdirectory.
+      schedule({ subdirectory + "/CMakeLists.dcmsl",
+                 subdirectory + "/CMakeLists.cmsl" },
+               subdirectory);
+    }
+  }
+}
+
+const source_prefetcher::prefetched_source* source_prefetcher::take(
+  const std::string& path)
+{
+  std::unique_lock<std::mutex> lock{ m_mutex };
+  return wait_for(lock, path);
+}
+
+std::unique_ptr<ast::ast_node> source_prefetcher::take_ast(
+  const std::string& path)
+{
+  std::unique_lock<std::mutex> lock{ m_mutex };
+  const auto prefetched = wait_for(lock, path);
+  return prefetched != nullptr ? std::move(prefetched->ast) : nullptr;
+}
+
+source_prefetcher::prefetched_source* source_prefetcher::wait_for(
+  std::unique_lock<std::mutex>& lock, const std::string& path)
+{
+  const auto found = m_jobs_by_path.find(path);
+  if (found == std::cend(m_jobs_by_path)) {
+    return nullptr;
+  }
+
+  auto& j = *found->second;
+  m_job_done.wait(lock, [&j] { return j.done; });
+
+  if (j.result == nullptr || j.result->path != path) {
+    return nullptr;
+  }
+
+  return j.result.get();
+}
+
+void source_prefetcher::schedule(std::vector<std::string> paths,
+                                 std::string directory)
+{
+  {
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    if (m_jobs_by_path.find(paths.front()) != std::cend(m_jobs_by_path)) {
+      return;
+    }
+
+    auto j = std::make_unique<job>();
+    j->paths = std::move(paths);
+    j->directory = std::move(directory);
+    for (const auto& path : j->paths) {
+      m_jobs_by_path.emplace(path, j.get());
+    }
+    m_queue.emplace_back(j.get());
+    m_jobs.emplace_back(std::move(j));
+  }
+
+  m_jobs_available.notify_one();
+}
+
+void source_prefetcher::work()
+{
+  while (true) {
+    job* j;
+    {
+      std::unique_lock<std::mutex> lock{ m_mutex };
+      m_jobs_available.wait(lock,
+                            [this] { return m_stopping || !m_queue.empty(); });
+      if (m_stopping) {
+        return;
+      }
+
+      j = m_queue.front();
+      m_queue.pop_front();
+    }
+
+    run(*j);
+
+    {
+      std::lock_guard<std::mutex> lock{ m_mutex };
+      j->done = true;
+    }
+    m_job_done.notify_all();
+  }
+}
+
+void source_prefetcher::run(job& j)
+{
+  for (const auto& path : j.paths) {
+    std::ifstream file{ path };
+    if (!file.is_open()) {
+      continue;
+    }
+
+    auto result = std::make_unique<prefetched_source>();
+    result->path = path;
+    result->source =
+      std::string(std::istreambuf_iterator<char>{ file }, {});
+
+    const auto view = source_view{ result->path, result->source };
+    result->registration = source_files::registration{ view };
+    const auto source_id = result->registration.id();
+    // Errors are not reported from here. A source with lexing errors is
+    // dropped, and a tree with parsing errors is not kept, so the source is
+    // processed again, and its errors are reported, when it is compiled.
+    std::ostringstream errors_out;
+    errors::errors_observer errs{ errors_out };
+    auto cached =
+      m_cache != nullptr ? m_cache->load(view, source_id) : std::nullopt;
+    if (cached) {
+      result->tokens = std::move(*cached);
+    } else {
+      lexer::lexer lex{ errs, view, source_id };
+      result->tokens = lex.lex();
+      if (lex.has_errors()) {
+        return;
+      }
+
+      if (m_cache != nullptr) {
+        m_cache->store(view, result->tokens);
+      }
+    }
+
+    prefetch_referenced(result->tokens, j.directory);
+
+    if (!is_declarative(path)) {
+      ast::parser parser{ errs, result->strings, view, result->tokens };
+      result->ast = parser.parse_translation_unit();
+      if (errs.notified_count() != 0u) {
+        result->ast = nullptr;
+      }
+    }
+    j.result = std::move(result);
+    return;
+  }
+}
+}
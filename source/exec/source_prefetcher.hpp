@@ -0,0 +1,102 @@
+#pragma once
+
+#include "common/strings_container_impl.hpp"
+#include "lexer/token.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace cmsl {
+namespace ast {
+class ast_node;
+}
+
+namespace exec {
+class compilation_cache;
+
+// Loads, lexes and parses scripts of subdirectories and imported modules on
+// worker threads, before the compilation of their parent asks for them. Lexed
+// sources are scanned for add_subdirectory("name" and import "path" tokens,
+// so the whole tree is discovered without waiting for the parent's sema.
+// Sema still runs on the calling thread, in the usual order, because it is
+// driven by the add_subdirectory and import handlers and shares factories
+// and contexts of the executor. Declarative scripts are not parsed.
+class source_prefetcher
+{
+public:
+  struct prefetched_source
+  {
+    std::string path;
+    std::string source;
+    // Tokens point into the source through the registration.
+    source_files::registration registration;
+    lexer::token_container_t tokens;
+    // Strings stored while parsing, viewed by the parsed tree.
+    strings_container_impl strings;
+    // Null if the script is declarative, contains parsing errors, or the tree
+    // has been taken.
+    std::unique_ptr<ast::ast_node> ast;
+  };
+
+  // Imports are resolved relatively to imports_root_dir, the same way as
+  // global_executor does. Cache can be null.
+  explicit source_prefetcher(std::string imports_root_dir,
+                             unsigned threads_count,
+                             compilation_cache* cache);
+  ~source_prefetcher();
+
+  // Schedules prefetching of scripts referenced by tokens of a script placed
+  // in directory.
+  void prefetch_referenced(const lexer::token_container_t& tokens,
+                           const std::string& directory);
+
+  // Waits for the source if it has been scheduled. Returns null if it has not
+  // been scheduled, it could not be read, or it contains lexing errors.
+  // Returned source lives as long as the prefetcher.
+  const prefetched_source* take(const std::string& path);
+
+  // Takes the parsed tree of the source, if it has been scheduled and parsed
+  // without errors. Strings viewed by the tree live as long as the
+  // prefetcher.
+  std::unique_ptr<ast::ast_node> take_ast(const std::string& path);
+
+private:
+  struct job
+  {
+    // Candidate paths, in order of precedence. The first existing one is
+    // loaded.
+    std::vector<std::string> paths;
+    std::string directory;
+    bool done{ false };
+    std::unique_ptr<prefetched_source> result;
+  };
+
+  // Waits for the job of the path. Returns null in the same cases as take().
+  prefetched_source* wait_for(std::unique_lock<std::mutex>& lock,
+                              const std::string& path);
+  void schedule(std::vector<std::string> paths, std::string directory);
+  void work();
+  void run(job& j);
+
+private:
+  const std::string m_imports_root_dir;
+  compilation_cache* m_cache;
+
+  std::mutex m_mutex;
+  std::condition_variable m_jobs_available;
+  std::condition_variable m_job_done;
+  std::deque<job*> m_queue;
+  std::vector<std::unique_ptr<job>> m_jobs;
+  std::unordered_map<std::string, job*> m_jobs_by_path;
+  bool m_stopping{ false };
+
+  std::vector<std::thread> m_workers;
+};
+}
+}
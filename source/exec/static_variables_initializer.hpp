@@ -36,6 +36,12 @@ public:
     return found == std::cend(m_instances) ? nullptr : found->second.get();
   }
 
+  inst::instance* lookup_local_variable(unsigned) override
+  {
+    // Static variables are initialized outside of any function.
+    return nullptr;
+  }
+
   inst::instance* get_class_instance() override { return nullptr; }
 
   void visit(const sema::variable_declaration_node& node) override
@@ -0,0 +1,339 @@
+#include "exec/unboxed_evaluator.hpp"
+
+#include "common/assert.hpp"
+#include "common/overloaded.hpp"
+#include "exec/expression_evaluation_context.hpp"
+#include "exec/expression_evaluation_visitor.hpp"
+#include "exec/identifiers_context.hpp"
+#include "exec/instance/instance.hpp"
+#include "exec/instance/instances_holder_interface.hpp"
+#include "sema/sema_nodes.hpp"
+
+#include "cmake_facade.hpp"
+
+namespace cmsl::exec {
+namespace {
+using kind_t = sema::builtin_function_kind;
+
+bool modifies_operand(kind_t operation)
+{
+  switch (operation) {
+    case kind_t::bool_operator_equal:
+    case kind_t::int_operator_unary_plusplus:
+    case kind_t::int_operator_unary_minusminus:
+    case kind_t::int_operator_equal:
+    case kind_t::int_operator_plus_equal:
+    case kind_t::int_operator_minus_equal:
+    case kind_t::int_operator_star_equal:
+    case kind_t::int_operator_slash_equal:
+    case kind_t::double_operator_unary_plusplus:
+    case kind_t::double_operator_unary_minusminus:
+    case kind_t::double_operator_equal:
+    case kind_t::double_operator_plus_equal:
+    case kind_t::double_operator_minus_equal:
+    case kind_t::double_operator_star_equal:
+    case kind_t::double_operator_slash_equal:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+unboxed_evaluator::value_t to_value(const inst::instance& instance)
+{
+  const auto& value = instance.value_cref();
+  switch (value.which()) {
+    case inst::instance_value_alternative::bool_:
+      return value.get_bool();
+    case inst::instance_value_alternative::int_:
+      return value.get_int();
+    case inst::instance_value_alternative::double_:
+      return value.get_double();
+
+    default:
+      CMSL_UNREACHABLE("Unboxed evaluation of a non int, double or bool");
+      return {};
+  }
+}
+}
+
+unboxed_evaluator::unboxed_evaluator(expression_evaluation_context& ctx)
+  : m_ctx{ ctx }
+{
+}
+
+bool unboxed_evaluator::is_unboxed_operation(const sema::sema_node& node)
+{
+  if (auto binary = dynamic_cast<const sema::binary_operator_node*>(&node)) {
+    return binary->unboxed_operation().has_value();
+  }
+  if (auto unary = dynamic_cast<const sema::unary_operator_node*>(&node)) {
+    return unary->unboxed_operation().has_value();
+  }
+
+  return false;
+}
+
+unboxed_evaluator::value_t unboxed_evaluator::evaluate(
+  const sema::sema_node& node)
+{
+  m_evaluated = false;
+  node.visit(*this);
+  if (m_evaluated) {
+    return m_result;
+  }
+
+  m_modified = nullptr;
+  const auto instance = evaluate_boxed(node);
+  if (instance == nullptr) {
+    return value_t{};
+  }
+
+  return to_value(*instance);
+}
+
+void unboxed_evaluator::execute(const sema::sema_node& node)
+{
+  if (is_unboxed_operation(node)) {
+    (void)evaluate(node);
+  } else {
+    (void)evaluate_boxed(node);
+  }
+}
+
+inst::instance* unboxed_evaluator::evaluate_to_instance(
+  const sema::sema_node& node)
+{
+  const auto value = evaluate(node);
+  if (m_ctx.cmake_facade.did_fatal_error_occure()) {
+    return nullptr;
+  }
+
+  if (m_modified != nullptr) {
+    return m_ctx.instances.create_reference(*m_modified);
+  }
+
+  return std::visit(
+    [this](auto val) { return m_ctx.instances.create(val); }, value);
+}
+
+void unboxed_evaluator::visit(const sema::binary_operator_node& node)
+{
+  const auto& operation = node.unboxed_operation();
+  if (!operation) {
+    return;
+  }
+
+  if (modifies_operand(*operation)) {
+    const auto lhs = evaluate_boxed(node.lhs());
+    if (lhs == nullptr) {
+      set_result(value_t{});
+      return;
+    }
+
+    const auto rhs = evaluate(node.rhs());
+    if (m_ctx.cmake_facade.did_fatal_error_occure()) {
+      set_result(value_t{});
+      return;
+    }
+
+    modify(*lhs, apply(*operation, to_value(*lhs), rhs));
+    return;
+  }
+
+  const auto lhs = evaluate(node.lhs());
+  if (m_ctx.cmake_facade.did_fatal_error_occure()) {
+    set_result(value_t{});
+    return;
+  }
+
+  const auto rhs = evaluate(node.rhs());
+  if (m_ctx.cmake_facade.did_fatal_error_occure()) {
+    set_result(value_t{});
+    return;
+  }
+
+  set_result(apply(*operation, lhs, rhs));
+}
+
+void unboxed_evaluator::visit(const sema::unary_operator_node& node)
+{
+  const auto& operation = node.unboxed_operation();
+  if (!operation) {
+    return;
+  }
+
+  if (modifies_operand(*operation)) {
+    const auto operand = evaluate_boxed(node.expression());
+    if (operand == nullptr) {
+      set_result(value_t{});
+      return;
+    }
+
+    modify(*operand, apply(*operation, to_value(*operand), value_t{}));
+    return;
+  }
+
+  const auto operand = evaluate(node.expression());
+  if (m_ctx.cmake_facade.did_fatal_error_occure()) {
+    set_result(value_t{});
+    return;
+  }
+
+  set_result(apply(*operation, operand, value_t{}));
+}
+
+void unboxed_evaluator::visit(const sema::bool_value_node& node)
+{
+  set_result(node.value());
+}
+
+void unboxed_evaluator::visit(const sema::int_value_node& node)
+{
+  set_result(node.value());
+}
+
+void unboxed_evaluator::visit(const sema::double_value_node& node)
+{
+  set_result(node.value());
+}
+
+void unboxed_evaluator::visit(const sema::id_node& node)
+{
+  const auto& slot = node.slot();
+  const auto instance = slot
+    ? m_ctx.ids_context.lookup_local_variable(slot->index)
+    : m_ctx.ids_context.lookup_identifier(node.index());
+  set_result(to_value(*instance));
+}
+
+void unboxed_evaluator::visit(const sema::cast_to_reference_node& node)
+{
+  set_result(evaluate(node.expression()));
+}
+
+void unboxed_evaluator::visit(const sema::cast_to_value_node& node)
+{
+  set_result(evaluate(node.expression()));
+}
+
+inst::instance* unboxed_evaluator::evaluate_boxed(const sema::sema_node& node)
+{
+  expression_evaluation_visitor visitor{ m_ctx };
+  node.visit(visitor);
+  if (m_ctx.cmake_facade.did_fatal_error_occure()) {
+    return nullptr;
+  }
+
+  return visitor.result;
+}
+
+void unboxed_evaluator::set_result(value_t value)
+{
+  m_result = value;
+  m_evaluated = true;
+  m_modified = nullptr;
+}
+
+void unboxed_evaluator::modify(inst::instance& instance, value_t value)
+{
+  std::visit(overloaded{
+               [&instance](bool val) {
+                 instance.value_accessor().access().set_bool(val);
+               },
+               [&instance](int_t val) {
+                 instance.value_accessor().access().set_int(val);
+               },
+               [&instance](double val) {
+                 instance.value_accessor().access().set_double(val);
+               } },
+             value);
+
+  m_result = value;
+  m_evaluated = true;
+  m_modified = &instance;
+}
+
+unboxed_evaluator::value_t unboxed_evaluator::apply(kind_t operation,
+                                                    value_t lhs,
+                                                    value_t rhs) const
+{
+  switch (operation) {
+    case kind_t::bool_operator_equal:
+      return std::get<bool>(rhs);
+    case kind_t::bool_operator_equal_equal:
+      return std::get<bool>(lhs) == std::get<bool>(rhs);
+    case kind_t::bool_operator_pipe_pipe:
+      return std::get<bool>(lhs) || std::get<bool>(rhs);
+    case kind_t::bool_operator_amp_amp:
+      return std::get<bool>(lhs) && std::get<bool>(rhs);
+    case kind_t::bool_operator_unary_exclaim:
+      return !std::get<bool>(lhs);
+
+    case kind_t::int_operator_plus:
+    case kind_t::int_operator_plus_equal:
+      return std::get<int_t>(lhs) + std::get<int_t>(rhs);
+    case kind_t::int_operator_unary_plusplus:
+      return int_t{ std::get<int_t>(lhs) + 1 };
+    case kind_t::int_operator_minus:
+    case kind_t::int_operator_minus_equal:
+      return std::get<int_t>(lhs) - std::get<int_t>(rhs);
+    case kind_t::int_operator_unary_minus:
+      return -1 * std::get<int_t>(lhs);
+    case kind_t::int_operator_unary_minusminus:
+      return int_t{ std::get<int_t>(lhs) - 1 };
+    case kind_t::int_operator_star:
+    case kind_t::int_operator_star_equal:
+      return std::get<int_t>(lhs) * std::get<int_t>(rhs);
+    case kind_t::int_operator_slash:
+    case kind_t::int_operator_slash_equal:
+      return std::get<int_t>(lhs) / std::get<int_t>(rhs);
+    case kind_t::int_operator_equal:
+      return std::get<int_t>(rhs);
+    case kind_t::int_operator_less:
+      return std::get<int_t>(lhs) < std::get<int_t>(rhs);
+    case kind_t::int_operator_less_equal:
+      return std::get<int_t>(lhs) <= std::get<int_t>(rhs);
+    case kind_t::int_operator_greater:
+      return std::get<int_t>(lhs) > std::get<int_t>(rhs);
+    case kind_t::int_operator_greater_equal:
+      return std::get<int_t>(lhs) >= std::get<int_t>(rhs);
+    case kind_t::int_operator_equal_equal:
+      return std::get<int_t>(lhs) == std::get<int_t>(rhs);
+
+    case kind_t::double_operator_plus:
+    case kind_t::double_operator_plus_equal:
+      return std::get<double>(lhs) + std::get<double>(rhs);
+    case kind_t::double_operator_unary_plusplus:
+      return std::get<double>(lhs) + 1.0;
+    case kind_t::double_operator_minus:
+    case kind_t::double_operator_minus_equal:
+      return std::get<double>(lhs) - std::get<double>(rhs);
+    case kind_t::double_operator_unary_minus:
+      return -1 * std::get<double>(lhs);
+    case kind_t::double_operator_unary_minusminus:
+      return std::get<double>(lhs) - 1.0;
+    case kind_t::double_operator_star:
+    case kind_t::double_operator_star_equal:
+      return std::get<double>(lhs) * std::get<double>(rhs);
+    case kind_t::double_operator_slash:
+    case kind_t::double_operator_slash_equal:
+      return std::get<double>(lhs) / std::get<double>(rhs);
+    case kind_t::double_operator_equal:
+      return std::get<double>(rhs);
+    case kind_t::double_operator_less:
+      return std::get<double>(lhs) < std::get<double>(rhs);
+    case kind_t::double_operator_less_equal:
+      return std::get<double>(lhs) <= std::get<double>(rhs);
+    case kind_t::double_operator_greater:
+      return std::get<double>(lhs) > std::get<double>(rhs);
+    case kind_t::double_operator_greater_equal:
+      return std::get<double>(lhs) >= std::get<double>(rhs);
+
+    default:
+      CMSL_UNREACHABLE("Not an unboxed operation");
+      return value_t{};
+  }
+}
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "common/int_alias.hpp"
+#include "sema/builtin_function_kind.hpp"
+#include "sema/sema_node_visitor.hpp"
+
+#include <variant>
+
+namespace cmsl {
+namespace sema {
+class sema_node;
+}
+
+namespace exec {
+struct expression_evaluation_context;
+
+namespace inst {
+class instance;
+}
+
+// Evaluates operators marked by sema as unboxed operations directly on int,
+// double and bool values. Instances are created only for the final result,
+// and only if it is needed. Nodes that can not be evaluated this way are
+// delegated to the expression_evaluation_visitor.
+class unboxed_evaluator : public sema::empty_sema_node_visitor
+{
+public:
+  using value_t = std::variant<bool, int_t, double>;
+
+  explicit unboxed_evaluator(expression_evaluation_context& ctx);
+
+  static bool is_unboxed_operation(const sema::sema_node& node);
+
+  // Node has to be of int, double or bool type. Returns a default value if
+  // a fatal error occurred.
+  value_t evaluate(const sema::sema_node& node);
+
+  // Evaluates node and discards its result.
+  void execute(const sema::sema_node& node);
+
+  // Returns nullptr if a fatal error occurred.
+  inst::instance* evaluate_to_instance(const sema::sema_node& node);
+
+  void visit(const sema::binary_operator_node& node) override;
+  void visit(const sema::bool_value_node& node) override;
+  void visit(const sema::cast_to_reference_node& node) override;
+  void visit(const sema::cast_to_value_node& node) override;
+  void visit(const sema::double_value_node& node) override;
+  void visit(const sema::id_node& node) override;
+  void visit(const sema::int_value_node& node) override;
+  void visit(const sema::unary_operator_node& node) override;
+
+private:
+  inst::instance* evaluate_boxed(const sema::sema_node& node);
+  void set_result(value_t value);
+  void modify(inst::instance& instance, value_t value);
+
+  value_t apply(sema::builtin_function_kind operation, value_t lhs,
+                value_t rhs) const;
+
+private:
+  expression_evaluation_context& m_ctx;
+  value_t m_result;
+  bool m_evaluated{ false };
+  // Instance modified by the last evaluated operator, e.g. +=.
+  inst::instance* m_modified{ nullptr };
+};
+}
+}
@@ -1,64 +1,387 @@
 #include "lexer/lexer.hpp"
-#include "common/algorithm.hpp"
+#include "common/assert.hpp"
 #include "errors/error.hpp"
 #include "errors/errors_observer.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cassert>
-#include <cctype>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace cmsl::lexer {
+namespace {
+enum char_class : std::uint8_t
+{
+  whitespace = 1u << 0u,
+  digit = 1u << 1u,
+  identifier_start = 1u << 2u,
+  identifier_char = 1u << 3u,
+  arithmetical = 1u << 4u
+};
+
+constexpr std::array<std::uint8_t, 256u> make_char_classes()
+{
+  std::array<std::uint8_t, 256u> classes{};
+
+  for (const auto c : cmsl::string_view{ " \t\n\r" }) {
+    classes[static_cast<unsigned char>(c)] |= whitespace;
+  }
+  for (auto c = '0'; c <= '9'; ++c) {
+    classes[static_cast<unsigned char>(c)] |= digit;
+  }
+  for (auto c = 'a'; c <= 'z'; ++c) {
+    classes[static_cast<unsigned char>(c)] |= identifier_start;
+    classes[static_cast<unsigned char>(c - 'a' + 'A')] |= identifier_start;
+  }
+  classes['_'] |= identifier_start;
+  for (auto& cls : classes) {
+    if (cls & (digit | identifier_start)) {
+      cls |= identifier_char;
+    }
+  }
+  for (const auto c : cmsl::string_view{ "-+&|/*%!^<>" }) {
+    classes[static_cast<unsigned char>(c)] |= arithmetical;
+  }
+
+  return classes;
+}
+
+constexpr auto char_classes = make_char_classes();
+
+bool is_of_class(char c, char_class cls)
+{
+  return (char_classes[static_cast<unsigned char>(c)] & cls) != 0u;
+}
+
+constexpr std::array<token_type, 256u> make_one_char_tokens()
+{
+  std::array<token_type, 256u> tokens{};
+  for (auto& t : tokens) {
+    t = token_type::undef;
+  }
+
+  tokens['('] = token_type::open_paren;
+  tokens[')'] = token_type::close_paren;
+  tokens['{'] = token_type::open_brace;
+  tokens['}'] = token_type::close_brace;
+  tokens['['] = token_type::open_square;
+  tokens[']'] = token_type::close_square;
+  tokens[';'] = token_type::semicolon;
+  tokens['?'] = token_type::question;
+  tokens[','] = token_type::comma;
+
+  return tokens;
+}
+
+constexpr auto one_char_tokens = make_one_char_tokens();
+
+struct arithmetical_token_definition
+{
+  token_type single{ token_type::undef };
+  token_type op_equal{ token_type::undef };
+  token_type twice{ token_type::undef };
+
+  constexpr bool has_twice() const { return twice != token_type::undef; }
+};
+
+constexpr std::array<arithmetical_token_definition, 256u>
+make_arithmetical_token_definitions()
+{
+  using def_t = arithmetical_token_definition;
+
+  std::array<def_t, 256u> definitions{};
+
+  definitions['-'] =
+    def_t{ token_type::minus, token_type::minusequal, token_type::minusminus };
+  definitions['+'] =
+    def_t{ token_type::plus, token_type::plusequal, token_type::plusplus };
+  definitions['&'] =
+    def_t{ token_type::amp, token_type::ampequal, token_type::ampamp };
+  definitions['|'] =
+    def_t{ token_type::pipe, token_type::pipeequal, token_type::pipepipe };
+  definitions['/'] = def_t{ token_type::slash, token_type::slashequal };
+  definitions['*'] = def_t{ token_type::star, token_type::starequal };
+  definitions['%'] = def_t{ token_type::percent, token_type::percentequal };
+  definitions['!'] = def_t{ token_type::exclaim, token_type::exclaimequal };
+  definitions['^'] = def_t{ token_type::xor_, token_type::xorequal };
+  definitions['<'] = def_t{ token_type::less, token_type::lessequal };
+  definitions['>'] = def_t{ token_type::greater, token_type::greaterequal };
+
+  return definitions;
+}
+
+constexpr auto arithmetical_token_definitions =
+  make_arithmetical_token_definitions();
+
+struct keyword
+{
+  cmsl::string_view name;
+  token_type type{ token_type::undef };
+};
+
+constexpr keyword keywords[] = {
+  { "void", token_type::kw_void },
+  { "int", token_type::kw_int },
+  { "double", token_type::kw_double },
+  { "bool", token_type::kw_bool },
+  { "true", token_type::kw_true },
+  { "false", token_type::kw_false },
+  { "string", token_type::kw_string },
+  { "version", token_type::kw_version },
+  { "list", token_type::kw_list },
+  { "extern", token_type::kw_extern },
+  { "library", token_type::kw_library },
+  { "executable", token_type::kw_executable },
+  { "project", token_type::kw_project },
+  { "option", token_type::kw_option },
+  { "return", token_type::kw_return },
+  { "class", token_type::kw_class },
+  { "enum", token_type::kw_enum },
+  { "if", token_type::kw_if },
+  { "else", token_type::kw_else },
+  { "while", token_type::kw_while },
+  { "auto", token_type::kw_auto },
+  { "for", token_type::kw_for },
+  { "break", token_type::kw_break },
+  { "namespace", token_type::kw_namespace },
+  { "import", token_type::kw_import },
+  { "export", token_type::kw_export }
+};
+
+// Perfect hash of the keywords. The constants have been found by a brute
+// force search. If a keyword is added, the static_assert below tells whether
+// they need to be searched for again.
+constexpr auto keywords_table_size = std::size_t{ 64u };
+
+constexpr std::size_t keyword_hash(cmsl::string_view name)
+{
+  return (name.size() * 2u + static_cast<unsigned char>(name.front()) * 9u +
+          static_cast<unsigned char>(name.back())) %
+    keywords_table_size;
+}
+
+struct keywords_table
+{
+  std::array<keyword, keywords_table_size> slots{};
+  bool perfect{ true };
+};
+
+constexpr keywords_table make_keywords_table()
+{
+  keywords_table table{};
+  for (const auto& kw : keywords) {
+    auto& slot = table.slots[keyword_hash(kw.name)];
+    if (slot.type != token_type::undef) {
+      table.perfect = false;
+    }
+    slot = kw;
+  }
+  return table;
+}
+
+constexpr auto keywords_lookup = make_keywords_table();
+static_assert(keywords_lookup.perfect, "Keywords hash has collisions");
+
+token_type keyword_or_identifier(cmsl::string_view name)
+{
+  const auto& slot = keywords_lookup.slots[keyword_hash(name)];
+  return slot.name == name ? slot.type : token_type::identifier;
+}
+
+// Scanning helpers. Each of them returns the offset of the first char, at or
+// after offset, that the scan stops at, or size if there is none.
+
+std::size_t skip_whitespaces(const char* data, std::size_t offset,
+                             std::size_t size)
+{
+#if defined(__SSE2__)
+  const auto space = _mm_set1_epi8(' ');
+  const auto tab = _mm_set1_epi8('\t');
+  const auto new_line = _mm_set1_epi8('\n');
+  const auto carriage_return = _mm_set1_epi8('\r');
+  while (offset + 16u <= size) {
+    const auto chunk =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+    const auto ws = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+      _mm_or_si128(_mm_cmpeq_epi8(chunk, new_line),
+                   _mm_cmpeq_epi8(chunk, carriage_return)));
+    const auto ws_mask = static_cast<unsigned>(_mm_movemask_epi8(ws));
+    const auto not_ws = ~ws_mask & 0xffffu;
+    if (not_ws != 0u) {
+      return offset + __builtin_ctz(not_ws);
+    }
+    offset += 16u;
+  }
+#endif
+
+  while (offset < size && is_of_class(data[offset], whitespace)) {
+    ++offset;
+  }
+  return offset;
+}
+
+std::size_t skip_identifier_chars(const char* data, std::size_t offset,
+                                  std::size_t size)
+{
+#if defined(__SSE2__)
+  // Bytes are compared as signed, so non ASCII chars never fall in a range.
+  const auto in_range = [](__m128i chunk, char low, char high) {
+    return _mm_and_si128(_mm_cmpgt_epi8(chunk, _mm_set1_epi8(low - 1)),
+                         _mm_cmpgt_epi8(_mm_set1_epi8(high + 1), chunk));
+  };
+  const auto to_lower = _mm_set1_epi8(0x20);
+  const auto underscore = _mm_set1_epi8('_');
+  while (offset + 16u <= size) {
+    const auto chunk =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+    const auto letter = in_range(_mm_or_si128(chunk, to_lower), 'a', 'z');
+    const auto digit_or_underscore = _mm_or_si128(
+      in_range(chunk, '0', '9'), _mm_cmpeq_epi8(chunk, underscore));
+    const auto id = _mm_or_si128(letter, digit_or_underscore);
+    const auto id_mask = static_cast<unsigned>(_mm_movemask_epi8(id));
+    const auto not_id = ~id_mask & 0xffffu;
+    if (not_id != 0u) {
+      return offset + __builtin_ctz(not_id);
+    }
+    offset += 16u;
+  }
+#endif
+
+  while (offset < size && is_of_class(data[offset], identifier_char)) {
+    ++offset;
+  }
+  return offset;
+}
+
+// Finds a quotation mark or a backslash.
+std::size_t find_string_special_char(const char* data, std::size_t offset,
+                                     std::size_t size)
+{
+#if defined(__SSE2__)
+  const auto quote = _mm_set1_epi8('"');
+  const auto backslash = _mm_set1_epi8('\\');
+  while (offset + 16u <= size) {
+    const auto chunk =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+    const auto special = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                      _mm_cmpeq_epi8(chunk, backslash));
+    const auto mask = static_cast<unsigned>(_mm_movemask_epi8(special));
+    if (mask != 0u) {
+      return offset + __builtin_ctz(mask);
+    }
+    offset += 16u;
+  }
+#endif
+
+  while (offset < size && data[offset] != '"' && data[offset] != '\\') {
+    ++offset;
+  }
+  return offset;
+}
+
+std::size_t find_char(const char* data, std::size_t offset, std::size_t size,
+                      char c)
+{
+  if (offset >= size) {
+    return size;
+  }
+
+  const auto found = static_cast<const char*>(
+    std::memchr(data + offset, c, size - offset));
+  return found != nullptr ? static_cast<std::size_t>(found - data) : size;
+}
+}
+
 lexer::lexer(errors::errors_observer& err_observer, source_t source)
   : m_err_observer{ err_observer }
   , m_source{ source }
-  , m_source_loc{ m_source.source() }
-  , m_aritmetical_token_definitions{ create_arithmetical_token_definitions() }
-  , m_one_char_tokens{ create_one_char_tokens() }
-  , m_keyword_tokens{ create_keyword_tokens() }
+  , m_data{ m_source.source().data() }
+  , m_size{ m_source.source().size() }
+  , m_registration{ m_source }
+  , m_source_id{ m_registration.id() }
+{
+}
+
+lexer::lexer(errors::errors_observer& err_observer, source_t source,
+             source_files::id_t source_id)
+  : m_err_observer{ err_observer }
+  , m_source{ source }
+  , m_data{ m_source.source().data() }
+  , m_size{ m_source.source().size() }
+  , m_source_id{ source_id }
 {
 }
 
 std::vector<token> lexer::lex()
 {
   auto tokens = std::vector<token>{};
+  // Rough estimation, to avoid most of the reallocations.
+  tokens.reserve(m_size / 4u);
+
+  while (const auto t = lex_next()) {
+    tokens.push_back(*t);
+  }
+
+  return tokens;
+}
+
+void lexer::seek(std::size_t offset)
+{
+  CMSL_ASSERT(offset <= m_size);
+  m_offset = offset;
+}
 
+std::optional<token> lexer::lex_next()
+{
   while (!is_end()) {
     const auto t = get_next_token();
     const auto type = t.get_type();
     if (type != token_type::undef && type != token_type::comment) {
-      tokens.push_back(t);
+      return t;
     }
   }
 
-  return tokens;
+  return std::nullopt;
+}
+
+bool lexer::has_errors() const
+{
+  return m_has_errors;
 }
 
 bool lexer::is_end() const
 {
-  return m_source_loc.is_at_end();
+  return m_offset >= m_size;
 }
 
 bool lexer::has_next() const
 {
-  return m_source_loc.has_next();
+  return m_offset + 1u < m_size;
 }
 
 char lexer::current() const
 {
-  return m_source_loc.current_char();
+  return m_data[m_offset];
 }
 
 char lexer::next() const
 {
-  return m_source_loc.next_char();
+  return has_next() ? m_data[m_offset + 1u] : '\0';
 }
 
 token lexer::get_next_token()
 {
   consume_whitespaces();
-  const auto begin_loc = m_source_loc.location();
+  const auto begin = m_offset;
   const auto token_type = get_next_token_type();
-  const auto end_loc = m_source_loc.location();
-  return token{ token_type, source_range{ begin_loc, end_loc }, m_source };
+  return token{ token_type, static_cast<std::uint32_t>(begin),
+                static_cast<std::uint32_t>(m_offset - begin), m_source_id };
 }
 
 token_type lexer::get_next_token_type()
@@ -70,11 +393,11 @@ token_type lexer::get_next_token_type()
 
   const auto curr = current();
 
-  if (std::isdigit(curr)) {
+  if (is_of_class(curr, digit)) {
     return get_numeric_token_type();
   }
   if (curr == '.') {
-    if (has_next() && std::isdigit(next())) // .123
+    if (has_next() && is_of_class(next(), digit)) // .123
     {
       return get_numeric_token_type();
     } else {
@@ -99,16 +422,18 @@ token_type lexer::get_next_token_type()
   if (curr == '"') {
     return get_string_token_type();
   }
-  if (is_one_char_token(curr)) {
+  if (one_char_tokens[static_cast<unsigned char>(curr)] != token_type::undef) {
     return get_one_char_token_type(curr);
   }
-  if (is_arithmetical_operator(curr)) {
+  if (is_of_class(curr, arithmetical)) {
     return get_arithmetical_token_type(curr);
   }
-  if (std::isalpha(curr) || curr == '_') {
+  if (is_of_class(curr, identifier_start)) {
     return get_identifier_or_keyword_token_type();
   }
 
+  // Unknown char. Skip it, so lexing can go on.
+  consume_char();
   return token_type::undef;
 }
 
@@ -122,7 +447,7 @@ token_type lexer::get_numeric_token_type()
 
   // Handle double_ e.g. 123.
   if (current() == '.') {
-    m_source_loc.consume_char();
+    consume_char();
     consume_integer();
     return token_type::double_;
   }
@@ -134,7 +459,7 @@ token_type lexer::get_numeric_token_type()
 
 void lexer::consume_integer()
 {
-  while (!is_end() && std::isdigit(current())) {
+  while (!is_end() && is_of_class(current(), digit)) {
     consume_char();
   }
 }
@@ -142,46 +467,26 @@ void lexer::consume_integer()
 void lexer::consume_char()
 {
   assert(!is_end());
-  m_source_loc.consume_char();
+  ++m_offset;
 }
 
 void lexer::consume_whitespaces()
 {
-  assert(!is_end());
-  while (!is_end() && is_whitespace(current())) {
-    consume_char();
-  }
+  m_offset = skip_whitespaces(m_data, m_offset, m_size);
 }
 
 token_type lexer::get_identifier_or_keyword_token_type()
 {
-  std::string token_val;
-  while (!is_end() && is_identifier_char(current())) {
-    token_val += current();
-    consume_char();
-  }
-
-  auto found = m_keyword_tokens.find(token_val);
-
-  if (found != m_keyword_tokens.end()) {
-    return found->second;
-  }
-
-  return found != m_keyword_tokens.end() ? found->second
-                                         : token_type::identifier;
-}
-
-bool lexer::is_identifier_char(char c) const
-{
-  // At this point we know that identifier won't start with a digit, so we can
-  // use isalnum()
-  return std::isalnum(c) || c == '_';
+  const auto begin = m_offset;
+  m_offset = skip_identifier_chars(m_data, m_offset, m_size);
+  return keyword_or_identifier(
+    cmsl::string_view{ m_data + begin, m_offset - begin });
 }
 
 token_type lexer::get_equal_token_type()
 {
   // current == '='
-  m_source_loc.consume_char();
+  consume_char();
 
   if (!is_end() && current() == '=') // ==
   {
@@ -198,33 +503,23 @@ token_type lexer::get_string_token_type()
   consume_char();
 
   // TODO: handle new lines
-  while (!is_end() && current() != '"') {
-    if (current() == '\\') {
-      // Doesn't matter what is after '\', we need to consume it
-      consume_char();
-
-      if (is_end()) {
-        break;
-      }
+  while (true) {
+    m_offset = find_string_special_char(m_data, m_offset, m_size);
+    if (is_end() || current() == '"') {
+      break;
     }
 
+    // Doesn't matter what is after '\', we need to consume it
+    consume_char();
+    if (is_end()) {
+      break;
+    }
     consume_char();
   }
 
   if (is_end()) {
-    const auto current_loc = m_source_loc.location();
-
-    errors::error err;
-    err.type = errors::error_type::error;
-    err.source_path = m_source.path();
-    err.range = source_range{ current_loc, current_loc };
-    err.message = "Unexpected end of source in a middle of string";
-
-    const auto line_info = m_source.line(current_loc.line);
-    err.line_snippet = line_info.line;
-    err.line_start_pos = line_info.start_pos;
-
-    m_err_observer.notify_error(std::move(err));
+    raise_unexpected_end_error(
+      "Unexpected end of source in a middle of string");
     return token_type::undef;
   }
 
@@ -239,10 +534,9 @@ token_type lexer::get_arithmetical_token_type(char operator_char)
   // current() == operator_char, go to next char
   consume_char();
 
-  const auto found = m_aritmetical_token_definitions.find(operator_char);
-  assert(found != m_aritmetical_token_definitions.end());
-
-  const auto& definition = found->second;
+  const auto& definition =
+    arithmetical_token_definitions[static_cast<unsigned char>(operator_char)];
+  assert(definition.single != token_type::undef);
 
   if (is_end()) {
     return definition.single;
@@ -263,66 +557,6 @@ token_type lexer::get_arithmetical_token_type(char operator_char)
   return definition.single;
 }
 
-lexer::aritmetical_token_definition_t
-lexer::create_arithmetical_token_definitions() const
-{
-  using def_t = arithmetical_token_definition;
-
-  aritmetical_token_definition_t definitions;
-
-  definitions['-'] =
-    def_t{ token_type::minus, token_type::minusequal, token_type::minusminus };
-  definitions['+'] =
-    def_t{ token_type::plus, token_type::plusequal, token_type::plusplus };
-  definitions['&'] =
-    def_t{ token_type::amp, token_type::ampequal, token_type::ampamp };
-  definitions['|'] =
-    def_t{ token_type::pipe, token_type::pipeequal, token_type::pipepipe };
-  definitions['/'] = def_t{ token_type::slash, token_type::slashequal };
-  definitions['*'] = def_t{ token_type::star, token_type::starequal };
-  definitions['%'] = def_t{ token_type::percent, token_type::percentequal };
-  definitions['!'] = def_t{ token_type::exclaim, token_type::exclaimequal };
-  definitions['^'] = def_t{ token_type::xor_, token_type::xorequal };
-  definitions['<'] = def_t{ token_type::less, token_type::lessequal };
-  definitions['>'] = def_t{ token_type::greater, token_type::greaterequal };
-
-  return definitions;
-}
-
-lexer::one_char_tokens_t lexer::create_one_char_tokens() const
-{
-  one_char_tokens_t tokens;
-
-  tokens['('] = token_type::open_paren;
-  tokens[')'] = token_type::close_paren;
-  tokens['{'] = token_type::open_brace;
-  tokens['}'] = token_type::close_brace;
-  tokens['['] = token_type::open_square;
-  tokens[']'] = token_type::close_square;
-  tokens[';'] = token_type::semicolon;
-  tokens['?'] = token_type::question;
-  tokens[','] = token_type::comma;
-
-  return tokens;
-}
-
-bool lexer::is_arithmetical_operator(char c) const
-{
-  const auto arith_operators = cmsl::string_view{ "-+&|/*%!^<>" };
-  return arith_operators.find(c) != cmsl::string_view::npos;
-}
-
-bool lexer::is_one_char_token(char c) const
-{
-  return contains(m_one_char_tokens, c);
-}
-
-bool lexer::is_whitespace(char c) const
-{
-  const auto chars = cmsl::string_view{ " \t\n\r" };
-  return chars.find(c) != cmsl::string_view::npos;
-}
-
 bool lexer::comment_starts() const
 {
   if (!has_next()) {
@@ -335,47 +569,8 @@ bool lexer::comment_starts() const
 
 token_type lexer::get_one_char_token_type(char c)
 {
-  const auto found = m_one_char_tokens.find(c);
-  assert(found != m_one_char_tokens.end());
-
   consume_char();
-
-  const auto token_type = found->second;
-  return token_type;
-}
-
-lexer::keyword_tokens_t lexer::create_keyword_tokens() const
-{
-  keyword_tokens_t tokens;
-
-  tokens["void"] = token_type::kw_void;
-  tokens["int"] = token_type::kw_int;
-  tokens["double"] = token_type::kw_double;
-  tokens["bool"] = token_type::kw_bool;
-  tokens["true"] = token_type::kw_true;
-  tokens["false"] = token_type::kw_false;
-  tokens["string"] = token_type::kw_string;
-  tokens["version"] = token_type::kw_version;
-  tokens["list"] = token_type::kw_list;
-  tokens["extern"] = token_type::kw_extern;
-  tokens["library"] = token_type::kw_library;
-  tokens["executable"] = token_type::kw_executable;
-  tokens["project"] = token_type::kw_project;
-  tokens["option"] = token_type::kw_option;
-  tokens["return"] = token_type::kw_return;
-  tokens["class"] = token_type::kw_class;
-  tokens["enum"] = token_type::kw_enum;
-  tokens["if"] = token_type::kw_if;
-  tokens["else"] = token_type::kw_else;
-  tokens["while"] = token_type::kw_while;
-  tokens["auto"] = token_type::kw_auto;
-  tokens["for"] = token_type::kw_for;
-  tokens["break"] = token_type::kw_break;
-  tokens["namespace"] = token_type::kw_namespace;
-  tokens["import"] = token_type::kw_import;
-  tokens["export"] = token_type::kw_export;
-
-  return tokens;
+  return one_char_tokens[static_cast<unsigned char>(c)];
 }
 
 token_type lexer::get_scope_operator()
@@ -396,46 +591,46 @@ token_type lexer::get_comment()
   const auto is_one_line_comment = current() == '/';
   consume_char(); // Consume '/' or '*'
 
-  auto last_char = '\0';
+  if (is_one_line_comment) {
+    // The new line char is a part of the comment.
+    const auto new_line = find_char(m_data, m_offset, m_size, '\n');
+    m_offset = std::min(new_line + 1u, m_size);
+    return token_type::comment;
+  }
+
   while (true) {
-    if (is_one_line_comment) {
-      if (is_end()) {
-        break;
-      }
-
-      const auto curr = current();
-      if (curr == '\n') {
-        consume_char();
-        break;
-      }
-    } else {
-      if (is_end()) {
-        const auto current_loc = m_source_loc.location();
-        errors::error err;
-        err.type = errors::error_type::error;
-        err.source_path = m_source.path();
-        err.range = source_range{ current_loc, current_loc };
-        err.message =
-          "Unexpected end of source in a middle of a multiline comment";
-
-        const auto line_info = m_source.line(current_loc.line);
-        err.line_snippet = line_info.line;
-        err.line_start_pos = line_info.start_pos;
-
-        m_err_observer.notify_error(std::move(err));
-        return token_type::undef;
-      }
-
-      if (last_char == '*' && current() == '/') {
-        consume_char();
-        break;
-      }
+    m_offset = find_char(m_data, m_offset, m_size, '*');
+    if (has_next() && next() == '/') {
+      m_offset += 2u;
+      return token_type::comment;
+    }
+
+    if (is_end() || !has_next()) {
+      m_offset = m_size;
+      raise_unexpected_end_error(
+        "Unexpected end of source in a middle of a multiline comment");
+      return token_type::undef;
     }
 
-    last_char = current();
     consume_char();
   }
+}
+
+void lexer::raise_unexpected_end_error(const char* message)
+{
+  const auto current_loc = source_files::location(m_source_id, m_offset);
+
+  errors::error err;
+  err.type = errors::error_type::error;
+  err.source_path = m_source.path();
+  err.range = source_range{ current_loc, current_loc };
+  err.message = message;
+
+  const auto line_info = m_source.line(current_loc.line);
+  err.line_snippet = line_info.line;
+  err.line_start_pos = line_info.start_pos;
 
-  return token_type::comment;
+  m_err_observer.notify_error(std::move(err));
+  m_has_errors = true;
 }
 }
@@ -2,11 +2,11 @@
 
 #include "common/source_view.hpp"
 #include "common/string.hpp"
-#include "lexer/source_location_manipulator.hpp"
 #include "token.hpp"
 
+#include <cstddef>
+#include <optional>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 namespace cmsl {
@@ -15,37 +15,37 @@ class errors_observer;
 }
 
 namespace lexer {
+// Character classes, one and two char tokens and keywords are looked up in
+// tables built at compile time. Whitespaces, identifiers, string bodies and
+// comments are scanned many chars at a time where SSE2 is available. Tokens
+// keep only offsets, line and column are computed by source_files when they
+// are needed.
 class lexer
 {
 private:
   using source_t = cmsl::source_view;
-  using source_it_t = cmsl::string_view::const_iterator;
 
 public:
+  // Registers the source till the lexer is destroyed, so its tokens can't be
+  // used after that.
   lexer(errors::errors_observer& err_observer, source_t source);
+  // Lexes a source registered before, e.g. a new version of a source passed
+  // to source_files::replace().
+  lexer(errors::errors_observer& err_observer, source_t source,
+        source_files::id_t source_id);
 
   std::vector<token> lex();
 
-private:
-  struct arithmetical_token_definition
-  {
-    token_type single;
-    token_type op_equal;
-    token_type twice{ token_type::undef };
-
-    bool has_twice() const { return twice != token_type::undef; }
-  };
-
-  using aritmetical_token_definition_t =
-    std::unordered_map<char, arithmetical_token_definition>;
-  aritmetical_token_definition_t create_arithmetical_token_definitions() const;
+  // Lexes tokens one by one. Offset passed to seek() has to be placed
+  // between tokens, outside of comments. Returns std::nullopt at the end of
+  // the source.
+  void seek(std::size_t offset);
+  std::optional<token> lex_next();
 
-  using one_char_tokens_t = std::unordered_map<char, token_type>;
-  one_char_tokens_t create_one_char_tokens() const;
-
-  using keyword_tokens_t = string_view_map<token_type>;
-  keyword_tokens_t create_keyword_tokens() const;
+  // Whether an error has been reported while lexing.
+  bool has_errors() const;
 
+private:
   token get_next_token();
   token_type get_next_token_type();
   token_type get_numeric_token_type();
@@ -64,22 +64,24 @@ private:
   bool is_end() const;
   bool has_next() const;
 
-  bool is_identifier_char(char c) const;
-  bool is_arithmetical_operator(char c) const;
-  bool is_one_char_token(char c) const;
-  bool is_whitespace(char c) const;
   bool comment_starts() const;
 
   char current() const;
   char next() const;
 
+  void raise_unexpected_end_error(const char* message);
+
 private:
   errors::errors_observer& m_err_observer;
   const source_t m_source;
-  source_location_manipulator m_source_loc;
-  const aritmetical_token_definition_t m_aritmetical_token_definitions;
-  const one_char_tokens_t m_one_char_tokens;
-  const keyword_tokens_t m_keyword_tokens;
+  const char* const m_data;
+  const std::size_t m_size;
+  // Empty if the source has been registered by the caller.
+  source_files::registration m_registration;
+  const source_files::id_t m_source_id;
+  std::size_t m_offset{ 0u };
+
+  bool m_has_errors{ false };
 };
 }
 }
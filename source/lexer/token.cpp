@@ -9,15 +9,23 @@ token::token()
 }
 
 token::token(token_type_t type)
-  : token{ type, source_range{}, cmsl::source_view{ "" } }
+  : token{ type, 0u, 0u, source_files::empty_source_id }
 {
 }
 
 token::token(token_type_t type, const source_range& src_range,
              cmsl::source_view source)
+  : token{ type, src_range.begin.absolute, src_range.size(),
+           source_files::add_static(source) }
+{
+}
+
+token::token(token_type_t type, std::uint32_t offset, std::uint32_t length,
+             source_files::id_t source_id)
   : m_type{ type }
-  , m_source_range{ src_range }
-  , m_source{ source }
+  , m_offset{ offset }
+  , m_length{ length }
+  , m_source_id{ source_id }
 {
 }
 
@@ -38,13 +46,17 @@ token token::undef()
 
 cmsl::string_view token::str() const
 {
-  return cmsl::string_view{ std::next(m_source.cdata(),
-                                      m_source_range.begin.absolute),
-                            m_source_range.size() };
+  const auto data = source_files::view(m_source_id).cdata();
+  return cmsl::string_view{ std::next(data, m_offset), m_length };
 }
 
 bool token::operator==(const token& rhs) const
 {
+  if (m_source_id == rhs.m_source_id && m_offset == rhs.m_offset &&
+      m_length == rhs.m_length) {
+    return true;
+  }
+
   return str() == rhs.str();
 }
 
@@ -61,11 +73,28 @@ std::ostream& operator<<(std::ostream& out, const token& t)
 
 source_range token::src_range() const
 {
-  return m_source_range;
+  return source_range{ source_files::location(m_source_id, m_offset),
+                       source_files::location(m_source_id,
+                                              m_offset + m_length) };
 }
 
 cmsl::source_view token::source() const
 {
-  return m_source;
+  return source_files::view(m_source_id);
+}
+
+source_files::id_t token::source_id() const
+{
+  return m_source_id;
+}
+
+std::uint32_t token::offset() const
+{
+  return m_offset;
+}
+
+std::uint32_t token::end_offset() const
+{
+  return m_offset + m_length;
 }
 }
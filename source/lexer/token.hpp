@@ -1,13 +1,18 @@
 #pragma once
 
+#include "common/source_files.hpp"
 #include "common/source_location.hpp"
 #include "common/source_view.hpp"
 #include "common/string.hpp"
 #include "token_type.hpp"
 
+#include <cstdint>
 #include <vector>
 
 namespace cmsl::lexer {
+// Token keeps only its type, position and id of its source, so it is cheap to
+// copy and store in containers. The source view and line and column of the
+// token are recovered from source_files.
 class token
 {
 public:
@@ -16,8 +21,14 @@ public:
   // Creates token with invalid begin and end locations
   explicit token();
   explicit token(token_type_t type);
+  // Registers the source in source_files for the whole process, like
+  // make_token() does, so the text has to outlive all tokens of it, e.g. be a
+  // literal. Tokens of other sources should be created with an id of their
+  // source_files::registration.
   explicit token(token_type_t type, const source_range& src_range,
                  cmsl::source_view source);
+  explicit token(token_type_t type, std::uint32_t offset,
+                 std::uint32_t length, source_files::id_t source_id);
 
   token(const token&) = default;
   token& operator=(const token&) = default;
@@ -33,6 +44,10 @@ public:
 
   source_range src_range() const;
   cmsl::source_view source() const;
+  source_files::id_t source_id() const;
+  // Offsets of the token in its source, cheaper than src_range().
+  std::uint32_t offset() const;
+  std::uint32_t end_offset() const;
 
   bool operator==(const token& rhs) const;
   bool operator!=(const token& rhs) const;
@@ -41,19 +56,21 @@ public:
 
 private:
   token_type_t m_type;
-  source_range m_source_range;
-  cmsl::source_view m_source;
+  std::uint32_t m_offset;
+  std::uint32_t m_length;
+  source_files::id_t m_source_id;
 };
 
+static_assert(sizeof(token) == 16u, "Token is meant to be compact");
+
 using token_container_t = std::vector<token>;
 
 template <unsigned N>
 token make_token(lexer::token_type token_type, const char (&tok)[N])
 {
   // N counts also '\0'
-  const auto src_range = source_range{ source_location{ 1u, 1u, 0u },
-                                       source_location{ 1u, N, N - 1u } };
-  return token{ token_type, src_range, cmsl::source_view{ tok } };
+  return token{ token_type, 0u, N - 1u,
+                source_files::add_static(cmsl::source_view{ tok }) };
 }
 }
 
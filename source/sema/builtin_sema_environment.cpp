@@ -0,0 +1,96 @@
+#include "sema/builtin_sema_environment.hpp"
+
+#include "common/assert.hpp"
+#include "sema/builtin_sema_context.hpp"
+#include "sema/builtin_token_provider.hpp"
+#include "sema/enum_values_context.hpp"
+#include "sema/factories.hpp"
+#include "sema/functions_context.hpp"
+#include "sema/identifiers_context.hpp"
+#include "sema/qualified_contextes_refs.hpp"
+#include "sema/sema_function.hpp"
+#include "sema/sema_type.hpp"
+#include "sema/types_context.hpp"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace cmsl::sema {
+namespace {
+qualified_contextes create_empty_qualified_contexts()
+{
+  return qualified_contextes{ std::make_unique<enum_values_context_impl>(),
+                              std::make_unique<functions_context_impl>(),
+                              std::make_unique<identifiers_context_impl>(),
+                              std::make_unique<types_context_impl>() };
+}
+}
+
+builtin_sema_environment::builtin_sema_environment(
+  std::string builtin_documentation_path)
+  : m_tokens{ std::make_unique<builtin_token_provider>(
+      std::move(builtin_documentation_path)) }
+  , m_qualified_contexts{ create_empty_qualified_contexts() }
+{
+  auto refs = qualified_contextes_refs{ m_qualified_contexts };
+  m_context = std::make_unique<builtin_sema_context>(
+    m_factories, m_errors_observer, *m_tokens, refs);
+}
+
+builtin_sema_environment::~builtin_sema_environment() = default;
+
+const builtin_sema_environment& builtin_sema_environment::shared(
+  const std::string& builtin_documentation_path)
+{
+  // Environments are intentionally never destroyed. Sema trees that refer to
+  // builtin types can outlive statics.
+  static std::mutex environments_mutex;
+  static auto environments =
+    new std::unordered_map<std::string,
+                           std::unique_ptr<builtin_sema_environment>>;
+
+  std::lock_guard<std::mutex> lock{ environments_mutex };
+  auto& environment = (*environments)[builtin_documentation_path];
+  if (environment == nullptr) {
+    environment.reset(
+      new builtin_sema_environment{ builtin_documentation_path });
+  }
+
+  return *environment;
+}
+
+const builtin_token_provider& builtin_sema_environment::tokens() const
+{
+  return *m_tokens;
+}
+
+const builtin_sema_context& builtin_sema_environment::context() const
+{
+  return *m_context;
+}
+
+builtin_types_accessor builtin_sema_environment::builtin_types() const
+{
+  return m_context->builtin_types();
+}
+
+void builtin_sema_environment::add_builtins_to(
+  qualified_contextes_refs& ctxs, errors::errors_observer& errs) const
+{
+  const auto& builtin = m_qualified_contexts;
+  const auto enums_succeed =
+    ctxs.enums.merge_imported_stuff(*builtin.enums, errs);
+  const auto functions_succeed =
+    ctxs.functions.merge_imported_stuff(*builtin.functions, errs);
+  const auto ids_succeed = ctxs.ids.merge_imported_stuff(*builtin.ids, errs);
+  const auto types_succeed =
+    ctxs.types.merge_imported_stuff(*builtin.types, errs);
+
+  CMSL_ASSERT(enums_succeed && functions_succeed && ids_succeed &&
+              types_succeed);
+  (void)enums_succeed;
+  (void)functions_succeed;
+  (void)ids_succeed;
+  (void)types_succeed;
+}
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "errors/errors_observer.hpp"
+#include "sema/builtin_types_accessor.hpp"
+#include "sema/factories_provider.hpp"
+#include "sema/qualified_contextes.hpp"
+
+#include <memory>
+#include <string>
+
+namespace cmsl::sema {
+class builtin_sema_context;
+class builtin_token_provider;
+struct qualified_contextes_refs;
+
+// Builtin sema context together with everything it is built from: builtin
+// tokens, factories that own builtin types and functions, and qualified
+// contexts with builtin entries. Building it is expensive, so it is built
+// once per process for every builtin documentation path and shared. Once
+// built, it is only looked up, so it can be used by many parses at the same
+// time, also from different threads. Generic types that are not builtin are
+// created by users in their own contexts, and errors are reported to their
+// own observers.
+class builtin_sema_environment
+{
+public:
+  ~builtin_sema_environment();
+
+  static const builtin_sema_environment& shared(
+    const std::string& builtin_documentation_path = {});
+
+  const builtin_token_provider& tokens() const;
+  const builtin_sema_context& context() const;
+  builtin_types_accessor builtin_types() const;
+
+  // Makes ctxs look builtin entries up in the shared contexts, without
+  // copying them.
+  void add_builtins_to(qualified_contextes_refs& ctxs,
+                       errors::errors_observer& errors_observer) const;
+
+private:
+  explicit builtin_sema_environment(std::string builtin_documentation_path);
+
+private:
+  std::unique_ptr<builtin_token_provider> m_tokens;
+  factories_provider m_factories;
+  // Used only while the environment is built.
+  errors::errors_observer m_errors_observer;
+  qualified_contextes m_qualified_contexts;
+  std::unique_ptr<builtin_sema_context> m_context;
+};
+}
@@ -0,0 +1,492 @@
+#include "sema/constant_folder.hpp"
+
+#include "common/assert.hpp"
+#include "common/strings_container.hpp"
+#include "sema/builtin_sema_function.hpp"
+#include "sema/sema_nodes.hpp"
+#include "sema/sema_type.hpp"
+
+#include <array>
+
+namespace cmsl::sema {
+namespace {
+using kind_t = builtin_function_kind;
+using version_t = std::array<int_t, 4u>;
+
+template <typename Node, typename Value>
+std::unique_ptr<expression_node> make_value(const expression_node& folded,
+                                            Value value)
+{
+  return std::make_unique<Node>(folded.ast_node(), folded.type(), value);
+}
+
+std::optional<kind_t> builtin_kind(const sema_function& function)
+{
+  const auto builtin = dynamic_cast<const builtin_sema_function*>(&function);
+  if (builtin == nullptr) {
+    return std::nullopt;
+  }
+
+  return builtin->kind();
+}
+
+// Version created by a constructor call with int literals as parameters.
+std::optional<version_t> version_literal(const expression_node& node)
+{
+  const auto ctor = dynamic_cast<const constructor_call_node*>(&node);
+  if (ctor == nullptr) {
+    return std::nullopt;
+  }
+
+  const auto kind = builtin_kind(ctor->function());
+  if (!kind) {
+    return std::nullopt;
+  }
+
+  switch (*kind) {
+    case kind_t::version_ctor_major:
+    case kind_t::version_ctor_major_minor:
+    case kind_t::version_ctor_major_minor_patch:
+    case kind_t::version_ctor_major_minor_patch_tweak:
+      break;
+
+    default:
+      return std::nullopt;
+  }
+
+  const auto& params = ctor->param_expressions();
+  CMSL_ASSERT(params.size() <= 4u);
+
+  version_t version{};
+  for (auto i = 0u; i < params.size(); ++i) {
+    const auto value = dynamic_cast<const int_value_node*>(params[i].get());
+    if (value == nullptr) {
+      return std::nullopt;
+    }
+    version[i] = value->value();
+  }
+
+  return version;
+}
+
+std::unique_ptr<expression_node> fold_bool(const expression_node& node,
+                                           kind_t kind, bool lhs, bool rhs)
+{
+  switch (kind) {
+    case kind_t::bool_operator_equal_equal:
+      return make_value<bool_value_node>(node, lhs == rhs);
+    case kind_t::bool_operator_pipe_pipe:
+      return make_value<bool_value_node>(node, lhs || rhs);
+    case kind_t::bool_operator_amp_amp:
+      return make_value<bool_value_node>(node, lhs && rhs);
+
+    default:
+      return nullptr;
+  }
+}
+
+std::unique_ptr<expression_node> fold_int(const expression_node& node,
+                                          kind_t kind, int_t lhs, int_t rhs)
+{
+  switch (kind) {
+    case kind_t::int_operator_plus:
+      return make_value<int_value_node>(node, lhs + rhs);
+    case kind_t::int_operator_minus:
+      return make_value<int_value_node>(node, lhs - rhs);
+    case kind_t::int_operator_star:
+      return make_value<int_value_node>(node, lhs * rhs);
+    case kind_t::int_operator_slash:
+      if (rhs == 0) {
+        return nullptr;
+      }
+      return make_value<int_value_node>(node, lhs / rhs);
+    case kind_t::int_operator_less:
+      return make_value<bool_value_node>(node, lhs < rhs);
+    case kind_t::int_operator_less_equal:
+      return make_value<bool_value_node>(node, lhs <= rhs);
+    case kind_t::int_operator_greater:
+      return make_value<bool_value_node>(node, lhs > rhs);
+    case kind_t::int_operator_greater_equal:
+      return make_value<bool_value_node>(node, lhs >= rhs);
+    case kind_t::int_operator_equal_equal:
+      return make_value<bool_value_node>(node, lhs == rhs);
+
+    default:
+      return nullptr;
+  }
+}
+
+std::unique_ptr<expression_node> fold_double(const expression_node& node,
+                                             kind_t kind, double lhs,
+                                             double rhs)
+{
+  switch (kind) {
+    case kind_t::double_operator_plus:
+      return make_value<double_value_node>(node, lhs + rhs);
+    case kind_t::double_operator_minus:
+      return make_value<double_value_node>(node, lhs - rhs);
+    case kind_t::double_operator_star:
+      return make_value<double_value_node>(node, lhs * rhs);
+    case kind_t::double_operator_slash:
+      return make_value<double_value_node>(node, lhs / rhs);
+    case kind_t::double_operator_less:
+      return make_value<bool_value_node>(node, lhs < rhs);
+    case kind_t::double_operator_less_equal:
+      return make_value<bool_value_node>(node, lhs <= rhs);
+    case kind_t::double_operator_greater:
+      return make_value<bool_value_node>(node, lhs > rhs);
+    case kind_t::double_operator_greater_equal:
+      return make_value<bool_value_node>(node, lhs >= rhs);
+
+    default:
+      return nullptr;
+  }
+}
+
+std::unique_ptr<expression_node> fold_version(const expression_node& node,
+                                              kind_t kind,
+                                              const version_t& lhs,
+                                              const version_t& rhs)
+{
+  switch (kind) {
+    case kind_t::version_operator_equal_equal:
+      return make_value<bool_value_node>(node, lhs == rhs);
+    case kind_t::version_operator_not_equal:
+      return make_value<bool_value_node>(node, lhs != rhs);
+    case kind_t::version_operator_less:
+      return make_value<bool_value_node>(node, lhs < rhs);
+    case kind_t::version_operator_less_equal:
+      return make_value<bool_value_node>(node, lhs <= rhs);
+    case kind_t::version_operator_greater:
+      return make_value<bool_value_node>(node, lhs > rhs);
+    case kind_t::version_operator_greater_equal:
+      return make_value<bool_value_node>(node, lhs >= rhs);
+
+    default:
+      return nullptr;
+  }
+}
+
+template <typename Node>
+const Node* literal(const expression_node& node)
+{
+  return dynamic_cast<const Node*>(&node);
+}
+}
+
+constant_folder::constant_folder(strings_container& strings)
+  : m_strings{ strings }
+{
+}
+
+constant_folder::~constant_folder() = default;
+
+void constant_folder::fold(sema_node& tree)
+{
+  tree.visit(*this);
+  m_folded_expression.reset();
+  m_folded_statement.reset();
+}
+
+void constant_folder::visit(add_subdirectory_node& node)
+{
+  fold_children(node);
+}
+
+void constant_folder::visit(binary_operator_node& node)
+{
+  fold_children(node);
+
+  const auto kind = builtin_kind(node.operator_function());
+  if (!kind || node.type().is_reference()) {
+    return;
+  }
+
+  m_folded_expression = fold_binary_operator(node, *kind);
+}
+
+void constant_folder::visit(block_node& node)
+{
+  fold_children(node);
+}
+
+void constant_folder::visit(cast_to_reference_node& node)
+{
+  fold_children(node);
+}
+
+void constant_folder::visit(cast_to_reference_to_base_node& node)
+{
+  fold_children(node);
+}
+
+void constant_folder::visit(cast_to_base_value_node& node)
+{
+  fold_children(node);
+}
+
+void constant_folder::visit(cast_to_value_node& node)
+{
+  fold_children(node);
+}
+
+void constant_folder::visit(class_member_access_node& node)
+{
+  fold_children(node);
+}
+
+void constant_folder::visit(class_node& node)
+{
+  fold_children(node);
+}
+
+void constant_folder::visit(conditional_node& node)
+{
+  fold_children(node);
+}
+
+void constant_folder::visit(constructor_call_node& node)
+{
+  fold_children(node);
+}
+
+void constant_folder::visit(designated_initializers_node& node)
+{
+  fold_children(node);
+}
+
+void constant_folder::visit(for_node& node)
+{
+  fold_children(node);
+}
+
+void constant_folder::visit(function_call_node& node)
+{
+  fold_children(node);
+}
+
+void constant_folder::visit(function_node& node)
+{
+  fold_children(node);
+}
+
+void constant_folder::visit(if_else_node& node)
+{
+  fold_children(node);
+
+  // Branches are removed from the node, so they are iterated over a copy.
+  std::vector<const conditional_node*> ifs;
+  for (const auto& if_ : node.ifs()) {
+    ifs.emplace_back(if_.get());
+  }
+
+  std::unique_ptr<sema_node> taken_body;
+  for (const auto if_ : ifs) {
+    if (taken_body) {
+      node.replace_child(*if_, nullptr);
+      continue;
+    }
+
+    const auto condition = literal<bool_value_node>(if_->get_condition());
+    if (condition == nullptr) {
+      continue;
+    }
+
+    // Following branches are never taken, and neither is a false one.
+    const auto removed = node.replace_child(*if_, nullptr);
+    if (condition->value()) {
+      taken_body = removed->replace_child(if_->get_body(), nullptr);
+    }
+  }
+
+  if (taken_body) {
+    node.set_else_body(std::unique_ptr<block_node>(
+      dynamic_cast<block_node*>(taken_body.release())));
+  }
+
+  if (node.ifs().empty()) {
+    const auto else_body = node.else_body();
+    m_folded_statement =
+      else_body != nullptr ? node.replace_child(*else_body, nullptr) : nullptr;
+  }
+}
+
+void constant_folder::visit(implicit_member_function_call_node& node)
+{
+  fold_children(node);
+}
+
+void constant_folder::visit(initializer_list_node& node)
+{
+  fold_children(node);
+}
+
+void constant_folder::visit(member_function_call_node& node)
+{
+  fold_children(node);
+}
+
+void constant_folder::visit(namespace_node& node)
+{
+  fold_children(node);
+}
+
+void constant_folder::visit(return_node& node)
+{
+  fold_children(node);
+}
+
+void constant_folder::visit(ternary_operator_node& node)
+{
+  fold_children(node);
+
+  const auto condition = literal<bool_value_node>(node.condition());
+  if (condition == nullptr) {
+    return;
+  }
+
+  // The taken expression has to be usable the same way the operator is, e.g.
+  // a reference to a variable can not replace an operator that creates a
+  // temporary value.
+  const auto& taken = condition->value() ? node.true_() : node.false_();
+  if (taken.type() != node.type() ||
+      taken.produces_temporary_value() != node.produces_temporary_value()) {
+    return;
+  }
+
+  m_folded_expression = node.replace_child(taken, nullptr);
+}
+
+void constant_folder::visit(translation_unit_node& node)
+{
+  fold_children(node);
+}
+
+void constant_folder::visit(unary_operator_node& node)
+{
+  fold_children(node);
+
+  const auto kind = builtin_kind(node.function());
+  if (!kind || node.type().is_reference()) {
+    return;
+  }
+
+  m_folded_expression = fold_unary_operator(node, *kind);
+}
+
+void constant_folder::visit(variable_declaration_node& node)
+{
+  fold_children(node);
+}
+
+void constant_folder::visit(while_node& node)
+{
+  fold_children(node);
+}
+
+void constant_folder::fold_children(sema_node& node)
+{
+  for (const auto child : node.children()) {
+    child->visit(*this);
+
+    auto folded = std::move(m_folded_expression);
+    if (m_folded_statement) {
+      folded = std::move(*m_folded_statement);
+      m_folded_statement.reset();
+    } else if (folded == nullptr) {
+      continue;
+    }
+
+    const auto replaced = node.replace_child(*child, std::move(folded));
+    CMSL_ASSERT(replaced != nullptr);
+  }
+}
+
+std::unique_ptr<expression_node> constant_folder::fold_binary_operator(
+  const binary_operator_node& node, builtin_function_kind kind)
+{
+  const auto& lhs = node.lhs();
+  const auto& rhs = node.rhs();
+
+  if (const auto l = literal<bool_value_node>(lhs),
+      r = literal<bool_value_node>(rhs);
+      l && r) {
+    return fold_bool(node, kind, l->value(), r->value());
+  }
+
+  if (const auto l = literal<int_value_node>(lhs),
+      r = literal<int_value_node>(rhs);
+      l && r) {
+    return fold_int(node, kind, l->value(), r->value());
+  }
+
+  if (const auto l = literal<double_value_node>(lhs),
+      r = literal<double_value_node>(rhs);
+      l && r) {
+    return fold_double(node, kind, l->value(), r->value());
+  }
+
+  if (const auto l = literal<string_value_node>(lhs),
+      r = literal<string_value_node>(rhs);
+      l && r) {
+    const auto lhs_value = l->value();
+    const auto rhs_value = r->value();
+    switch (kind) {
+      case kind_t::string_operator_plus: {
+        auto concatenated = std::string{ lhs_value };
+        concatenated += rhs_value;
+        return make_value<string_value_node>(
+          node, m_strings.store(std::move(concatenated)));
+      }
+      case kind_t::string_operator_equal_equal:
+        return make_value<bool_value_node>(node, lhs_value == rhs_value);
+      case kind_t::string_operator_not_equal:
+        return make_value<bool_value_node>(node, lhs_value != rhs_value);
+      case kind_t::string_operator_less:
+        return make_value<bool_value_node>(node, lhs_value < rhs_value);
+      case kind_t::string_operator_less_equal:
+        return make_value<bool_value_node>(node, lhs_value <= rhs_value);
+      case kind_t::string_operator_greater:
+        return make_value<bool_value_node>(node, lhs_value > rhs_value);
+      case kind_t::string_operator_greater_equal:
+        return make_value<bool_value_node>(node, lhs_value >= rhs_value);
+
+      default:
+        return nullptr;
+    }
+  }
+
+  if (const auto l = version_literal(lhs), r = version_literal(rhs); l && r) {
+    return fold_version(node, kind, *l, *r);
+  }
+
+  return nullptr;
+}
+
+std::unique_ptr<expression_node> constant_folder::fold_unary_operator(
+  const unary_operator_node& node, builtin_function_kind kind) const
+{
+  const auto& operand = node.expression();
+
+  switch (kind) {
+    case kind_t::bool_operator_unary_exclaim:
+      if (const auto value = literal<bool_value_node>(operand)) {
+        return make_value<bool_value_node>(node, !value->value());
+      }
+      return nullptr;
+    case kind_t::int_operator_unary_minus:
+      if (const auto value = literal<int_value_node>(operand)) {
+        return make_value<int_value_node>(node, -1 * value->value());
+      }
+      return nullptr;
+    case kind_t::double_operator_unary_minus:
+      if (const auto value = literal<double_value_node>(operand)) {
+        return make_value<double_value_node>(node, -1 * value->value());
+      }
+      return nullptr;
+
+    default:
+      return nullptr;
+  }
+}
+}
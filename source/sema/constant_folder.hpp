@@ -0,0 +1,83 @@
+#pragma once
+
+#include "sema/builtin_function_kind.hpp"
+#include "sema/sema_node_visitor.hpp"
+
+#include <memory>
+#include <optional>
+
+namespace cmsl {
+class strings_container;
+
+namespace sema {
+class expression_node;
+
+// Optimizes a built sema tree in place. Builtin operators on literals, e.g.
+// int and double arithmetic, string concatenation and comparison of versions
+// created from literals, are replaced with their results. Branches of if-else
+// statements and ternary operators with literal conditions that can never be
+// taken are removed.
+//
+// Only operations that don't depend on the state of the execution are
+// folded, so calls of functions, even builtin ones like
+// cmake::get_system_info(), are left as they are.
+// Nodes are evaluated the same way the execution does it. Operations whose
+// result is not well defined, like an int division by zero, are left for the
+// execution.
+class constant_folder : public empty_mutable_sema_node_visitor
+{
+public:
+  explicit constant_folder(strings_container& strings);
+  ~constant_folder();
+
+  // The tree must not be executed yet, as folded nodes are destroyed.
+  void fold(sema_node& tree);
+
+  void visit(add_subdirectory_node& node) override;
+  void visit(binary_operator_node& node) override;
+  void visit(block_node& node) override;
+  void visit(cast_to_reference_node& node) override;
+  void visit(cast_to_reference_to_base_node& node) override;
+  void visit(cast_to_base_value_node& node) override;
+  void visit(cast_to_value_node& node) override;
+  void visit(class_member_access_node& node) override;
+  void visit(class_node& node) override;
+  void visit(conditional_node& node) override;
+  void visit(constructor_call_node& node) override;
+  void visit(designated_initializers_node& node) override;
+  void visit(for_node& node) override;
+  void visit(function_call_node& node) override;
+  void visit(function_node& node) override;
+  void visit(if_else_node& node) override;
+  void visit(implicit_member_function_call_node& node) override;
+  void visit(initializer_list_node& node) override;
+  void visit(member_function_call_node& node) override;
+  void visit(namespace_node& node) override;
+  void visit(return_node& node) override;
+  void visit(ternary_operator_node& node) override;
+  void visit(translation_unit_node& node) override;
+  void visit(unary_operator_node& node) override;
+  void visit(variable_declaration_node& node) override;
+  void visit(while_node& node) override;
+
+private:
+  // Visits children of the node and puts their folded versions in their
+  // places.
+  void fold_children(sema_node& node);
+
+  std::unique_ptr<expression_node> fold_binary_operator(
+    const binary_operator_node& node, builtin_function_kind kind);
+  std::unique_ptr<expression_node> fold_unary_operator(
+    const unary_operator_node& node, builtin_function_kind kind) const;
+
+private:
+  strings_container& m_strings;
+  // Result of the last visited expression, if it has been folded. Taken by
+  // the parent, that puts it in place of the visited node.
+  std::unique_ptr<sema_node> m_folded_expression;
+  // Set by a visit of an if-else statement, that has been folded to a block
+  // or, if it is null, removed.
+  std::optional<std::unique_ptr<sema_node>> m_folded_statement;
+};
+}
+}
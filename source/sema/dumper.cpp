@@ -15,6 +15,7 @@ void dumper::visit(const variable_declaration_node& node)
 
   out() << "-name: " << node.name().str();
   out() << "-index: " << node.index();
+  dump_frame_slot(node.slot());
 
   if (auto init = node.initialization()) {
     out() << "-initialization";
@@ -50,6 +51,7 @@ void dumper::visit(const id_node& node)
 
   dump_qualified_name(node.names());
   out() << "-index: " << node.index();
+  dump_frame_slot(node.slot());
 }
 
 void dumper::visit(const enum_constant_access_node& node)
@@ -165,6 +167,11 @@ void dumper::visit(const function_node& node)
     }
   }
 
+  if (!node.has_body()) {
+    out() << "-body: not built";
+    return;
+  }
+
   {
     out() << "-body";
     auto body_ig = ident();
@@ -501,6 +508,14 @@ void dumper::visit(const import_node& node)
   out() << "-path: " << node.file_path().str();
 }
 
+void dumper::dump_frame_slot(const std::optional<frame_slot>& slot)
+{
+  if (slot) {
+    out() << "-frame slot: " << slot->index
+          << ", scope depth: " << slot->scope_depth;
+  }
+}
+
 void dumper::dump_exported(const sema_node& node)
 {
   out() << "-exported: " << (node.ast_node().is_exported() ? "true" : "false");
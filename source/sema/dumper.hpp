@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common/dumper_utils.hpp"
+#include "sema/identifier_info.hpp"
 #include "sema/sema_node_visitor.hpp"
 
 #include <ast/namespace_node.hpp>
@@ -68,5 +69,6 @@ private:
   void dump_type(const sema_type& type);
   void dump_qualified_name(
     const std::vector<ast::name_with_coloncolon>& names);
+  void dump_frame_slot(const std::optional<frame_slot>& slot);
 };
 }
@@ -54,6 +54,33 @@ bool enum_values_context_impl::merge_imported_stuff(
   return m_finder.merge_imported_stuff(casted.m_finder, errs);
 }
 
+qualified_entries_checkpoint enum_values_context_impl::make_checkpoint() const
+{
+  return m_finder.make_checkpoint();
+}
+
+void enum_values_context_impl::rollback(
+  const qualified_entries_checkpoint& checkpoint)
+{
+  m_finder.rollback(checkpoint);
+}
+
+qualified_entries_snapshot enum_values_context_impl::make_snapshot() const
+{
+  return m_finder.make_snapshot();
+}
+
+void enum_values_context_impl::enter_snapshot(
+  const qualified_entries_snapshot& snapshot)
+{
+  m_finder.enter_snapshot(snapshot, /*hide_later_entries=*/true);
+}
+
+void enum_values_context_impl::leave_snapshot()
+{
+  m_finder.leave_snapshot();
+}
+
 void enum_values_context_impl::dump(qualified_contexts_dumper& dumper) const
 {
   dumper.dump(m_finder);
@@ -24,4 +24,16 @@ sema_type_factory factories_provider::type_factory(types_context& ctx)
 {
   return sema_type_factory{ ctx, m_types };
 }
+
+factories_provider::checkpoint factories_provider::make_checkpoint() const
+{
+  return checkpoint{ m_contextes.size(), m_functions.size(), m_types.size() };
+}
+
+void factories_provider::rollback(const checkpoint& cp)
+{
+  m_contextes.resize(cp.contextes_count);
+  m_functions.resize(cp.functions_count);
+  m_types.resize(cp.types_count);
+}
 }
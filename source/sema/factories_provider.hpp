@@ -21,6 +21,18 @@ public:
   sema_function_factory function_factory();
   sema_type_factory type_factory(types_context& ctx);
 
+  struct checkpoint
+  {
+    std::size_t contextes_count{ 0u };
+    std::size_t functions_count{ 0u };
+    std::size_t types_count{ 0u };
+  };
+
+  // Entities created after the checkpoint are destroyed by rollback(), so
+  // nothing may refer to them anymore.
+  checkpoint make_checkpoint() const;
+  void rollback(const checkpoint& cp);
+
 private:
   std::vector<std::unique_ptr<sema_context>> m_contextes;
   std::vector<std::unique_ptr<sema_function>> m_functions;
@@ -82,6 +82,33 @@ bool functions_context_impl::merge_imported_stuff(
                                                  errs);
 }
 
+qualified_entries_checkpoint functions_context_impl::make_checkpoint() const
+{
+  return m_functions_finder.make_checkpoint();
+}
+
+void functions_context_impl::rollback(
+  const qualified_entries_checkpoint& checkpoint)
+{
+  m_functions_finder.rollback(checkpoint);
+}
+
+qualified_entries_snapshot functions_context_impl::make_snapshot() const
+{
+  return m_functions_finder.make_snapshot();
+}
+
+void functions_context_impl::enter_snapshot(
+  const qualified_entries_snapshot& snapshot)
+{
+  m_functions_finder.enter_snapshot(snapshot, /*hide_later_entries=*/true);
+}
+
+void functions_context_impl::leave_snapshot()
+{
+  m_functions_finder.leave_snapshot();
+}
+
 void functions_context_impl::dump(qualified_contexts_dumper& dumper) const
 {
   dumper.dump(m_functions_finder);
@@ -1,13 +1,26 @@
 #pragma once
 
 #include <functional>
+#include <optional>
 
 namespace cmsl::sema {
 class sema_type;
+
+// Location of a local variable or a parameter in a function call frame.
+struct frame_slot
+{
+  unsigned index;
+  // Parameters have depth 0, variables declared in function body have 1 and
+  // so on.
+  unsigned scope_depth;
+};
+
 struct identifier_info
 {
   std::reference_wrapper<const sema_type> type;
   unsigned index;
+  // Set only for local variables and parameters.
+  std::optional<frame_slot> slot{};
 };
 
 struct builtin_identifier_info
@@ -92,6 +92,33 @@ bool identifiers_context_impl::merge_imported_stuff(
                                                   errs);
 }
 
+qualified_entries_checkpoint identifiers_context_impl::make_checkpoint() const
+{
+  return m_contextes_handler.make_checkpoint();
+}
+
+void identifiers_context_impl::rollback(
+  const qualified_entries_checkpoint& checkpoint)
+{
+  m_contextes_handler.rollback(checkpoint);
+}
+
+qualified_entries_snapshot identifiers_context_impl::make_snapshot() const
+{
+  return m_contextes_handler.make_snapshot();
+}
+
+void identifiers_context_impl::enter_snapshot(
+  const qualified_entries_snapshot& snapshot)
+{
+  m_contextes_handler.enter_snapshot(snapshot, /*hide_later_entries=*/true);
+}
+
+void identifiers_context_impl::leave_snapshot()
+{
+  m_contextes_handler.leave_snapshot();
+}
+
 void identifiers_context_impl::dump(qualified_contexts_dumper& dumper) const
 {
   dumper.dump(m_contextes_handler);
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+
 namespace cmsl::sema {
 class identifiers_index_provider
 {
@@ -8,7 +10,8 @@ public:
 
   static id_t get_next()
   {
-    static id_t current{ 0u };
+    // Parses can run on many threads at the same time.
+    static std::atomic<id_t> current{ 0u };
     return current++;
   }
 };
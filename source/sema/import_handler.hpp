@@ -12,8 +12,10 @@ class import_handler
 public:
   virtual ~import_handler() = default;
 
-  // It could be std::optional, but gmock complains about its copy ctor.
-  virtual std::unique_ptr<qualified_contextes> handle_import(
+  // Returns exported stuff of the imported module, or null if importing
+  // failed. Exported stuff is shared by all importers of the module and lives
+  // as long as the handler.
+  virtual const qualified_contextes* handle_import(
     cmsl::string_view path) = 0;
 };
 }
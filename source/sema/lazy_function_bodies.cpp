@@ -0,0 +1,144 @@
+#include "sema/lazy_function_bodies.hpp"
+
+#include "ast/block_node.hpp"
+#include "common/assert.hpp"
+#include "sema/constant_folder.hpp"
+#include "sema/sema_nodes.hpp"
+#include "sema/user_sema_function.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace cmsl::sema {
+lazy_function_bodies::deferred_body::deferred_body(
+  function_node& node, user_sema_function& function,
+  const ast::block_node& body, const sema_builder_ast_visitor_members& members,
+  sema_context& ctx, overload_resolution_cache& overload_resolutions,
+  lazy_function_bodies& lazy_bodies)
+  : node{ node }
+  , function{ function }
+  , body{ body }
+  , members{ members.generic_types_context,
+             ctx,
+             members.errors_observer,
+             members.qualified_ctxs,
+             members.factories,
+             members.builtin_tokens,
+             parsing_ctx,
+             members.builtin_types,
+             members.add_subdir_handler,
+             members.add_declarative_file_handler,
+             members.imports_handler,
+             &overload_resolutions,
+             &lazy_bodies,
+             /*defer_function_bodies=*/false }
+  , snapshot{ members.qualified_ctxs.make_snapshot() }
+{
+}
+
+lazy_function_bodies::lazy_function_bodies(strings_container& strings)
+  : m_strings{ strings }
+{
+}
+
+lazy_function_bodies::~lazy_function_bodies() = default;
+
+void lazy_function_bodies::defer(
+  function_node& node, user_sema_function& function,
+  const ast::block_node& body, const sema_builder_ast_visitor_members& members,
+  sema_context& ctx)
+{
+  auto& deferred = m_bodies.emplace_back(
+    node, function, body, members, ctx, m_overload_resolutions, *this);
+  m_function_bodies.emplace(&function, &deferred);
+}
+
+void lazy_function_bodies::require(const sema_function& function)
+{
+  const auto found = m_function_bodies.find(&function);
+  if (found == std::cend(m_function_bodies)) {
+    return;
+  }
+
+  auto& deferred = *found->second;
+  if (deferred.state == body_state::deferred) {
+    deferred.state = body_state::required;
+    m_required.emplace_back(&deferred);
+  } else if (deferred.state == body_state::failed) {
+    m_failed_body_required = true;
+  }
+}
+
+bool lazy_function_bodies::build_required()
+{
+  auto succeed = !std::exchange(m_failed_body_required, false);
+
+  // A body may require other bodies, and building it may compile other
+  // sources, that build required bodies themselves.
+  while (!m_required.empty()) {
+    auto& deferred = *m_required.back();
+    m_required.pop_back();
+    if (deferred.state == body_state::required) {
+      succeed = build(deferred) && succeed;
+    }
+  }
+
+  return succeed;
+}
+
+bool lazy_function_bodies::build_all()
+{
+  for (auto& deferred : m_bodies) {
+    require(deferred.function);
+  }
+
+  const auto succeed = build_required();
+  return succeed &&
+    std::none_of(std::cbegin(m_bodies), std::cend(m_bodies),
+                 [](const deferred_body& deferred) {
+                   return deferred.state == body_state::failed;
+                 });
+}
+
+void lazy_function_bodies::discard(const sema_context& global_context)
+{
+  for (auto& deferred : m_bodies) {
+    if (&deferred.members.generic_types_context == &global_context) {
+      deferred.state = body_state::discarded;
+    }
+  }
+}
+
+std::size_t lazy_function_bodies::deferred_count() const
+{
+  return static_cast<std::size_t>(
+    std::count_if(std::cbegin(m_bodies), std::cend(m_bodies),
+                  [](const deferred_body& deferred) {
+                    return deferred.state == body_state::deferred ||
+                      deferred.state == body_state::required;
+                  }));
+}
+
+bool lazy_function_bodies::build(deferred_body& deferred)
+{
+  const qualified_contextes_refs::snapshot_guard snapshot_guard{
+    deferred.members.qualified_ctxs, deferred.snapshot
+  };
+
+  deferred.parsing_ctx = parsing_context{};
+  sema_builder_ast_visitor visitor{ deferred.members };
+  auto body = visitor.build_function_body(deferred.function, deferred.body,
+                                          /*should_deduce_return_type=*/false,
+                                          deferred.members.ctx);
+  if (!body) {
+    deferred.state = body_state::failed;
+    return false;
+  }
+
+  deferred.node.set_body(std::move(body));
+  constant_folder folder{ m_strings };
+  folder.fold(deferred.node);
+  deferred.state = body_state::built;
+  return true;
+}
+}
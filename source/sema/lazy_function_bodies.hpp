@@ -0,0 +1,105 @@
+#pragma once
+
+#include "sema/overload_resolution_cache.hpp"
+#include "sema/qualified_contextes_refs.hpp"
+#include "sema/sema_builder_ast_visitor.hpp"
+
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+namespace cmsl {
+class strings_container;
+
+namespace ast {
+class block_node;
+}
+
+namespace sema {
+class function_node;
+class sema_context;
+class sema_function;
+class user_sema_function;
+
+// Bodies of functions, that are built on demand. Such a function is
+// registered with its signature only, and its body is built when an overload
+// resolution chooses the function for the first time. Bodies are built with
+// names that were visible where the functions are defined, so contextes and
+// nodes of modules that defer bodies have to outlive this object.
+class lazy_function_bodies
+{
+public:
+  explicit lazy_function_bodies(strings_container& strings);
+  ~lazy_function_bodies();
+
+  // The body is going to be built by a visitor with the members, in the
+  // context.
+  void defer(function_node& node, user_sema_function& function,
+             const ast::block_node& body,
+             const sema_builder_ast_visitor_members& members,
+             sema_context& ctx);
+
+  // Does nothing if the function body is not deferred.
+  void require(const sema_function& function);
+
+  // Builds bodies of required functions, and of functions that they require.
+  // Returns false if any of required bodies is not valid. Errors of a body
+  // are reported once.
+  bool build_required();
+
+  // Builds all bodies, that have not been built yet, e.g. to report their
+  // errors.
+  bool build_all();
+
+  // Bodies deferred by a source, that failed to compile, are never built.
+  // The global context is the one the source has been built in.
+  void discard(const sema_context& global_context);
+
+  // Number of bodies that have not been built yet.
+  std::size_t deferred_count() const;
+
+private:
+  enum class body_state
+  {
+    deferred,
+    required,
+    built,
+    failed,
+    discarded
+  };
+
+  struct deferred_body
+  {
+    explicit deferred_body(function_node& node, user_sema_function& function,
+                           const ast::block_node& body,
+                           const sema_builder_ast_visitor_members& members,
+                           sema_context& ctx,
+                           overload_resolution_cache& overload_resolutions,
+                           lazy_function_bodies& lazy_bodies);
+
+    function_node& node;
+    user_sema_function& function;
+    const ast::block_node& body;
+    // Members of the visitor refer to it.
+    parsing_context parsing_ctx;
+    sema_builder_ast_visitor_members members;
+    qualified_contextes_refs::snapshot snapshot;
+    body_state state{ body_state::deferred };
+  };
+
+  bool build(deferred_body& deferred);
+
+private:
+  strings_container& m_strings;
+  // Functions and types of deferred bodies live as long as the bodies.
+  overload_resolution_cache m_overload_resolutions;
+  // Bodies are referenced by the visitors that build them, so they can't be
+  // moved.
+  std::deque<deferred_body> m_bodies;
+  std::unordered_map<const sema_function*, deferred_body*> m_function_bodies;
+  std::vector<deferred_body*> m_required;
+  // Set if a body that failed to build is required again.
+  bool m_failed_body_required{ false };
+};
+}
+}
@@ -4,6 +4,7 @@
 #include "errors/errors_observer.hpp"
 #include "overload_resolution.hpp"
 #include "sema/failed_initialization_errors_reporters.hpp"
+#include "sema/overload_resolution_cache.hpp"
 #include "sema/sema_function.hpp"
 #include "sema/sema_nodes.hpp"
 #include "sema/variable_initialization_checker.hpp"
@@ -13,9 +14,11 @@
 
 namespace cmsl::sema {
 overload_resolution::overload_resolution(errors::errors_observer& errs,
-                                         lexer::token call_token)
+                                         lexer::token call_token,
+                                         overload_resolution_cache* cache)
   : m_errs{ errs }
   , m_call_token{ call_token }
+  , m_cache{ cache }
 {
 }
 
@@ -73,12 +76,20 @@ const sema_function* overload_resolution::choose_from_scope(
   const std::vector<std::reference_wrapper<const expression_node>>&
     call_parameters) const
 {
+  if (m_cache != nullptr) {
+    if (const auto cached = m_cache->find(functions, call_parameters)) {
+      return cached;
+    }
+  }
 
   std::vector<function_match_result> results;
 
   for (const auto function : functions) {
     auto result = params_match(*function, call_parameters);
     if (std::holds_alternative<match_result::ok>(result)) {
+      if (m_cache != nullptr) {
+        m_cache->store(functions, call_parameters, *function);
+      }
       return function;
     }
 
@@ -17,13 +17,17 @@ namespace sema {
 class sema_type;
 class expression_node;
 class call_node;
+class overload_resolution_cache;
 
 class overload_resolution
 {
 public:
   // Todo: consider accepting source range instead of token
+  // If a cache is given, successful resolutions are looked up and stored in
+  // it.
   explicit overload_resolution(errors::errors_observer& errs,
-                               lexer::token call_token);
+                               lexer::token call_token,
+                               overload_resolution_cache* cache = nullptr);
 
   // Todo: use small vector
   const sema_function* choose(
@@ -123,6 +127,7 @@ private:
 private:
   errors::errors_observer& m_errs;
   lexer::token m_call_token;
+  overload_resolution_cache* m_cache;
 };
 }
 }
@@ -0,0 +1,120 @@
+#include "sema/overload_resolution_cache.hpp"
+
+#include "sema/sema_nodes.hpp"
+#include "sema/sema_type.hpp"
+
+#include <algorithm>
+
+namespace cmsl::sema {
+namespace {
+void hash_combine(std::size_t& seed, std::size_t value)
+{
+  seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+}
+}
+
+bool overload_resolution_cache::parameter_key::operator==(
+  const parameter_key& rhs) const
+{
+  return type == rhs.type &&
+    produces_temporary_value == rhs.produces_temporary_value;
+}
+
+const sema_function* overload_resolution_cache::find(
+  const single_scope_function_lookup_result_t& functions,
+  const call_parameters_t& call_parameters) const
+{
+  if (!is_cacheable(functions, call_parameters)) {
+    return nullptr;
+  }
+
+  const auto [begin, end] =
+    m_entries.equal_range(hash_of(functions, call_parameters));
+  for (auto it = begin; it != end; ++it) {
+    if (matches(it->second, functions, call_parameters)) {
+      return it->second.chosen;
+    }
+  }
+
+  return nullptr;
+}
+
+void overload_resolution_cache::store(
+  const single_scope_function_lookup_result_t& functions,
+  const call_parameters_t& call_parameters, const sema_function& chosen)
+{
+  if (!is_cacheable(functions, call_parameters)) {
+    return;
+  }
+
+  entry e{ .functions = functions, .parameters = {}, .chosen = &chosen };
+  e.parameters.reserve(call_parameters.size());
+  for (const auto& param : call_parameters) {
+    e.parameters.emplace_back(key_of(param.get()));
+  }
+
+  m_entries.emplace(hash_of(functions, call_parameters), std::move(e));
+}
+
+std::size_t overload_resolution_cache::size() const
+{
+  return m_entries.size();
+}
+
+bool overload_resolution_cache::is_cacheable(
+  const single_scope_function_lookup_result_t& functions,
+  const call_parameters_t& call_parameters)
+{
+  const auto is_designated_initializer = [](const auto& param) {
+    return param.get().type().is_designated_initializer();
+  };
+
+  return functions.size() > 1u &&
+    std::none_of(std::cbegin(call_parameters), std::cend(call_parameters),
+                 is_designated_initializer);
+}
+
+std::size_t overload_resolution_cache::hash_of(
+  const single_scope_function_lookup_result_t& functions,
+  const call_parameters_t& call_parameters)
+{
+  auto seed = functions.size();
+  for (const auto function : functions) {
+    hash_combine(seed, std::hash<const sema_function*>{}(function));
+  }
+
+  for (const auto& param : call_parameters) {
+    const auto key = key_of(param.get());
+    hash_combine(seed, std::hash<const sema_type*>{}(key.type));
+    hash_combine(seed, key.produces_temporary_value);
+  }
+
+  return seed;
+}
+
+overload_resolution_cache::parameter_key overload_resolution_cache::key_of(
+  const expression_node& parameter)
+{
+  return parameter_key{ .type = &parameter.type(),
+                        .produces_temporary_value =
+                          parameter.produces_temporary_value() };
+}
+
+bool overload_resolution_cache::matches(
+  const entry& e, const single_scope_function_lookup_result_t& functions,
+  const call_parameters_t& call_parameters)
+{
+  if (e.functions != functions ||
+      e.parameters.size() != call_parameters.size()) {
+    return false;
+  }
+
+  for (auto i = 0u; i < call_parameters.size(); ++i) {
+    if (!(e.parameters[i] == key_of(call_parameters[i].get()))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+}
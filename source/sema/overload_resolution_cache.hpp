@@ -0,0 +1,74 @@
+#pragma once
+
+#include "sema/function_lookup_result.hpp"
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace cmsl::sema {
+class expression_node;
+class sema_function;
+class sema_type;
+
+// Remembers functions chosen by overload resolution, keyed by the set of
+// candidates and by types of call parameters, so calls to the same overloaded
+// functions with the same parameter types are not matched again.
+//
+// Only successful resolutions are stored, failed ones are done again to
+// report errors. Calls with designated initializers are not cached, because
+// whether they match depends on the initializers, not only on their type.
+// Neither are calls of not overloaded functions, as matching one candidate
+// costs about as much as a lookup.
+// Entries refer to functions and types by their addresses, so the cache
+// must not outlive them.
+class overload_resolution_cache
+{
+public:
+  using call_parameters_t =
+    std::vector<std::reference_wrapper<const expression_node>>;
+
+  const sema_function* find(
+    const single_scope_function_lookup_result_t& functions,
+    const call_parameters_t& call_parameters) const;
+
+  void store(const single_scope_function_lookup_result_t& functions,
+             const call_parameters_t& call_parameters,
+             const sema_function& chosen);
+
+  std::size_t size() const;
+
+private:
+  // Everything that matching of a call parameter depends on.
+  struct parameter_key
+  {
+    const sema_type* type;
+    bool produces_temporary_value;
+
+    bool operator==(const parameter_key& rhs) const;
+  };
+
+  struct entry
+  {
+    single_scope_function_lookup_result_t functions;
+    std::vector<parameter_key> parameters;
+    const sema_function* chosen;
+  };
+
+  static bool is_cacheable(
+    const single_scope_function_lookup_result_t& functions,
+    const call_parameters_t& call_parameters);
+  static std::size_t hash_of(
+    const single_scope_function_lookup_result_t& functions,
+    const call_parameters_t& call_parameters);
+  static parameter_key key_of(const expression_node& parameter);
+  static bool matches(const entry& e,
+                      const single_scope_function_lookup_result_t& functions,
+                      const call_parameters_t& call_parameters);
+
+private:
+  // Entries are looked up by the hash, and then compared without creating a
+  // key, so a lookup doesn't allocate.
+  std::unordered_multimap<std::size_t, entry> m_entries;
+};
+}
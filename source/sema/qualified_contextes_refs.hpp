@@ -133,6 +133,72 @@ struct qualified_contextes_refs
                                           enums, name,  exported };
   }
 
+  struct checkpoint
+  {
+    qualified_entries_checkpoint functions;
+    qualified_entries_checkpoint enums;
+    qualified_entries_checkpoint ids;
+    qualified_entries_checkpoint types;
+  };
+
+  checkpoint make_checkpoint() const
+  {
+    return checkpoint{ functions.make_checkpoint(), enums.make_checkpoint(),
+                       ids.make_checkpoint(), types.make_checkpoint() };
+  }
+
+  // Removes entries registered after the checkpoint from all contextes.
+  void rollback(const checkpoint& cp)
+  {
+    functions.rollback(cp.functions);
+    enums.rollback(cp.enums);
+    ids.rollback(cp.ids);
+    types.rollback(cp.types);
+  }
+
+  struct snapshot
+  {
+    qualified_entries_snapshot functions;
+    qualified_entries_snapshot enums;
+    qualified_entries_snapshot ids;
+    qualified_entries_snapshot types;
+  };
+
+  snapshot make_snapshot() const
+  {
+    return snapshot{ functions.make_snapshot(), enums.make_snapshot(),
+                     ids.make_snapshot(), types.make_snapshot() };
+  }
+
+  // Makes lookups of all contextes behave as at the time the snapshot was
+  // made, till the guard is destroyed.
+  class snapshot_guard
+  {
+  public:
+    explicit snapshot_guard(qualified_contextes_refs& ctxs, const snapshot& s)
+      : m_ctxs{ ctxs }
+    {
+      m_ctxs.functions.enter_snapshot(s.functions);
+      m_ctxs.enums.enter_snapshot(s.enums);
+      m_ctxs.ids.enter_snapshot(s.ids);
+      m_ctxs.types.enter_snapshot(s.types);
+    }
+
+    ~snapshot_guard()
+    {
+      m_ctxs.functions.leave_snapshot();
+      m_ctxs.enums.leave_snapshot();
+      m_ctxs.ids.leave_snapshot();
+      m_ctxs.types.leave_snapshot();
+    }
+
+    snapshot_guard(const snapshot_guard&) = delete;
+    snapshot_guard& operator=(const snapshot_guard&) = delete;
+
+  private:
+    qualified_contextes_refs& m_ctxs;
+  };
+
   functions_context& functions;
   enum_values_context& enums;
   identifiers_context& ids;
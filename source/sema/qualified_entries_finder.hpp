@@ -6,28 +6,114 @@
 #include "errors/error.hpp"
 #include "errors/errors_observer.hpp"
 #include "lexer/token.hpp"
+#include "sema/symbol_table.hpp"
 
 #include <algorithm>
+#include <limits>
 
 namespace cmsl::sema {
+// State of a finder, that it can be rolled back to. See
+// qualified_entries_finder::rollback().
+struct qualified_entries_checkpoint
+{
+  std::size_t nodes_count{ 0u };
+  std::size_t entries_count{ 0u };
+  std::size_t imported_count{ 0u };
+  std::size_t path_depth{ 0u };
+};
+
+// Global node, that a finder is in, and nodes, entries and imported layers
+// visible from it. See qualified_entries_finder::enter_snapshot().
+struct qualified_entries_snapshot
+{
+  std::vector<unsigned> nodes_path;
+  std::size_t nodes_count{ 0u };
+  std::size_t entries_count{ 0u };
+  std::size_t imported_count{ 0u };
+};
+
+// Names are interned to symbol ids of the finder when entries and nodes are
+// registered, so a lookup hashes the looked name once and then walks nodes
+// comparing integers. Names are resolved as strings only in imported layers,
+// that have their own symbol tables.
 template <typename Entry>
 class qualified_entries_finder
 {
 private:
   using token_t = lexer::token;
-  struct possibly_exported_entry
+  using symbol_id_t = symbol_table::id_t;
+
+public:
+  struct entry_info
   {
-    Entry e;
+    token_t registration_token;
+    Entry entry;
     bool exported{ false };
+    // Number of entries registered before this one.
+    std::size_t registration_index{ 0u };
+  };
+
+  // Entries found by a lookup. Usually it is a view of entries stored in the
+  // finder, valid until the finder is modified. Only if entries come from
+  // more than one layer, they are copied.
+  class found_entries
+  {
+  public:
+    using const_iterator = const entry_info*;
+
+    const_iterator begin() const
+    {
+      return m_merged.empty() ? m_data : m_merged.data();
+    }
+    const_iterator end() const { return begin() + size(); }
+    std::size_t size() const
+    {
+      return m_merged.empty() ? m_size : m_merged.size();
+    }
+    bool empty() const { return size() == 0u; }
+    const entry_info& operator[](std::size_t index) const
+    {
+      return begin()[index];
+    }
+
+  private:
+    friend class qualified_entries_finder;
+
+    void append(const entry_info* entries, std::size_t count)
+    {
+      if (empty()) {
+        m_data = entries;
+        m_size = count;
+        return;
+      }
+
+      if (m_merged.empty()) {
+        // Entries are not assignable, so they are only copy constructed.
+        m_merged.reserve(m_size + count);
+        for (auto it = m_data; it != m_data + m_size; ++it) {
+          m_merged.emplace_back(*it);
+        }
+      }
+
+      for (auto it = entries; it != entries + count; ++it) {
+        m_merged.emplace_back(*it);
+      }
+    }
+
+  private:
+    const entry_info* m_data{ nullptr };
+    std::size_t m_size{ 0u };
+    std::vector<entry_info> m_merged;
   };
-  using entries_map_t =
-    std::unordered_multimap<token_t, possibly_exported_entry>;
+
+private:
+  // Entries with the same name, the most recently registered first.
+  using entries_t = std::vector<entry_info>;
+  using entries_map_t = std::unordered_map<symbol_id_t, entries_t>;
   using node_id_t = unsigned;
   static constexpr auto k_bad_id = std::numeric_limits<node_id_t>::max();
   using qualified_names_t = std::vector<ast::name_with_coloncolon>;
-  using search_result_range_t =
-    std::pair<typename entries_map_t ::const_iterator,
-              typename entries_map_t ::const_iterator>;
+  using names_path_t = std::vector<token_t>;
 
   struct tree_node
   {
@@ -35,7 +121,7 @@ private:
     node_id_t id{ k_bad_id };
     node_id_t parent_id{ k_bad_id };
     bool exported{ false };
-    std::unordered_map<token_t, node_id_t> nodes;
+    std::unordered_map<symbol_id_t, node_id_t> nodes;
     entries_map_t entries;
   };
 
@@ -45,6 +131,19 @@ private:
     node_id_t id{};
   };
 
+  // State put aside while a snapshot is entered.
+  struct outside_snapshot_state
+  {
+    std::vector<node_id_and_name> nodes_path;
+    std::vector<entries_map_t> local_nodes;
+    std::size_t visible_nodes_count;
+    std::size_t visible_entries_count;
+    std::size_t visible_imported_count;
+  };
+
+  static constexpr auto k_all_visible =
+    std::numeric_limits<std::size_t>::max();
+
 public:
   explicit qualified_entries_finder()
   {
@@ -56,22 +155,35 @@ public:
 
   void register_entry(token_t name, Entry entry, bool exported)
   {
-    possibly_exported_entry e{ .e = std::move(entry), .exported = exported };
-    current_entries().emplace(name, std::move(e));
+    const auto symbol = m_symbols.intern(name.str());
+    auto& entries = current_entries()[symbol];
+
+    // Entries are not assignable, so they can't be inserted at the front.
+    // There are only a few entries with the same name in a node, so they are
+    // just copied.
+    entries_t updated;
+    updated.reserve(entries.size() + 1u);
+    updated.emplace_back(
+      entry_info{ .registration_token = name,
+                  .entry = std::move(entry),
+                  .exported = exported,
+                  .registration_index = m_entries_count++ });
+    for (const auto& e : entries) {
+      updated.emplace_back(e);
+    }
+    entries = std::move(updated);
   }
 
   void enter_global_node(token_t name, bool exported)
   {
-    node_id_t node_id;
+    const auto symbol = m_symbols.intern(name.str());
+    const auto& nodes = current_node().nodes;
 
-    auto current = &current_node();
-
-    if (contains(current->nodes, name)) {
-      node_id = current->nodes[name];
+    node_id_t node_id;
+    if (const auto found = nodes.find(symbol); found != std::cend(nodes)) {
+      node_id = found->second;
     } else {
       node_id = create_node(name, exported);
-      current = &current_node();
-      current->nodes[name] = node_id;
     }
 
     m_current_nodes_path.push_back({ name, node_id });
@@ -91,62 +203,188 @@ public:
 
   bool is_in_global_context() const { return m_local_nodes.empty(); }
 
-  struct entry_info
+  found_entries find(const qualified_names_t& names) const
   {
-    token_t registration_token;
-    Entry entry;
-    bool exported{ false };
-  };
-
-  std::vector<entry_info> find(const qualified_names_t& names) const
-  {
-    const auto found_range = find_it(names);
-
-    if (!found_range) {
-      return {};
+    if (is_qualified_name(names)) {
+      return find_qualified(names);
     }
 
-    return to_entries_info(*found_range);
+    return find(names.front().name);
   }
 
-  std::vector<entry_info> find_in_current_node(const lexer::token& name) const
+  found_entries find_in_current_node(const token_t& name) const
   {
-    const auto& entries = current_entries();
-    const auto found_range = entries.equal_range(name);
-    return to_entries_info(found_range);
+    found_entries result;
+    if (!m_local_nodes.empty()) {
+      const auto entries = find_entries(m_local_nodes.back(), name.str());
+      if (entries) {
+        result.append(entries->data(), entries->size());
+      }
+      return result;
+    }
+
+    if (const auto entries = find_entries(current_entries(), name.str())) {
+      append_global_entries(*entries, result);
+    }
+
+    append_imported_entries(current_node(), name, result);
+    return result;
   }
 
   std::optional<token_t> find_node_registration_token(
     const qualified_names_t& names) const
   {
-    const auto node = find_node(std::cbegin(names), std::cend(names));
-    if (!node) {
+    const auto path = find_node_path(std::cbegin(names), std::cend(names));
+    if (!path) {
       return std::nullopt;
     }
 
-    return node->name;
+    if (const auto node = node_at(*path)) {
+      return node->name;
+    }
+
+    for (auto it = std::cbegin(m_imported); it != visible_imported_end();
+         ++it) {
+      if (const auto node = (*it)->node_at(*path)) {
+        return node->name;
+      }
+    }
+
+    return std::nullopt;
   }
 
   // Todo: test it
   qualified_entries_finder collect_exported_stuff() const
   {
     qualified_entries_finder cloned;
+    cloned.m_symbols = m_symbols;
     cloned.m_nodes_container = m_nodes_container;
     cloned.erase_not_exported();
     return cloned;
   }
 
+  // Imported entries are not copied. The imported finder is kept as a layer,
+  // which lookups consult after entries of the corresponding node of this
+  // finder, so it must outlive this finder and all its clones. Entries of
+  // layers are never exported, so there are no recursive imports. Returns
+  // false if any imported entry collides with an already visible one.
   bool merge_imported_stuff(const qualified_entries_finder& imported,
                             errors::errors_observer& errs)
   {
-    auto backup = std::move(m_current_nodes_path);
+    names_path_t path;
     const auto succeed =
-      merge_node(imported.m_nodes_container, imported.m_nodes_container[0],
-                 m_nodes_container[0]);
-    m_current_nodes_path = std::move(backup);
+      !collides(imported, imported.m_nodes_container[0], path);
+    m_imported.emplace_back(&imported);
     return succeed;
   }
 
+  qualified_entries_checkpoint make_checkpoint() const
+  {
+    return qualified_entries_checkpoint{ .nodes_count =
+                                           m_nodes_container.size(),
+                                         .entries_count = m_entries_count,
+                                         .imported_count = m_imported.size(),
+                                         .path_depth =
+                                           m_current_nodes_path.size() };
+  }
+
+  // Removes global nodes, entries and imported layers, that have been added
+  // after the checkpoint, and leaves nodes entered since then. Checkpoint has
+  // to be made in a global node.
+  void rollback(const qualified_entries_checkpoint& checkpoint)
+  {
+    CMSL_ASSERT(checkpoint.path_depth <= m_current_nodes_path.size());
+
+    const auto is_added_node = [&checkpoint](const auto& pair) {
+      return pair.second >= checkpoint.nodes_count;
+    };
+    const auto is_added_entry = [&checkpoint](const entry_info& e) {
+      return e.registration_index >= checkpoint.entries_count;
+    };
+
+    m_nodes_container.erase(std::next(std::begin(m_nodes_container),
+                                      checkpoint.nodes_count),
+                            std::end(m_nodes_container));
+    for (auto& node : m_nodes_container) {
+      cmsl::remove_if(node.nodes, is_added_node);
+
+      for (auto& [symbol, entries] : node.entries) {
+        (void)symbol;
+        // Added entries are at the front.
+        const auto first_kept =
+          std::find_if_not(std::cbegin(entries), std::cend(entries),
+                           is_added_entry);
+        if (first_kept != std::cbegin(entries)) {
+          entries = entries_t(first_kept, std::cend(entries));
+        }
+      }
+      cmsl::remove_if(node.entries,
+                      [](const auto& pair) { return pair.second.empty(); });
+    }
+
+    m_local_nodes.clear();
+    m_current_nodes_path.erase(std::next(std::begin(m_current_nodes_path),
+                                         checkpoint.path_depth),
+                               std::end(m_current_nodes_path));
+    m_entries_count = checkpoint.entries_count;
+    m_imported.resize(checkpoint.imported_count);
+  }
+
+  qualified_entries_snapshot make_snapshot() const
+  {
+    qualified_entries_snapshot snapshot;
+    snapshot.nodes_count = m_nodes_container.size();
+    snapshot.entries_count = m_entries_count;
+    snapshot.imported_count = m_imported.size();
+    for (const auto& node : m_current_nodes_path) {
+      snapshot.nodes_path.emplace_back(node.id);
+    }
+    return snapshot;
+  }
+
+  // Enters the global node of the snapshot, so names are looked up as at the
+  // time the snapshot was made. If hide_later_entries is set, nodes, entries
+  // and imported layers added after the snapshot are not found. Local nodes
+  // are put aside till leave_snapshot(). Snapshots can be nested.
+  void enter_snapshot(const qualified_entries_snapshot& snapshot,
+                      bool hide_later_entries)
+  {
+    auto& outside = m_outside_snapshots.emplace_back();
+    outside.nodes_path = std::move(m_current_nodes_path);
+    outside.local_nodes = std::move(m_local_nodes);
+    outside.visible_nodes_count = m_visible_nodes_count;
+    outside.visible_entries_count = m_visible_entries_count;
+    outside.visible_imported_count = m_visible_imported_count;
+    m_current_nodes_path.clear();
+    m_local_nodes.clear();
+    for (const auto id : snapshot.nodes_path) {
+      m_current_nodes_path.push_back({ m_nodes_container[id].name, id });
+    }
+
+    if (hide_later_entries) {
+      m_visible_nodes_count = snapshot.nodes_count;
+      m_visible_entries_count = snapshot.entries_count;
+      m_visible_imported_count = snapshot.imported_count;
+    } else {
+      m_visible_nodes_count = k_all_visible;
+      m_visible_entries_count = k_all_visible;
+      m_visible_imported_count = k_all_visible;
+    }
+  }
+
+  void leave_snapshot()
+  {
+    CMSL_ASSERT(!m_outside_snapshots.empty());
+
+    auto& outside = m_outside_snapshots.back();
+    m_current_nodes_path = std::move(outside.nodes_path);
+    m_local_nodes = std::move(outside.local_nodes);
+    m_visible_nodes_count = outside.visible_nodes_count;
+    m_visible_entries_count = outside.visible_entries_count;
+    m_visible_imported_count = outside.visible_imported_count;
+    m_outside_snapshots.pop_back();
+  }
+
   template <typename ScopeHandler, typename EntryHandler>
   void visit_entries(ScopeHandler& scope_handler,
                      EntryHandler& entry_handler) const
@@ -161,8 +399,11 @@ private:
   {
     scope_handler.enter_global_scope(node.name.str());
 
-    for (const auto& [token, entry] : node.entries) {
-      entry_handler(token, entry.exported, entry.e);
+    for (const auto& [symbol, entries] : node.entries) {
+      (void)symbol;
+      for (const auto& e : entries) {
+        entry_handler(e.registration_token, e.exported, e.entry);
+      }
     }
 
     for (const auto& child_node_pair : node.nodes) {
@@ -174,40 +415,38 @@ private:
     scope_handler.leave_global_scope();
   }
 
-  bool merge_node(std::vector<tree_node> imported_nodes_container,
-                  const tree_node& imported_node, tree_node& into)
+  bool collides(const qualified_entries_finder& imported,
+                const tree_node& imported_node, names_path_t& path) const
   {
-    bool result{ true };
+    bool result{ false };
 
-    // We don't want recursive imports, thus the false.
-    const auto exported{ false };
-
-    entries_map_t merged_entries;
-
-    for (const auto& [token, entry] : imported_node.entries) {
-      const auto found = into.entries.find(token);
-      if (found != std::cend(into.entries)) {
+    const auto own_node = node_at(path);
+    for (const auto& [symbol, entries] : imported_node.entries) {
+      const auto name = imported.m_symbols.name_of(symbol);
+      (void)entries;
+      if (own_node != nullptr && find_entries(own_node->entries, name)) {
         // Todo: redeclaration
-        result = false;
+        result = true;
         continue;
       }
 
-      possibly_exported_entry e{ .e = entry.e, .exported = exported };
-      merged_entries.emplace(token, std::move(e));
+      for (const auto layer : m_imported) {
+        const auto layer_node = layer->node_at(path);
+        if (layer_node != nullptr &&
+            layer->find_entries(layer_node->entries, name)) {
+          result = true;
+          break;
+        }
+      }
     }
 
-    auto& curr_entries = current_entries();
-    std::move(std::begin(merged_entries), std::end(merged_entries),
-              std::inserter(curr_entries, std::end(curr_entries)));
-
-    for (const auto& [token, id] : imported_node.nodes) {
-      (void)token;
-      const auto& node = imported_nodes_container[id];
-      enter_global_node(node.name, exported);
-      const auto node_merging_result =
-        merge_node(imported_nodes_container, node, current_node());
-      result = result && node_merging_result;
-      leave_node();
+    for (const auto& [symbol, id] : imported_node.nodes) {
+      (void)symbol;
+      const auto& child = imported.m_nodes_container[id];
+      path.emplace_back(child.name);
+      const auto child_collides = collides(imported, child, path);
+      result = result || child_collides;
+      path.pop_back();
     }
 
     return result;
@@ -221,12 +460,20 @@ private:
 
   void erase_not_exported_in_node(tree_node& node)
   {
-    const auto entry_pred = [](const auto& pair) {
-      const auto& entry = pair.second;
-      return !entry.exported;
-    };
+    for (auto& [symbol, entries] : node.entries) {
+      (void)symbol;
+      // Exported entries are copied, as entries are not assignable.
+      entries_t exported;
+      for (const auto& e : entries) {
+        if (e.exported) {
+          exported.emplace_back(e);
+        }
+      }
+      entries = std::move(exported);
+    }
 
-    cmsl::remove_if(node.entries, entry_pred);
+    cmsl::remove_if(node.entries,
+                    [](const auto& pair) { return pair.second.empty(); });
 
     for (auto& child : node.nodes) {
       const auto node_id = child.second;
@@ -235,22 +482,51 @@ private:
     }
   }
 
-  std::vector<entry_info> to_entries_info(
-    const search_result_range_t& range) const
+  const entries_t* find_entries(const entries_map_t& entries,
+                                cmsl::string_view name) const
   {
-    std::vector<entry_info> results;
+    const auto symbol = m_symbols.find(name);
+    if (!symbol) {
+      return nullptr;
+    }
 
-    std::transform(range.first, range.second, std::back_inserter(results),
-                   [](const auto& pair) {
-                     const auto& [registration_token, exported_entry] = pair;
+    const auto found = entries.find(*symbol);
+    return found != std::cend(entries) ? &found->second : nullptr;
+  }
 
-                     return entry_info{ .registration_token =
-                                          registration_token,
-                                        .entry = exported_entry.e,
-                                        .exported = exported_entry.exported };
-                   });
+  const tree_node* child_node(const tree_node& node,
+                              cmsl::string_view name) const
+  {
+    const auto symbol = m_symbols.find(name);
+    if (!symbol) {
+      return nullptr;
+    }
 
-    return results;
+    const auto found = node.nodes.find(*symbol);
+    if (found == std::cend(node.nodes) ||
+        found->second >= m_visible_nodes_count) {
+      return nullptr;
+    }
+
+    return &m_nodes_container[found->second];
+  }
+
+  // Node of this finder, that has the same path of names as the node of the
+  // other finder.
+  const tree_node* node_matching(const qualified_entries_finder& other,
+                                 const tree_node& other_node) const
+  {
+    if (other_node.id == 0u) {
+      return &m_nodes_container[0];
+    }
+
+    const auto parent =
+      node_matching(other, other.m_nodes_container[other_node.parent_id]);
+    if (parent == nullptr) {
+      return nullptr;
+    }
+
+    return child_node(*parent, other_node.name.str());
   }
 
   tree_node& current_node()
@@ -281,7 +557,7 @@ private:
     m_nodes_container.emplace_back(node);
     if (current_node_id() != k_bad_id) {
       auto& current = current_node();
-      current.nodes[name] = id;
+      current.nodes[m_symbols.intern(name.str())] = id;
     }
     return id;
   }
@@ -297,113 +573,199 @@ private:
     return names.size() > 1u;
   }
 
-  std::optional<search_result_range_t> find_it(
-    const qualified_names_t& names) const
+  // Path of names of global nodes, from the root (excluded) to the current
+  // node.
+  names_path_t current_path() const
   {
-    if (is_qualified_name(names)) {
-      return find_qualified(names);
-    } else {
-      const auto name = names.front().name;
-      return find(name);
+    names_path_t path;
+    for (const auto& node : m_current_nodes_path) {
+      if (node.id != 0u) {
+        path.emplace_back(node.name);
+      }
+    }
+    return path;
+  }
+
+  const tree_node* node_at(const names_path_t& path) const
+  {
+    const tree_node* node = &m_nodes_container[0];
+    for (const auto& name : path) {
+      node = child_node(*node, name.str());
+      if (node == nullptr) {
+        return nullptr;
+      }
+    }
+    return node;
+  }
+
+  bool has_node(const names_path_t& path) const
+  {
+    if (node_at(path) != nullptr) {
+      return true;
+    }
+
+    return std::any_of(
+      std::cbegin(m_imported), visible_imported_end(),
+      [&path](const auto imported) { return imported->node_at(path); });
+  }
+
+  // Imported layers added after the entered snapshot are skipped.
+  typename std::vector<const qualified_entries_finder*>::const_iterator
+  visible_imported_end() const
+  {
+    return std::next(std::cbegin(m_imported),
+                     std::min(m_imported.size(), m_visible_imported_count));
+  }
+
+  void append_imported_entries(const names_path_t& path, const token_t& name,
+                               found_entries& result) const
+  {
+    for (auto it = std::cbegin(m_imported); it != visible_imported_end();
+         ++it) {
+      if (const auto node = (*it)->node_at(path)) {
+        append_entries(**it, *node, name, result);
+      }
+    }
+  }
+
+  // Appends entries of nodes of imported layers, that correspond to the own
+  // node.
+  void append_imported_entries(const tree_node& own_node, const token_t& name,
+                               found_entries& result) const
+  {
+    for (auto it = std::cbegin(m_imported); it != visible_imported_end();
+         ++it) {
+      if (const auto node = (*it)->node_matching(*this, own_node)) {
+        append_entries(**it, *node, name, result);
+      }
     }
   }
 
-  std::optional<node_id_and_name> find_node(
+  static void append_entries(const qualified_entries_finder& finder,
+                             const tree_node& node, const token_t& name,
+                             found_entries& result)
+  {
+    if (const auto entries = finder.find_entries(node.entries, name.str())) {
+      finder.append_global_entries(*entries, result);
+    }
+  }
+
+  // Entries registered after the entered snapshot are at the front, and are
+  // skipped.
+  void append_global_entries(const entries_t& entries,
+                             found_entries& result) const
+  {
+    const auto first_visible = std::find_if(
+      std::cbegin(entries), std::cend(entries), [this](const entry_info& e) {
+        return e.registration_index < m_visible_entries_count;
+      });
+    if (first_visible != std::cend(entries)) {
+      result.append(&*first_visible,
+                    static_cast<std::size_t>(
+                      std::distance(first_visible, std::cend(entries))));
+    }
+  }
+
+  // Finds the path of the node named by names, the same way as the name
+  // lookup does: the first name is looked for in the current node and then in
+  // its parents. Nodes of imported layers are taken into account.
+  std::optional<names_path_t> find_node_path(
     qualified_names_t::const_iterator begin,
     qualified_names_t::const_iterator end) const
   {
-    const auto& first_name = begin->name;
-    auto* node = &current_node();
+    names_path_t path;
 
+    const auto& first_name = begin->name;
     const auto is_explicit_root_node_accessed = first_name.str().empty();
-    if (is_explicit_root_node_accessed) {
-      node = &m_nodes_container[0];
-    } else {
+    if (!is_explicit_root_node_accessed) {
+      path = current_path();
+
       while (true) {
-        const auto found = node->nodes.find(first_name);
-        if (found != std::cend(node->nodes)) {
-          const auto id = found->second;
-          node = &m_nodes_container[id];
+        path.emplace_back(first_name);
+        if (has_node(path)) {
           break;
         }
+        path.pop_back();
 
-        const auto is_root_node = (node->id == 0u);
-        if (is_root_node) {
-          node = nullptr;
-          break;
+        if (path.empty()) {
+          return std::nullopt;
         }
 
-        node = &m_nodes_container[node->parent_id];
+        path.pop_back();
       }
     }
 
-    if (node == nullptr) {
-      return std::nullopt;
+    for (auto it = std::next(begin); it != end; ++it) {
+      path.emplace_back(it->name);
     }
 
-    auto first = std::next(begin);
-    while (first != end) {
-      if (!contains(node->nodes, first->name)) {
-        return std::nullopt;
-      }
-
-      const auto next_node_id = node->nodes.at(first->name);
-      node = &m_nodes_container[next_node_id];
-      ++first;
+    if (!has_node(path)) {
+      return std::nullopt;
     }
 
-    return node_id_and_name{ node->name, node->id };
+    return path;
   }
 
-  std::optional<search_result_range_t> find_qualified(
-    const qualified_names_t& names) const
+  found_entries find_qualified(const qualified_names_t& names) const
   {
-    const auto found_ctx =
-      find_node(std::cbegin(names), std::prev(std::cend(names)));
-    if (!found_ctx) {
-      return std::nullopt;
+    const auto path =
+      find_node_path(std::cbegin(names), std::prev(std::cend(names)));
+    if (!path) {
+      return {};
     }
 
-    const auto node = &m_nodes_container[found_ctx->id];
-    const auto looked_identifier_name = names.back().name;
-
-    return find_in_node(looked_identifier_name, node->entries);
-  }
+    const auto& looked_name = names.back().name;
 
-  std::optional<search_result_range_t> find_in_node(
-    const token_t& name, const entries_map_t& ids) const
-  {
-    const auto found = ids.equal_range(name);
-    if (found.first == std::cend(ids)) {
-      return std::nullopt;
+    found_entries result;
+    if (const auto node = node_at(*path)) {
+      append_entries(*this, *node, looked_name, result);
     }
 
-    return found;
+    append_imported_entries(*path, looked_name, result);
+    return result;
   }
 
-  std::optional<search_result_range_t> find(const token_t& name) const
+  found_entries find(const token_t& name) const
   {
+    const auto symbol = m_symbols.find(name.str());
+    const auto find_in_node =
+      [&symbol](const entries_map_t& entries) -> const entries_t* {
+      if (!symbol) {
+        return nullptr;
+      }
+
+      const auto found = entries.find(*symbol);
+      return found != std::cend(entries) ? &found->second : nullptr;
+    };
+
+    found_entries result;
+
     // Try to find in local nodes.
     for (auto node_it = std::crbegin(m_local_nodes);
          node_it != std::crend(m_local_nodes); ++node_it) {
-      const auto found = find_in_node(name, *node_it);
-      if (found) {
-        return *found;
+      if (const auto found = find_in_node(*node_it)) {
+        result.append(found->data(), found->size());
+        return result;
       }
     }
 
-    // If not found, try to find in global nodes.
+    // If not found, try to find in global nodes and in the corresponding nodes
+    // of imported layers.
     auto* current = &current_node();
 
     while (true) {
-      const auto found = find_in_node(name, current->entries);
-      if (found) {
-        return *found;
+      if (const auto found = find_in_node(current->entries)) {
+        append_global_entries(*found, result);
+      }
+
+      append_imported_entries(*current, name, result);
+      if (!result.empty()) {
+        return result;
       }
 
       const auto is_root_ctx = (current->id == 0u);
       if (is_root_ctx) {
-        return std::nullopt;
+        return {};
       }
 
       current = &m_nodes_container[current->parent_id];
@@ -429,8 +791,16 @@ private:
   }
 
 private:
+  symbol_table m_symbols;
   std::vector<tree_node> m_nodes_container;
   std::vector<node_id_and_name> m_current_nodes_path;
   std::vector<entries_map_t> m_local_nodes;
+  std::vector<const qualified_entries_finder*> m_imported;
+  std::size_t m_entries_count{ 0u };
+  // States outside of entered snapshots, the innermost one last.
+  std::vector<outside_snapshot_state> m_outside_snapshots;
+  std::size_t m_visible_nodes_count{ k_all_visible };
+  std::size_t m_visible_entries_count{ k_all_visible };
+  std::size_t m_visible_imported_count{ k_all_visible };
 };
 }
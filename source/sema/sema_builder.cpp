@@ -1,6 +1,7 @@
 #include "sema/sema_builder.hpp"
 
 #include "ast/ast_node.hpp"
+#include "common/assert.hpp"
 #include "sema/sema_builder_ast_visitor.hpp"
 
 namespace cmsl::sema {
@@ -11,7 +12,8 @@ sema_builder::sema_builder(
   add_declarative_file_semantic_handler& add_declarative_file_handler,
   import_handler& imports_handler,
   const builtin_token_provider& builtin_token_provider,
-  builtin_types_accessor builtin_types)
+  builtin_types_accessor builtin_types, lazy_function_bodies* lazy_bodies,
+  bool defer_function_bodies)
   : m_ctx{ ctx }
   , m_errs{ errs }
   , m_qualified_ctxs{ qualified_ctxs }
@@ -21,7 +23,10 @@ sema_builder::sema_builder(
   , m_imports_handler{ imports_handler }
   , m_builtin_token_provider{ builtin_token_provider }
   , m_builtin_types{ builtin_types }
+  , m_lazy_bodies{ lazy_bodies }
+  , m_defer_function_bodies{ defer_function_bodies }
 {
+  CMSL_ASSERT(!m_defer_function_bodies || m_lazy_bodies != nullptr);
 }
 
 std::unique_ptr<sema_node> sema_builder::build(const ast::ast_node& ast_tree)
@@ -39,7 +44,10 @@ std::unique_ptr<sema_node> sema_builder::build(const ast::ast_node& ast_tree)
                                       m_builtin_types,
                                       m_add_subdirectory_handler,
                                       m_add_declarative_file_handler,
-                                      m_imports_handler };
+                                      m_imports_handler,
+                                      &m_overload_resolution_cache,
+                                      m_lazy_bodies,
+                                      m_defer_function_bodies };
 
   sema_builder_ast_visitor visitor{ members };
 
@@ -2,6 +2,7 @@
 
 #include "ast/ast_node_visitor.hpp"
 #include "sema/builtin_types_accessor.hpp"
+#include "sema/overload_resolution_cache.hpp"
 
 #include <memory>
 
@@ -20,6 +21,7 @@ class add_subdirectory_semantic_handler;
 class builtin_token_provider;
 class factories_provider;
 class import_handler;
+class lazy_function_bodies;
 class sema_context;
 class sema_node;
 struct qualified_contextes_refs;
@@ -27,6 +29,8 @@ struct qualified_contextes_refs;
 class sema_builder
 {
 public:
+  // If defer_function_bodies is set, bodies of functions with explicit return
+  // types are deferred to lazy_bodies, instead of being built.
   explicit sema_builder(
     sema_context& ctx, errors::errors_observer& errs,
     qualified_contextes_refs& qualified_ctxs, factories_provider& factories,
@@ -34,7 +38,9 @@ public:
     add_declarative_file_semantic_handler& add_declarative_file_handler,
     import_handler& imports_handler,
     const builtin_token_provider& builtin_token_provider,
-    builtin_types_accessor builtin_types);
+    builtin_types_accessor builtin_types,
+    lazy_function_bodies* lazy_bodies = nullptr,
+    bool defer_function_bodies = false);
 
   std::unique_ptr<sema_node> build(const ast::ast_node& ast_tree);
 
@@ -48,6 +54,12 @@ private:
   import_handler& m_imports_handler;
   const builtin_token_provider& m_builtin_token_provider;
   builtin_types_accessor m_builtin_types;
+  // Null if all function bodies are built eagerly.
+  lazy_function_bodies* m_lazy_bodies;
+  bool m_defer_function_bodies;
+  // Functions and types don't go away while the builder exists, so chosen
+  // overloads are remembered across all built nodes.
+  overload_resolution_cache m_overload_resolution_cache;
 };
 }
 }
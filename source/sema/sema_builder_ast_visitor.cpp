@@ -35,6 +35,7 @@
 #include "sema/identifiers_context.hpp"
 #include "sema/identifiers_index_provider.hpp"
 #include "sema/import_handler.hpp"
+#include "sema/lazy_function_bodies.hpp"
 #include "sema/overload_resolution.hpp"
 #include "sema/sema_context.hpp"
 #include "sema/sema_nodes.hpp"
@@ -49,6 +50,30 @@
 #include <unordered_set>
 
 namespace cmsl::sema {
+namespace {
+// Frame slots allocated inside of a scope are given back when the scope ends.
+class frame_scope_guard
+{
+public:
+  explicit frame_scope_guard(function_parsing_context& ctx)
+    : m_ctx{ ctx }
+    , m_next_frame_slot{ ctx.next_frame_slot }
+  {
+    ++m_ctx.scope_depth;
+  }
+
+  ~frame_scope_guard()
+  {
+    m_ctx.next_frame_slot = m_next_frame_slot;
+    --m_ctx.scope_depth;
+  }
+
+private:
+  function_parsing_context& m_ctx;
+  unsigned m_next_frame_slot;
+};
+}
+
 sema_builder_ast_visitor::sema_builder_ast_visitor(
   sema_builder_ast_visitor_members& members)
   : m_{ members }
@@ -58,6 +83,7 @@ sema_builder_ast_visitor::sema_builder_ast_visitor(
 void sema_builder_ast_visitor::visit(const ast::block_node& node)
 {
   auto ig = m_.qualified_ctxs.local_ids_guard();
+  frame_scope_guard frame_guard{ m_.parsing_ctx.function_parsing_ctx };
   std::vector<std::unique_ptr<sema_node>> nodes;
 
   for (const auto& n : node.nodes()) {
@@ -117,35 +143,25 @@ void sema_builder_ast_visitor::visit(const ast::class_node& node)
   std::vector<std::unique_ptr<function_node>> functions;
 
   for (auto function_declaration : members->functions) {
-    auto function_params_guard = m_.qualified_ctxs.local_ids_guard();
-    for (const auto& param_decl :
-         function_declaration.fun->signature().params) {
-      m_.qualified_ctxs.ids.register_identifier(
-        param_decl.name, { param_decl.ty, param_decl.index },
-        /*exported=*/false);
+    if (should_defer_function_body(
+          function_declaration.should_deduce_return_type)) {
+      auto deferred_node = std::make_unique<function_node>(
+        function_declaration.ast_function_node, *function_declaration.fun,
+        nullptr);
+      m_.lazy_bodies->defer(*deferred_node, *function_declaration.fun,
+                            function_declaration.body_to_visit, m_,
+                            class_context);
+      functions.emplace_back(std::move(deferred_node));
+      continue;
     }
 
-    m_.parsing_ctx.function_parsing_ctx.function = function_declaration.fun;
-    m_.parsing_ctx.function_parsing_ctx.return_nodes.clear();
-    auto body = visit_child_node<block_node>(
-      function_declaration.body_to_visit, class_context);
-    m_.parsing_ctx.function_parsing_ctx.function = nullptr;
+    auto body = build_function_body(
+      *function_declaration.fun, function_declaration.body_to_visit,
+      function_declaration.should_deduce_return_type, class_context);
     if (!body) {
       return;
     }
 
-    add_implicit_return_node_if_need(*body);
-
-    if (function_declaration.should_deduce_return_type) {
-      const auto return_type =
-        try_deduce_currently_parsed_function_return_type();
-      if (!return_type) {
-        return;
-      }
-      function_declaration.fun->set_return_type(*return_type);
-    }
-
-    function_declaration.fun->set_body(*body);
     functions.emplace_back(std::make_unique<function_node>(
       function_declaration.ast_function_node, *function_declaration.fun,
       std::move(body)));
@@ -225,15 +241,17 @@ void sema_builder_ast_visitor::visit(const ast::binary_operator_node& node)
     return;
   }
 
-  overload_resolution over_resolution{ m_.errors_observer, op };
+  overload_resolution over_resolution{ m_.errors_observer, op,
+                                       m_.overload_resolutions };
   const auto chosen_function = over_resolution.choose(lookup_result, *rhs);
   if (!chosen_function) {
     return;
   }
+  require_function_body(*chosen_function);
 
   m_result_node = std::make_unique<binary_operator_node>(
     node, std::move(lhs), node.operator_(), *chosen_function, std::move(rhs),
-    chosen_function->return_type());
+    chosen_function->return_type(), unboxed_operation(*chosen_function));
 }
 
 void sema_builder_ast_visitor::visit(const ast::class_member_access_node& node)
@@ -268,12 +286,14 @@ std::unique_ptr<expression_node> sema_builder_ast_visitor::build_function_call(
   const auto function_lookup_result = node.is_generic_type_constructor_call()
     ? find_generict_type_constructor_functions(node.generic_type_name())
     : find_functions(node.names());
-  overload_resolution over_resolution{ m_.errors_observer, node.name() };
+  overload_resolution over_resolution{ m_.errors_observer, node.name(),
+                                       m_.overload_resolutions };
   const auto chosen_function =
     over_resolution.choose(function_lookup_result, *params);
   if (!chosen_function) {
     return nullptr;
   }
+  require_function_body(*chosen_function);
 
   const auto chosen_function_return_type_not_known_yet =
     chosen_function->try_return_type() == nullptr;
@@ -309,8 +329,11 @@ std::unique_ptr<expression_node> sema_builder_ast_visitor::build_function_call(
     } break;
     case sema_context::context_type::class_: {
       const auto& name = chosen_function->return_type().name();
-      const auto& function_name =
-        name.is_generic() ? name.primary_name_token().str() : name.to_string();
+      // Both branches are std::string, so the result does not view the
+      // destroyed result of to_string().
+      const auto function_name = name.is_generic()
+        ? std::string{ name.primary_name_token().str() }
+        : name.to_string();
       const auto is_constructor =
         chosen_function->signature().name.str() == function_name;
 
@@ -460,12 +483,14 @@ void sema_builder_ast_visitor::visit(
   }
 
   const auto member_functions = lhs->type().find_member_function(name);
-  overload_resolution over_resolution{ m_.errors_observer, node.name() };
+  overload_resolution over_resolution{ m_.errors_observer, node.name(),
+                                       m_.overload_resolutions };
   const auto chosen_function =
     over_resolution.choose(member_functions, *params);
   if (!chosen_function) {
     return;
   }
+  require_function_body(*chosen_function);
 
   // Convert call parameter nodes if need, e.g. to a cast_to_reference_node, if
   // function accepts a reference.
@@ -524,8 +549,8 @@ void sema_builder_ast_visitor::visit(const ast::id_node& node)
   const auto id_token = names.back().name;
 
   if (const auto info = m_.qualified_ctxs.ids.info_of(names)) {
-    m_result_node =
-      std::make_unique<id_node>(node, info->type, names, info->index);
+    m_result_node = std::make_unique<id_node>(node, info->type, names,
+                                              info->index, info->slot);
     return;
   } else if (const auto enum_info = m_.qualified_ctxs.enums.info_of(names)) {
     m_result_node = std::make_unique<enum_constant_access_node>(
@@ -608,10 +633,12 @@ void sema_builder_ast_visitor::visit(const ast::user_function_node& node)
     }
 
     const auto identifier_index = identifiers_index_provider::get_next();
+    const auto slot = frame_slot{ static_cast<unsigned>(params.size()), 0u };
     params.emplace_back(
       param_decl_t{ *param_type, param_decl.name, identifier_index });
     m_.qualified_ctxs.ids.register_identifier(
-      param_decl.name, { *param_type, identifier_index }, /*exported=*/false);
+      param_decl.name, { *param_type, identifier_index, slot },
+      /*exported=*/false);
   }
 
   // Todo: add test for function redefinition.
@@ -629,16 +656,27 @@ void sema_builder_ast_visitor::visit(const ast::user_function_node& node)
   m_.qualified_ctxs.functions.register_function(node.name(), function,
                                                 is_exported);
 
+  if (should_defer_function_body(should_deduce_return_type)) {
+    auto deferred_node =
+      std::make_unique<function_node>(node, function, nullptr);
+    m_.lazy_bodies->defer(*deferred_node, function, node.body(), m_, m_.ctx);
+    m_result_node = std::move(deferred_node);
+    return;
+  }
+
   // Store pointer to function that is currently parsed,
   // so function body will be able to figure out function return type
   // and make casted return expression nodes as needed.
-  m_.parsing_ctx.function_parsing_ctx.function = &function;
-  m_.parsing_ctx.function_parsing_ctx.return_nodes.clear();
+  auto& function_parsing_ctx = m_.parsing_ctx.function_parsing_ctx;
+  function_parsing_ctx.function = &function;
+  function_parsing_ctx.return_nodes.clear();
+  function_parsing_ctx.start_frame(function.signature().params.size());
   auto block = visit_child_node<block_node>(node.body());
-  m_.parsing_ctx.function_parsing_ctx.function = nullptr;
+  function_parsing_ctx.function = nullptr;
   if (!block) {
     return;
   }
+  function.set_frame_size(function_parsing_ctx.frame_size);
 
   if (should_deduce_return_type) {
     return_type = try_deduce_currently_parsed_function_return_type();
@@ -791,7 +829,10 @@ sema_builder_ast_visitor sema_builder_ast_visitor::clone(
                                       m_.builtin_types,
                                       m_.add_subdir_handler,
                                       m_.add_declarative_file_handler,
-                                      m_.imports_handler };
+                                      m_.imports_handler,
+                                      m_.overload_resolutions,
+                                      m_.lazy_bodies,
+                                      m_.defer_function_bodies };
 
   return sema_builder_ast_visitor{ members };
 }
@@ -838,7 +879,10 @@ std::unique_ptr<sema_node> sema_builder_ast_visitor::visit_child(
                                       m_.builtin_types,
                                       m_.add_subdir_handler,
                                       m_.add_declarative_file_handler,
-                                      m_.imports_handler };
+                                      m_.imports_handler,
+                                      m_.overload_resolutions,
+                                      m_.lazy_bodies,
+                                      m_.defer_function_bodies };
   auto v = sema_builder_ast_visitor{ members };
   node.visit(v);
   return std::move(v.m_result_node);
@@ -955,10 +999,7 @@ template <unsigned N>
 lexer::token sema_builder_ast_visitor::make_token(lexer::token_type token_type,
                                                   const char (&tok)[N])
 {
-  // N counts also '\0'
-  const auto src_range = source_range{ source_location{ 1u, 1u, 0u },
-                                       source_location{ 1u, N, N - 1u } };
-  return lexer::token{ token_type, src_range, source_view{ tok } };
+  return lexer::make_token(token_type, tok);
 }
 
 std::unique_ptr<expression_node>
@@ -1110,6 +1151,62 @@ void sema_builder_ast_visitor::add_implicit_return_node_if_need(
   manipulator.append_expression(std::move(ret_node));
 }
 
+std::unique_ptr<block_node> sema_builder_ast_visitor::build_function_body(
+  user_sema_function& function, const ast::block_node& body,
+  bool should_deduce_return_type, sema_context& ctx)
+{
+  auto function_params_guard = m_.qualified_ctxs.local_ids_guard();
+  const auto& params = function.signature().params;
+  for (auto i = 0u; i < params.size(); ++i) {
+    const auto& param_decl = params[i];
+    const auto slot = frame_slot{ i, 0u };
+    m_.qualified_ctxs.ids.register_identifier(
+      param_decl.name, { param_decl.ty, param_decl.index, slot },
+      /*exported=*/false);
+  }
+
+  auto& function_parsing_ctx = m_.parsing_ctx.function_parsing_ctx;
+  function_parsing_ctx.function = &function;
+  function_parsing_ctx.return_nodes.clear();
+  function_parsing_ctx.start_frame(params.size());
+  auto block = visit_child_node<block_node>(body, ctx);
+  function_parsing_ctx.function = nullptr;
+  if (!block) {
+    return nullptr;
+  }
+  function.set_frame_size(function_parsing_ctx.frame_size);
+
+  add_implicit_return_node_if_need(*block);
+
+  if (should_deduce_return_type) {
+    const auto return_type =
+      try_deduce_currently_parsed_function_return_type();
+    if (!return_type) {
+      return nullptr;
+    }
+    function.set_return_type(*return_type);
+  }
+
+  function.set_body(*block);
+  return block;
+}
+
+bool sema_builder_ast_visitor::should_defer_function_body(
+  bool should_deduce_return_type) const
+{
+  // Return type has to be known when a call is built, so it can't be deduced
+  // from a deferred body.
+  return m_.defer_function_bodies && !should_deduce_return_type;
+}
+
+void sema_builder_ast_visitor::require_function_body(
+  const sema_function& function)
+{
+  if (m_.lazy_bodies != nullptr) {
+    m_.lazy_bodies->require(function);
+  }
+}
+
 bool sema_builder_ast_visitor::is_last_node_return_node(
   const block_node& block) const
 {
@@ -1280,15 +1377,23 @@ void sema_builder_ast_visitor::visit(
 
   const auto identifier_index = identifiers_index_provider::get_next();
   const auto is_exported = node.export_().has_value();
+  auto& function_parsing_ctx = m_.parsing_ctx.function_parsing_ctx;
+  std::optional<frame_slot> slot;
+  if (function_parsing_ctx.function != nullptr) {
+    slot = function_parsing_ctx.allocate_frame_slot();
+  }
+
   m_.qualified_ctxs.ids.register_identifier(
-    node.name(), { *type, identifier_index }, is_exported);
+    node.name(), { *type, identifier_index, slot }, is_exported);
   m_result_node = std::make_unique<variable_declaration_node>(
-    node, *type, node.name(), std::move(initialization), identifier_index);
+    node, *type, node.name(), std::move(initialization), identifier_index,
+    slot);
 }
 
 void sema_builder_ast_visitor::visit(const ast::for_node& node)
 {
   auto guard = m_.qualified_ctxs.local_ids_guard();
+  frame_scope_guard frame_guard{ m_.parsing_ctx.function_parsing_ctx };
 
   std::unique_ptr<sema_node> init;
   if (node.init()) {
@@ -1513,14 +1618,17 @@ void sema_builder_ast_visitor::visit(const ast::unary_operator& node)
 
   const auto found_functions =
     expression->type().context().find_function_in_this_scope(node.operator_());
-  overload_resolution resolution{ m_.errors_observer, node.operator_() };
+  overload_resolution resolution{ m_.errors_observer, node.operator_(),
+                                  m_.overload_resolutions };
   const auto chosen_function = resolution.choose(found_functions);
   if (!chosen_function) {
     return;
   }
+  require_function_body(*chosen_function);
 
   m_result_node = std::make_unique<unary_operator_node>(
-    node, node.operator_(), std::move(expression), *chosen_function);
+    node, node.operator_(), std::move(expression), *chosen_function,
+    unboxed_operation(*chosen_function));
 }
 
 void sema_builder_ast_visitor::visit(const ast::enum_node& node)
@@ -1641,4 +1749,60 @@ bool sema_builder_ast_visitor::is_export_allowed() const
 {
   return m_.qualified_ctxs.ids.is_in_global_ctx();
 }
+
+std::optional<builtin_function_kind>
+sema_builder_ast_visitor::unboxed_operation(
+  const sema_function& function) const
+{
+  const auto builtin_function =
+    dynamic_cast<const builtin_sema_function*>(&function);
+  if (builtin_function == nullptr) {
+    return std::nullopt;
+  }
+
+  switch (const auto kind = builtin_function->kind()) {
+    case builtin_function_kind::bool_operator_equal:
+    case builtin_function_kind::bool_operator_equal_equal:
+    case builtin_function_kind::bool_operator_pipe_pipe:
+    case builtin_function_kind::bool_operator_amp_amp:
+    case builtin_function_kind::bool_operator_unary_exclaim:
+    case builtin_function_kind::int_operator_plus:
+    case builtin_function_kind::int_operator_unary_plusplus:
+    case builtin_function_kind::int_operator_minus:
+    case builtin_function_kind::int_operator_unary_minus:
+    case builtin_function_kind::int_operator_unary_minusminus:
+    case builtin_function_kind::int_operator_star:
+    case builtin_function_kind::int_operator_slash:
+    case builtin_function_kind::int_operator_equal:
+    case builtin_function_kind::int_operator_plus_equal:
+    case builtin_function_kind::int_operator_minus_equal:
+    case builtin_function_kind::int_operator_star_equal:
+    case builtin_function_kind::int_operator_slash_equal:
+    case builtin_function_kind::int_operator_less:
+    case builtin_function_kind::int_operator_less_equal:
+    case builtin_function_kind::int_operator_greater:
+    case builtin_function_kind::int_operator_greater_equal:
+    case builtin_function_kind::int_operator_equal_equal:
+    case builtin_function_kind::double_operator_plus:
+    case builtin_function_kind::double_operator_unary_plusplus:
+    case builtin_function_kind::double_operator_minus:
+    case builtin_function_kind::double_operator_unary_minus:
+    case builtin_function_kind::double_operator_unary_minusminus:
+    case builtin_function_kind::double_operator_star:
+    case builtin_function_kind::double_operator_slash:
+    case builtin_function_kind::double_operator_equal:
+    case builtin_function_kind::double_operator_plus_equal:
+    case builtin_function_kind::double_operator_minus_equal:
+    case builtin_function_kind::double_operator_star_equal:
+    case builtin_function_kind::double_operator_slash_equal:
+    case builtin_function_kind::double_operator_less:
+    case builtin_function_kind::double_operator_less_equal:
+    case builtin_function_kind::double_operator_greater:
+    case builtin_function_kind::double_operator_greater_equal:
+      return kind;
+
+    default:
+      return std::nullopt;
+  }
+}
 }
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "ast/ast_node_visitor.hpp"
+#include "sema/builtin_function_kind.hpp"
 #include "sema/builtin_types_accessor.hpp"
+#include "sema/identifier_info.hpp"
 #include "sema/qualified_contextes_refs.hpp"
 #include "sema/sema_context.hpp"
 #include "sema/sema_node.hpp"
@@ -9,6 +11,7 @@
 
 #include <optional>
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -38,6 +41,8 @@ class factories_provider;
 class functions_context;
 class identifiers_context;
 class import_handler;
+class lazy_function_bodies;
+class overload_resolution_cache;
 class return_node;
 class sema_context_impl;
 class sema_type;
@@ -52,11 +57,32 @@ struct function_parsing_context
   sema_function* function{ nullptr };
   std::vector<const return_node*> return_nodes;
 
+  // Parameters occupy the first frame slots. Slots of local variables are
+  // reused by the following scopes after the scope that declared them ends.
+  unsigned next_frame_slot{ 0u };
+  unsigned frame_size{ 0u };
+  unsigned scope_depth{ 0u };
+
   void reset()
   {
     function_node = nullptr;
     function = nullptr;
     return_nodes.clear();
+    start_frame(0u);
+  }
+
+  void start_frame(unsigned params_count)
+  {
+    next_frame_slot = params_count;
+    frame_size = params_count;
+    scope_depth = 0u;
+  }
+
+  frame_slot allocate_frame_slot()
+  {
+    const auto slot = frame_slot{ next_frame_slot++, scope_depth };
+    frame_size = std::max(frame_size, next_frame_slot);
+    return slot;
   }
 };
 
@@ -79,6 +105,13 @@ struct sema_builder_ast_visitor_members
   add_subdirectory_semantic_handler& add_subdir_handler;
   add_declarative_file_semantic_handler& add_declarative_file_handler;
   import_handler& imports_handler;
+  // Shared by all visitors of a sema_builder. Optional.
+  overload_resolution_cache* overload_resolutions{ nullptr };
+  // Functions chosen by overload resolutions are required from it. Optional.
+  lazy_function_bodies* lazy_bodies{ nullptr };
+  // If set, bodies of functions with explicit return types are not built, but
+  // deferred to lazy_bodies.
+  bool defer_function_bodies{ false };
 };
 
 class sema_builder_ast_visitor : public ast::ast_node_visitor
@@ -119,6 +152,9 @@ public:
   void visit(const ast::while_node& node) override;
 
 private:
+  // Builds deferred function bodies.
+  friend class lazy_function_bodies;
+
   function_lookup_result_t find_functions(
     const std::vector<ast::name_with_coloncolon>& names);
   function_lookup_result_t find_generict_type_constructor_functions(
@@ -206,6 +242,13 @@ private:
   bool is_last_node_return_node(const block_node& block) const;
   void add_implicit_return_node_if_need(block_node& block);
 
+  // Registers parameters of the function and builds its body.
+  std::unique_ptr<block_node> build_function_body(
+    user_sema_function& function, const ast::block_node& body,
+    bool should_deduce_return_type, sema_context& ctx);
+  bool should_defer_function_body(bool should_deduce_return_type) const;
+  void require_function_body(const sema_function& function);
+
   bool check_function_return_type(const lexer::token& return_kw,
                                   const expression_node& return_expression);
   const sema_type* try_deduce_currently_parsed_function_return_type();
@@ -217,6 +260,9 @@ private:
 
   bool is_export_allowed() const;
 
+  std::optional<builtin_function_kind> unboxed_operation(
+    const sema_function& function) const;
+
 public:
   std::unique_ptr<sema_node> m_result_node;
 
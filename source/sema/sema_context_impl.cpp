@@ -1,6 +1,7 @@
 #include "sema/sema_context_impl.hpp"
 #include "common/assert.hpp"
 #include "sema/sema_function.hpp"
+#include "sema/sema_type.hpp"
 
 #include <algorithm>
 
@@ -22,6 +23,7 @@ void sema_context_impl::add_function(const sema_function& function)
 void sema_context_impl::add_type(const sema_type& type)
 {
   m_types.emplace_back(&type);
+  m_types_by_name.emplace(type.name().to_string(), &type);
 }
 
 const sema_type* sema_context_impl::find_type(
@@ -57,9 +59,8 @@ const sema_type* sema_context_impl::find_referenced_type(
 const sema_type* sema_context_impl::find_type_in_this_scope(
   const ast::type_representation& name) const
 {
-  const auto pred = [&name](const auto& type) { return name == type->name(); };
-
-  return find_type_in_this_scope_with_predicate(pred);
+  const auto found = m_types_by_name.find(name.to_string());
+  return found != std::cend(m_types_by_name) ? found->second : nullptr;
 }
 
 function_lookup_result_t sema_context_impl::find_function(
@@ -91,9 +92,19 @@ sema_context_impl::find_function_in_this_scope(const lexer::token& name) const
 
   // Collect constructors.
   // Todo: test ctors collecting.
-  const auto type_name =
-    ast::type_representation{ ast::qualified_name{ name } };
-  if (auto ty = find_type_in_this_scope(type_name)) {
+  // Same as looking for a type named by the token alone, but without creating
+  // strings of names of all types.
+  const auto is_named_by_token = [name](const auto& type) {
+    const auto& type_name = type->name();
+    if (type_name.is_generic() || type_name.is_reference()) {
+      return false;
+    }
+
+    const auto& names = type_name.qual_name().names();
+    return names.size() == 1u && !names.front().coloncolon &&
+      names.front().name.str() == name.str();
+  };
+  if (auto ty = find_type_in_this_scope_with_predicate(is_named_by_token)) {
     const auto& type_ctx = ty->context();
     const auto constructors = type_ctx.find_function_in_this_scope(name);
     result.insert(std::end(result), std::cbegin(constructors),
@@ -199,4 +210,26 @@ const sema_context* sema_context_impl::find_root() const
 
   return ctx;
 }
+
+sema_context_impl::checkpoint sema_context_impl::make_checkpoint() const
+{
+  return checkpoint{ m_functions.size(), m_types.size() };
+}
+
+void sema_context_impl::rollback(const checkpoint& cp)
+{
+  CMSL_ASSERT(cp.functions_count <= m_functions.size() &&
+              cp.types_count <= m_types.size());
+  m_functions.resize(cp.functions_count);
+
+  // A removed type may be the first one of its name only if there is no
+  // kept type of the name.
+  for (auto i = cp.types_count; i < m_types.size(); ++i) {
+    const auto found = m_types_by_name.find(m_types[i]->name().to_string());
+    if (found != std::end(m_types_by_name) && found->second == m_types[i]) {
+      m_types_by_name.erase(found);
+    }
+  }
+  m_types.resize(cp.types_count);
+}
 }
@@ -2,6 +2,8 @@
 
 #include "sema/sema_context.hpp"
 
+#include <unordered_map>
+
 namespace cmsl::sema {
 class sema_context_impl : public sema_context
 {
@@ -32,6 +34,17 @@ public:
 
   const sema_context* parent() const override { return m_parent; }
 
+  struct checkpoint
+  {
+    std::size_t functions_count{ 0u };
+    std::size_t types_count{ 0u };
+  };
+
+  // Functions and types added after the checkpoint are removed by
+  // rollback().
+  checkpoint make_checkpoint() const;
+  void rollback(const checkpoint& cp);
+
 private:
   template <typename Predicate>
   const sema_type* find_type_in_this_scope_with_predicate(
@@ -46,6 +59,9 @@ private:
   const sema_context* m_parent;
   std::vector<const sema_function*> m_functions;
   std::vector<const sema_type*> m_types;
+  // The first added type of each name, so a type is found without comparing
+  // names of all types.
+  std::unordered_map<std::string, const sema_type*> m_types_by_name;
   context_type m_context_type;
   std::string m_name;
 };
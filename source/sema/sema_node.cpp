@@ -1,6 +1,7 @@
 #include "sema/sema_node.hpp"
 
 #include "ast/ast_node.hpp"
+#include "sema/sema_nodes.hpp"
 #include "sema_node.hpp"
 
 namespace cmsl::sema {
@@ -24,6 +25,17 @@ const ast::ast_node& sema_node::ast_node() const
   return m_ast_node;
 }
 
+std::vector<sema_node*> sema_node::children()
+{
+  return {};
+}
+
+std::unique_ptr<sema_node> sema_node::replace_child(const sema_node&,
+                                                   std::unique_ptr<sema_node>)
+{
+  return nullptr;
+}
+
 void sema_node::set_parent(const sema_node& node, passkey)
 {
   m_parent = &node;
@@ -33,4 +45,24 @@ const sema_node* sema_node::parent() const
 {
   return m_parent;
 }
+
+unsigned sema_node::statement_line() const
+{
+  return m_statement_line;
+}
+
+void sema_node::set_statement_line(unsigned line, passkey)
+{
+  m_statement_line = line;
+}
+
+unsigned profiled_statement_line(const sema_node& statement)
+{
+  if (dynamic_cast<const block_node*>(&statement) != nullptr ||
+      dynamic_cast<const implicit_return_node*>(&statement) != nullptr) {
+    return 0u;
+  }
+
+  return statement.begin_location().line;
+}
 }
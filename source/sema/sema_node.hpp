@@ -1,5 +1,11 @@
 #pragma once
 
+#include "common/assert.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 namespace cmsl {
 struct source_location;
 
@@ -8,6 +14,7 @@ class ast_node;
 }
 
 namespace sema {
+class mutable_sema_node_visitor;
 class sema_node_visitor;
 
 class sema_node
@@ -23,15 +30,124 @@ public:
   virtual ~sema_node() = default;
 
   virtual void visit(sema_node_visitor& visitor) const = 0;
+  virtual void visit(mutable_sema_node_visitor& visitor) = 0;
+
+  // Children of the node that can be replaced, in order of execution.
+  virtual std::vector<sema_node*> children();
+  // Puts the replacement in place of the child and makes this node its
+  // parent. A null replacement removes the child: it is erased from a list
+  // or leaves a null child, and then the node must not be used anymore.
+  // Returns the replaced child, or null if the node has no such child.
+  virtual std::unique_ptr<sema_node> replace_child(
+    const sema_node& child, std::unique_ptr<sema_node> replacement);
+
   virtual source_location begin_location() const;
   virtual source_location end_location() const;
   const ast::ast_node& ast_node() const;
   const sema_node* parent() const;
   void set_parent(const sema_node& node, passkey);
 
+  // Line that starts when the node is executed as a statement of a block, or
+  // 0 if the node is not such statement or the statement is not profiled,
+  // like a nested block. See profiled_statement_line().
+  unsigned statement_line() const;
+  void set_statement_line(unsigned line, passkey);
+
+protected:
+  template <typename... Slots>
+  static std::vector<sema_node*> children_in(Slots&... slots)
+  {
+    std::vector<sema_node*> children;
+    (add_children(children, slots), ...);
+    return children;
+  }
+
+  // Replaces the child in the first of the slots that holds it. See
+  // replace_child().
+  template <typename... Slots>
+  std::unique_ptr<sema_node> replace_in(
+    const sema_node& child, std::unique_ptr<sema_node>& replacement,
+    Slots&... slots)
+  {
+    std::unique_ptr<sema_node> replaced;
+    (replace_in_slot(child, replacement, replaced, slots) || ...);
+    return replaced;
+  }
+
+private:
+  template <typename Node>
+  static void add_children(std::vector<sema_node*>& children,
+                           std::unique_ptr<Node>& slot)
+  {
+    if (slot) {
+      children.emplace_back(slot.get());
+    }
+  }
+
+  template <typename Node>
+  static void add_children(std::vector<sema_node*>& children,
+                           std::vector<std::unique_ptr<Node>>& slots)
+  {
+    for (auto& slot : slots) {
+      children.emplace_back(slot.get());
+    }
+  }
+
+  template <typename Node>
+  bool replace_in_slot(const sema_node& child,
+                       std::unique_ptr<sema_node>& replacement,
+                       std::unique_ptr<sema_node>& replaced,
+                       std::unique_ptr<Node>& slot)
+  {
+    if (slot.get() != &child) {
+      return false;
+    }
+
+    replaced = std::move(slot);
+    slot = adopt<Node>(replacement);
+    return true;
+  }
+
+  template <typename Node>
+  bool replace_in_slot(const sema_node& child,
+                       std::unique_ptr<sema_node>& replacement,
+                       std::unique_ptr<sema_node>& replaced,
+                       std::vector<std::unique_ptr<Node>>& slots)
+  {
+    const auto found = std::find_if(
+      std::begin(slots), std::end(slots),
+      [&child](const auto& slot) { return slot.get() == &child; });
+    if (found == std::end(slots)) {
+      return false;
+    }
+
+    replaced = std::move(*found);
+    if (replacement) {
+      *found = adopt<Node>(replacement);
+    } else {
+      slots.erase(found);
+    }
+    return true;
+  }
+
+  // Takes the replacement, that has to be a Node, and reparents it.
+  template <typename Node>
+  std::unique_ptr<Node> adopt(std::unique_ptr<sema_node>& replacement)
+  {
+    CMSL_ASSERT(replacement == nullptr ||
+                dynamic_cast<Node*>(replacement.get()) != nullptr);
+    auto node =
+      std::unique_ptr<Node>(static_cast<Node*>(replacement.release()));
+    if (node) {
+      node->set_parent(*this, passkey{});
+    }
+    return node;
+  }
+
 private:
   const ast::ast_node& m_ast_node;
   const sema_node* m_parent{ nullptr };
+  unsigned m_statement_line{ 0u };
 };
 }
 }
@@ -9,6 +9,7 @@ class binary_operator_node;
 class block_node;
 class bool_value_node;
 class break_node;
+class call_node;
 class cast_to_reference_node;
 class cast_to_reference_to_base_node;
 class cast_to_base_value_node;
@@ -137,4 +138,99 @@ public:
   virtual void visit(const variable_declaration_node&) override {}
   virtual void visit(const while_node&) override {}
 };
+
+// Visits nodes of a tree that can be modified, e.g. by the constant_folder.
+class mutable_sema_node_visitor
+{
+public:
+  virtual ~mutable_sema_node_visitor() = default;
+
+  virtual void visit(initializer_list_node& node) = 0;
+  virtual void visit(add_declarative_file_node& node) = 0;
+  virtual void visit(add_subdirectory_node& node) = 0;
+  virtual void visit(add_subdirectory_with_declarative_script_node& node) = 0;
+  virtual void visit(add_subdirectory_with_old_script_node& node) = 0;
+  virtual void visit(binary_operator_node& node) = 0;
+  virtual void visit(block_node& node) = 0;
+  virtual void visit(bool_value_node& node) = 0;
+  virtual void visit(break_node& node) = 0;
+  virtual void visit(cast_to_reference_node& node) = 0;
+  virtual void visit(cast_to_value_node& node) = 0;
+  virtual void visit(cast_to_reference_to_base_node& node) = 0;
+  virtual void visit(cast_to_base_value_node& node) = 0;
+  virtual void visit(class_member_access_node& node) = 0;
+  virtual void visit(class_node& node) = 0;
+  virtual void visit(conditional_node& node) = 0;
+  virtual void visit(constructor_call_node& node) = 0;
+  virtual void visit(designated_initializers_node& node) = 0;
+  virtual void visit(double_value_node& node) = 0;
+  virtual void visit(enum_constant_access_node& node) = 0;
+  virtual void visit(enum_node& node) = 0;
+  virtual void visit(for_node& node) = 0;
+  virtual void visit(function_call_node& node) = 0;
+  virtual void visit(function_node& node) = 0;
+  virtual void visit(id_node& node) = 0;
+  virtual void visit(if_else_node& node) = 0;
+  virtual void visit(implicit_member_function_call_node& node) = 0;
+  virtual void visit(implicit_return_node& node) = 0;
+  virtual void visit(import_node& node) = 0;
+  virtual void visit(int_value_node& node) = 0;
+  virtual void visit(member_function_call_node& node) = 0;
+  virtual void visit(namespace_node& node) = 0;
+  virtual void visit(return_node& node) = 0;
+  virtual void visit(string_value_node& node) = 0;
+  virtual void visit(ternary_operator_node& node) = 0;
+  virtual void visit(translation_unit_node& node) = 0;
+  virtual void visit(unary_operator_node& node) = 0;
+  virtual void visit(variable_declaration_node& node) = 0;
+  virtual void visit(while_node& node) = 0;
+};
+
+class empty_mutable_sema_node_visitor : public mutable_sema_node_visitor
+{
+public:
+  virtual ~empty_mutable_sema_node_visitor() = default;
+
+  virtual void visit(initializer_list_node&) override {}
+  virtual void visit(add_declarative_file_node&) override {}
+  virtual void visit(add_subdirectory_node&) override {}
+  virtual void visit(add_subdirectory_with_declarative_script_node&) override
+  {
+  }
+  virtual void visit(add_subdirectory_with_old_script_node&) override {}
+  virtual void visit(binary_operator_node&) override {}
+  virtual void visit(block_node&) override {}
+  virtual void visit(bool_value_node&) override {}
+  virtual void visit(break_node&) override {}
+  virtual void visit(cast_to_reference_node&) override {}
+  virtual void visit(cast_to_value_node&) override {}
+  virtual void visit(cast_to_reference_to_base_node&) override {}
+  virtual void visit(cast_to_base_value_node&) override {}
+  virtual void visit(class_member_access_node&) override {}
+  virtual void visit(class_node&) override {}
+  virtual void visit(conditional_node&) override {}
+  virtual void visit(constructor_call_node&) override {}
+  virtual void visit(designated_initializers_node&) override {}
+  virtual void visit(double_value_node&) override {}
+  virtual void visit(enum_constant_access_node&) override {}
+  virtual void visit(enum_node&) override {}
+  virtual void visit(for_node&) override {}
+  virtual void visit(function_call_node&) override {}
+  virtual void visit(function_node&) override {}
+  virtual void visit(id_node&) override {}
+  virtual void visit(if_else_node&) override {}
+  virtual void visit(implicit_member_function_call_node&) override {}
+  virtual void visit(implicit_return_node&) override {}
+  virtual void visit(import_node&) override {}
+  virtual void visit(int_value_node&) override {}
+  virtual void visit(member_function_call_node&) override {}
+  virtual void visit(namespace_node&) override {}
+  virtual void visit(return_node&) override {}
+  virtual void visit(string_value_node&) override {}
+  virtual void visit(ternary_operator_node&) override {}
+  virtual void visit(translation_unit_node&) override {}
+  virtual void visit(unary_operator_node&) override {}
+  virtual void visit(variable_declaration_node&) override {}
+  virtual void visit(while_node&) override {}
+};
 }
@@ -5,19 +5,38 @@
 #include "ast/qualified_name.hpp"
 #include "common/int_alias.hpp"
 #include "lexer/token.hpp"
+#include "sema/builtin_function_kind.hpp"
+#include "sema/identifier_info.hpp"
 #include "sema/sema_function.hpp"
 #include "sema/sema_node.hpp"
 #include "sema/sema_node_visitor.hpp"
 #include "sema/sema_type.hpp"
 
 #include <memory>
+#include <optional>
 
 #define VISIT_METHOD                                                          \
   void visit(sema_node_visitor& visitor) const override                       \
+  {                                                                           \
+    visitor.visit(*this);                                                     \
+  }                                                                           \
+  void visit(mutable_sema_node_visitor& visitor) override                     \
   {                                                                           \
     visitor.visit(*this);                                                     \
   }
 
+// Children are given as members that own them, single nodes or lists.
+#define REPLACEABLE_CHILDREN(...)                                             \
+  std::vector<sema_node*> children() override                                 \
+  {                                                                           \
+    return children_in(__VA_ARGS__);                                          \
+  }                                                                           \
+  std::unique_ptr<sema_node> replace_child(                                   \
+    const sema_node& child, std::unique_ptr<sema_node> replacement) override  \
+  {                                                                           \
+    return replace_in(child, replacement, __VA_ARGS__);                       \
+  }
+
 using token_t = cmsl::lexer::token;
 
 namespace cmsl::sema {
@@ -105,11 +124,13 @@ class id_node : public expression_node
 public:
   explicit id_node(const ast::ast_node& ast_node, const sema_type& t,
                    std::vector<ast::name_with_coloncolon> names,
-                   unsigned index)
+                   unsigned index,
+                   std::optional<frame_slot> slot = std::nullopt)
     : expression_node{ ast_node }
     , m_type{ t }
     , m_names{ std::move(names) }
     , m_index{ index }
+    , m_slot{ slot }
   {
   }
 
@@ -124,12 +145,16 @@ public:
 
   unsigned index() const { return m_index; }
 
+  // Set if the identifier is a local variable or a parameter.
+  const std::optional<frame_slot>& slot() const { return m_slot; }
+
   VISIT_METHOD
 
 private:
   const sema_type& m_type;
   std::vector<ast::name_with_coloncolon> m_names;
   const unsigned m_index;
+  std::optional<frame_slot> m_slot;
 };
 
 class enum_constant_access_node : public expression_node
@@ -190,6 +215,7 @@ public:
   const expression_node& expression() const { return *m_expr; }
 
   VISIT_METHOD
+  REPLACEABLE_CHILDREN(m_expr)
 
 private:
   std::unique_ptr<expression_node> m_expr;
@@ -203,13 +229,16 @@ public:
                                 lexer::token op,
                                 const sema_function& operator_function,
                                 std::unique_ptr<expression_node> rhs,
-                                const sema_type& result_type)
+                                const sema_type& result_type,
+                                std::optional<builtin_function_kind>
+                                  unboxed_operation = std::nullopt)
     : expression_node{ ast_node }
     , m_lhs{ std::move(lhs) }
     , m_operator{ op }
     , m_operator_function{ operator_function }
     , m_rhs{ std::move(rhs) }
     , m_type{ result_type }
+    , m_unboxed_operation{ unboxed_operation }
   {
     m_lhs->set_parent(*this, passkey{});
     m_rhs->set_parent(*this, passkey{});
@@ -233,7 +262,15 @@ public:
     return !type().is_reference();
   }
 
+  // Set if the operator is a builtin operation on int, double or bool
+  // values, that can be evaluated without creating instances.
+  const std::optional<builtin_function_kind>& unboxed_operation() const
+  {
+    return m_unboxed_operation;
+  }
+
   VISIT_METHOD
+  REPLACEABLE_CHILDREN(m_lhs, m_rhs)
 
 private:
   std::unique_ptr<expression_node> m_lhs;
@@ -242,6 +279,7 @@ private:
   const sema_function& m_operator_function;
   std::unique_ptr<expression_node> m_rhs;
   const sema_type& m_type;
+  std::optional<builtin_function_kind> m_unboxed_operation;
 };
 
 class variable_declaration_node : public sema_node
@@ -249,9 +287,11 @@ class variable_declaration_node : public sema_node
 public:
   explicit variable_declaration_node(
     const ast::ast_node& ast_node, const sema_type& type, lexer::token name,
-    std::unique_ptr<expression_node> initialization, unsigned index)
+    std::unique_ptr<expression_node> initialization, unsigned index,
+    std::optional<frame_slot> slot = std::nullopt)
     : sema_node{ ast_node }
     , m_index{ index }
+    , m_slot{ slot }
     , m_type{ type }
     , m_name{ name }
     , m_initialization{ std::move(initialization) }
@@ -268,10 +308,15 @@ public:
   const sema_node* initialization() const { return m_initialization.get(); }
   unsigned index() const { return m_index; }
 
+  // Set if it is a declaration of a local variable.
+  const std::optional<frame_slot>& slot() const { return m_slot; }
+
   VISIT_METHOD
+  REPLACEABLE_CHILDREN(m_initialization)
 
 private:
   unsigned m_index;
+  std::optional<frame_slot> m_slot;
   const sema_type& m_type;
   const lexer::token m_name;
   std::unique_ptr<expression_node> m_initialization;
@@ -310,6 +355,8 @@ public:
     return !type().is_reference();
   }
 
+  REPLACEABLE_CHILDREN(m_params)
+
 private:
   const sema_function& m_function;
   param_expressions_t m_params;
@@ -348,6 +395,24 @@ public:
 
   VISIT_METHOD
 
+  std::vector<sema_node*> children() override
+  {
+    auto children = children_in(m_lhs);
+    const auto params = call_node::children();
+    children.insert(std::end(children), std::cbegin(params),
+                    std::cend(params));
+    return children;
+  }
+
+  std::unique_ptr<sema_node> replace_child(
+    const sema_node& child, std::unique_ptr<sema_node> replacement) override
+  {
+    if (auto replaced = replace_in(child, replacement, m_lhs)) {
+      return replaced;
+    }
+    return call_node::replace_child(child, std::move(replacement));
+  }
+
 private:
   std::unique_ptr<expression_node> m_lhs;
 };
@@ -494,6 +559,11 @@ private:
 
 class block_node_manipulator;
 
+// Line of the statement, that profilers attribute its execution to, or 0 for
+// statements that are not profiled, like blocks. Looking up a location is
+// not cheap, so it is done once, when the statement is added to a block.
+unsigned profiled_statement_line(const sema_node& statement);
+
 class block_node : public sema_node
 {
 private:
@@ -506,6 +576,7 @@ public:
   {
     for (auto& node : m_nodes) {
       node->set_parent(*this, passkey{});
+      node->set_statement_line(profiled_statement_line(*node), passkey{});
     }
   }
 
@@ -513,6 +584,18 @@ public:
 
   VISIT_METHOD
 
+  std::vector<sema_node*> children() override { return children_in(m_nodes); }
+
+  std::unique_ptr<sema_node> replace_child(
+    const sema_node& child, std::unique_ptr<sema_node> replacement) override
+  {
+    if (replacement) {
+      replacement->set_statement_line(profiled_statement_line(*replacement),
+                                      passkey{});
+    }
+    return replace_in(child, replacement, m_nodes);
+  }
+
 private:
   friend class block_node_manipulator;
 
@@ -522,6 +605,8 @@ private:
 class function_node : public sema_node
 {
 public:
+  // Body is null till the body of a lazily built function is set. See
+  // lazy_function_bodies.
   explicit function_node(const ast::ast_node& ast_node,
                          const sema_function& function,
                          std::unique_ptr<block_node> body)
@@ -529,7 +614,9 @@ public:
     , m_function{ function }
     , m_body{ std::move(body) }
   {
-    m_body->set_parent(*this, passkey{});
+    if (m_body) {
+      m_body->set_parent(*this, passkey{});
+    }
   }
 
   const function_signature& signature() const
@@ -541,9 +628,17 @@ public:
 
   const sema_type& return_type() const { return m_function.return_type(); }
 
+  bool has_body() const { return m_body != nullptr; }
   const block_node& body() const { return *m_body; }
 
+  void set_body(std::unique_ptr<block_node> body)
+  {
+    m_body = std::move(body);
+    m_body->set_parent(*this, passkey{});
+  }
+
   VISIT_METHOD
+  REPLACEABLE_CHILDREN(m_body)
 
 private:
   const sema_function& m_function;
@@ -579,6 +674,7 @@ public:
   const functions_t& functions() const { return m_functions; }
 
   VISIT_METHOD
+  REPLACEABLE_CHILDREN(m_members, m_functions)
 
 private:
   lexer::token m_name;
@@ -605,6 +701,7 @@ public:
   const block_node& get_body() const { return *m_body; }
 
   VISIT_METHOD
+  REPLACEABLE_CHILDREN(m_condition, m_body)
 
 private:
   std::unique_ptr<expression_node> m_condition;
@@ -629,6 +726,7 @@ public:
   const block_node& body() const { return m_conditional->get_body(); }
 
   VISIT_METHOD
+  REPLACEABLE_CHILDREN(m_conditional)
 
 private:
   std::unique_ptr<conditional_node> m_conditional;
@@ -658,7 +756,16 @@ public:
 
   const block_node* else_body() const { return m_else.get(); }
 
+  void set_else_body(std::unique_ptr<block_node> else_node)
+  {
+    m_else = std::move(else_node);
+    if (m_else) {
+      m_else->set_parent(*this, passkey{});
+    }
+  }
+
   VISIT_METHOD
+  REPLACEABLE_CHILDREN(m_ifs, m_else)
 
 private:
   ifs_t m_ifs;
@@ -694,6 +801,7 @@ public:
   unsigned member_index() const { return m_member_info.index; }
 
   VISIT_METHOD
+  REPLACEABLE_CHILDREN(m_lhs)
 
 private:
   std::unique_ptr<expression_node> m_lhs;
@@ -719,9 +827,13 @@ public:
 
   const nodes_t& nodes() const { return m_nodes; }
 
+  // Moves the nodes out, e.g. to reuse them in a new translation unit.
+  nodes_t release_nodes() { return std::move(m_nodes); }
+
   const sema_context& context() const { return m_ctx; }
 
   VISIT_METHOD
+  REPLACEABLE_CHILDREN(m_nodes)
 
 private:
   const sema_context& m_ctx;
@@ -748,6 +860,7 @@ public:
   const expression_node& expression() const { return *m_expr; }
 
   VISIT_METHOD
+  REPLACEABLE_CHILDREN(m_expr)
 
 private:
   const sema_type& m_type;
@@ -774,6 +887,7 @@ public:
   const expression_node& expression() const { return *m_expr; }
 
   VISIT_METHOD
+  REPLACEABLE_CHILDREN(m_expr)
 
 private:
   const sema_type& m_base_reference_type;
@@ -800,6 +914,7 @@ public:
   const expression_node& expression() const { return *m_expr; }
 
   VISIT_METHOD
+  REPLACEABLE_CHILDREN(m_expr)
 
 private:
   const sema_type& m_type;
@@ -826,6 +941,7 @@ public:
   const expression_node& expression() const { return *m_expr; }
 
   VISIT_METHOD
+  REPLACEABLE_CHILDREN(m_expr)
 
 private:
   const sema_type& m_base_type;
@@ -857,6 +973,7 @@ public:
   }
 
   VISIT_METHOD
+  REPLACEABLE_CHILDREN(m_values)
 
 private:
   const sema_type& m_type;
@@ -923,6 +1040,7 @@ public:
   const block_node& body() const { return *m_body; }
 
   VISIT_METHOD
+  REPLACEABLE_CHILDREN(m_init, m_condition, m_iteration, m_body)
 
 private:
   std::unique_ptr<sema_node> m_init;
@@ -960,6 +1078,7 @@ public:
   }
 
   VISIT_METHOD
+  REPLACEABLE_CHILDREN(m_nodes)
 
   const nodes_t& nodes() const { return m_nodes; }
 
@@ -1000,6 +1119,7 @@ public:
   }
 
   VISIT_METHOD
+  REPLACEABLE_CHILDREN(m_condition, m_true, m_false)
 
 private:
   std::unique_ptr<expression_node> m_condition;
@@ -1040,6 +1160,28 @@ public:
 
   VISIT_METHOD
 
+  std::vector<sema_node*> children() override
+  {
+    std::vector<sema_node*> children;
+    for (auto& init : m_initializers) {
+      if (init.init) {
+        children.emplace_back(init.init.get());
+      }
+    }
+    return children;
+  }
+
+  std::unique_ptr<sema_node> replace_child(
+    const sema_node& child, std::unique_ptr<sema_node> replacement) override
+  {
+    for (auto& init : m_initializers) {
+      if (auto replaced = replace_in(child, replacement, init.init)) {
+        return replaced;
+      }
+    }
+    return nullptr;
+  }
+
 private:
   const sema_type& m_type;
   initializers_t m_initializers;
@@ -1050,10 +1192,13 @@ class unary_operator_node : public expression_node
 public:
   explicit unary_operator_node(const ast::ast_node& ast_node, token_t op,
                                std::unique_ptr<expression_node> expression,
-                               const sema_function& function)
+                               const sema_function& function,
+                               std::optional<builtin_function_kind>
+                                 unboxed_operation = std::nullopt)
     : expression_node{ ast_node }
     , m_expression{ std::move(expression) }
     , m_function{ function }
+    , m_unboxed_operation{ unboxed_operation }
   {
     m_expression->set_parent(*this, passkey{});
   }
@@ -1071,12 +1216,20 @@ public:
     return !m_function.return_type().is_reference();
   }
 
+  // See binary_operator_node::unboxed_operation().
+  const std::optional<builtin_function_kind>& unboxed_operation() const
+  {
+    return m_unboxed_operation;
+  }
+
   VISIT_METHOD
+  REPLACEABLE_CHILDREN(m_expression)
 
 private:
   token_t m_operator;
   std::unique_ptr<expression_node> m_expression;
   const sema_function& m_function;
+  std::optional<builtin_function_kind> m_unboxed_operation;
 };
 
 class enum_node : public sema_node
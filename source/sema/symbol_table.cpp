@@ -0,0 +1,81 @@
+#include "sema/symbol_table.hpp"
+
+#include <functional>
+
+namespace cmsl::sema {
+symbol_table::id_t symbol_table::intern(cmsl::string_view name)
+{
+  // Keep the load factor below 1/2, so probe sequences stay short.
+  if ((size() + 1u) * 2u > m_slots.size()) {
+    grow();
+  }
+
+  const auto hash = std::hash<cmsl::string_view>{}(name);
+  const auto slot = slot_of(name, hash);
+  if (m_slots[slot] != 0u) {
+    return m_slots[slot] - 1u;
+  }
+
+  const auto id = static_cast<id_t>(size());
+  m_names.append(name.data(), name.size());
+  m_name_offsets.emplace_back(static_cast<std::uint32_t>(m_names.size()));
+  m_hashes.emplace_back(hash);
+  m_slots[slot] = id + 1u;
+  return id;
+}
+
+std::optional<symbol_table::id_t> symbol_table::find(
+  cmsl::string_view name) const
+{
+  if (m_slots.empty()) {
+    return std::nullopt;
+  }
+
+  const auto slot = slot_of(name, std::hash<cmsl::string_view>{}(name));
+  if (m_slots[slot] == 0u) {
+    return std::nullopt;
+  }
+
+  return m_slots[slot] - 1u;
+}
+
+cmsl::string_view symbol_table::name_of(id_t id) const
+{
+  const auto begin = m_name_offsets[id];
+  return cmsl::string_view{ m_names.data() + begin,
+                            m_name_offsets[id + 1u] - begin };
+}
+
+std::size_t symbol_table::size() const
+{
+  return m_hashes.size();
+}
+
+std::size_t symbol_table::slot_of(cmsl::string_view name,
+                                  std::size_t hash) const
+{
+  const auto mask = m_slots.size() - 1u;
+  for (auto slot = hash & mask;; slot = (slot + 1u) & mask) {
+    const auto stored = m_slots[slot];
+    if (stored == 0u ||
+        (m_hashes[stored - 1u] == hash && name_of(stored - 1u) == name)) {
+      return slot;
+    }
+  }
+}
+
+void symbol_table::grow()
+{
+  const auto new_size = m_slots.empty() ? 16u : m_slots.size() * 2u;
+  m_slots.assign(new_size, 0u);
+
+  const auto mask = new_size - 1u;
+  for (auto id = id_t{ 0u }; id < size(); ++id) {
+    auto slot = m_hashes[id] & mask;
+    while (m_slots[slot] != 0u) {
+      slot = (slot + 1u) & mask;
+    }
+    m_slots[slot] = id + 1u;
+  }
+}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "common/string.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace cmsl::sema {
+// Interns names to dense ids. Equal names get the same id, so once a name is
+// interned, it can be hashed and compared as an integer.
+//
+// Names are copied to a single buffer and looked up in an open addressing
+// table of ids, so the whole table is made of three flat vectors and copying
+// it is cheap.
+class symbol_table
+{
+public:
+  using id_t = std::uint32_t;
+
+  id_t intern(cmsl::string_view name);
+  std::optional<id_t> find(cmsl::string_view name) const;
+
+  cmsl::string_view name_of(id_t id) const;
+  std::size_t size() const;
+
+private:
+  // Slot that holds id of the name or, if it is not interned, the empty slot
+  // where it would be placed.
+  std::size_t slot_of(cmsl::string_view name, std::size_t hash) const;
+  void grow();
+
+private:
+  std::string m_names;
+  // Name of id i spans from m_name_offsets[i] to m_name_offsets[i + 1].
+  std::vector<std::uint32_t> m_name_offsets{ 0u };
+  std::vector<std::size_t> m_hashes;
+  // Ids incremented by one, zero marks an empty slot. Size is a power of two.
+  std::vector<id_t> m_slots;
+};
+}
@@ -96,6 +96,35 @@ bool types_context_impl::merge_imported_stuff(const types_context& imported,
   return m_types_finder.merge_imported_stuff(casted.m_types_finder, errs);
 }
 
+qualified_entries_checkpoint types_context_impl::make_checkpoint() const
+{
+  return m_types_finder.make_checkpoint();
+}
+
+void types_context_impl::rollback(
+  const qualified_entries_checkpoint& checkpoint)
+{
+  m_types_finder.rollback(checkpoint);
+}
+
+qualified_entries_snapshot types_context_impl::make_snapshot() const
+{
+  return m_types_finder.make_snapshot();
+}
+
+void types_context_impl::enter_snapshot(
+  const qualified_entries_snapshot& snapshot)
+{
+  // Generic types are registered when they are used for the first time, so
+  // types registered later stay visible, not to create them again.
+  m_types_finder.enter_snapshot(snapshot, /*hide_later_entries=*/false);
+}
+
+void types_context_impl::leave_snapshot()
+{
+  m_types_finder.leave_snapshot();
+}
+
 void types_context_impl::dump(qualified_contexts_dumper& dumper) const
 {
   dumper.dump(m_types_finder);
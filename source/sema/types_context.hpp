@@ -51,6 +51,12 @@ public:
   virtual bool merge_imported_stuff(const types_context& imported,
                                     errors::errors_observer& errs) = 0;
 
+  virtual qualified_entries_checkpoint make_checkpoint() const = 0;
+  virtual void rollback(const qualified_entries_checkpoint& checkpoint) = 0;
+  virtual qualified_entries_snapshot make_snapshot() const = 0;
+  virtual void enter_snapshot(const qualified_entries_snapshot& snapshot) = 0;
+  virtual void leave_snapshot() = 0;
+
   virtual void dump(qualified_contexts_dumper& dumper) const = 0;
 };
 
@@ -78,6 +84,13 @@ public:
   bool merge_imported_stuff(const types_context& imported,
                             errors::errors_observer& errs) override;
 
+  qualified_entries_checkpoint make_checkpoint() const override;
+  void rollback(const qualified_entries_checkpoint& checkpoint) override;
+
+  qualified_entries_snapshot make_snapshot() const override;
+  void enter_snapshot(const qualified_entries_snapshot& snapshot) override;
+  void leave_snapshot() override;
+
   void dump(qualified_contexts_dumper& dumper) const override;
 
 private:
@@ -21,12 +21,18 @@ public:
   // Todo: consider creating user_sema_funciton manipulator class
   void set_body(const block_node& body) { m_body = &body; }
   void set_return_type(const sema_type& ty) { m_return_type = &ty; }
+  void set_frame_size(unsigned size) { m_frame_size = size; }
 
+  // False if the function is built lazily and its body is not built yet.
+  bool has_body() const { return m_body != nullptr; }
   const block_node& body() const { return *m_body; }
   const function_signature& signature() const override { return m_signature; }
   const sema_context& context() const override { return m_ctx; }
   const sema_type& return_type() const override { return *m_return_type; }
 
+  // Number of frame slots needed by parameters and local variables.
+  unsigned frame_size() const { return m_frame_size; }
+
   // It should used only by sema_builder_ast_visitor while creating sema tree.
   const sema_type* try_return_type() const override { return m_return_type; }
 
@@ -42,6 +48,7 @@ private:
   function_signature m_signature;
   // It will be set while building a class node. It needs to be set after
   // creation because it can refer to itself in case of a recursion.
-  const block_node* m_body;
+  const block_node* m_body{ nullptr };
+  unsigned m_frame_size{ 0u };
 };
 }
\ No newline at end of file
@@ -23,8 +23,18 @@ errors_observer::errors_observer(facade::cmake_facade*)
 {
 }
 
+errors_observer::errors_observer(std::ostream&)
+{
+}
+
 void errors_observer::notify_error(const cmsl::errors::error& error)
 {
+  ++m_notified_count;
   errors_observer_mock_ptr->notify_error(error);
 }
+
+std::size_t errors_observer::notified_count() const
+{
+  return m_notified_count;
+}
 }
@@ -49,4 +49,54 @@ TEST_F(AddSubdirectorySmokeTest,
   const auto result = m_executor->execute(source);
   EXPECT_THAT(result, Eq(42));
 }
+
+TEST_F(AddSubdirectorySmokeTest,
+       AddSubdirectoryWithImports_WithPrefetching_GivesTheSameResult)
+{
+  auto opts = executor_options();
+  opts.prefetch_threads = 2u;
+  m_executor = std::make_unique<global_executor>(
+    CMAKESL_EXEC_SMOKE_TEST_ROOT_DIR, m_facade, *m_errs, opts);
+
+  const auto source = "import \"add_subdirectory_test/import/foo.cmsl\";"
+                      ""
+                      "int main()"
+                      "{"
+                      "    foo::bar *= 100.0;"
+                      "    add_subdirectory(\"foo\", 4.2);"
+                      "    add_subdirectory(\"import\");"
+                      "    return int(foo::bar);"
+                      "}";
+
+  EXPECT_CALL(m_facade, current_directory())
+    .WillRepeatedly(Return(CMAKESL_EXEC_SMOKE_TEST_ROOT_DIR +
+                           std::string{ "/add_subdirectory_test" }));
+
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(42));
+}
+
+TEST_F(AddSubdirectorySmokeTest,
+       AddSubdirectoryWithParseError_WithPrefetching_ReportsErrors)
+{
+  auto opts = executor_options();
+  opts.prefetch_threads = 2u;
+  m_executor = std::make_unique<global_executor>(
+    CMAKESL_EXEC_SMOKE_TEST_ROOT_DIR, m_facade, *m_errs, opts);
+
+  const auto source = "int main()"
+                      "{"
+                      "    add_subdirectory(\"parse_error\");"
+                      "    return 42;"
+                      "}";
+
+  EXPECT_CALL(m_facade, current_directory())
+    .WillRepeatedly(Return(CMAKESL_EXEC_SMOKE_TEST_ROOT_DIR +
+                           std::string{ "/add_subdirectory_test" }));
+  EXPECT_CALL(*m_errors_observer_mock, notify_error(_))
+    .Times(::testing::AtLeast(1));
+
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(-1));
+}
 }
@@ -0,0 +1,301 @@
+#include "exec/buffered_cmake_facade.hpp"
+#include "test/exec/smoke_test_fixture.hpp"
+
+#include <gmock/gmock.h>
+
+namespace cmsl::exec::test {
+using ::testing::_;
+using ::testing::Eq;
+using ::testing::InSequence;
+using ::testing::InvokeWithoutArgs;
+using ::testing::StrictMock;
+
+using command_kind = facade::command_buffer::command_kind;
+
+namespace {
+facade::command_buffer create_commands()
+{
+  facade::command_buffer commands;
+  commands.add_command(command_kind::register_project, "project");
+  commands.add_command(command_kind::add_executable, "exe",
+                       facade::visibility::private_,
+                       std::vector<std::string>{ "main.cpp" });
+  commands.add_command(command_kind::target_sources, "exe",
+                       facade::visibility::public_,
+                       std::vector<std::string>{ "a b.cpp", "" });
+  commands.add_command(command_kind::target_link_library, "exe",
+                       facade::visibility::interface);
+  commands.add_argument("lib");
+  return commands;
+}
+}
+
+class BatchedExecutionSmokeTest : public ExecutionSmokeTest
+{
+protected:
+  void SetUp() override
+  {
+    ExecutionSmokeTest::SetUp();
+    auto opts = executor_options();
+    opts.batch_facade_calls = true;
+    m_executor = std::make_unique<global_executor>(
+      CMAKESL_EXEC_SMOKE_TEST_ROOT_DIR, m_facade, *m_errs, opts);
+  }
+};
+
+TEST(CommandBufferTest, AddCommand_InternsStrings)
+{
+  const auto commands = create_commands();
+
+  // project, exe, main.cpp, a b.cpp, empty string and lib.
+  EXPECT_THAT(commands.strings_count(), Eq(6u));
+  EXPECT_THAT(commands.commands()[1].name, Eq(commands.commands()[2].name));
+}
+
+TEST(CommandBufferTest, Serialize_Deserialize_RestoresCommands)
+{
+  const auto commands = create_commands();
+
+  const auto serialized = commands.serialize();
+  const auto deserialized = facade::command_buffer::deserialize(serialized);
+
+  ASSERT_TRUE(deserialized);
+  EXPECT_THAT(deserialized->serialize(), Eq(serialized));
+  EXPECT_THAT(deserialized->commands().size(), Eq(4u));
+  EXPECT_THAT(deserialized->arguments(deserialized->commands()[2]),
+              Eq(std::vector<std::string_view>{ "a b.cpp", "" }));
+}
+
+TEST(CommandBufferTest, Deserialize_MalformedInput_ReturnsNullopt)
+{
+  EXPECT_FALSE(facade::command_buffer::deserialize("foo"));
+  EXPECT_FALSE(facade::command_buffer::deserialize("42 0 3:exe 0\n"));
+  EXPECT_FALSE(facade::command_buffer::deserialize("7 1 3:exe 1 10:a.cpp\n"));
+  EXPECT_FALSE(facade::command_buffer::deserialize("3 1 3:exe 0\n"));
+}
+
+TEST(CommandBufferTest, ApplyCommands_CallsFacadeMethodsInOrder)
+{
+  StrictMock<cmake_facade_mock> cmake_facade;
+
+  {
+    InSequence seq;
+    EXPECT_CALL(cmake_facade, register_project("project"));
+    EXPECT_CALL(cmake_facade,
+                add_executable("exe", std::vector<std::string>{ "main.cpp" }));
+    EXPECT_CALL(cmake_facade,
+                target_sources("exe", facade::visibility::public_,
+                               std::vector<std::string>{ "a b.cpp", "" }));
+    EXPECT_CALL(cmake_facade, target_link_library(
+                          "exe", facade::visibility::interface, "lib"));
+  }
+
+  cmake_facade.apply_commands(create_commands());
+}
+
+TEST(CommandBufferTest, ApplyCommand_CallsFacadeMethodWithCopies)
+{
+  StrictMock<cmake_facade_mock> cmake_facade;
+  const std::string dirs[] = { "include", "src" };
+
+  EXPECT_CALL(cmake_facade, target_include_directories(
+                              "exe", facade::visibility::public_,
+                              std::vector<std::string>{ "include", "src" }));
+
+  cmake_facade.apply_command(command_kind::target_include_directories, "exe",
+                             facade::visibility::public_,
+                             { dirs[0], dirs[1] });
+}
+
+TEST(BufferedCmakeFacadeTest, TargetOperations_AppliedOnFlush)
+{
+  StrictMock<cmake_facade_mock> cmake_facade;
+  buffered_cmake_facade buffered{ cmake_facade };
+
+  buffered.add_library("lib", { "lib.cpp" });
+  buffered.target_compile_definitions("lib", facade::visibility::private_,
+                                      { "FOO" });
+  EXPECT_THAT(buffered.commands().commands().size(), Eq(2u));
+
+  {
+    InSequence seq;
+    EXPECT_CALL(cmake_facade,
+                add_library("lib", std::vector<std::string>{ "lib.cpp" }));
+    EXPECT_CALL(cmake_facade, target_compile_definitions(
+                          "lib", facade::visibility::private_,
+                          std::vector<std::string>{ "FOO" }));
+  }
+
+  buffered.flush();
+  EXPECT_TRUE(buffered.commands().empty());
+}
+
+TEST(BufferedCmakeFacadeTest, ApplyCommand_RecordsViewedStrings)
+{
+  StrictMock<cmake_facade_mock> cmake_facade;
+  buffered_cmake_facade buffered{ cmake_facade };
+
+  {
+    std::string source = "foo.cpp";
+    buffered.apply_command(command_kind::target_sources, "exe",
+                           facade::visibility::private_, { source });
+    source = "bar.cpp";
+  }
+
+  EXPECT_CALL(cmake_facade,
+              target_sources("exe", facade::visibility::private_,
+                             std::vector<std::string>{ "foo.cpp" }));
+
+  buffered.flush();
+}
+
+TEST(BufferedCmakeFacadeTest, FullBuffer_AppliesCommands)
+{
+  StrictMock<cmake_facade_mock> cmake_facade;
+  buffered_cmake_facade buffered{ cmake_facade };
+  const auto count = buffered_cmake_facade::k_max_recorded_commands;
+
+  EXPECT_CALL(cmake_facade, target_sources("exe", _, _)).Times(count);
+
+  for (auto i = 0u; i < count; ++i) {
+    buffered.target_sources("exe", facade::visibility::private_,
+                            { "foo.cpp" });
+  }
+
+  EXPECT_TRUE(buffered.commands().empty());
+}
+
+TEST(BufferedCmakeFacadeTest, GoIntoSubdirectory_AppliesCommandsBefore)
+{
+  StrictMock<cmake_facade_mock> cmake_facade;
+  buffered_cmake_facade buffered{ cmake_facade };
+
+  buffered.add_executable("exe", {});
+
+  {
+    InSequence seq;
+    EXPECT_CALL(cmake_facade, add_executable("exe", _));
+    EXPECT_CALL(cmake_facade, go_into_subdirectory("dir"));
+  }
+
+  buffered.go_into_subdirectory("dir");
+}
+
+TEST(BufferedCmakeFacadeTest, Install_AppliesCommandsBefore)
+{
+  StrictMock<cmake_facade_mock> cmake_facade;
+  buffered_cmake_facade buffered{ cmake_facade };
+
+  buffered.add_executable("exe", {});
+
+  {
+    InSequence seq;
+    EXPECT_CALL(cmake_facade, add_executable("exe", _));
+    EXPECT_CALL(cmake_facade, install("exe", "bin"));
+  }
+
+  buffered.install("exe", "bin");
+}
+
+TEST(BufferedCmakeFacadeTest, Message_DoesNotApplyCommands)
+{
+  StrictMock<cmake_facade_mock> cmake_facade;
+  buffered_cmake_facade buffered{ cmake_facade };
+
+  buffered.add_executable("exe", {});
+
+  EXPECT_CALL(cmake_facade, message("foo"));
+
+  buffered.message("foo");
+  EXPECT_FALSE(buffered.commands().empty());
+}
+
+TEST(BufferedCmakeFacadeTest, FatalError_AppliesCommandsBefore)
+{
+  StrictMock<cmake_facade_mock> cmake_facade;
+  buffered_cmake_facade buffered{ cmake_facade };
+
+  buffered.add_executable("exe", {});
+
+  {
+    InSequence seq;
+    EXPECT_CALL(cmake_facade, add_executable("exe", _));
+    EXPECT_CALL(cmake_facade, fatal_error("foo"));
+  }
+
+  buffered.fatal_error("foo");
+}
+
+TEST(BufferedCmakeFacadeTest, FatalErrorOfRecordedCommand_ReportedOnFlush)
+{
+  StrictMock<cmake_facade_mock> cmake_facade;
+  buffered_cmake_facade buffered{ cmake_facade };
+  auto error_occurred = false;
+
+  EXPECT_CALL(cmake_facade, did_fatal_error_occure())
+    .WillRepeatedly(
+      InvokeWithoutArgs([&error_occurred] { return error_occurred; }));
+  EXPECT_CALL(cmake_facade, add_executable("exe", _))
+    .WillOnce(InvokeWithoutArgs([&error_occurred] { error_occurred = true; }));
+
+  buffered.add_executable("exe", {});
+  EXPECT_FALSE(buffered.did_fatal_error_occure());
+
+  buffered.flush();
+  EXPECT_TRUE(buffered.did_fatal_error_occure());
+}
+
+TEST_F(BatchedExecutionSmokeTest, ListOperations_AppliedWithListElements)
+{
+  const auto source =
+    "int main()"
+    "{"
+    "    cmake::project p = cmake::project(\"foo\");"
+    "    list<string> sources;"
+    "    cmake::library lib = p.add_library(\"lib\", sources);"
+    "    list<string> definitions = { \"FOO\", \"BAR=1\" };"
+    "    lib.compile_definitions(definitions);"
+    "    definitions.clear();"
+    "    lib.compile_definitions(definitions);"
+    "    return 42;"
+    "}";
+
+  {
+    InSequence seq;
+    EXPECT_CALL(m_facade, register_project("foo"));
+    EXPECT_CALL(m_facade, add_library("lib", std::vector<std::string>{}));
+    EXPECT_CALL(m_facade, target_compile_definitions(
+                            "lib", facade::visibility::private_,
+                            std::vector<std::string>{ "FOO", "BAR=1" }));
+  }
+
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(42));
+}
+
+TEST_F(BatchedExecutionSmokeTest, TargetOperations_AppliedInOrderAtExit)
+{
+  const auto source =
+    "int main()"
+    "{"
+    "    cmake::project p = cmake::project(\"foo\");"
+    "    list<string> sources = { \"main.cpp\" };"
+    "    cmake::executable exe = p.add_executable(\"exe\", sources);"
+    "    exe.add_sources({ \"foo.cpp\" });"
+    "    return 42;"
+    "}";
+
+  {
+    InSequence seq;
+    EXPECT_CALL(m_facade, register_project("foo"));
+    EXPECT_CALL(m_facade,
+                add_executable("exe", std::vector<std::string>{ "main.cpp" }));
+    EXPECT_CALL(m_facade,
+                target_sources("exe", facade::visibility::private_,
+                               std::vector<std::string>{ "foo.cpp" }));
+  }
+
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(42));
+}
+}
@@ -0,0 +1,44 @@
+#include "test/exec/smoke_test_fixture.hpp"
+
+#include <gmock/gmock.h>
+
+namespace cmsl::exec::test {
+using ::testing::_;
+using ::testing::AtLeast;
+using ::testing::Eq;
+using ::testing::Gt;
+
+using BuiltinSemaEnvironmentSmokeTest = ExecutionSmokeTest;
+
+TEST_F(BuiltinSemaEnvironmentSmokeTest,
+       ExecutorsWithDifferentErrorsObservers_ReportErrorsSeparately)
+{
+  errors::errors_observer first_errs;
+  errors::errors_observer second_errs;
+  global_executor first{ CMAKESL_EXEC_SMOKE_TEST_ROOT_DIR, m_facade,
+                         first_errs, executor_options() };
+  global_executor second{ CMAKESL_EXEC_SMOKE_TEST_ROOT_DIR, m_facade,
+                          second_errs, executor_options() };
+
+  EXPECT_CALL(*m_errors_observer_mock, notify_error(_)).Times(AtLeast(1));
+  const auto invalid_source = "int main()"
+                              "{"
+                              "    list<int> l = undeclared;"
+                              "    return l.size();"
+                              "}";
+  EXPECT_THAT(first.execute(invalid_source), Eq(-1));
+  ::testing::Mock::VerifyAndClearExpectations(m_errors_observer_mock.get());
+
+  EXPECT_CALL(*m_errors_observer_mock, notify_error(_)).Times(0);
+  const auto source = "int main()"
+                      "{"
+                      "    list<int> l = { 24, 42 };"
+                      "    list<string> s = { \"foo\" };"
+                      "    return l.size() + s.size();"
+                      "}";
+  EXPECT_THAT(second.execute(source), Eq(3));
+
+  EXPECT_THAT(first_errs.notified_count(), Gt(0u));
+  EXPECT_THAT(second_errs.notified_count(), Eq(0u));
+}
+}
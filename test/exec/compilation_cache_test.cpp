@@ -0,0 +1,159 @@
+#include "exec/compilation_cache.hpp"
+
+#include "common/source_view.hpp"
+#include "errors/errors_observer.hpp"
+#include "lexer/lexer.hpp"
+
+#include "test/errors_observer_mock/errors_observer_mock.hpp"
+
+#include <gmock/gmock.h>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+namespace cmsl::exec::test {
+using ::testing::_;
+using ::testing::AtLeast;
+using ::testing::Eq;
+
+class CompilationCacheTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_dir = std::filesystem::temp_directory_path() /
+      ("cmakesl_compilation_cache_test_" +
+       std::to_string(std::random_device{}()));
+    std::filesystem::create_directories(m_dir);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(m_dir); }
+
+  std::string dir() const { return m_dir.string(); }
+
+  errors::test::errors_observer_mock m_errors_observer_mock;
+  errors::errors_observer m_errs;
+  std::filesystem::path m_dir;
+};
+
+TEST_F(CompilationCacheTest, Lex_SecondTimeLoadsTokensFromCache)
+{
+  const auto source = source_view{ "foo.cmsl", "int main() { return 42; }" };
+  const source_files::registration registration{ source };
+  compilation_cache cache{ dir() };
+
+  const auto lexed = lex(m_errs, source, registration.id(), &cache);
+  const auto loaded = lex(m_errs, source, registration.id(), &cache);
+
+  EXPECT_THAT(cache.get_stats().misses, Eq(1u));
+  EXPECT_THAT(cache.get_stats().hits, Eq(1u));
+  EXPECT_THAT(loaded,
+              Eq(lexer::lexer{ m_errs, source, registration.id() }.lex()));
+  EXPECT_THAT(loaded, Eq(lexed));
+}
+
+TEST_F(CompilationCacheTest, Load_ModifiedSource_Misses)
+{
+  const auto source = source_view{ "foo.cmsl", "int main() { return 42; }" };
+  const source_files::registration registration{ source };
+  const auto modified =
+    source_view{ "foo.cmsl", "int main() { return 24; }" };
+  const source_files::registration modified_registration{ modified };
+  compilation_cache cache{ dir() };
+
+  (void)lex(m_errs, source, registration.id(), &cache);
+
+  EXPECT_FALSE(cache.load(modified, modified_registration.id()).has_value());
+}
+
+TEST_F(CompilationCacheTest, Load_CorruptedEntry_Misses)
+{
+  const auto source = source_view{ "foo.cmsl", "int main() { return 42; }" };
+  const source_files::registration registration{ source };
+  compilation_cache cache{ dir() };
+  (void)lex(m_errs, source, registration.id(), &cache);
+
+  for (const auto& entry : std::filesystem::directory_iterator{ m_dir }) {
+    std::filesystem::resize_file(entry.path(),
+                                 std::filesystem::file_size(entry.path()) / 2);
+  }
+
+  EXPECT_FALSE(cache.load(source, registration.id()).has_value());
+}
+
+TEST_F(CompilationCacheTest, Lex_SourceWithErrors_IsNotStored)
+{
+  const auto source = source_view{ "foo.cmsl", "string s = \"unterminated" };
+  const source_files::registration registration{ source };
+  compilation_cache cache{ dir() };
+
+  EXPECT_CALL(m_errors_observer_mock, notify_error(_)).Times(AtLeast(1));
+  (void)lex(m_errs, source, registration.id(), &cache);
+
+  EXPECT_THAT(std::filesystem::is_empty(m_dir), Eq(true));
+}
+
+TEST_F(CompilationCacheTest, Dump_PrintsLookupsAndSummary)
+{
+  const auto source = source_view{ "foo.cmsl", "int main() { return 42; }" };
+  const source_files::registration registration{ source };
+  compilation_cache cache{ dir() };
+  (void)lex(m_errs, source, registration.id(), &cache);
+  (void)lex(m_errs, source, registration.id(), &cache);
+
+  std::ostringstream out;
+  cache.dump(out);
+
+  EXPECT_THAT(out.str(),
+              Eq("miss: foo.cmsl\n"
+                 "hit: foo.cmsl\n"
+                 "compilation cache: 1 hits, 1 misses, 0 checked\n"));
+}
+
+TEST_F(CompilationCacheTest, IsChecked_StoredWithUnchangedImports_IsChecked)
+{
+  const auto import_path = (m_dir / "bar.cmsl").string();
+  std::ofstream{ import_path } << "int bar() { return 42; }";
+  const auto source = source_view{ "foo.cmsl", "int foo() { return 42; }" };
+  compilation_cache cache{ dir() };
+
+  EXPECT_FALSE(cache.is_checked(source));
+
+  cache.store_checked(source,
+                      { { import_path,
+                          compilation_cache::hash(
+                            "int bar() { return 42; }") } });
+
+  EXPECT_TRUE(cache.is_checked(source));
+  EXPECT_THAT(cache.get_stats().checked, Eq(1u));
+}
+
+TEST_F(CompilationCacheTest, IsChecked_ModifiedImport_IsNotChecked)
+{
+  const auto import_path = (m_dir / "bar.cmsl").string();
+  std::ofstream{ import_path } << "int bar() { return 42; }";
+  const auto source = source_view{ "foo.cmsl", "int foo() { return 42; }" };
+  compilation_cache cache{ dir() };
+  cache.store_checked(source,
+                      { { import_path,
+                          compilation_cache::hash(
+                            "int bar() { return 42; }") } });
+
+  std::ofstream{ import_path } << "int bar() { return 24; }";
+
+  EXPECT_FALSE(cache.is_checked(source));
+}
+
+TEST_F(CompilationCacheTest, IsChecked_ModifiedSource_IsNotChecked)
+{
+  const auto source = source_view{ "foo.cmsl", "int foo() { return 42; }" };
+  const auto modified =
+    source_view{ "foo.cmsl", "int foo() { return 24; }" };
+  compilation_cache cache{ dir() };
+  cache.store_checked(source, {});
+
+  EXPECT_FALSE(cache.is_checked(modified));
+}
+}
@@ -0,0 +1,198 @@
+#include "test/exec/smoke_test_fixture.hpp"
+
+#include <gmock/gmock.h>
+
+#include <sstream>
+
+namespace cmsl::exec::test {
+using ::testing::_;
+using ::testing::Eq;
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+using ConstantFoldingSmokeTest = ExecutionSmokeTest;
+
+TEST_F(ConstantFoldingSmokeTest, IntArithmetic)
+{
+  const auto source = "int main()"
+                      "{"
+                      "    return 2 * 3 + (-1) - 10 / 5;"
+                      "}";
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(3));
+}
+
+TEST_F(ConstantFoldingSmokeTest, BoolAndDoubleOperators)
+{
+  const auto source = "int main()"
+                      "{"
+                      "    bool b = (!true) || (1.5 * 2.0 < 3.5);"
+                      "    return b ? 42 : 0;"
+                      "}";
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(42));
+}
+
+TEST_F(ConstantFoldingSmokeTest, StringConcatenation)
+{
+  const auto source = "int main()"
+                      "{"
+                      "    string s = \"foo\" + \"_\" + \"bar\";"
+                      "    return s.size() + (\"abc\" + \"d\").size();"
+                      "}";
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(11));
+}
+
+TEST_F(ConstantFoldingSmokeTest, StringComparison)
+{
+  const auto source =
+    "int main()"
+    "{"
+    "    return \"abc\" < \"abd\" && \"a\" != \"b\" ? 42 : 0;"
+    "}";
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(42));
+}
+
+TEST_F(ConstantFoldingSmokeTest, VersionComparison)
+{
+  const auto source =
+    "int main()"
+    "{"
+    "    bool newer = cmake::version(3, 10) > cmake::version(3, 2);"
+    "    bool equal = cmake::version(1) == cmake::version(1, 0, 0, 0);"
+    "    return newer && equal ? 42 : 0;"
+    "}";
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(42));
+}
+
+TEST_F(ConstantFoldingSmokeTest, IfElse_FalseConditionsSkipped)
+{
+  const auto source = "int main()"
+                      "{"
+                      "    int result = 42;"
+                      "    if(1 > 2)"
+                      "    {"
+                      "        result = 1;"
+                      "    }"
+                      "    else if(false)"
+                      "    {"
+                      "        result = 2;"
+                      "    }"
+                      "    return result;"
+                      "}";
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(42));
+}
+
+TEST_F(ConstantFoldingSmokeTest, IfElse_TrueConditionTaken)
+{
+  const auto source =
+    "int main()"
+    "{"
+    "    if(false)"
+    "    {"
+    "        return 1;"
+    "    }"
+    "    else if(cmake::version(3, 10) >= cmake::version(3, 10))"
+    "    {"
+    "        int value = 40;"
+    "        value += 2;"
+    "        return value;"
+    "    }"
+    "    else"
+    "    {"
+    "        return 2;"
+    "    }"
+    "}";
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(42));
+}
+
+TEST_F(ConstantFoldingSmokeTest, IfElse_NotConstantConditionKept)
+{
+  const auto source = "int main()"
+                      "{"
+                      "    int value = 2;"
+                      "    if(false)"
+                      "    {"
+                      "        return 1;"
+                      "    }"
+                      "    else if(value == 2)"
+                      "    {"
+                      "        return 42;"
+                      "    }"
+                      "    else if(true)"
+                      "    {"
+                      "        return 3;"
+                      "    }"
+                      "    return 4;"
+                      "}";
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(42));
+}
+
+TEST_F(ConstantFoldingSmokeTest, IfElse_FoldedInsideLoop)
+{
+  const auto source = "int main()"
+                      "{"
+                      "    int counter = 0;"
+                      "    while(true)"
+                      "    {"
+                      "        if(2 > 1)"
+                      "        {"
+                      "            ++counter;"
+                      "            if(counter == 42)"
+                      "            {"
+                      "                break;"
+                      "            }"
+                      "        }"
+                      "    }"
+                      "    return counter;"
+                      "}";
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(42));
+}
+
+TEST_F(ConstantFoldingSmokeTest, Ternary_ReferenceToVariableKept)
+{
+  const auto source = "int main()"
+                      "{"
+                      "    int foo = 1;"
+                      "    int bar = 2;"
+                      "    int& baz = (1 < 2) ? foo : bar;"
+                      "    baz = 42;"
+                      "    return foo + (false ? 0 : 0 * bar);"
+                      "}";
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(42));
+}
+
+TEST_F(ConstantFoldingSmokeTest, DumpOptimized_DumpsFoldedTreeBeforeExecution)
+{
+  std::ostringstream dump;
+  auto opts = executor_options();
+  opts.dump_optimized = &dump;
+  const auto executor = std::make_unique<global_executor>(
+    CMAKESL_EXEC_SMOKE_TEST_ROOT_DIR, m_facade, *m_errs, opts);
+
+  const auto source = "int main()"
+                      "{"
+                      "    cmake::message(\"foo\");"
+                      "    return 2 * 21;"
+                      "}";
+
+  std::string dumped_before_execution;
+  EXPECT_CALL(m_facade, message(_))
+    .WillOnce([&dump, &dumped_before_execution](const std::string&) {
+      dumped_before_execution = dump.str();
+    });
+
+  const auto result = executor->execute(source);
+  EXPECT_THAT(result, Eq(42));
+  EXPECT_THAT(dumped_before_execution, HasSubstr("-int value: value: 42"));
+  EXPECT_THAT(dumped_before_execution, Not(HasSubstr("value: 21")));
+}
+}
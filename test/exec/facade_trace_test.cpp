@@ -0,0 +1,172 @@
+#include "exec/buffered_cmake_facade.hpp"
+#include "exec/facade_trace.hpp"
+#include "exec/profiler.hpp"
+#include "exec/recording_cmake_facade.hpp"
+#include "test/exec/smoke_test_fixture.hpp"
+
+#include <gmock/gmock.h>
+
+#include <sstream>
+
+namespace cmsl::exec::test {
+using ::testing::_;
+using ::testing::Eq;
+using ::testing::Gt;
+using ::testing::InSequence;
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::StrictMock;
+
+namespace {
+// Makes the calls and expects them, in order, on the facade.
+void make_calls(facade::cmake_facade& facade)
+{
+  facade.register_project("project");
+  facade.add_library("lib", { "lib.cpp", "lib with spaces.cpp" });
+  facade.target_compile_options("lib", facade::visibility::interface,
+                                { "-Wall", "" });
+  facade.message("multi\nline");
+  facade.get_option_value("OPTION");
+  facade.register_option("OPTION", "description", true);
+}
+
+void expect_calls(cmake_facade_mock& facade)
+{
+  InSequence seq;
+  EXPECT_CALL(facade, register_project("project"));
+  EXPECT_CALL(
+    facade,
+    add_library("lib",
+                std::vector<std::string>{ "lib.cpp", "lib with spaces.cpp" }));
+  EXPECT_CALL(facade,
+              target_compile_options("lib", facade::visibility::interface,
+                                     std::vector<std::string>{ "-Wall", "" }));
+  EXPECT_CALL(facade, message("multi\nline"));
+  EXPECT_CALL(facade, get_option_value("OPTION"));
+  EXPECT_CALL(facade, register_option("OPTION", "description", true));
+}
+}
+
+TEST(FacadeTraceTest, RecordingFacade_ForwardsCalls)
+{
+  StrictMock<cmake_facade_mock> facade;
+  std::ostringstream trace;
+  recording_cmake_facade recording{ facade, trace };
+
+  expect_calls(facade);
+
+  make_calls(recording);
+}
+
+TEST(FacadeTraceTest, RecordingFacade_ForwardsResults)
+{
+  NiceMock<cmake_facade_mock> facade;
+  std::ostringstream trace;
+  recording_cmake_facade recording{ facade, trace };
+
+  EXPECT_CALL(facade, get_old_style_variable("FOO"))
+    .WillOnce(Return(std::optional<std::string>{ "bar" }));
+
+  EXPECT_THAT(recording.get_old_style_variable("FOO"),
+              Eq(std::optional<std::string>{ "bar" }));
+}
+
+TEST(FacadeTraceTest, Replay_CallsRecordedFunctionsInOrder)
+{
+  std::stringstream trace;
+  {
+    NiceMock<cmake_facade_mock> facade;
+    recording_cmake_facade recording{ facade, trace };
+    make_calls(recording);
+  }
+
+  StrictMock<cmake_facade_mock> facade;
+  expect_calls(facade);
+
+  const auto replayed = replay_facade_trace(trace, facade);
+  EXPECT_THAT(replayed, Eq(std::optional<std::size_t>{ 6u }));
+}
+
+TEST(FacadeTraceTest, Replay_BatchedCalls_RecordedAsSeparateCalls)
+{
+  std::stringstream trace;
+  {
+    NiceMock<cmake_facade_mock> facade;
+    recording_cmake_facade recording{ facade, trace };
+    buffered_cmake_facade buffered{ recording };
+    make_calls(buffered);
+    buffered.flush();
+  }
+
+  StrictMock<cmake_facade_mock> facade;
+  {
+    InSequence seq;
+    // Message and queries are not batched, so they are recorded first.
+    EXPECT_CALL(facade, message("multi\nline"));
+    EXPECT_CALL(facade, get_option_value("OPTION"));
+    EXPECT_CALL(facade, register_option("OPTION", "description", true));
+    EXPECT_CALL(facade, register_project("project"));
+    EXPECT_CALL(facade, add_library("lib", _));
+    EXPECT_CALL(facade, target_compile_options(
+                          "lib", facade::visibility::interface, _));
+  }
+
+  const auto replayed = replay_facade_trace(trace, facade);
+  EXPECT_THAT(replayed, Eq(std::optional<std::size_t>{ 6u }));
+}
+
+TEST(FacadeTraceTest, Replay_MalformedTrace_ReturnsNullopt)
+{
+  NiceMock<cmake_facade_mock> facade;
+
+  for (const auto trace_str :
+       { "unknown_function\n", "message 10:foo\n", "message foo\n",
+         "target_sources 3:lib 3 0\n", "register_option 1:a 1:b 2\n" }) {
+    std::istringstream trace{ trace_str };
+    EXPECT_FALSE(replay_facade_trace(trace, facade)) << trace_str;
+  }
+}
+
+TEST(FacadeTraceTest, Replay_SizesExceedingTrace_ReturnsNullopt)
+{
+  NiceMock<cmake_facade_mock> facade;
+
+  // Sizes far beyond available memory, that must not be allocated up front.
+  for (const auto trace_str :
+       { "message 1000000000000000:foo\n",
+         "add_library 3:lib 1000000000000000 1:a\n" }) {
+    std::istringstream trace{ trace_str };
+    EXPECT_FALSE(replay_facade_trace(trace, facade)) << trace_str;
+  }
+}
+
+using PhaseTimingsSmokeTest = ExecutionSmokeTest;
+
+TEST_F(PhaseTimingsSmokeTest, Execute_MeasuresAllPhases)
+{
+  profiler prof{ false };
+  std::ostringstream trace;
+  recording_cmake_facade recording{ m_facade, trace, &prof };
+  auto opts = executor_options();
+  opts.profiler = &prof;
+  m_executor = std::make_unique<global_executor>(
+    CMAKESL_EXEC_SMOKE_TEST_ROOT_DIR, recording, *m_errs, opts);
+
+  const auto source = "int main()"
+                      "{"
+                      "    cmake::message(\"foo\");"
+                      "    return 42;"
+                      "}";
+
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(42));
+
+  for (const auto p : { phase::lex, phase::parse, phase::sema,
+                        phase::execute, phase::facade }) {
+    EXPECT_THAT(prof.phase_total(p).count(), Gt(0))
+      << profiler::phase_name(p);
+  }
+
+  m_executor.reset();
+}
+}
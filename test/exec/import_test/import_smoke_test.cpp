@@ -1,8 +1,15 @@
 #include "test/exec/smoke_test_fixture.hpp"
 
+#include "exec/compilation_cache.hpp"
+
 #include <gmock/gmock.h>
 
+#include <filesystem>
+#include <random>
+
 namespace cmsl::exec::test {
+using ::testing::_;
+using ::testing::AtLeast;
 using ::testing::Eq;
 
 using ImportSmokeTest = ExecutionSmokeTest;
@@ -69,4 +76,174 @@ TEST_F(ImportSmokeTest, EnumImport)
   const auto result = m_executor->execute(source);
   EXPECT_THAT(result, Eq(1));
 }
+
+class LazyImportSmokeTest : public ExecutionSmokeTest
+{
+protected:
+  void SetUp() override
+  {
+    ExecutionSmokeTest::SetUp();
+    create_executor(/*lazy_imports=*/true);
+  }
+
+  void create_executor(bool lazy_imports)
+  {
+    auto opts = executor_options();
+    opts.lazy_imports = lazy_imports;
+    m_executor = std::make_unique<global_executor>(
+      CMAKESL_EXEC_SMOKE_TEST_ROOT_DIR, m_facade, *m_errs, opts);
+  }
+};
+
+TEST_F(LazyImportSmokeTest, InvalidFunction_EagerImport_Fails)
+{
+  create_executor(/*lazy_imports=*/false);
+  const auto source = "import \"import_test/lazy.cmsl\";"
+                      ""
+                      "int main()"
+                      "{"
+                      "    return lazy::used();"
+                      "}";
+  EXPECT_CALL(*m_errors_observer_mock, notify_error(_))
+    .Times(AtLeast(1));
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(-1));
+}
+
+TEST_F(LazyImportSmokeTest, UnusedInvalidFunction_NotChecked)
+{
+  const auto source = "import \"import_test/lazy.cmsl\";"
+                      ""
+                      "int main()"
+                      "{"
+                      "    return lazy::used();"
+                      "}";
+  EXPECT_CALL(*m_errors_observer_mock, notify_error(_)).Times(0);
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(42));
+}
+
+TEST_F(LazyImportSmokeTest, ClassMethod_BuiltOnFirstUse)
+{
+  const auto source = "import \"import_test/lazy.cmsl\";"
+                      ""
+                      "int main()"
+                      "{"
+                      "    lazy::counter c;"
+                      "    return c.get();"
+                      "}";
+  EXPECT_CALL(*m_errors_observer_mock, notify_error(_)).Times(0);
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(42));
+}
+
+TEST_F(LazyImportSmokeTest, UsedInvalidFunction_Fails)
+{
+  const auto source = "import \"import_test/lazy.cmsl\";"
+                      ""
+                      "int main()"
+                      "{"
+                      "    return lazy::invalid();"
+                      "}";
+  EXPECT_CALL(*m_errors_observer_mock, notify_error(_))
+    .Times(AtLeast(1));
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(-1));
+}
+
+TEST_F(LazyImportSmokeTest, FunctionDeclaredLater_NotVisibleInBody)
+{
+  const auto source = "import \"import_test/lazy.cmsl\";"
+                      ""
+                      "int main()"
+                      "{"
+                      "    return lazy::calls_later();"
+                      "}";
+  EXPECT_CALL(*m_errors_observer_mock, notify_error(_))
+    .Times(AtLeast(1));
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(-1));
+}
+
+TEST_F(LazyImportSmokeTest, BuildAllFunctionBodies_ReportsErrorsOfUnused)
+{
+  const auto source = "import \"import_test/lazy.cmsl\";"
+                      ""
+                      "int main()"
+                      "{"
+                      "    return lazy::used();"
+                      "}";
+  EXPECT_CALL(*m_errors_observer_mock, notify_error(_)).Times(0);
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(42));
+  ::testing::Mock::VerifyAndClearExpectations(m_errors_observer_mock.get());
+
+  EXPECT_CALL(*m_errors_observer_mock, notify_error(_))
+    .Times(AtLeast(1));
+  EXPECT_FALSE(m_executor->build_all_function_bodies());
+}
+
+class CachedImportSmokeTest : public ExecutionSmokeTest
+{
+protected:
+  void SetUp() override
+  {
+    ExecutionSmokeTest::SetUp();
+    m_dir = std::filesystem::temp_directory_path() /
+      ("cmakesl_cached_import_smoke_test_" +
+       std::to_string(std::random_device{}()));
+    std::filesystem::create_directories(m_dir);
+  }
+
+  void TearDown() override
+  {
+    std::filesystem::remove_all(m_dir);
+    ExecutionSmokeTest::TearDown();
+  }
+
+  // Executes the source with a new executor and a new cache in the same
+  // directory, like a subsequent run of the tool.
+  int execute_with_cache(const char* source)
+  {
+    m_cache = std::make_unique<compilation_cache>(m_dir.string());
+    auto opts = executor_options();
+    opts.cache = m_cache.get();
+    m_executor = std::make_unique<global_executor>(
+      CMAKESL_EXEC_SMOKE_TEST_ROOT_DIR, m_facade, *m_errs, opts);
+    return m_executor->execute(source);
+  }
+
+  std::filesystem::path m_dir;
+  std::unique_ptr<compilation_cache> m_cache;
+};
+
+TEST_F(CachedImportSmokeTest, CleanImports_CheckedOnSecondRun)
+{
+  const auto source = "import \"import_test/baz.cmsl\";"
+                      ""
+                      "int main()"
+                      "{"
+                      "    return baz::qux;"
+                      "}";
+  EXPECT_THAT(execute_with_cache(source), Eq(42));
+  EXPECT_THAT(m_cache->get_stats().checked, Eq(0u));
+
+  EXPECT_THAT(execute_with_cache(source), Eq(42));
+  EXPECT_THAT(m_cache->get_stats().checked, Eq(2u));
+}
+
+TEST_F(CachedImportSmokeTest, ImportWithErrors_NotChecked)
+{
+  const auto source = "import \"import_test/lazy.cmsl\";"
+                      ""
+                      "int main()"
+                      "{"
+                      "    return lazy::used();"
+                      "}";
+  EXPECT_CALL(*m_errors_observer_mock, notify_error(_))
+    .Times(AtLeast(2));
+  EXPECT_THAT(execute_with_cache(source), Eq(-1));
+  EXPECT_THAT(execute_with_cache(source), Eq(-1));
+  EXPECT_THAT(m_cache->get_stats().checked, Eq(0u));
+}
 }
@@ -0,0 +1,59 @@
+#include "exec/instance/instance_allocator.hpp"
+
+#include <gmock/gmock.h>
+
+namespace cmsl::exec::inst::test {
+using ::testing::Eq;
+using ::testing::Ne;
+
+TEST(InstanceAllocatorTest, Deallocate_ReusesMemoryForTheSameSize)
+{
+  const auto size = std::size_t{ 100u };
+  const auto first = instance_allocator::allocate(size);
+  instance_allocator::deallocate(first, size);
+
+  const auto second = instance_allocator::allocate(size);
+  EXPECT_THAT(second, Eq(first));
+  instance_allocator::deallocate(second, size);
+}
+
+TEST(InstanceAllocatorTest, Allocate_ReturnsDistinctMemory)
+{
+  const auto size = std::size_t{ 24u };
+  const auto first = instance_allocator::allocate(size);
+  const auto second = instance_allocator::allocate(size);
+  EXPECT_THAT(second, Ne(first));
+
+  instance_allocator::deallocate(first, size);
+  instance_allocator::deallocate(second, size);
+}
+
+TEST(InstanceAllocatorTest, Allocate_ReusedMemory_DoesNotAllocateFromHeap)
+{
+  const auto size = std::size_t{ 152u };
+  instance_allocator::deallocate(instance_allocator::allocate(size), size);
+
+  auto& stats = instance_allocator::stats();
+  stats = {};
+
+  for (auto i = 0; i < 100; ++i) {
+    instance_allocator::deallocate(instance_allocator::allocate(size), size);
+  }
+
+  EXPECT_THAT(stats.instances_allocated, Eq(100u));
+  EXPECT_THAT(stats.instances_freed, Eq(100u));
+  EXPECT_THAT(stats.heap_allocations, Eq(0u));
+}
+
+TEST(InstanceAllocatorTest, Allocate_BigSize_AllocatesFromHeap)
+{
+  const auto size = std::size_t{ 1024u };
+  auto& stats = instance_allocator::stats();
+  stats = {};
+
+  const auto ptr = instance_allocator::allocate(size);
+  instance_allocator::deallocate(ptr, size);
+
+  EXPECT_THAT(stats.heap_allocations, Eq(1u));
+}
+}
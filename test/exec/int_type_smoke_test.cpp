@@ -243,4 +243,34 @@ TEST_F(IntTypeSmokeTest, OperatorEqualEqual)
   const auto result = m_executor->execute(source);
   EXPECT_THAT(result, Eq(1));
 }
+
+TEST_F(IntTypeSmokeTest, NestedOperators)
+{
+  const auto source = "int foo()"
+                      "{"
+                      "    return 3;"
+                      "}"
+                      ""
+                      "int main()"
+                      "{"
+                      "    int i = 2;"
+                      "    int j = (-i) * (i + foo()) + 60 / i;"
+                      "    return int(j == 20 && i < j);"
+                      "}";
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(1));
+}
+
+TEST_F(IntTypeSmokeTest, CompoundAssignmentResultReferencesVariable)
+{
+  const auto source = "int main()"
+                      "{"
+                      "    int i = 40;"
+                      "    int& ref = (i += 1);"
+                      "    ++ref;"
+                      "    return i;"
+                      "}";
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(42));
+}
 }
@@ -570,4 +570,49 @@ TEST_F(ListTypeSmokeTest, InitializerList)
   const auto result = m_executor->execute(source);
   EXPECT_THAT(result, Eq(1));
 }
+
+TEST_F(ListTypeSmokeTest, ModifyElement)
+{
+  const auto source = "int main()"
+                      "{"
+                      "    list<int> l = { 1, 2, 3 };"
+                      "    l.at(1) += 40;"
+                      "    l.push_back(4);"
+                      "    l.push_front(0);"
+                      "    l.sort();"
+                      "    return int(l.back() == 42 && l.size() == 5);"
+                      "}";
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(1));
+}
+
+TEST_F(ListTypeSmokeTest, ModifyElement_CopyIsNotModified)
+{
+  const auto source =
+    "int main()"
+    "{"
+    "    list<string> l = { \"foo\", \"bar\" };"
+    "    list<string> copy = l;"
+    "    l.front() += \"baz\";"
+    "    copy.push_back(\"qux\");"
+    "    return int(copy.at(0) == \"foo\" && l.at(0) == \"foobaz\""
+    "               && copy.size() == 3 && l.size() == 2);"
+    "}";
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(1));
+}
+
+TEST_F(ListTypeSmokeTest, Strings_SortFindMinMax)
+{
+  const auto source = "int main()"
+                      "{"
+                      "    list<string> l = { \"c\", \"a\", \"d\", \"b\" };"
+                      "    int min = l.min();"
+                      "    int max = l.max();"
+                      "    l.sort();"
+                      "    return min * 100 + max * 10 + l.find(\"c\");"
+                      "}";
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(122));
+}
 }
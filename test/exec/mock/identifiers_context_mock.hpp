@@ -7,6 +7,7 @@ class identifiers_context_mock : public identifiers_context
 {
 public:
   MOCK_METHOD1(lookup_identifier, inst::instance*(unsigned index));
+  MOCK_METHOD1(lookup_local_variable, inst::instance*(unsigned slot));
   MOCK_METHOD0(get_class_instance, inst::instance*());
 };
 }
\ No newline at end of file
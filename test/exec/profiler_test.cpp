@@ -0,0 +1,195 @@
+#include "exec/profiler.hpp"
+#include "test/exec/smoke_test_fixture.hpp"
+
+#include <gmock/gmock.h>
+
+#include <sstream>
+#include <thread>
+
+namespace cmsl::exec::test {
+using ::testing::Eq;
+using ::testing::Ge;
+using ::testing::HasSubstr;
+using ::testing::Lt;
+using ::testing::MatchesRegex;
+using ::testing::Not;
+
+namespace {
+// Folded stacks without the times.
+std::vector<std::string> folded_stacks(const profiler& p)
+{
+  std::ostringstream out;
+  p.write_folded_stacks(out);
+
+  std::vector<std::string> stacks;
+  std::istringstream in{ out.str() };
+  for (std::string line; std::getline(in, line);) {
+    stacks.emplace_back(line.substr(0u, line.rfind(' ')));
+  }
+  return stacks;
+}
+}
+
+TEST(ProfilerTest, FoldedStacks_MergesEqualStacks)
+{
+  profiler p;
+  {
+    const profile_scope outer{ &p, "outer", "phase", "file.cmsl", 1u };
+    for (auto i = 0; i < 2; ++i) {
+      const profile_scope inner{ &p, "inner", "phase" };
+    }
+  }
+  {
+    const profile_scope other{ &p, "other", "phase" };
+  }
+
+  const auto expected = std::vector<std::string>{
+    "outer (file.cmsl:1)", "outer (file.cmsl:1);inner", "other"
+  };
+  EXPECT_THAT(folded_stacks(p), Eq(expected));
+}
+
+TEST(ProfilerTest, ChromeTrace_WritesCompleteEventsWithEscapedStrings)
+{
+  profiler p;
+  {
+    const profile_scope scope{ &p, "a \"b\"", "phase", "c\\d.cmsl", 3u };
+  }
+
+  std::ostringstream out;
+  p.write_chrome_trace(out);
+
+  const auto trace = out.str();
+  EXPECT_THAT(trace, HasSubstr("{\"traceEvents\":["));
+  EXPECT_THAT(trace, HasSubstr("\"name\":\"a \\\"b\\\"\""));
+  EXPECT_THAT(trace, HasSubstr("\"ph\":\"X\""));
+  EXPECT_THAT(trace,
+              HasSubstr("\"args\":{\"calls\":1,\"file\":\"c\\\\d.cmsl\","
+                        "\"line\":3}"));
+}
+
+TEST(ProfilerTest, ChromeTrace_MergesScopesWithEqualStacks)
+{
+  profiler p;
+  for (auto i = 0; i < 3; ++i) {
+    const profile_scope scope{ &p, "scope", "phase" };
+  }
+
+  std::ostringstream out;
+  p.write_chrome_trace(out);
+
+  const auto trace = out.str();
+  EXPECT_THAT(trace, HasSubstr("\"args\":{\"calls\":3}"));
+  EXPECT_THAT(trace.find("\"name\""), Eq(trace.rfind("\"name\"")));
+}
+
+TEST(ProfilerTest, PhaseTotal_DoesNotIncludeNestedPhases)
+{
+  profiler p;
+  {
+    const profile_scope sema{ &p, phase::sema };
+    {
+      const profile_scope function{ &p, "foo", "function" };
+      const profile_scope lex{ &p, phase::lex };
+      std::this_thread::sleep_for(std::chrono::milliseconds{ 2 });
+    }
+  }
+
+  // Time of the nested lex phase is accounted only to lex.
+  EXPECT_THAT(p.phase_total(phase::lex),
+              Ge(std::chrono::milliseconds{ 2 }));
+  EXPECT_THAT(p.phase_total(phase::sema),
+              Lt(std::chrono::milliseconds{ 2 }));
+  EXPECT_THAT(p.phase_total(phase::parse).count(), Eq(0));
+}
+
+TEST(ProfilerTest, ChromeTrace_WritesTimesAsWholeMicroseconds)
+{
+  profiler p;
+  {
+    const profile_scope scope{ &p, "name", "phase" };
+  }
+
+  std::ostringstream out;
+  p.write_chrome_trace(out);
+
+  // Timestamps are integers, never written in the exponent notation.
+  const auto trace = out.str();
+  const auto number_at = [&trace](const std::string& key) {
+    const auto begin = trace.find(key) + key.size();
+    return trace.substr(begin, trace.find_first_of(",}", begin) - begin);
+  };
+  EXPECT_THAT(number_at("\"ts\":"), MatchesRegex("[0-9]+"));
+  EXPECT_THAT(number_at("\"dur\":"), MatchesRegex("[0-9]+"));
+}
+
+TEST(ProfilerTest, NullProfiler_ScopesAreNoOps)
+{
+  const profile_scope scope{ nullptr, "name", "phase" };
+}
+
+using ProfilerSmokeTest = ExecutionSmokeTest;
+
+TEST_F(ProfilerSmokeTest, Execute_RecordsPhasesAndFunctionCalls)
+{
+  profiler p;
+  auto opts = executor_options();
+  opts.profiler = &p;
+  m_executor = std::make_unique<global_executor>(
+    CMAKESL_EXEC_SMOKE_TEST_ROOT_DIR, m_facade, *m_errs, opts);
+
+  const auto source = "int foo()"
+                      "{"
+                      "    return 42;"
+                      "}"
+                      ""
+                      "int main()"
+                      "{"
+                      "    string s = \"bar\";"
+                      "    s.size();"
+                      "    return foo();"
+                      "}";
+
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(42));
+  m_executor.reset();
+
+  const auto path =
+    std::string{ CMAKESL_EXEC_SMOKE_TEST_ROOT_DIR } + "/CMakeLists.cmsl";
+  const auto main_frame = "execute;main (" + path + ":1)";
+  const auto stacks = folded_stacks(p);
+  for (const auto& expected : {
+         "lex (" + path + ')',
+         "parse (" + path + ')',
+         "sema (" + path + ')',
+         "static variables initialization (" + path + ')',
+         main_frame,
+         main_frame + ";foo (" + path + ":1)",
+         main_frame + ";string::size",
+       }) {
+    EXPECT_THAT(stacks, ::testing::Contains(expected));
+  }
+  EXPECT_THAT(stacks, Not(::testing::Contains(HasSubstr("::main"))));
+}
+
+TEST_F(ProfilerSmokeTest, Execute_WithoutFunctionCalls_RecordsOnlyPhases)
+{
+  profiler p{ false };
+  auto opts = executor_options();
+  opts.profiler = &p;
+  m_executor = std::make_unique<global_executor>(
+    CMAKESL_EXEC_SMOKE_TEST_ROOT_DIR, m_facade, *m_errs, opts);
+
+  const auto source = "int main()"
+                      "{"
+                      "    return 42;"
+                      "}";
+
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(42));
+  m_executor.reset();
+
+  EXPECT_THAT(folded_stacks(p), Not(::testing::Contains(HasSubstr("main ("))));
+  EXPECT_THAT(p.phase_total(phase::execute).count(), ::testing::Gt(0));
+}
+}
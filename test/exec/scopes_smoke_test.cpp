@@ -41,4 +41,71 @@ TEST_F(ScopesSmokeTest, FunctionScope)
   const auto result = m_executor->execute(source);
   EXPECT_THAT(result, Eq(42));
 }
+
+TEST_F(ScopesSmokeTest, SiblingScopesReuseFrameSlots)
+{
+  const auto source = "int main()"
+                      "{"
+                      "    int result = 0;"
+                      "    {"
+                      "        int foo = 40;"
+                      "        result = result + foo;"
+                      "    }"
+                      "    {"
+                      "        int bar;"
+                      "        result = result + bar + 2;"
+                      "    }"
+                      "    return result;"
+                      "}";
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(42));
+}
+
+TEST_F(ScopesSmokeTest, RecursiveCallsHaveSeparateFrames)
+{
+  const auto source = "int fib(int n)"
+                      "{"
+                      "    if (n < 2)"
+                      "    {"
+                      "        return n;"
+                      "    }"
+                      "    int a = fib(n - 1);"
+                      "    int b = fib(n - 2);"
+                      "    return a + b;"
+                      "}"
+                      ""
+                      "int main()"
+                      "{"
+                      "    return fib(9);"
+                      "}";
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(34));
+}
+
+TEST_F(ScopesSmokeTest, LocalVariableShadowsClassMember)
+{
+  const auto source = "class foo"
+                      "{"
+                      "    int value;"
+                      ""
+                      "    int get()"
+                      "    {"
+                      "        int sum = value;"
+                      "        {"
+                      "            int value = 40;"
+                      "            sum = sum + value;"
+                      "        }"
+                      "        return sum;"
+                      "    }"
+                      "};"
+                      ""
+                      "int main()"
+                      "{"
+                      "    foo f;"
+                      "    f.value = 2;"
+                      "    return f.get();"
+                      "}";
+  const auto result = m_executor->execute(source);
+  EXPECT_THAT(result, Eq(42));
+}
 }
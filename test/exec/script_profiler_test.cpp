@@ -0,0 +1,210 @@
+#include "exec/script_profiler.hpp"
+#include "test/exec/smoke_test_fixture.hpp"
+
+#include <gmock/gmock.h>
+
+#include <sstream>
+
+namespace cmsl::exec::test {
+using ::testing::Eq;
+using ::testing::Ge;
+using ::testing::Gt;
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+using ::testing::Not;
+
+class ScriptProfilerSmokeTest : public ExecutionSmokeTest
+{
+protected:
+  // Executes the source and returns the profile as JSON.
+  std::string execute_profiled(const std::string& source)
+  {
+    script_profiler p;
+    auto opts = executor_options();
+    opts.script_profiler = &p;
+    m_executor = std::make_unique<global_executor>(
+      CMAKESL_EXEC_SMOKE_TEST_ROOT_DIR, m_facade, *m_errs, opts);
+
+    m_result = m_executor->execute(source);
+
+    std::ostringstream out;
+    p.write_json(out);
+    m_executor.reset();
+    return out.str();
+  }
+
+  // JSON of the function with the given name, without its lines.
+  static std::string function_json(const std::string& json,
+                                   const std::string& name)
+  {
+    const auto begin = json.find("{\"name\":\"" + name + '"');
+    if (begin == std::string::npos) {
+      return {};
+    }
+
+    return json.substr(begin, json.find("\"lines\"", begin) - begin);
+  }
+
+  static double number(const std::string& json, const std::string& key)
+  {
+    const auto key_str = '"' + key + "\":";
+    const auto found = json.find(key_str);
+    if (found == std::string::npos) {
+      return -1.0;
+    }
+
+    return std::stod(json.substr(found + key_str.size()));
+  }
+
+  // JSON of the line of the function with the given name.
+  static std::string line_json(const std::string& json,
+                               const std::string& name, unsigned line)
+  {
+    const auto function = json.find("{\"name\":\"" + name + '"');
+    const auto begin =
+      json.find("{\"line\":" + std::to_string(line) + ',', function);
+    if (function == std::string::npos || begin == std::string::npos) {
+      return {};
+    }
+
+    return json.substr(begin, json.find('}', begin) - begin);
+  }
+
+protected:
+  int m_result{ 0 };
+};
+
+TEST_F(ScriptProfilerSmokeTest, CountsCallsAndLines)
+{
+  const auto source = "int foo(int n)\n"
+                      "{\n"
+                      "  list<int> l;\n"
+                      "  for(int i = 0; i < n; i = i + 1)\n"
+                      "  {\n"
+                      "    l.push_back(i);\n"
+                      "  }\n"
+                      "  return l.size();\n"
+                      "}\n"
+                      "\n"
+                      "int main()\n"
+                      "{\n"
+                      "  int a = foo(3);\n"
+                      "  return a + foo(2);\n"
+                      "}\n";
+
+  const auto json = execute_profiled(source);
+  EXPECT_THAT(m_result, Eq(5));
+
+  const auto path =
+    std::string{ CMAKESL_EXEC_SMOKE_TEST_ROOT_DIR } + "/CMakeLists.cmsl";
+  const auto foo = function_json(json, "foo");
+  const auto main = function_json(json, "main");
+  EXPECT_THAT(foo, HasSubstr("\"file\":\"" + path + "\",\"line\":1,"));
+  EXPECT_THAT(number(foo, "calls"), Eq(2.0));
+  EXPECT_THAT(number(main, "calls"), Eq(1.0));
+
+  EXPECT_THAT(json, HasSubstr("{\"line\":3,\"hits\":2,"));
+  EXPECT_THAT(json, HasSubstr("{\"line\":6,\"hits\":5,"));
+  EXPECT_THAT(json, HasSubstr("{\"line\":8,\"hits\":2,"));
+  EXPECT_THAT(json, HasSubstr("{\"line\":13,\"hits\":1,"));
+  EXPECT_THAT(json, HasSubstr("{\"line\":14,\"hits\":1,"));
+
+  EXPECT_THAT(number(main, "inclusive_us"),
+              Ge(number(foo, "inclusive_us")));
+  EXPECT_THAT(number(foo, "exclusive_allocations"), Gt(0.0));
+  EXPECT_THAT(number(main, "inclusive_allocations"),
+              Eq(number(main, "exclusive_allocations") +
+                 number(foo, "inclusive_allocations")));
+}
+
+TEST_F(ScriptProfilerSmokeTest, Lines_DoNotContainCallees)
+{
+  const auto source = "int foo()\n"
+                      "{\n"
+                      "  list<int> l;\n"
+                      "  l.push_back(1);\n"
+                      "  return l.size();\n"
+                      "}\n"
+                      "\n"
+                      "int main()\n"
+                      "{\n"
+                      "  int a = foo();\n"
+                      "  while(a < 3)\n"
+                      "  {\n"
+                      "    a = a + foo();\n"
+                      "  }\n"
+                      "  return a;\n"
+                      "}\n";
+
+  const auto json = execute_profiled(source);
+  EXPECT_THAT(m_result, Eq(3));
+
+  // Lines of main, including the while loop and its body, do not contain
+  // allocations of foo, so they sum up to exclusive allocations of main.
+  auto lines_allocations = 0.0;
+  for (const auto line : { 10u, 11u, 13u, 15u }) {
+    const auto line_stats = line_json(json, "main", line);
+    ASSERT_THAT(line_stats, Not(IsEmpty())) << line;
+    lines_allocations += number(line_stats, "allocations");
+  }
+
+  const auto main = function_json(json, "main");
+  EXPECT_THAT(lines_allocations, Eq(number(main, "exclusive_allocations")));
+  EXPECT_THAT(number(line_json(json, "foo", 3u), "allocations"), Gt(0.0));
+}
+
+TEST_F(ScriptProfilerSmokeTest, RecursiveCalls_AccountedToInclusiveOnce)
+{
+  const auto source = "int foo(int n)\n"
+                      "{\n"
+                      "  if(n == 0)\n"
+                      "  {\n"
+                      "    return 0;\n"
+                      "  }\n"
+                      "  return foo(n - 1) + 1;\n"
+                      "}\n"
+                      "\n"
+                      "int main()\n"
+                      "{\n"
+                      "  return foo(3);\n"
+                      "}\n";
+
+  const auto json = execute_profiled(source);
+  EXPECT_THAT(m_result, Eq(3));
+
+  const auto foo = function_json(json, "foo");
+  const auto main = function_json(json, "main");
+  EXPECT_THAT(number(foo, "calls"), Eq(4.0));
+  EXPECT_THAT(number(main, "inclusive_us"),
+              Ge(number(foo, "inclusive_us")));
+  EXPECT_THAT(number(main, "inclusive_allocations"),
+              Eq(number(main, "exclusive_allocations") +
+                 number(foo, "inclusive_allocations")));
+  EXPECT_THAT(number(foo, "inclusive_allocations"),
+              Eq(number(foo, "exclusive_allocations")));
+}
+
+TEST_F(ScriptProfilerSmokeTest, WriteReport_ContainsFunctionsAndLines)
+{
+  script_profiler p;
+  auto opts = executor_options();
+  opts.script_profiler = &p;
+  m_executor = std::make_unique<global_executor>(
+    CMAKESL_EXEC_SMOKE_TEST_ROOT_DIR, m_facade, *m_errs, opts);
+
+  const auto result = m_executor->execute("int main()\n"
+                                          "{\n"
+                                          "  return 42;\n"
+                                          "}\n");
+  EXPECT_THAT(result, Eq(42));
+
+  std::ostringstream out;
+  p.write_report(out);
+  m_executor.reset();
+
+  const auto path =
+    std::string{ CMAKESL_EXEC_SMOKE_TEST_ROOT_DIR } + "/CMakeLists.cmsl";
+  EXPECT_THAT(out.str(), HasSubstr("main (" + path + ":1)"));
+  EXPECT_THAT(out.str(), HasSubstr(path + ":3"));
+}
+}
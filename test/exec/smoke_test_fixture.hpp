@@ -2,12 +2,54 @@
 
 #include "errors/errors_observer.hpp"
 #include "exec/global_executor.hpp"
+#include "exec/instance/instance_allocator.hpp"
 #include "test/errors_observer_mock/errors_observer_mock.hpp"
 #include "test/mock/cmake_facade_mock.hpp"
 
 #include <gmock/gmock.h>
 
+#include <cstdlib>
+#include <iostream>
+
 namespace cmsl::exec::test {
+// The same smoke tests are run against every execution engine. The engine is
+// chosen by the environment of the test run, see test/exec/CMakeLists.txt.
+inline execution_engine engine_under_test()
+{
+  const auto engine = std::getenv("CMAKESL_EXEC_SMOKE_TEST_ENGINE");
+  if (engine != nullptr && std::string{ engine } == "bytecode") {
+    return execution_engine::bytecode;
+  }
+
+  return execution_engine::tree_walker;
+}
+
+// Options of an executor running on the engine under test.
+inline global_executor::options executor_options()
+{
+  global_executor::options opts;
+  opts.engine = engine_under_test();
+  return opts;
+}
+
+// When CMAKESL_EXEC_SMOKE_TEST_ALLOCATION_STATS environment variable is set,
+// instance allocation counters of every test are printed.
+inline void print_allocation_stats()
+{
+  if (std::getenv("CMAKESL_EXEC_SMOKE_TEST_ALLOCATION_STATS") == nullptr) {
+    return;
+  }
+
+  const auto& stats = inst::instance_allocator::stats();
+  const auto test_info =
+    ::testing::UnitTest::GetInstance()->current_test_info();
+  std::cout << test_info->test_suite_name() << '.' << test_info->name()
+            << ": instances allocated: " << stats.instances_allocated
+            << ", freed: " << stats.instances_freed
+            << ", heap allocations: " << stats.heap_allocations
+            << ", full expressions: " << stats.full_expressions << '\n';
+}
+
 class ExecutionSmokeTest : public ::testing::Test
 {
 protected:
@@ -15,16 +57,21 @@ protected:
 
   void SetUp() override
   {
+    inst::instance_allocator::stats() = {};
+
     m_errors_observer_mock =
       std::make_unique<errors::test::errors_observer_mock>();
+    m_errs = std::make_unique<errors::errors_observer>();
 
     m_executor = std::make_unique<global_executor>(
-      CMAKESL_EXEC_SMOKE_TEST_ROOT_DIR, m_facade, *m_errs);
+      CMAKESL_EXEC_SMOKE_TEST_ROOT_DIR, m_facade, *m_errs,
+      executor_options());
   }
 
   void TearDown() override
   {
     m_executor.reset();
+    print_allocation_stats();
     m_errors_observer_mock.reset();
   }
 
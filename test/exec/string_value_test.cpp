@@ -0,0 +1,100 @@
+#include "exec/instance/string_value.hpp"
+
+#include <gmock/gmock.h>
+
+namespace cmsl::exec::inst::test {
+using ::testing::Eq;
+using ::testing::Ne;
+
+namespace {
+const auto short_str = std::string{ "foo" };
+const auto long_str =
+  std::string{ "some/quite/long/path/to/a/source/file.cpp" };
+}
+
+TEST(StringValueTest, DefaultConstructor_CreatesEmptyString)
+{
+  string_value value;
+  EXPECT_TRUE(value.empty());
+  EXPECT_THAT(value.size(), Eq(0u));
+  EXPECT_THAT(value.str(), Eq(""));
+}
+
+TEST(StringValueTest, Constructor_StoresPassedString)
+{
+  for (const auto& str : { short_str, long_str }) {
+    EXPECT_THAT(string_value{ str }.str(), Eq(str));
+    EXPECT_THAT(string_value{ cmsl::string_view{ str } }.view(), Eq(str));
+    EXPECT_THAT(string_value{ str.c_str() }.size(), Eq(str.size()));
+  }
+}
+
+TEST(StringValueTest, Copy_SharesLongString)
+{
+  const string_value value{ long_str };
+  const auto copy = value;
+  EXPECT_THAT(copy.view().data(), Eq(value.view().data()));
+  EXPECT_THAT(copy, Eq(value));
+}
+
+TEST(StringValueTest, Copy_StoresShortStringInline)
+{
+  const string_value value{ short_str };
+  const auto copy = value;
+  EXPECT_THAT(copy.view().data(), Ne(value.view().data()));
+  EXPECT_THAT(copy, Eq(value));
+}
+
+TEST(StringValueTest, Modify_DoesNotChangeCopies)
+{
+  for (const auto& str : { short_str, long_str }) {
+    string_value value{ str };
+    const auto copy = value;
+
+    value.modify([](std::string& s) { s += "_bar"; });
+
+    EXPECT_THAT(value.str(), Eq(str + "_bar"));
+    EXPECT_THAT(copy.str(), Eq(str));
+  }
+}
+
+TEST(StringValueTest, Modify_NotSharedString_ModifiesInPlace)
+{
+  string_value value{ long_str };
+  const auto data = value.view().data();
+
+  value.modify([](std::string& s) { s.back() = 'h'; });
+
+  EXPECT_THAT(value.view().data(), Eq(data));
+  EXPECT_THAT(value.view().back(), Eq('h'));
+}
+
+TEST(StringValueTest, Modify_GrowsShortStringOverInlineCapacity)
+{
+  string_value value{ short_str };
+  value.modify([](std::string& s) { s = long_str; });
+  EXPECT_THAT(value.str(), Eq(long_str));
+}
+
+TEST(StringValueTest, Move_LeavesEmptyString)
+{
+  for (const auto& str : { short_str, long_str }) {
+    string_value value{ str };
+    const auto moved = std::move(value);
+    EXPECT_THAT(moved.str(), Eq(str));
+    EXPECT_TRUE(value.empty());
+  }
+}
+
+TEST(StringValueTest, Comparison_ComparesCharacters)
+{
+  const string_value foo{ "foo" };
+  const string_value bar{ "bar" };
+  EXPECT_TRUE(foo == string_value{ "foo" });
+  EXPECT_TRUE(foo != bar);
+  EXPECT_TRUE(bar < foo);
+  EXPECT_TRUE(bar <= foo);
+  EXPECT_TRUE(foo > bar);
+  EXPECT_TRUE(foo >= foo);
+}
+}
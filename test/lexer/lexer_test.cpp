@@ -401,4 +401,92 @@ const auto values = testing::Values(
     { token_type::identifier, token_type::dot, token_type::identifier } });
 INSTANTIATE_TEST_CASE_P(Lexer, Lex_Comment, values);
 }
+
+namespace unknown_chars {
+TEST(Lexer_Lex, UnknownChar_Skipped)
+{
+  auto lex = create_lexer("foo @ $ \\ bar");
+  const auto tokens = lex.lex();
+
+  ASSERT_THAT(tokens.size(), 2u);
+  EXPECT_THAT(tokens[0].str(), "foo");
+  EXPECT_THAT(tokens[1].str(), "bar");
+}
+}
+
+namespace locations {
+TEST(Lexer_Lex, TokensInManyLines_GetLocations)
+{
+  // Long runs of whitespaces and identifier chars are lexed in chunks.
+  const auto long_name = std::string(40u, 'a');
+  const auto source =
+    "  foo\n\n" + std::string(37u, ' ') + long_name + "\n\"s\"";
+  auto lex = create_lexer(source);
+  const auto tokens = lex.lex();
+
+  ASSERT_THAT(tokens.size(), 3u);
+
+  const auto foo = tokens[0].src_range();
+  EXPECT_THAT(foo.begin.line, 1u);
+  EXPECT_THAT(foo.begin.column, 3u);
+  EXPECT_THAT(foo.begin.absolute, 2u);
+  EXPECT_THAT(foo.end.absolute, 5u);
+
+  const auto name = tokens[1].src_range();
+  EXPECT_THAT(tokens[1].str(), long_name);
+  EXPECT_THAT(name.begin.line, 3u);
+  // The new line char itself is the first column of a line.
+  EXPECT_THAT(name.begin.column, 39u);
+  EXPECT_THAT(name.begin.absolute, 44u);
+
+  const auto str = tokens[2].src_range();
+  EXPECT_THAT(tokens[2].get_type(), token_type::string);
+  EXPECT_THAT(str.begin.line, 4u);
+  EXPECT_THAT(str.begin.column, 2u);
+}
+}
+
+namespace compact_token {
+TEST(Token, MadeFromSameLiteral_SharesSource)
+{
+  const auto first = make_token(token_type::identifier, "foo");
+  const auto second = make_token(token_type::identifier, "foo");
+
+  EXPECT_THAT(first.source_id(), second.source_id());
+  EXPECT_THAT(first.str(), "foo");
+}
+
+TEST(Token, SrcRange_ComputedFromOffset)
+{
+  const auto source = std::string{ "foo\n  bar" };
+  const auto registration =
+    source_files::registration{ cmsl::source_view{ "path.cmsl", source } };
+  const auto t = token{ token_type::identifier, 6u, 3u, registration.id() };
+
+  EXPECT_THAT(t.str(), "bar");
+  EXPECT_THAT(t.source().path(), "path.cmsl");
+
+  const auto range = t.src_range();
+  EXPECT_THAT(range.begin.line, 2u);
+  EXPECT_THAT(range.begin.column, 4u);
+  EXPECT_THAT(range.begin.absolute, 6u);
+  EXPECT_THAT(range.end.absolute, 9u);
+}
+
+TEST(SourceFiles, RemovedSourceId_IsReused)
+{
+  const auto source = std::string{ "foo" };
+  const auto other_source = std::string{ "bar" };
+  auto registration =
+    source_files::registration{ cmsl::source_view{ "foo.cmsl", source } };
+  const auto id = registration.id();
+
+  registration = source_files::registration{};
+  const auto other = source_files::registration{ cmsl::source_view{
+    "bar.cmsl", other_source } };
+
+  EXPECT_THAT(other.id(), ::testing::Eq(id));
+  EXPECT_THAT(source_files::view(other.id()).path(), "bar.cmsl");
+}
+}
 }
@@ -1,3 +1,4 @@
+#include "errors/errors_observer.hpp"
 #include "sema/identifiers_context.hpp"
 #include "sema/sema_context_impl.hpp"
 #include "sema/sema_type.hpp"
@@ -543,4 +544,164 @@ TEST_F(IdentifiersContextTest,
   EXPECT_THAT(&(got_info->type.get()), &different_type);
   EXPECT_THAT(got_info->index, different_identifier_index);
 }
+
+TEST_F(IdentifiersContextTest,
+       MergeImportedStuff_ImportedNamespace_TypeOf_ReturnsImportedInfo)
+{
+  identifiers_context_impl module_ctx;
+  module_ctx.enter_global_ctx(token_identifier("ctx"), /*exported=*/true);
+  const auto identifier_index = 0u;
+  module_ctx.register_identifier(token_identifier("foo"),
+                                 { valid_type, identifier_index },
+                                 /*exported=*/true);
+  module_ctx.leave_ctx();
+  const auto exported = module_ctx.collect_exported_stuff();
+
+  errors::errors_observer errs;
+  identifiers_context_impl ctx;
+  EXPECT_TRUE(ctx.merge_imported_stuff(*exported, errs));
+
+  {
+    // ctx::foo
+    const auto got_info = ctx.info_of(create_qualified_name("foo", "ctx"));
+    ASSERT_NE(got_info, std::nullopt);
+    EXPECT_THAT(&(got_info->type.get()), &valid_type);
+    EXPECT_THAT(got_info->index, identifier_index);
+  }
+  {
+    // foo, looked up from inside of ctx
+    ctx.enter_global_ctx(token_identifier("ctx"), /*exported=*/false);
+    ctx.enter_local_ctx();
+    const auto got_info = ctx.info_of(create_qualified_name("foo"));
+    ASSERT_NE(got_info, std::nullopt);
+    EXPECT_THAT(&(got_info->type.get()), &valid_type);
+  }
+}
+
+TEST_F(IdentifiersContextTest,
+       MergeImportedStuff_AlreadyRegisteredName_ReturnsFalse)
+{
+  identifiers_context_impl module_ctx;
+  module_ctx.register_identifier(token_identifier("foo"), { valid_type, 0u },
+                                 /*exported=*/true);
+  const auto exported = module_ctx.collect_exported_stuff();
+
+  errors::errors_observer errs;
+  identifiers_context_impl ctx;
+  ctx.register_identifier(token_identifier("foo"), { different_type, 0u },
+                          /*exported=*/false);
+
+  EXPECT_FALSE(ctx.merge_imported_stuff(*exported, errs));
+}
+
+TEST_F(IdentifiersContextTest,
+       MergeImportedStuff_CollectExportedStuff_DoesNotReexportImported)
+{
+  identifiers_context_impl module_ctx;
+  module_ctx.register_identifier(token_identifier("foo"), { valid_type, 0u },
+                                 /*exported=*/true);
+  const auto exported = module_ctx.collect_exported_stuff();
+
+  errors::errors_observer errs;
+  identifiers_context_impl ctx;
+  EXPECT_TRUE(ctx.merge_imported_stuff(*exported, errs));
+  const auto reexported = ctx.collect_exported_stuff();
+
+  EXPECT_EQ(reexported->info_of(create_qualified_name("foo")), std::nullopt);
+}
+
+TEST_F(IdentifiersContextTest,
+       Rollback_RegisteredAfterCheckpoint_NotFoundAnymore)
+{
+  identifiers_context_impl ctx;
+  ctx.register_identifier(token_identifier("foo"), { valid_type, 0u },
+                          /*exported=*/false);
+  const auto checkpoint = ctx.make_checkpoint();
+
+  ctx.register_identifier(token_identifier("bar"), { valid_type, 1u },
+                          /*exported=*/false);
+  ctx.enter_global_ctx(token_identifier("baz"), /*exported=*/false);
+  ctx.register_identifier(token_identifier("qux"), { valid_type, 2u },
+                          /*exported=*/false);
+  ctx.leave_ctx();
+
+  ctx.rollback(checkpoint);
+
+  EXPECT_NE(ctx.info_of(create_qualified_name("foo")), std::nullopt);
+  EXPECT_EQ(ctx.info_of(create_qualified_name("bar")), std::nullopt);
+  EXPECT_EQ(ctx.info_of(create_qualified_name("qux", "baz")), std::nullopt);
+}
+
+TEST_F(IdentifiersContextTest,
+       Rollback_ReopenedGlobalCtx_KeepsEntriesRegisteredBeforeCheckpoint)
+{
+  identifiers_context_impl ctx;
+  ctx.enter_global_ctx(token_identifier("baz"), /*exported=*/false);
+  ctx.register_identifier(token_identifier("foo"), { valid_type, 0u },
+                          /*exported=*/false);
+  ctx.leave_ctx();
+  const auto checkpoint = ctx.make_checkpoint();
+
+  ctx.enter_global_ctx(token_identifier("baz"), /*exported=*/false);
+  ctx.register_identifier(token_identifier("bar"), { valid_type, 1u },
+                          /*exported=*/false);
+  ctx.enter_local_ctx();
+
+  ctx.rollback(checkpoint);
+
+  EXPECT_TRUE(ctx.is_in_global_ctx());
+  EXPECT_NE(ctx.info_of(create_qualified_name("foo", "baz")), std::nullopt);
+  EXPECT_EQ(ctx.info_of(create_qualified_name("bar", "baz")), std::nullopt);
+  EXPECT_EQ(ctx.info_of(create_qualified_name("foo")), std::nullopt);
+}
+
+TEST_F(IdentifiersContextTest,
+       Snapshot_RegisteredAfterSnapshot_NotFoundTillSnapshotLeft)
+{
+  identifiers_context_impl ctx;
+  ctx.register_identifier(token_identifier("foo"), { valid_type, 0u },
+                          /*exported=*/false);
+  const auto snapshot = ctx.make_snapshot();
+
+  ctx.register_identifier(token_identifier("bar"), { valid_type, 1u },
+                          /*exported=*/false);
+
+  ctx.enter_snapshot(snapshot);
+  ctx.enter_local_ctx();
+  ctx.register_identifier(token_identifier("baz"), { valid_type, 0u },
+                          /*exported=*/false);
+  EXPECT_NE(ctx.info_of(create_qualified_name("foo")), std::nullopt);
+  EXPECT_EQ(ctx.info_of(create_qualified_name("bar")), std::nullopt);
+  EXPECT_NE(ctx.info_of(create_qualified_name("baz")), std::nullopt);
+  ctx.leave_ctx();
+  ctx.leave_snapshot();
+
+  EXPECT_NE(ctx.info_of(create_qualified_name("bar")), std::nullopt);
+}
+
+TEST_F(IdentifiersContextTest, Snapshot_Nested_RestoresNamespacesOfSnapshots)
+{
+  identifiers_context_impl ctx;
+  ctx.enter_global_ctx(token_identifier("baz"), /*exported=*/false);
+  ctx.register_identifier(token_identifier("foo"), { valid_type, 0u },
+                          /*exported=*/false);
+  const auto inner_snapshot = ctx.make_snapshot();
+  ctx.leave_ctx();
+  ctx.register_identifier(token_identifier("bar"), { valid_type, 1u },
+                          /*exported=*/false);
+  const auto outer_snapshot = ctx.make_snapshot();
+
+  ctx.enter_snapshot(outer_snapshot);
+  EXPECT_EQ(ctx.info_of(create_qualified_name("foo")), std::nullopt);
+  EXPECT_NE(ctx.info_of(create_qualified_name("bar")), std::nullopt);
+
+  ctx.enter_snapshot(inner_snapshot);
+  EXPECT_NE(ctx.info_of(create_qualified_name("foo")), std::nullopt);
+  EXPECT_EQ(ctx.info_of(create_qualified_name("bar")), std::nullopt);
+  ctx.leave_snapshot();
+
+  EXPECT_EQ(ctx.info_of(create_qualified_name("foo")), std::nullopt);
+  EXPECT_NE(ctx.info_of(create_qualified_name("bar")), std::nullopt);
+  ctx.leave_snapshot();
+}
 }
@@ -16,6 +16,7 @@ public:
   MOCK_CONST_METHOD0(type, const sema_type&());
   MOCK_CONST_METHOD0(produces_temporary_value, bool());
   MOCK_CONST_METHOD1(visit, void(sema_node_visitor&));
+  MOCK_METHOD1(visit, void(mutable_sema_node_visitor&));
   MOCK_CONST_METHOD0(begin_location, source_location());
   MOCK_CONST_METHOD0(end_location, source_location());
   MOCK_CONST_METHOD0(ast_node, const ast::ast_node&());
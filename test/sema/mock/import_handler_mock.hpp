@@ -9,7 +9,6 @@ namespace cmsl::sema::test {
 class import_handler_mock : public import_handler
 {
 public:
-  MOCK_METHOD1(handle_import,
-               std::unique_ptr<qualified_contextes>(cmsl::string_view));
+  MOCK_METHOD1(handle_import, const qualified_contextes*(cmsl::string_view));
 };
 }
\ No newline at end of file
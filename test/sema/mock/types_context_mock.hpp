@@ -29,6 +29,12 @@ public:
                bool(const types_context& imported,
                     errors::errors_observer& errs));
 
+  MOCK_CONST_METHOD0(make_checkpoint, qualified_entries_checkpoint());
+  MOCK_METHOD1(rollback, void(const qualified_entries_checkpoint&));
+  MOCK_CONST_METHOD0(make_snapshot, qualified_entries_snapshot());
+  MOCK_METHOD1(enter_snapshot, void(const qualified_entries_snapshot&));
+  MOCK_METHOD0(leave_snapshot, void());
+
   MOCK_CONST_METHOD1(dump, void(qualified_contexts_dumper&));
 };
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "sema/overload_resolution.hpp"
+#include "sema/overload_resolution_cache.hpp"
 
 #include "errors/errors_observer.hpp"
 
@@ -316,4 +317,104 @@ TEST_F(OverloarResolutionTest, GoodOveloadedFunction_ReturnFunction)
   EXPECT_THAT(chosen, NotNull());
   EXPECT_THAT(chosen, Eq(&good_function));
 }
+
+TEST_F(OverloarResolutionTest,
+       CachedResolution_SameParamTypes_ReturnFunctionWithoutMatching)
+{
+  errs_t errs;
+  const auto call_token = token_identifier("foo");
+  StrictMock<sema_function_mock> good_function;
+  StrictMock<sema_function_mock> bad_function;
+  auto param_expression = expression_mock();
+  auto param_expression_ptr = param_expression.get();
+  std::vector<std::unique_ptr<expression_node>> param_expressions;
+  param_expressions.emplace_back(std::move(param_expression));
+
+  single_scope_function_lookup_result_t scope{ &bad_function, &good_function };
+  function_lookup_result_t lookup_result{ scope };
+
+  const auto function_name_token = token_identifier("foo");
+  const auto param_name_token = token_identifier("param");
+
+  const sema_type bad_function_param_type{
+    valid_context,
+    ast::type_representation{ ast::qualified_name{ param_name_token } },
+    {}
+  };
+  function_signature bad_function_signature{
+    function_name_token,
+    { parameter_declaration{ bad_function_param_type, param_name_token } }
+  };
+  function_signature good_function_signature{
+    function_name_token,
+    { parameter_declaration{ valid_type, param_name_token } }
+  };
+
+  // Signatures are checked only by the first resolution.
+  EXPECT_CALL(bad_function, signature())
+    .WillOnce(ReturnRef(bad_function_signature));
+  EXPECT_CALL(good_function, signature())
+    .WillOnce(ReturnRef(good_function_signature));
+
+  EXPECT_CALL(*param_expression_ptr, type())
+    .WillRepeatedly(ReturnRef(valid_type));
+  EXPECT_CALL(*param_expression_ptr, produces_temporary_value())
+    .WillRepeatedly(Return(false));
+
+  overload_resolution_cache cache;
+  for (auto i = 0; i < 2; ++i) {
+    overload_resolution resolution{ errs.observer, call_token, &cache };
+    const auto chosen = resolution.choose(lookup_result, param_expressions);
+    EXPECT_THAT(chosen, Eq(&good_function));
+  }
+
+  EXPECT_THAT(cache.size(), Eq(1u));
+}
+
+TEST_F(OverloarResolutionTest,
+       CachedResolution_ParamTypesDontMatch_RaiseErrorEveryTime)
+{
+  errs_t errs;
+  const auto call_token = token_identifier("foo");
+  StrictMock<sema_function_mock> function;
+  StrictMock<sema_function_mock> other_function;
+  auto param_expression = expression_mock();
+  auto param_expression_ptr = param_expression.get();
+  const sema_type param_type{ valid_context,
+                              ast::type_representation{ ast::qualified_name{
+                                token_identifier("param_type") } },
+                              {} };
+  std::vector<std::unique_ptr<expression_node>> param_expressions;
+  param_expressions.emplace_back(std::move(param_expression));
+
+  single_scope_function_lookup_result_t scope_result{ &function,
+                                                      &other_function };
+  function_lookup_result_t lookup_result{ scope_result };
+
+  const auto function_name_token = token_identifier("foo");
+  const auto param_name_token = token_identifier("param");
+  function_signature signature{ function_name_token,
+                                { parameter_declaration{
+                                  valid_type, param_name_token } } };
+  EXPECT_CALL(function, signature()).WillRepeatedly(ReturnRef(signature));
+  EXPECT_CALL(other_function, signature())
+    .WillRepeatedly(ReturnRef(signature));
+
+  EXPECT_CALL(*param_expression_ptr, type())
+    .WillRepeatedly(ReturnRef(param_type));
+  EXPECT_CALL(*param_expression_ptr, produces_temporary_value())
+    .WillRepeatedly(Return(false));
+
+  // The error and notes about both candidates, for each resolution.
+  EXPECT_CALL(errs.mock, notify_error(_)).Times(6);
+
+  overload_resolution_cache cache;
+  for (auto i = 0; i < 2; ++i) {
+    overload_resolution resolution{ errs.observer, call_token, &cache };
+    const auto chosen = resolution.choose(lookup_result, param_expressions);
+    EXPECT_THAT(chosen, IsNull());
+  }
+
+  EXPECT_THAT(cache.size(), Eq(0u));
+}
 }
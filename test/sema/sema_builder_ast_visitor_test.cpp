@@ -2592,7 +2592,7 @@ TEST_F(SemaBuilderAstVisitorTest, Visit_Import_HandlerFailed_ReportError)
   ast::import_node node{ token_kw_import(), foo_token, token_semicolon() };
 
   EXPECT_CALL(m_import_handler_mock, handle_import(_))
-    .WillRepeatedly(Return(ByMove(nullptr)));
+    .WillRepeatedly(Return(nullptr));
 
   EXPECT_CALL(errs.mock, notify_error(_)).Times(AnyNumber());
 
@@ -2624,11 +2624,9 @@ TEST_F(SemaBuilderAstVisitorTest,
                          std::make_unique<functions_context_mock>(),
                          std::make_unique<identifiers_context_mock>(),
                          std::make_unique<types_context_mock>() };
-  auto qualified_ptr =
-    std::make_unique<qualified_contextes>(std::move(qualified));
 
   EXPECT_CALL(m_import_handler_mock, handle_import(_))
-    .WillRepeatedly(Return(ByMove(std::move(qualified_ptr))));
+    .WillRepeatedly(Return(&qualified));
 
   EXPECT_CALL(enums_ctx, merge_imported_stuff(_, _)).WillOnce(Return(false));
   EXPECT_CALL(functions_ctx, merge_imported_stuff(_, _))
@@ -0,0 +1,56 @@
+#include "sema/symbol_table.hpp"
+
+#include <gmock/gmock.h>
+
+#include <string>
+
+namespace cmsl::sema::test {
+using ::testing::Eq;
+
+TEST(SymbolTableTest, Intern_SameName_ReturnsSameId)
+{
+  symbol_table symbols;
+  const std::string first{ "foo" };
+  const std::string second{ "foo" };
+
+  const auto id = symbols.intern(first);
+
+  EXPECT_THAT(symbols.intern(second), Eq(id));
+  EXPECT_THAT(symbols.size(), Eq(1u));
+  EXPECT_THAT(symbols.name_of(id), Eq("foo"));
+}
+
+TEST(SymbolTableTest, Intern_DifferentNames_ReturnsDenseIds)
+{
+  symbol_table symbols;
+
+  EXPECT_THAT(symbols.intern("foo"), Eq(0u));
+  EXPECT_THAT(symbols.intern("bar"), Eq(1u));
+  EXPECT_THAT(symbols.intern(""), Eq(2u));
+  EXPECT_THAT(symbols.name_of(1u), Eq("bar"));
+}
+
+TEST(SymbolTableTest, Find_NotInternedName_ReturnsNullopt)
+{
+  symbol_table symbols;
+  EXPECT_THAT(symbols.find("foo"), Eq(std::nullopt));
+
+  symbols.intern("bar");
+  EXPECT_THAT(symbols.find("foo"), Eq(std::nullopt));
+}
+
+TEST(SymbolTableTest, ManyNames_AllCanBeFound)
+{
+  symbol_table symbols;
+  for (auto i = 0u; i < 1000u; ++i) {
+    EXPECT_THAT(symbols.intern("name_" + std::to_string(i)), Eq(i));
+  }
+
+  for (auto i = 0u; i < 1000u; ++i) {
+    const auto name = "name_" + std::to_string(i);
+    EXPECT_THAT(symbols.find(name), Eq(i));
+    EXPECT_THAT(symbols.name_of(i), Eq(name));
+  }
+  EXPECT_THAT(symbols.find("name_1000"), Eq(std::nullopt));
+}
+}
@@ -42,6 +42,7 @@ auto sort_results(cmsl_complete_results* results)
 namespace cmsl::tools::test {
 using ::testing::NotNull;
 using ::testing::Eq;
+using ::testing::IsNull;
 
 class CompleteSmokeTest : public ::testing::Test
 {
@@ -101,6 +102,30 @@ TEST_F(CompleteSmokeTest, TopLevelEmpty_ReturnsTopLevelDefaultValues)
   cleanup(parsed_source, results);
 }
 
+TEST_F(CompleteSmokeTest,
+       AfterParsingSourceWithGenericType_BuiltinContextIsNotModified)
+{
+  auto generic_parsed_source =
+    cmsl_parse_source("list<int> foo() { return list<int>(); }", nullptr);
+  ASSERT_THAT(generic_parsed_source, NotNull());
+
+  const auto source = "";
+  auto [parsed_source, results] = complete_at(source, 0u);
+  ASSERT_THAT(parsed_source, NotNull());
+  ASSERT_THAT(results, NotNull());
+
+  EXPECT_THAT(parsed_source->builtin_context,
+              Eq(generic_parsed_source->builtin_context));
+
+  const auto sorted_expected = sort(top_level_default_values());
+  const auto sorted_results = sort_results(results);
+
+  EXPECT_THAT(sorted_results, Eq(sorted_expected));
+
+  cleanup(parsed_source, results);
+  cmsl_destroy_parsed_source(generic_parsed_source);
+}
+
 TEST_F(CompleteSmokeTest,
        TopLevelWithVariable_CompleteAfterVariable_ReturnsTopLevelDefaultValues)
 {
@@ -233,6 +258,37 @@ TEST_F(
   cleanup(parsed_source, results);
 }
 
+TEST_F(
+  CompleteSmokeTest,
+  FunctionWithNestedBlock_CompleteInsideNestedBlock_ReturnsStandAloneDefaultValuesAndNamesDeclaredBefore)
+{
+  const auto source = "int foo() { int a; { } } int bar;";
+  auto [parsed_source, results] = complete_at(source, 20u);
+  ASSERT_THAT(parsed_source, NotNull());
+  ASSERT_THAT(results, NotNull());
+
+  auto expected = merge(builtin_types(), standalone_statement());
+  expected.emplace_back("foo");
+  expected.emplace_back("a");
+  const auto sorted_expected = sort(expected);
+  const auto sorted_results = sort_results(results);
+
+  EXPECT_THAT(sorted_results, Eq(sorted_expected));
+
+  cleanup(parsed_source, results);
+}
+
+TEST_F(CompleteSmokeTest, SourceWithSemanticError_ReturnsNull)
+{
+  const auto source = "int foo() { return bar; }";
+  auto parsed_source = cmsl_parse_source(source, nullptr);
+  ASSERT_THAT(parsed_source, NotNull());
+
+  EXPECT_THAT(cmsl_complete_at(parsed_source, 12u), IsNull());
+
+  cmsl_destroy_parsed_source(parsed_source);
+}
+
 // Todo: Enable when adding class name in member functions is implemented.
 TEST_F(
   CompleteSmokeTest,
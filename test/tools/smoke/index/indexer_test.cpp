@@ -3,9 +3,15 @@
 #include "tools/lib/cmsl_index.hpp"
 #include "tools/lib/cmsl_parsed_source.hpp"
 
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <vector>
+
 namespace cmsl::tools::test {
 using ::testing::NotNull;
 using ::testing::Eq;
+using ::testing::Ne;
 
 class IndexerSmokeTest : public ::testing::Test
 {
@@ -224,4 +230,100 @@ TEST_F(IndexerSmokeTest, EnumValueConstant)
 
   cleanup(parsed_source, index_entries);
 }
+
+TEST_F(IndexerSmokeTest, SourcePaths_AreInterned)
+{
+  const auto source = "int foo(int a)"
+                      "{"
+                      "    int b = a;"
+                      "    return foo(b);"
+                      "}";
+  auto [parsed_source, index_entries] = index_source(source);
+  ASSERT_THAT(parsed_source, NotNull());
+  ASSERT_THAT(index_entries, NotNull());
+
+  EXPECT_THAT(index_entries->num_source_paths, Ne(0u));
+  for (auto i = 0u; i < index_entries->num_source_paths; ++i) {
+    for (auto j = i + 1u; j < index_entries->num_source_paths; ++j) {
+      EXPECT_THAT(std::strcmp(index_entries->source_paths[i],
+                              index_entries->source_paths[j]),
+                  Ne(0));
+    }
+  }
+
+  for (auto i = 0u; i < index_entries->num_entries; ++i) {
+    const auto& entry = index_entries->entries[i];
+    ASSERT_THAT(entry.source_path_index,
+                ::testing::Lt(index_entries->num_source_paths));
+    EXPECT_THAT(entry.source_path,
+                Eq(index_entries->source_paths[entry.source_path_index]));
+  }
+
+  cleanup(parsed_source, index_entries);
+}
+
+TEST_F(IndexerSmokeTest, SourcePaths_AreNullTerminatedCopies)
+{
+  const auto source = "int foo(int a)"
+                      "{"
+                      "    return foo(a);"
+                      "}";
+  const auto source_path = std::string{ "index_smoke/source.cmsl" };
+  const auto parsed_source = cmsl_parse_source_with_imports(
+    source, source_path.c_str(), nullptr, nullptr, nullptr);
+  ASSERT_THAT(parsed_source, NotNull());
+  const auto index_entries = cmsl_index(parsed_source);
+  ASSERT_THAT(index_entries, NotNull());
+
+  auto entries_in_source = 0u;
+  for (auto i = 0u; i < index_entries->num_entries; ++i) {
+    const auto path = std::string{ index_entries->entries[i].source_path };
+    if (path.rfind(source_path, 0u) == 0u) {
+      EXPECT_THAT(path, Eq(source_path));
+      ++entries_in_source;
+    }
+  }
+  EXPECT_THAT(entries_in_source, Ne(0u));
+
+  cleanup(parsed_source, index_entries);
+}
+
+TEST_F(IndexerSmokeTest, Callback_GetsSameEntriesAsIndex)
+{
+  using entry_t =
+    std::tuple<unsigned, unsigned, cmsl_index_entry_type, std::string,
+               unsigned>;
+
+  const auto source = "enum foo"
+                      "{"
+                      "    bar"
+                      "};"
+                      "int baz(foo f)"
+                      "{"
+                      "    return baz(foo::bar);"
+                      "}";
+  auto [parsed_source, index_entries] = index_source(source);
+  ASSERT_THAT(parsed_source, NotNull());
+  ASSERT_THAT(index_entries, NotNull());
+
+  std::vector<entry_t> expected;
+  for (auto i = 0u; i < index_entries->num_entries; ++i) {
+    const auto& entry = index_entries->entries[i];
+    expected.emplace_back(entry.begin_pos, entry.end_pos, entry.type,
+                          entry.source_path, entry.position);
+  }
+
+  std::vector<entry_t> streamed;
+  const auto collect = [](const cmsl_index_entry* entry, void* user_data) {
+    static_cast<std::vector<entry_t>*>(user_data)->emplace_back(
+      entry->begin_pos, entry->end_pos, entry->type, entry->source_path,
+      entry->position);
+  };
+  EXPECT_THAT(cmsl_index_with_callback(parsed_source, collect, &streamed),
+              Ne(0));
+
+  EXPECT_THAT(streamed, Eq(expected));
+
+  cleanup(parsed_source, index_entries);
+}
 }
@@ -0,0 +1,369 @@
+#include <gmock/gmock.h>
+
+#include "tools/lsp/json.hpp"
+#include "tools/lsp/server.hpp"
+#include "tools/lsp/transport.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace cmsl::lsp::test {
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::IsEmpty;
+using ::testing::NotNull;
+using ::testing::SizeIs;
+
+class LspSmokeTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_root = ::testing::TempDir();
+    if (!m_root.empty() && m_root.back() == '/') {
+      m_root.pop_back();
+    }
+  }
+
+  std::string uri_of(const std::string& file_name) const
+  {
+    return "file://" + m_root + '/' + file_name;
+  }
+
+  void write_file(const std::string& file_name, const std::string& content)
+  {
+    std::ofstream file{ m_root + '/' + file_name };
+    file << content;
+  }
+
+  // Processes the whole session and returns all messages sent by the server.
+  std::vector<json_value> run(const std::vector<json_value>& messages)
+  {
+    std::ostringstream out;
+    server srv{ out };
+
+    for (const auto& message : messages) {
+      srv.enqueue(message.dump());
+    }
+    srv.close_input();
+    while (srv.process_next()) {
+    }
+
+    return parse_sent(out.str());
+  }
+
+  // Parses all messages written by the server.
+  static std::vector<json_value> parse_sent(const std::string& output)
+  {
+    std::vector<json_value> sent;
+    std::istringstream in{ output };
+    while (const auto content = read_message(in)) {
+      auto message = json_value::parse(*content);
+      EXPECT_TRUE(message.has_value());
+      if (message) {
+        sent.emplace_back(std::move(*message));
+      }
+    }
+
+    return sent;
+  }
+
+  json_value initialize() const
+  {
+    json_value params;
+    params["rootUri"] = "file://" + m_root;
+    return request(1, "initialize", std::move(params));
+  }
+
+  static json_value request(int id, std::string method, json_value params)
+  {
+    auto message = notification(std::move(method), std::move(params));
+    message["id"] = id;
+    return message;
+  }
+
+  static json_value notification(std::string method, json_value params)
+  {
+    json_value message;
+    message["jsonrpc"] = "2.0";
+    message["method"] = std::move(method);
+    message["params"] = std::move(params);
+    return message;
+  }
+
+  json_value did_open(const std::string& file_name,
+                      const std::string& text) const
+  {
+    json_value params;
+    params["textDocument"]["uri"] = uri_of(file_name);
+    params["textDocument"]["version"] = 1;
+    params["textDocument"]["text"] = text;
+    return notification("textDocument/didOpen", std::move(params));
+  }
+
+  json_value did_change(const std::string& file_name,
+                        const std::string& text) const
+  {
+    json_value change;
+    change["text"] = text;
+
+    json_value params;
+    params["textDocument"]["uri"] = uri_of(file_name);
+    params["textDocument"]["version"] = 2;
+    params["contentChanges"] = json_value::array_t{ std::move(change) };
+    return notification("textDocument/didChange", std::move(params));
+  }
+
+  json_value completion(int id, const std::string& file_name, unsigned line,
+                        unsigned character) const
+  {
+    json_value params;
+    params["textDocument"]["uri"] = uri_of(file_name);
+    params["position"]["line"] = line;
+    params["position"]["character"] = character;
+    return request(id, "textDocument/completion", std::move(params));
+  }
+
+  json_value did_close(const std::string& file_name) const
+  {
+    json_value params;
+    params["textDocument"]["uri"] = uri_of(file_name);
+    return notification("textDocument/didClose", std::move(params));
+  }
+
+  static json_value cancel(int id)
+  {
+    json_value params;
+    params["id"] = id;
+    return notification("$/cancelRequest", std::move(params));
+  }
+
+  static const json_value* response(const std::vector<json_value>& sent,
+                                    int id)
+  {
+    for (const auto& message : sent) {
+      if (message.find("method") == nullptr &&
+          message.find("id") != nullptr && *message.find("id") == id) {
+        return &message;
+      }
+    }
+
+    return nullptr;
+  }
+
+  static std::optional<double> error_code(const json_value& message)
+  {
+    const auto error = message.find("error");
+    return error != nullptr && error->find("code") != nullptr
+      ? error->find("code")->as_number()
+      : std::nullopt;
+  }
+
+  // Diagnostics messages of every publishDiagnostics about the uri.
+  std::vector<std::vector<std::string>> published_diagnostics(
+    const std::vector<json_value>& sent, const std::string& file_name) const
+  {
+    std::vector<std::vector<std::string>> result;
+
+    for (const auto& message : sent) {
+      const auto method = message.find("method");
+      if (method == nullptr ||
+          *method != json_value{ "textDocument/publishDiagnostics" }) {
+        continue;
+      }
+
+      const auto& params = *message.find("params");
+      if (*params.find("uri") != json_value{ uri_of(file_name) }) {
+        continue;
+      }
+
+      std::vector<std::string> messages;
+      for (const auto& diagnostic : *params.find("diagnostics")->as_array()) {
+        messages.emplace_back(*diagnostic.find("message")->as_string());
+      }
+      result.emplace_back(std::move(messages));
+    }
+
+    return result;
+  }
+
+  static std::vector<std::string> labels(const json_value& message)
+  {
+    std::vector<std::string> result;
+    for (const auto& item : *message.find("result")->as_array()) {
+      result.emplace_back(*item.find("label")->as_string());
+    }
+    return result;
+  }
+
+private:
+  std::string m_root;
+};
+
+TEST_F(LspSmokeTest, Initialize_ReportsCapabilities)
+{
+  const auto sent = run({ initialize() });
+
+  const auto initialized = response(sent, 1);
+  ASSERT_THAT(initialized, NotNull());
+  const auto capabilities =
+    initialized->find("result")->find("capabilities");
+  ASSERT_THAT(capabilities, NotNull());
+  EXPECT_THAT(capabilities->find("completionProvider"), NotNull());
+  EXPECT_THAT(capabilities->find("definitionProvider"), NotNull());
+}
+
+TEST_F(LspSmokeTest, DidOpen_PublishesDiagnostics)
+{
+  const auto sent = run({
+    initialize(),
+    did_open("lsp_smoke_ok.cmsl", "int foo()\n{\n    return 1;\n}\n"),
+    did_open("lsp_smoke_error.cmsl", "int foo()\n{\n    return bar();\n}\n"),
+  });
+
+  EXPECT_THAT(published_diagnostics(sent, "lsp_smoke_ok.cmsl"),
+              ElementsAre(IsEmpty()));
+  EXPECT_THAT(published_diagnostics(sent, "lsp_smoke_error.cmsl"),
+              ElementsAre(SizeIs(1u)));
+}
+
+TEST_F(LspSmokeTest, Completion_ReturnsLabels)
+{
+  const auto sent = run({
+    initialize(),
+    did_open("lsp_smoke_complete.cmsl",
+             "int foo()\n{\n    int bar;\n    \n}\n"),
+    completion(2, "lsp_smoke_complete.cmsl", 3u, 4u),
+  });
+
+  const auto completed = response(sent, 2);
+  ASSERT_THAT(completed, NotNull());
+  const auto completions = labels(*completed);
+  EXPECT_THAT(std::count(std::cbegin(completions), std::cend(completions),
+                         "bar"),
+              Eq(1));
+  EXPECT_THAT(std::count(std::cbegin(completions), std::cend(completions),
+                         "foo"),
+              Eq(1));
+}
+
+TEST_F(LspSmokeTest, CancelledRequest_RepliesRequestCancelled)
+{
+  const auto sent = run({
+    initialize(),
+    did_open("lsp_smoke_cancel.cmsl", "int foo()\n{\n    \n}\n"),
+    completion(2, "lsp_smoke_cancel.cmsl", 2u, 4u),
+    cancel(2),
+  });
+
+  const auto completed = response(sent, 2);
+  ASSERT_THAT(completed, NotNull());
+  EXPECT_THAT(error_code(*completed), Eq(-32800));
+}
+
+TEST_F(LspSmokeTest, CancelOfAnsweredRequest_DoesNotCancelLaterRequest)
+{
+  std::ostringstream out;
+  server srv{ out };
+
+  srv.enqueue(initialize().dump());
+  srv.enqueue(
+    did_open("lsp_smoke_answered.cmsl", "int foo()\n{\n    \n}\n").dump());
+  srv.enqueue(completion(2, "lsp_smoke_answered.cmsl", 2u, 4u).dump());
+  for (auto i = 0; i < 3; ++i) {
+    ASSERT_TRUE(srv.process_next());
+  }
+
+  // Request 2 has been answered already, so the cancel matches nothing and
+  // must not affect a later request that reuses the id.
+  srv.enqueue(cancel(2).dump());
+  srv.enqueue(completion(2, "lsp_smoke_answered.cmsl", 2u, 4u).dump());
+  srv.close_input();
+  while (srv.process_next()) {
+  }
+
+  const auto sent = parse_sent(out.str());
+  auto responses = 0;
+  for (const auto& message : sent) {
+    if (message.find("method") == nullptr && message.find("id") != nullptr &&
+        *message.find("id") == 2) {
+      ++responses;
+      EXPECT_THAT(error_code(message), Eq(std::nullopt));
+    }
+  }
+  EXPECT_THAT(responses, Eq(2));
+}
+
+TEST_F(LspSmokeTest, RequestAfterCloseAndReopen_IsAnswered)
+{
+  const auto sent = run({
+    initialize(),
+    did_open("lsp_smoke_reopen.cmsl", "int foo()\n{\n    \n}\n"),
+    completion(2, "lsp_smoke_reopen.cmsl", 2u, 4u),
+    did_close("lsp_smoke_reopen.cmsl"),
+    did_open("lsp_smoke_reopen.cmsl", "int bar()\n{\n    \n}\n"),
+    completion(3, "lsp_smoke_reopen.cmsl", 2u, 4u),
+  });
+
+  const auto stale = response(sent, 2);
+  ASSERT_THAT(stale, NotNull());
+  EXPECT_THAT(error_code(*stale), Eq(-32801));
+
+  const auto completed = response(sent, 3);
+  ASSERT_THAT(completed, NotNull());
+  const auto completions = labels(*completed);
+  EXPECT_THAT(std::count(std::cbegin(completions), std::cend(completions),
+                         "bar"),
+              Eq(1));
+}
+
+TEST_F(LspSmokeTest, RequestQueuedBeforeChange_RepliesContentModified)
+{
+  const auto sent = run({
+    initialize(),
+    did_open("lsp_smoke_stale.cmsl", "int foo()\n{\n    \n}\n"),
+    completion(2, "lsp_smoke_stale.cmsl", 2u, 4u),
+    did_change("lsp_smoke_stale.cmsl", "int bar()\n{\n    \n}\n"),
+    completion(3, "lsp_smoke_stale.cmsl", 2u, 4u),
+  });
+
+  const auto stale = response(sent, 2);
+  ASSERT_THAT(stale, NotNull());
+  EXPECT_THAT(error_code(*stale), Eq(-32801));
+
+  const auto completed = response(sent, 3);
+  ASSERT_THAT(completed, NotNull());
+  const auto completions = labels(*completed);
+  EXPECT_THAT(std::count(std::cbegin(completions), std::cend(completions),
+                         "bar"),
+              Eq(1));
+}
+
+TEST_F(LspSmokeTest, ChangeOfImportedFile_RechecksImporters)
+{
+  write_file("lsp_smoke_util.cmsl",
+             "export int helper(int a)\n{\n    return a;\n}\n");
+
+  const auto sent = run({
+    initialize(),
+    did_open("lsp_smoke_main.cmsl",
+             "import \"lsp_smoke_util.cmsl\";\n\nint foo()\n{\n"
+             "    return helper(2);\n}\n"),
+    did_open("lsp_smoke_util.cmsl",
+             "export int helper(int a)\n{\n    return a;\n}\n"),
+    did_change("lsp_smoke_util.cmsl",
+               "export int helpr(int a)\n{\n    return a;\n}\n"),
+  });
+
+  const auto main_diagnostics =
+    published_diagnostics(sent, "lsp_smoke_main.cmsl");
+  ASSERT_THAT(main_diagnostics, SizeIs(3u));
+  EXPECT_THAT(main_diagnostics[0], IsEmpty());
+  EXPECT_THAT(main_diagnostics[1], IsEmpty());
+  EXPECT_THAT(main_diagnostics[2], SizeIs(1u));
+}
+}
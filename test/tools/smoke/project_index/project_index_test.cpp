@@ -0,0 +1,192 @@
+#include <gmock/gmock.h>
+
+#include "tools/lib/cmsl_project_index.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace cmsl::tools::test {
+using ::testing::Eq;
+using ::testing::IsNull;
+using ::testing::NotNull;
+using ::testing::UnorderedElementsAre;
+
+namespace fs = std::filesystem;
+
+class ProjectIndexSmokeTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    const auto test_name =
+      ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    m_root = fs::path{ ::testing::TempDir() } / "cmsl_project_index_smoke" /
+      test_name;
+    fs::remove_all(m_root);
+    fs::create_directories(m_root / "sub");
+
+    write_file("util.cmsl", m_util);
+    write_file("CMakeLists.cmsl", m_root_script);
+    write_file("sub/CMakeLists.cmsl", m_sub_script);
+  }
+
+  void TearDown() override { fs::remove_all(m_root); }
+
+  void write_file(const std::string& file_name, const std::string& content)
+  {
+    std::ofstream file{ m_root / file_name };
+    file << content;
+  }
+
+  std::string path_of(const std::string& file_name) const
+  {
+    return (m_root / file_name).lexically_normal().string();
+  }
+
+  cmsl_project_index* index_project(bool with_database = false)
+  {
+    const auto database = path_of("index.db");
+    return cmsl_index_project(path_of("CMakeLists.cmsl").c_str(), nullptr,
+                              with_database ? database.c_str() : nullptr,
+                              2u);
+  }
+
+  // Paths and offsets of references.
+  std::vector<std::pair<std::string, unsigned>> references_at(
+    const cmsl_project_index* project_index, const std::string& file_name,
+    unsigned position)
+  {
+    std::vector<std::pair<std::string, unsigned>> result;
+    const auto references = cmsl_find_references(
+      project_index, path_of(file_name).c_str(), position);
+    if (references == nullptr) {
+      return result;
+    }
+
+    for (auto i = 0u; i < references->num_references; ++i) {
+      const auto& reference = references->references[i];
+      result.emplace_back(reference.source_path, reference.begin_pos);
+    }
+
+    cmsl_destroy_references(references);
+    return result;
+  }
+
+  unsigned helper_declaration_pos() const { return m_util.find("helper"); }
+  unsigned helper_call_in_root_pos() const
+  {
+    return m_root_script.find("helper");
+  }
+  unsigned helper_call_in_sub_pos() const
+  {
+    return m_sub_script.find("helper");
+  }
+
+protected:
+  fs::path m_root;
+
+  const std::string m_util = "export int helper(int a)\n"
+                             "{\n"
+                             "  return a;\n"
+                             "}\n";
+  const std::string m_root_script = "import \"util.cmsl\";\n"
+                                    "\n"
+                                    "void main(cmake::project& p)\n"
+                                    "{\n"
+                                    "  int a = helper(1);\n"
+                                    "  add_subdirectory(\"sub\", p);\n"
+                                    "}\n";
+  const std::string m_sub_script = "import \"util.cmsl\";\n"
+                                   "\n"
+                                   "void main(cmake::project& p)\n"
+                                   "{\n"
+                                   "  int b = helper(2);\n"
+                                   "}\n";
+};
+
+TEST_F(ProjectIndexSmokeTest, IndexesImportedModulesAndSubdirectories)
+{
+  const auto project_index = index_project();
+  ASSERT_THAT(project_index, NotNull());
+
+  const auto stats = cmsl_get_project_index_stats(project_index);
+  EXPECT_THAT(stats.num_files, Eq(3u));
+  EXPECT_THAT(stats.num_indexed_files, Eq(3u));
+
+  cmsl_destroy_project_index(project_index);
+}
+
+TEST_F(ProjectIndexSmokeTest, FindReferences_AcrossFiles)
+{
+  const auto project_index = index_project();
+  ASSERT_THAT(project_index, NotNull());
+
+  const auto expected = UnorderedElementsAre(
+    std::make_pair(path_of("CMakeLists.cmsl"), helper_call_in_root_pos()),
+    std::make_pair(path_of("sub/CMakeLists.cmsl"), helper_call_in_sub_pos()));
+
+  // At the declaration.
+  EXPECT_THAT(
+    references_at(project_index, "util.cmsl", helper_declaration_pos() + 2u),
+    expected);
+  // At a reference.
+  EXPECT_THAT(references_at(project_index, "sub/CMakeLists.cmsl",
+                            helper_call_in_sub_pos()),
+              expected);
+
+  EXPECT_THAT(cmsl_find_references(project_index,
+                                   path_of("not_indexed.cmsl").c_str(), 0u),
+              IsNull());
+
+  cmsl_destroy_project_index(project_index);
+}
+
+TEST_F(ProjectIndexSmokeTest, Database_OnlyChangedFilesAreIndexedAgain)
+{
+  auto project_index = index_project(true);
+  ASSERT_THAT(project_index, NotNull());
+  EXPECT_THAT(cmsl_get_project_index_stats(project_index).num_indexed_files,
+              Eq(3u));
+  cmsl_destroy_project_index(project_index);
+
+  project_index = index_project(true);
+  ASSERT_THAT(project_index, NotNull());
+  const auto stats = cmsl_get_project_index_stats(project_index);
+  EXPECT_THAT(stats.num_files, Eq(3u));
+  EXPECT_THAT(stats.num_indexed_files, Eq(0u));
+  EXPECT_THAT(
+    references_at(project_index, "util.cmsl", helper_declaration_pos()).size(),
+    Eq(2u));
+
+  write_file("sub/CMakeLists.cmsl", m_sub_script + "\n");
+  EXPECT_THAT(cmsl_refresh_project_index(project_index), Eq(1u));
+
+  // Importers of a changed module are indexed again, too.
+  write_file("util.cmsl", "\n" + m_util);
+  EXPECT_THAT(cmsl_refresh_project_index(project_index), Eq(3u));
+  EXPECT_THAT(references_at(project_index, "util.cmsl",
+                            helper_declaration_pos() + 1u)
+                .size(),
+              Eq(2u));
+
+  cmsl_destroy_project_index(project_index);
+}
+
+TEST_F(ProjectIndexSmokeTest, Refresh_DropsFilesThatAreNoLongerReferenced)
+{
+  const auto project_index = index_project();
+  ASSERT_THAT(project_index, NotNull());
+
+  write_file("CMakeLists.cmsl",
+             "void main(cmake::project& p)\n"
+             "{\n"
+             "}\n");
+  EXPECT_THAT(cmsl_refresh_project_index(project_index), Eq(1u));
+  EXPECT_THAT(cmsl_get_project_index_stats(project_index).num_files, Eq(1u));
+
+  cmsl_destroy_project_index(project_index);
+}
+}
@@ -0,0 +1,187 @@
+#include <gmock/gmock.h>
+
+#include "tools/lib/cmsl_complete.hpp"
+#include "tools/lib/cmsl_index.hpp"
+#include "tools/lib/cmsl_parsed_source.hpp"
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace cmsl::tools::test {
+using ::testing::Eq;
+using ::testing::IsEmpty;
+using ::testing::IsNull;
+using ::testing::Not;
+using ::testing::NotNull;
+
+using index_entry_t =
+  std::tuple<unsigned, unsigned, cmsl_index_entry_type, unsigned>;
+
+class ReparseSmokeTest : public ::testing::Test
+{
+protected:
+  std::vector<index_entry_t> index_of(const cmsl_parsed_source* source)
+  {
+    std::vector<index_entry_t> result;
+
+    auto entries = cmsl_index(source);
+    if (entries == nullptr) {
+      return result;
+    }
+
+    for (auto i = 0u; i < entries->num_entries; ++i) {
+      const auto& entry = entries->entries[i];
+      result.emplace_back(entry.begin_pos, entry.end_pos, entry.type,
+                          entry.position);
+    }
+
+    cmsl_destroy_index_entries(entries);
+    return result;
+  }
+
+  std::vector<std::string> complete_at(const cmsl_parsed_source* source,
+                                       unsigned position)
+  {
+    auto results = cmsl_complete_at(source, position);
+    if (results == nullptr) {
+      return {};
+    }
+
+    std::vector<std::string> completions{ results->results,
+                                          results->results +
+                                            results->num_results };
+    cmsl_destroy_complete_results(results);
+    return completions;
+  }
+
+  void reparse(cmsl_parsed_source* source, unsigned begin, unsigned end,
+               const char* text)
+  {
+    const auto edit = cmsl_source_edit{ begin, end, text };
+    cmsl_reparse(source, &edit, 1u);
+  }
+
+  // Whether index of the reparsed source is the same as the one of a source
+  // parsed from scratch.
+  void expect_same_as_full_parse(const cmsl_parsed_source* reparsed)
+  {
+    auto parsed = cmsl_parse_source(reparsed->source.c_str(), nullptr);
+    ASSERT_THAT(reparsed->sema_tree, NotNull());
+    ASSERT_THAT(parsed->sema_tree, NotNull());
+
+    EXPECT_THAT(index_of(reparsed), Eq(index_of(parsed)));
+
+    cmsl_destroy_parsed_source(parsed);
+  }
+
+  const char* source() const
+  {
+    return "class foo\n"
+           "{\n"
+           "    int bar;\n"
+           "};\n"
+           "\n"
+           "int baz(foo f)\n"
+           "{\n"
+           "    return f.bar;\n"
+           "}\n"
+           "\n"
+           "int qux()\n"
+           "{\n"
+           "    foo f;\n"
+           "    return baz(f);\n"
+           "}\n";
+  }
+};
+
+TEST_F(ReparseSmokeTest, EditInLastDeclaration_SameAsFullParse)
+{
+  auto parsed_source = cmsl_parse_source(source(), nullptr);
+
+  const auto pos = std::string{ source() }.find("baz(f)");
+  reparse(parsed_source, pos + 6u, pos + 6u, " + 1");
+
+  EXPECT_THAT(parsed_source->source,
+              Eq(std::string{ source() }.insert(pos + 6u, " + 1")));
+  expect_same_as_full_parse(parsed_source);
+
+  cmsl_destroy_parsed_source(parsed_source);
+}
+
+TEST_F(ReparseSmokeTest, EditInFirstDeclaration_SameAsFullParse)
+{
+  auto parsed_source = cmsl_parse_source(source(), nullptr);
+
+  const auto pos = std::string{ source() }.find("int bar;");
+  reparse(parsed_source, pos, pos, "string name;\n    ");
+
+  expect_same_as_full_parse(parsed_source);
+
+  cmsl_destroy_parsed_source(parsed_source);
+}
+
+TEST_F(ReparseSmokeTest, EditsAppliedInOrder)
+{
+  auto parsed_source = cmsl_parse_source("int a;", nullptr);
+
+  const cmsl_source_edit edits[] = { { 4u, 5u, "bb" }, { 6u, 6u, " = 2" } };
+  cmsl_reparse(parsed_source, edits, 2u);
+
+  EXPECT_THAT(parsed_source->source, Eq("int bb = 2;"));
+  expect_same_as_full_parse(parsed_source);
+
+  cmsl_destroy_parsed_source(parsed_source);
+}
+
+TEST_F(ReparseSmokeTest, BrokenAndFixedSource_TreesRebuilt)
+{
+  auto parsed_source = cmsl_parse_source(source(), nullptr);
+
+  const auto pos = std::string{ source() }.find("return baz");
+  reparse(parsed_source, pos, pos, "{");
+  EXPECT_THAT(parsed_source->ast_tree, IsNull());
+  EXPECT_THAT(parsed_source->sema_tree, IsNull());
+
+  reparse(parsed_source, pos, pos + 1u, "");
+  EXPECT_THAT(parsed_source->source, Eq(source()));
+  expect_same_as_full_parse(parsed_source);
+
+  cmsl_destroy_parsed_source(parsed_source);
+}
+
+TEST_F(ReparseSmokeTest, RemovedDeclaration_NotVisibleAfterReparse)
+{
+  auto parsed_source = cmsl_parse_source(source(), nullptr);
+
+  const auto begin = std::string{ source() }.find("int baz");
+  const auto end = std::string{ source() }.find("int qux");
+  reparse(parsed_source, begin, end, "");
+
+  // qux calls removed baz.
+  EXPECT_THAT(parsed_source->sema_tree, IsNull());
+
+  reparse(parsed_source, begin, begin, "int baz(foo f) { return 1; }\n");
+  expect_same_as_full_parse(parsed_source);
+
+  cmsl_destroy_parsed_source(parsed_source);
+}
+
+TEST_F(ReparseSmokeTest, CompleteAfterReparse_SameAsFullParse)
+{
+  auto parsed_source = cmsl_parse_source(source(), nullptr);
+
+  const auto pos = std::string{ source() }.find("foo f;");
+  reparse(parsed_source, pos, pos, "int local = 1;\n    ");
+
+  auto parsed = cmsl_parse_source(parsed_source->source.c_str(), nullptr);
+  // Beginning of the inserted statement.
+  const auto complete_pos = static_cast<unsigned>(pos);
+  const auto completions = complete_at(parsed_source, complete_pos);
+  EXPECT_THAT(completions, Not(IsEmpty()));
+  EXPECT_THAT(completions, Eq(complete_at(parsed, complete_pos)));
+
+  cmsl_destroy_parsed_source(parsed);
+  cmsl_destroy_parsed_source(parsed_source);
+}
+}
@@ -0,0 +1,222 @@
+#include "errors/errors_observer.hpp"
+#include "exec/global_executor.hpp"
+
+#include "cmakesl/fake_cmake_facade.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Measures project and target operations passed to the facade one by one
+// and in batches, see global_executor::options::batch_facade_calls. Every
+// iteration creates a library and passes lists to its operations. The facade
+// stores properties of targets the way CMake does, as lists joined with ';'.
+// Batched operations are applied like a facade of CMake would apply them:
+// the target is looked up once for consecutive operations on it, recognized
+// by the interned name, and arguments are appended as they are stored in the
+// command buffer. Time of compilation is subtracted, by subtracting time of
+// a run without iterations. The best of a few runs is reported.
+//
+// Usage: cmakesl_exec_facade_benchmark [iterations]
+namespace {
+constexpr auto k_runs = 5;
+
+class storing_cmake_facade : public fake_cmake_facade
+{
+public:
+  void add_executable(const std::string& name,
+                      const std::vector<std::string>& sources) override
+  {
+    append(m_targets[name].sources, sources);
+  }
+
+  void add_library(const std::string& name,
+                   const std::vector<std::string>& sources) override
+  {
+    append(m_targets[name].sources, sources);
+  }
+
+  void target_link_library(const std::string& target_name,
+                           cmsl::facade::visibility,
+                           const std::string& library_name) override
+  {
+    append(m_targets[target_name].libraries, library_name);
+  }
+
+  void target_include_directories(
+    const std::string& target_name, cmsl::facade::visibility,
+    const std::vector<std::string>& dirs) override
+  {
+    append(m_targets[target_name].include_directories, dirs);
+  }
+
+  void target_compile_definitions(
+    const std::string& target_name, cmsl::facade::visibility,
+    const std::vector<std::string>& definitions) override
+  {
+    append(m_targets[target_name].compile_definitions, definitions);
+  }
+
+  void target_compile_options(
+    const std::string& target_name, cmsl::facade::visibility,
+    const std::vector<std::string>& options) override
+  {
+    append(m_targets[target_name].compile_options, options);
+  }
+
+  void target_sources(const std::string& target_name,
+                      cmsl::facade::visibility,
+                      const std::vector<std::string>& sources) override
+  {
+    append(m_targets[target_name].sources, sources);
+  }
+
+  void apply_commands(const cmsl::facade::command_buffer& commands) override
+  {
+    using command_kind = cmsl::facade::command_buffer::command_kind;
+
+    target* current = nullptr;
+    auto current_name = cmsl::facade::command_buffer::string_id{};
+    for (const auto& cmd : commands.commands()) {
+      if (cmd.kind == command_kind::register_project) {
+        continue;
+      }
+
+      if (current == nullptr || cmd.name != current_name) {
+        current = &m_targets[std::string{ commands.string(cmd.name) }];
+        current_name = cmd.name;
+      }
+
+      auto& property = current->property(cmd.kind);
+      for (auto i = 0u; i < cmd.arguments_count; ++i) {
+        append(property, commands.argument(cmd, i));
+      }
+    }
+  }
+
+private:
+  struct target
+  {
+    std::string sources;
+    std::string libraries;
+    std::string include_directories;
+    std::string compile_definitions;
+    std::string compile_options;
+
+    std::string& property(cmsl::facade::command_buffer::command_kind kind)
+    {
+      using command_kind = cmsl::facade::command_buffer::command_kind;
+      switch (kind) {
+        case command_kind::target_link_library:
+          return libraries;
+        case command_kind::target_include_directories:
+          return include_directories;
+        case command_kind::target_compile_definitions:
+          return compile_definitions;
+        case command_kind::target_compile_options:
+          return compile_options;
+        default:
+          return sources;
+      }
+    }
+  };
+
+  static void append(std::string& property, std::string_view value)
+  {
+    if (!property.empty()) {
+      property += ';';
+    }
+    property += value;
+  }
+
+  static void append(std::string& property,
+                     const std::vector<std::string>& values)
+  {
+    for (const auto& value : values) {
+      append(property, value);
+    }
+  }
+
+private:
+  std::unordered_map<std::string, target> m_targets;
+};
+
+std::string make_source(const std::string& iterations)
+{
+  return "int main()"
+         "{"
+         "    cmake::project p = cmake::project(\"benchmark\");"
+         "    list<string> sources = { \"src/foo.cpp\", \"src/bar.cpp\","
+         "                             \"src/baz.cpp\", \"src/qux.cpp\" };"
+         "    list<string> dirs = { \"include\", \"src\", \"generated\" };"
+         "    list<string> definitions = { \"FOO=1\", \"BAR\" };"
+         "    list<string> options = { \"-Wall\", \"-Wextra\", \"-O2\" };"
+         "    for (int i = 0; i < " +
+    iterations +
+    "; ++i)"
+    "    {"
+    "        cmake::library lib = p.add_library(\"lib_\" + i.to_string(),"
+    "                                           sources);"
+    "        lib.include_directories(dirs);"
+    "        lib.compile_definitions(definitions);"
+    "        lib.compile_options(options);"
+    "        lib.add_sources(sources);"
+    "    }"
+    "    return 0;"
+    "}";
+}
+
+double run_once(const std::string& source,
+                cmsl::exec::execution_engine engine, bool batch)
+{
+  storing_cmake_facade facade;
+  cmsl::errors::errors_observer errs{ &facade };
+  cmsl::exec::global_executor::options opts;
+  opts.engine = engine;
+  opts.batch_facade_calls = batch;
+  cmsl::exec::global_executor executor{ ".", facade, errs, opts };
+
+  const auto begin = std::chrono::steady_clock::now();
+  executor.execute(source);
+  const auto end = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+double run(const std::string& source, cmsl::exec::execution_engine engine,
+           bool batch)
+{
+  auto best = run_once(source, engine, batch);
+  for (auto i = 1; i < k_runs; ++i) {
+    best = std::min(best, run_once(source, engine, batch));
+  }
+
+  return best;
+}
+}
+
+int main(int argc, const char* argv[])
+{
+  const auto iterations = argc > 1 ? std::stoi(argv[1]) : 20000;
+  const auto source = make_source(std::to_string(iterations));
+  const auto empty_source = make_source("0");
+
+  const std::pair<const char*, cmsl::exec::execution_engine> engines[] = {
+    { "tree_walker", cmsl::exec::execution_engine::tree_walker },
+    { "bytecode", cmsl::exec::execution_engine::bytecode }
+  };
+
+  for (const auto& [engine_name, engine] : engines) {
+    for (const auto batch : { false, true }) {
+      const auto ms =
+        run(source, engine, batch) - run(empty_source, engine, batch);
+      std::cout << (batch ? "batched " : "direct ") << engine_name << ": "
+                << ms << " ms, " << ms * 1000000.0 / iterations
+                << " ns per iteration\n";
+    }
+  }
+}
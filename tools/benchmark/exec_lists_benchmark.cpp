@@ -0,0 +1,143 @@
+#include "errors/errors_observer.hpp"
+#include "exec/global_executor.hpp"
+
+#include "cmakesl/fake_cmake_facade.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Measures push_back, sort, find and copy of list<int> and list<string>.
+// Every case except push_back is measured without filling the list, by
+// subtracting time of a run that only fills it. The best of a few runs is
+// reported.
+//
+// Usage: cmakesl_exec_lists_benchmark [list_size]
+namespace {
+constexpr auto k_runs = 3;
+
+struct benchmark_case
+{
+  std::string name;
+  std::string setup;
+  std::string measured;
+};
+
+struct element_kind
+{
+  std::string name;
+  std::string type;
+  // Expression that creates a value from int i.
+  std::string value;
+};
+
+std::string make_source(const std::string& body)
+{
+  return "int main()"
+         "{" +
+    body +
+    "    return 0;"
+    "}";
+}
+
+std::vector<benchmark_case> make_cases(const element_kind& kind,
+                                       const std::string& size)
+{
+  const auto fill = "    list<" + kind.type +
+    "> l;"
+    "    for (int i = 0; i < " +
+    size +
+    "; ++i)"
+    "    {"
+    "        l.push_back(" +
+    kind.value +
+    ");"
+    "    }";
+  // Searches for values pushed last.
+  const auto search = "    int found = 0;"
+                      "    for (int j = 1; j <= 1000; ++j)"
+                      "    {"
+                      "        int i = " +
+    size +
+    " - j;"
+    "        found += l.find(" +
+    kind.value +
+    ");"
+    "    }";
+  const auto copy = "    for (int i = 0; i < 100; ++i)"
+                    "    {"
+                    "        list<" +
+    kind.type +
+    "> copied = l;"
+    "    }";
+
+  return {
+    { "push_back_" + kind.name, "", fill },
+    { "sort_" + kind.name, fill, "    l.sort();" },
+    { "find_" + kind.name, fill, search },
+    { "copy_" + kind.name, fill, copy },
+  };
+}
+
+double run_once(const std::string& body, cmsl::exec::execution_engine engine)
+{
+  fake_cmake_facade facade;
+  cmsl::errors::errors_observer errs{ &facade };
+  cmsl::exec::global_executor::options opts;
+  opts.engine = engine;
+  cmsl::exec::global_executor executor{ ".", facade, errs, opts };
+
+  const auto begin = std::chrono::steady_clock::now();
+  executor.execute(make_source(body));
+  const auto end = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+double run(const std::string& body, cmsl::exec::execution_engine engine)
+{
+  if (body.empty()) {
+    return 0.0;
+  }
+
+  auto best = run_once(body, engine);
+  for (auto i = 1; i < k_runs; ++i) {
+    best = std::min(best, run_once(body, engine));
+  }
+
+  return best;
+}
+}
+
+int main(int argc, const char* argv[])
+{
+  const auto size = argc > 1 ? std::stoi(argv[1]) : 100000;
+  const auto size_str = std::to_string(size);
+
+  // Values are shuffled, so sort has something to do. The language has no
+  // modulo operator.
+  const auto shuffled =
+    "(i * 7919 - i * 7919 / " + size_str + " * " + size_str + ")";
+  const element_kind kinds[] = {
+    { "int", "int", shuffled },
+    { "string", "string",
+      "\"source/file_\" + (" + shuffled + ").to_string() + \".cpp\"" }
+  };
+
+  const std::pair<const char*, cmsl::exec::execution_engine> engines[] = {
+    { "tree_walker", cmsl::exec::execution_engine::tree_walker },
+    { "bytecode", cmsl::exec::execution_engine::bytecode }
+  };
+
+  for (const auto& kind : kinds) {
+    for (const auto& c : make_cases(kind, size_str)) {
+      for (const auto& [engine_name, engine] : engines) {
+        const auto setup_ms = run(c.setup, engine);
+        const auto ms = run(c.setup + c.measured, engine) - setup_ms;
+        std::cout << c.name << ' ' << engine_name << ": " << ms << " ms\n";
+      }
+    }
+  }
+}
@@ -0,0 +1,101 @@
+#include "errors/errors_observer.hpp"
+#include "exec/global_executor.hpp"
+
+#include "cmakesl/fake_cmake_facade.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Measures execution of tight counting loops, that are dominated by int,
+// double and bool operators.
+//
+// Usage: cmakesl_exec_loops_benchmark [iterations]
+namespace {
+struct benchmark_case
+{
+  std::string name;
+  std::string source;
+};
+
+std::vector<benchmark_case> make_cases(const std::string& iterations)
+{
+  return {
+    { "while_counter",
+      "int main()"
+      "{"
+      "    int counter = 0;"
+      "    while (counter < " +
+        iterations +
+        ")"
+        "    {"
+        "        counter += 1;"
+        "    }"
+        "    return 0;"
+        "}" },
+    { "for_sum",
+      "int main()"
+      "{"
+      "    int sum = 0;"
+      "    for (int i = 0; i < " +
+        iterations +
+        "; ++i)"
+        "    {"
+        "        sum = sum + i * 2 - i;"
+        "    }"
+        "    return 0;"
+        "}" },
+    { "for_double",
+      "int main()"
+      "{"
+      "    double acc = 0.0;"
+      "    for (int i = 0; i < " +
+        iterations +
+        "; ++i)"
+        "    {"
+        "        acc += 0.5;"
+        "        if (acc > 100.0 && !(acc < 0.0))"
+        "        {"
+        "            acc -= 100.0;"
+        "        }"
+        "    }"
+        "    return 0;"
+        "}" }
+  };
+}
+
+double run(const benchmark_case& c, cmsl::exec::execution_engine engine)
+{
+  fake_cmake_facade facade;
+  cmsl::errors::errors_observer errs{ &facade };
+  cmsl::exec::global_executor::options opts;
+  opts.engine = engine;
+  cmsl::exec::global_executor executor{ ".", facade, errs, opts };
+
+  const auto begin = std::chrono::steady_clock::now();
+  executor.execute(c.source);
+  const auto end = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+}
+
+int main(int argc, const char* argv[])
+{
+  const auto iterations = argc > 1 ? std::stoi(argv[1]) : 1000000;
+  const auto cases = make_cases(std::to_string(iterations));
+
+  const std::pair<const char*, cmsl::exec::execution_engine> engines[] = {
+    { "tree_walker", cmsl::exec::execution_engine::tree_walker },
+    { "bytecode", cmsl::exec::execution_engine::bytecode }
+  };
+
+  for (const auto& c : cases) {
+    for (const auto& [engine_name, engine] : engines) {
+      const auto ms = run(c, engine);
+      std::cout << c.name << ' ' << engine_name << ": " << ms << " ms, "
+                << ms * 1000000.0 / iterations << " ns/iteration\n";
+    }
+  }
+}
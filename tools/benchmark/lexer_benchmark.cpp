@@ -0,0 +1,84 @@
+#include "common/source_view.hpp"
+#include "errors/errors_observer.hpp"
+#include "lexer/lexer.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Measures lexing throughput on a synthetic script, that mixes declarations,
+// string literals, comments and operators the way CMakeLists.cmsl files do.
+//
+// Usage: cmakesl_lexer_benchmark [source size in MB] [repetitions]
+namespace {
+const auto chunk = std::string{
+  "// Builds the library and its tests.\n"
+  "import \"cmake/cmsl_directories.cmsl\";\n"
+  "\n"
+  "namespace project_utils\n"
+  "{\n"
+  "    /* Sources shared between the library\n"
+  "       and the executable. */\n"
+  "    list<string> common_sources()\n"
+  "    {\n"
+  "        return { \"src/lexer.cpp\", \"src/parser.cpp\" };\n"
+  "    }\n"
+  "}\n"
+  "\n"
+  "int main(cmake::project& p)\n"
+  "{\n"
+  "    auto sources = project_utils::common_sources();\n"
+  "    double ratio = 0.75;\n"
+  "    for (int i = 0; i < 16; ++i)\n"
+  "    {\n"
+  "        if (i % 2 == 0 && !(ratio >= 1.0) || i != 3)\n"
+  "        {\n"
+  "            sources += \"gen/file_\" + i.to_string() + \".cpp\";\n"
+  "        }\n"
+  "    }\n"
+  "\n"
+  "    auto lib = p.add_library(\"cmakesl_lib\", sources);\n"
+  "    lib.include_directories({ cmsl::source_dir, \"esc\\\"aped\" });\n"
+  "    return 0;\n"
+  "}\n"
+  "\n"
+};
+
+std::string make_source(std::size_t size)
+{
+  std::string source;
+  source.reserve(size + chunk.size());
+  while (source.size() < size) {
+    source += chunk;
+  }
+  return source;
+}
+}
+
+int main(int argc, const char* argv[])
+{
+  const auto size_mb = argc > 1 ? std::stod(argv[1]) : 16.0;
+  const auto repetitions = argc > 2 ? std::stoi(argv[2]) : 10;
+
+  const auto source =
+    make_source(static_cast<std::size_t>(size_mb * 1024.0 * 1024.0));
+  const auto view = cmsl::source_view{ "benchmark.cmsl", source };
+
+  std::ostringstream errors_out;
+  cmsl::errors::errors_observer errs{ errors_out };
+
+  auto tokens_count = std::size_t{ 0u };
+  const auto begin = std::chrono::steady_clock::now();
+  for (auto i = 0; i < repetitions; ++i) {
+    cmsl::lexer::lexer lex{ errs, view };
+    tokens_count += lex.lex().size();
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  const auto seconds = std::chrono::duration<double>(end - begin).count();
+  const auto lexed_mb =
+    static_cast<double>(source.size()) * repetitions / (1024.0 * 1024.0);
+  std::cout << "lexed " << lexed_mb << " MB, " << tokens_count << " tokens in "
+            << seconds * 1000.0 << " ms: " << lexed_mb / seconds << " MB/s\n";
+}
@@ -0,0 +1,119 @@
+#include "lib/cmsl_parse_source.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Measures reparsing a big script after single char edits, compared to
+// parsing it from scratch. Every edit inserts a space at the beginning of a
+// random line and the next one removes it, so the script stays valid.
+//
+// Usage: cmakesl_reparse_benchmark [lines] [edits]
+namespace {
+const auto chunk = std::string{
+  "class builder_@\n"
+  "{\n"
+  "    list<string> sources;\n"
+  "\n"
+  "    int count()\n"
+  "    {\n"
+  "        return sources.size() + @;\n"
+  "    }\n"
+  "};\n"
+  "\n"
+  "namespace utils_@\n"
+  "{\n"
+  "    // Returns a name, that is unique in the project.\n"
+  "    string name(string base)\n"
+  "    {\n"
+  "        return base + \"_@\";\n"
+  "    }\n"
+  "}\n"
+  "\n"
+  "int configure_@(int value)\n"
+  "{\n"
+  "    builder_@ b;\n"
+  "    b.sources += utils_@::name(\"lib\");\n"
+  "    int result = value * 2;\n"
+  "    return result + b.count();\n"
+  "}\n"
+  "\n"
+};
+
+std::string make_source(std::size_t lines)
+{
+  const auto chunk_lines = static_cast<std::size_t>(
+    std::count(std::cbegin(chunk), std::cend(chunk), '\n'));
+
+  std::string source;
+  for (auto i = std::size_t{ 0u }; i * chunk_lines < lines; ++i) {
+    const auto id = std::to_string(i);
+    auto replaced = chunk;
+    for (auto pos = replaced.find('@'); pos != std::string::npos;
+         pos = replaced.find('@', pos + id.size())) {
+      replaced.replace(pos, 1u, id);
+    }
+    source += replaced;
+  }
+  return source;
+}
+
+double milliseconds_since(std::chrono::steady_clock::time_point begin)
+{
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+}
+
+int main(int argc, const char* argv[])
+{
+  const auto lines = argc > 1 ? std::stoul(argv[1]) : 20000ul;
+  const auto edits_count = argc > 2 ? std::stoi(argv[2]) : 50;
+
+  const auto source = make_source(lines);
+  std::vector<unsigned> line_starts{ 0u };
+  for (auto i = 0u; i + 1u < source.size(); ++i) {
+    if (source[i] == '\n') {
+      line_starts.push_back(i + 1u);
+    }
+  }
+
+  // Builtin stuff is created once per process, don't measure it.
+  cmsl_destroy_parsed_source(cmsl_parse_source("", nullptr));
+
+  auto begin = std::chrono::steady_clock::now();
+  auto parsed = cmsl_parse_source(source.c_str(), nullptr);
+  const auto full_parse_ms = milliseconds_since(begin);
+
+  std::mt19937 generator{ 42u };
+  std::uniform_int_distribution<std::size_t> line_distribution{
+    0u, line_starts.size() - 1u
+  };
+
+  auto total_ms = 0.0;
+  auto max_ms = 0.0;
+  for (auto i = 0; i < edits_count; ++i) {
+    const auto pos = line_starts[line_distribution(generator)];
+    const cmsl_source_edit insert{ pos, pos, " " };
+    const cmsl_source_edit remove{ pos, pos + 1u, "" };
+
+    for (const auto& edit : { insert, remove }) {
+      begin = std::chrono::steady_clock::now();
+      cmsl_reparse(parsed, &edit, 1u);
+      const auto ms = milliseconds_since(begin);
+      total_ms += ms;
+      max_ms = std::max(max_ms, ms);
+    }
+  }
+
+  cmsl_destroy_parsed_source(parsed);
+
+  const auto reparses = 2 * edits_count;
+  std::cout << line_starts.size() << " lines, full parse: " << full_parse_ms
+            << " ms, " << reparses
+            << " single char reparses: " << total_ms / reparses
+            << " ms on average, " << max_ms << " ms at most\n";
+}
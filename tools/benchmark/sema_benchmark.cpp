@@ -0,0 +1,133 @@
+#include "lib/cmsl_diagnostics.hpp"
+#include "lib/cmsl_parse_source.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// Measures parsing and semantic analysis of a script with thousands of
+// functions and namespaces, where most of the time is spent on looking up
+// qualified names of functions, types and variables, and on resolving calls
+// to overloaded builtin functions and operators.
+//
+// Usage: cmakesl_sema_benchmark [namespaces] [repetitions]
+namespace {
+// '@' is replaced with the index of the namespace, '#' with the index of the
+// previous one.
+const auto chunk = std::string{
+  "namespace outer_@\n"
+  "{\n"
+  "    namespace inner\n"
+  "    {\n"
+  "        class data\n"
+  "        {\n"
+  "            int value;\n"
+  "        };\n"
+  "\n"
+  "        int get(int v) { return v + @; }\n"
+  "        int get(double v) { return 1; }\n"
+  "    }\n"
+  "\n"
+  "    int first(int a) { return inner::get(a); }\n"
+  "    int second(int a, int b) { return first(a) + inner::get(b); }\n"
+  "    int third(int a)\n"
+  "    {\n"
+  "        inner::data d;\n"
+  "        int local = outer_#::inner::get(a);\n"
+  "        {\n"
+  "            int nested = local + second(a, d.value);\n"
+  "            local = nested + outer_#::first(local);\n"
+  "        }\n"
+  "        return ::outer_#::second(local, first(a));\n"
+  "    }\n"
+  "\n"
+  "    list<string> sources(string base)\n"
+  "    {\n"
+  "        list<string> result;\n"
+  "        string name = base + \"_@\";\n"
+  "        result.push_back(name + \".cpp\");\n"
+  "        result.push_back(name + \".hpp\");\n"
+  "        result += { \"main.cpp\", \"utils.cpp\" };\n"
+  "        double ratio = 0.5 * 2.0 + 1.0;\n"
+  "        if (result.size() > 2 && ratio < 3.0)\n"
+  "        {\n"
+  "            name += \"_gen\";\n"
+  "        }\n"
+  "        return result;\n"
+  "    }\n"
+  "}\n"
+  "\n"
+};
+
+std::string make_source(std::size_t namespaces)
+{
+  std::string source;
+  for (auto i = std::size_t{ 0u }; i < namespaces; ++i) {
+    const auto id = std::to_string(i);
+    const auto previous_id = std::to_string(i == 0u ? 0u : i - 1u);
+    auto replaced = chunk;
+    for (auto pos = replaced.find_first_of("@#"); pos != std::string::npos;
+         pos = replaced.find_first_of("@#", pos)) {
+      const auto& replacement = replaced[pos] == '@' ? id : previous_id;
+      replaced.replace(pos, 1u, replacement);
+      pos += replacement.size();
+    }
+    source += replaced;
+  }
+
+  source += "int main(cmake::project& p)\n"
+            "{\n"
+            "    return outer_0::third(1);\n"
+            "}\n";
+  return source;
+}
+
+double milliseconds_since(std::chrono::steady_clock::time_point begin)
+{
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+}
+
+int main(int argc, const char* argv[])
+{
+  const auto namespaces = argc > 1 ? std::stoul(argv[1]) : 2000ul;
+  const auto repetitions = argc > 2 ? std::stoi(argv[2]) : 5;
+
+  const auto source = make_source(namespaces);
+
+  // Builtin stuff is created once per process, don't measure it.
+  cmsl_destroy_parsed_source(cmsl_parse_source("", nullptr));
+
+  // Measuring a script with errors would not tell much.
+  {
+    const auto parsed = cmsl_parse_source(source.c_str(), nullptr);
+    const auto diagnostics = cmsl_get_diagnostics(parsed);
+    const auto diagnostics_count = diagnostics->num_diagnostics;
+    if (diagnostics_count > 0u) {
+      std::cerr << diagnostics->diagnostics[0].message << '\n';
+    }
+    cmsl_destroy_diagnostics(diagnostics);
+    cmsl_destroy_parsed_source(parsed);
+    if (diagnostics_count > 0u) {
+      return 1;
+    }
+  }
+
+  auto total_ms = 0.0;
+  auto min_ms = 0.0;
+  for (auto i = 0; i < repetitions; ++i) {
+    const auto begin = std::chrono::steady_clock::now();
+    const auto parsed = cmsl_parse_source(source.c_str(), nullptr);
+    const auto ms = milliseconds_since(begin);
+    cmsl_destroy_parsed_source(parsed);
+
+    total_ms += ms;
+    min_ms = i == 0 ? ms : std::min(min_ms, ms);
+  }
+
+  std::cout << namespaces << " namespaces, " << namespaces * 6u
+            << " functions: " << total_ms / repetitions
+            << " ms on average, " << min_ms << " ms at best\n";
+}
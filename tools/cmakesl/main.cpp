@@ -1,205 +1,298 @@
-#include "cmake_facade.hpp"
+#include "exec/compilation_cache.hpp"
+#include "exec/facade_trace.hpp"
 #include "exec/global_executor.hpp"
-#include "exec/instance/instance.hpp"
+#include "exec/profiler.hpp"
+#include "exec/recording_cmake_facade.hpp"
+#include "exec/script_profiler.hpp"
 
+#include "fake_cmake_facade.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
-#include <stack>
-
-class fake_cmake_facade : public cmsl::facade::cmake_facade
+#include <limits>
+#include <optional>
+#include <sstream>
+
+namespace {
+constexpr auto k_usage =
+  "Usage: cmakesl path/to/root/CMakeLists.cmsl [--bytecode] "
+  "[--cache-dir=path/to/existing/dir] [--cache-stats] [--jobs=N] "
+  "[--dump-optimized] [--batch-facade-calls] "
+  "[--record-trace=path/to/trace] [--profile-trace=path/to/trace.json] "
+  "[--profile-folded=path/to/stacks] [--script-profile] "
+  "[--script-profile-json=path/to/profile.json] [--bench[=N]] "
+  "[--lazy-imports] [--check-all]\n"
+  "       cmakesl --replay-trace=path/to/trace";
+
+constexpr auto k_default_bench_runs = 10;
+
+double milliseconds(cmsl::exec::profiler::clock::duration duration)
 {
-public:
-  version get_cmake_version() const override { return {}; }
-
-  void message(const std::string& msg) const override
-  {
-    std::cout << msg << '\n';
-  }
-
-  void warning(const std::string& msg) const override
-  {
-    std::cout << msg << '\n';
-  }
-
-  void error(const std::string& msg) const override
-  {
-    std::cout << msg << '\n';
-  }
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
 
-  void fatal_error(const std::string& msg) override
-  {
-    m_fatal_error_occured = true;
-    std::cout << msg << '\n';
+// Replays the trace to a facade that prints messages.
+int replay_trace(const std::string& trace_path)
+{
+  std::ifstream trace{ trace_path };
+  if (!trace) {
+    std::cerr << "Can not open trace: " << trace_path;
+    return 1;
   }
 
-  bool did_fatal_error_occure() const override
-  {
-    return m_fatal_error_occured;
-  }
+  fake_cmake_facade facade;
+  facade.go_into_subdirectory(".");
 
-  void register_project(const std::string& name) override {}
+  const auto begin = std::chrono::steady_clock::now();
+  const auto replayed = cmsl::exec::replay_facade_trace(trace, facade);
+  const auto end = std::chrono::steady_clock::now();
 
-  void install(const std::string& target_name,
-               const std::string& destination) override
-  {
+  if (!replayed) {
+    std::cerr << "Malformed trace: " << trace_path;
+    return 1;
   }
 
-  std::string get_current_binary_dir() const override { return {}; }
-  std::string get_current_source_dir() const override { return {}; }
-  std::string get_root_source_dir() const override { return {}; }
+  std::cerr << "Replayed " << *replayed << " calls in "
+            << milliseconds(end - begin) << " ms\n";
+  return 0;
+}
 
-  void add_custom_command(const std::vector<std::string>& command,
-                          const std::string& output) const override
-  {
+// Executes the script the given number of times. Output of the script is
+// dropped and facade calls are recorded to memory. Prints time of every
+// phase: the shortest one and the mean of all runs.
+int bench(const std::string& source, const std::string& root_dir_path,
+          cmsl::exec::global_executor::options options, int runs)
+{
+  using cmsl::exec::phase;
+  using cmsl::exec::profiler;
+
+  constexpr auto phases_count = profiler::k_phases_count;
+  // Phases, followed by time not accounted to any of them and the total.
+  constexpr auto rows_count = phases_count + 2u;
+  std::array<double, rows_count> min_ms;
+  min_ms.fill(std::numeric_limits<double>::max());
+  std::array<double, rows_count> sum_ms{};
+
+  for (auto run = 0; run < runs; ++run) {
+    std::ostream null_out{ nullptr };
+    fake_cmake_facade facade{ null_out };
+    std::ostringstream trace;
+    // Function calls are not recorded, so they do not skew the timings.
+    profiler prof{ false };
+    cmsl::exec::recording_cmake_facade recording_facade{ facade, trace,
+                                                         &prof };
+    cmsl::errors::errors_observer errs{ &facade };
+    options.profiler = &prof;
+
+    const auto begin = profiler::clock::now();
+    {
+      cmsl::exec::global_executor executor{ root_dir_path, recording_facade,
+                                            errs, options };
+      executor.execute(source);
+    }
+    const auto total_ms = milliseconds(profiler::clock::now() - begin);
+
+    std::array<double, rows_count> run_ms{};
+    auto phases_ms = 0.0;
+    for (auto i = 0u; i < phases_count; ++i) {
+      run_ms[i] = milliseconds(prof.phase_total(static_cast<phase>(i)));
+      phases_ms += run_ms[i];
+    }
+    run_ms[phases_count] = total_ms - phases_ms;
+    run_ms[phases_count + 1u] = total_ms;
+
+    for (auto i = 0u; i < rows_count; ++i) {
+      min_ms[i] = std::min(min_ms[i], run_ms[i]);
+      sum_ms[i] += run_ms[i];
+    }
   }
 
-  void add_custom_target(
-    const std::string& name,
-    const std::vector<std::string>& command) const override
-  {
+  std::cout << std::left << std::setw(10) << "phase" << std::right
+            << std::setw(12) << "min ms" << std::setw(12) << "mean ms"
+            << '\n'
+            << std::fixed << std::setprecision(3);
+  for (auto i = 0u; i < rows_count; ++i) {
+    const auto name = i < phases_count
+      ? profiler::phase_name(static_cast<phase>(i))
+      : (i == phases_count ? "other" : "total");
+    std::cout << std::left << std::setw(10) << name << std::right
+              << std::setw(12) << min_ms[i] << std::setw(12)
+              << sum_ms[i] / runs << '\n';
   }
 
-  void make_directory(const std::string& dir) const override {}
-
-  void add_executable(const std::string& name,
-                      const std::vector<std::string>& sources) override
-  {
-  }
-
-  void add_library(const std::string& name,
-                   const std::vector<std::string>& sources) override
-  {
-  }
+  return 0;
+}
+}
 
-  void target_link_library(const std::string& target_name,
-                           cmsl::facade::visibility v,
-                           const std::string& library_name) override
-  {
+int main(int argc, const char* argv[])
+{
+  if (argc < 2) {
+    std::cerr << k_usage;
+    return 1;
   }
 
-  void target_include_directories(
-    const std::string& name, cmsl::facade::visibility v,
-    const std::vector<std::string>& sources) override
-  {
+  if (argv[1] == std::string{ "--version" }) {
+    std::cout << "v0.0";
+    return 0;
   }
 
-  void target_compile_definitions(
-    const std::string& target_name, cmsl::facade::visibility v,
-    const std::vector<std::string>& definitions) override
-  {
+  const auto replay_trace_option = std::string{ "--replay-trace=" };
+  if (const auto option = std::string{ argv[1] };
+      option.compare(0u, replay_trace_option.size(), replay_trace_option) ==
+      0) {
+    return replay_trace(option.substr(replay_trace_option.size()));
   }
 
-  void target_compile_options(
-    const std::string& target_name, cmsl::facade::visibility v,
-    const std::vector<std::string>& definitions) override
-  {
+  const auto root_file_path = std::string{ argv[1] };
+  const auto end_of_root_dir = root_file_path.find("/CMakeLists.cmsl");
+  if (end_of_root_dir == std::string::npos) {
+    std::cerr << k_usage;
+    return 1;
   }
 
-  void target_sources(const std::string& target_name,
-                      cmsl::facade::visibility v,
-                      const std::vector<std::string>& definitions) override
-  {
-  }
+  const auto root_dir_path = root_file_path.substr(0, end_of_root_dir);
 
-  std::string current_directory() const override
-  {
-    return m_directory_stack.top();
+  cmsl::exec::global_executor::options executor_options;
+  std::optional<cmsl::exec::compilation_cache> cache;
+  auto dump_cache_stats = false;
+  auto dump_optimized = false;
+  std::optional<std::string> trace_path;
+  std::optional<std::string> profile_trace_path;
+  std::optional<std::string> profile_folded_path;
+  auto print_script_profile = false;
+  std::optional<std::string> script_profile_json_path;
+  auto bench_runs = 0;
+  auto check_all = false;
+
+  const auto cache_dir_option = std::string{ "--cache-dir=" };
+  const auto jobs_option = std::string{ "--jobs=" };
+  const auto record_trace_option = std::string{ "--record-trace=" };
+  const auto profile_trace_option = std::string{ "--profile-trace=" };
+  const auto profile_folded_option = std::string{ "--profile-folded=" };
+  const auto script_profile_json_option =
+    std::string{ "--script-profile-json=" };
+  const auto bench_option = std::string{ "--bench=" };
+  for (auto i = 2; i < argc; ++i) {
+    const auto option = std::string{ argv[i] };
+    if (option == "--bytecode") {
+      executor_options.engine = cmsl::exec::execution_engine::bytecode;
+    } else if (option.compare(0u, cache_dir_option.size(),
+                              cache_dir_option) == 0) {
+      cache.emplace(option.substr(cache_dir_option.size()));
+    } else if (option == "--cache-stats") {
+      dump_cache_stats = true;
+    } else if (option == "--dump-optimized") {
+      dump_optimized = true;
+    } else if (option == "--batch-facade-calls") {
+      executor_options.batch_facade_calls = true;
+    } else if (option.compare(0u, jobs_option.size(), jobs_option) == 0) {
+      // The calling thread compiles too, so it is not counted.
+      const auto jobs = std::stoi(option.substr(jobs_option.size()));
+      executor_options.prefetch_threads =
+        jobs > 1 ? static_cast<unsigned>(jobs - 1) : 0u;
+    } else if (option.compare(0u, record_trace_option.size(),
+                              record_trace_option) == 0) {
+      trace_path = option.substr(record_trace_option.size());
+    } else if (option.compare(0u, profile_trace_option.size(),
+                              profile_trace_option) == 0) {
+      profile_trace_path = option.substr(profile_trace_option.size());
+    } else if (option.compare(0u, profile_folded_option.size(),
+                              profile_folded_option) == 0) {
+      profile_folded_path = option.substr(profile_folded_option.size());
+    } else if (option == "--script-profile") {
+      print_script_profile = true;
+    } else if (option.compare(0u, script_profile_json_option.size(),
+                              script_profile_json_option) == 0) {
+      script_profile_json_path =
+        option.substr(script_profile_json_option.size());
+    } else if (option == "--bench") {
+      bench_runs = k_default_bench_runs;
+    } else if (option.compare(0u, bench_option.size(), bench_option) == 0) {
+      bench_runs = std::max(std::stoi(option.substr(bench_option.size())), 1);
+    } else if (option == "--lazy-imports") {
+      executor_options.lazy_imports = true;
+    } else if (option == "--check-all") {
+      check_all = true;
+    } else {
+      std::cerr << "Unknown option: " << option;
+      return 1;
+    }
   }
 
-  void add_subdirectory_with_old_script(const std::string& dir) override {}
+  std::ifstream in{ root_file_path };
+  std::string source{ (std::istreambuf_iterator<char>(in)),
+                      std::istreambuf_iterator<char>() };
 
-  void prepare_for_add_subdirectory_with_cmakesl_script(
-    const std::string& dir) override
-  {
+  executor_options.cache = cache ? &*cache : nullptr;
+  if (bench_runs > 0) {
+    return bench(source, root_dir_path, executor_options, bench_runs);
   }
-  void finalize_after_add_subdirectory_with_cmakesl_script() override {}
 
-  void go_into_subdirectory(const std::string& dir) override
-  {
-    m_directory_stack.push(dir);
+  std::optional<cmsl::exec::profiler> profiler;
+  if (profile_trace_path || profile_folded_path) {
+    profiler.emplace();
   }
 
-  void go_directory_up() override { m_directory_stack.pop(); }
-
-  void enable_ctest() const override {}
-
-  void add_test(const std::string& test_executable_name) override {}
-
-  system_info get_system_info() const override
-  {
-    return system_info{ system_id::windows };
+  fake_cmake_facade facade;
+  std::ofstream trace;
+  std::optional<cmsl::exec::recording_cmake_facade> recording_facade;
+  if (trace_path) {
+    trace.open(*trace_path);
+    recording_facade.emplace(facade, trace,
+                             profiler ? &*profiler : nullptr);
   }
 
-  cxx_compiler_info get_cxx_compiler_info() const override
-  {
-    return cxx_compiler_info{ cxx_compiler_id::clang };
+  std::optional<cmsl::exec::script_profiler> script_profiler;
+  if (print_script_profile || script_profile_json_path) {
+    script_profiler.emplace();
   }
 
-  std::optional<std::string> try_get_extern_define(
-    const std::string& name) const override
-  {
-    return std::nullopt;
-  }
+  executor_options.dump_optimized = dump_optimized ? &std::cout : nullptr;
+  executor_options.profiler = profiler ? &*profiler : nullptr;
+  executor_options.script_profiler =
+    script_profiler ? &*script_profiler : nullptr;
 
-  void set_property(const std::string&, const std::string&) const override {}
+  cmsl::errors::errors_observer errs{ &facade };
+  cmsl::exec::global_executor executor{
+    root_dir_path,
+    recording_facade ? static_cast<cmsl::facade::cmake_facade&>(
+                         *recording_facade)
+                     : facade,
+    errs, executor_options
+  };
 
-  std::optional<bool> get_option_value(const std::string& name) const override
-  {
-    return std::nullopt;
-  }
+  executor.execute(source);
 
-  void register_option(const std::string& name, const std::string& description,
-                       bool value) const override
-  {
-  }
+  // Bodies of imported functions, that have not been used, are checked only
+  // on demand.
+  const auto all_checked = !check_all || executor.build_all_function_bodies();
 
-  void set_old_style_variable(const std::string&,
-                              const std::string&) const override
-  {
+  if (profile_trace_path) {
+    std::ofstream out{ *profile_trace_path };
+    profiler->write_chrome_trace(out);
   }
 
-  std::optional<std::string> get_old_style_variable(
-    const std::string&) const override
-  {
-    return {};
+  if (profile_folded_path) {
+    std::ofstream out{ *profile_folded_path };
+    profiler->write_folded_stacks(out);
   }
 
-  std::string ctest_command() const override { return ""; }
-
-private:
-  std::stack<std::string> m_directory_stack;
-  std::unique_ptr<cmsl::exec::inst::instance> m_add_subdirectory_result;
-  bool m_fatal_error_occured{ false };
-};
-
-int main(int argc, const char* argv[])
-{
-  if (argc < 2) {
-    std::cerr << "Usage: cmakesl path/to/root/CMakeLists.cmsl";
-    return 1;
+  if (print_script_profile) {
+    script_profiler->write_report(std::cerr);
   }
 
-  if (argv[1] == std::string{ "--version" }) {
-    std::cout << "v0.0";
-    return 0;
+  if (script_profile_json_path) {
+    std::ofstream out{ *script_profile_json_path };
+    script_profiler->write_json(out);
   }
 
-  const auto root_file_path = std::string{ argv[1] };
-  const auto end_of_root_dir = root_file_path.find("/CMakeLists.cmsl");
-  if (end_of_root_dir == std::string::npos) {
-    std::cerr << "Usage: cmakesl path/to/root/CMakeLists.cmsl";
-    return 1;
+  if (cache && dump_cache_stats) {
+    cache->dump(std::cerr);
   }
 
-  const auto root_dir_path = root_file_path.substr(0, end_of_root_dir);
-
-  std::ifstream in{ root_file_path };
-  std::string source{ (std::istreambuf_iterator<char>(in)),
-                      std::istreambuf_iterator<char>() };
-
-  fake_cmake_facade facade;
-  cmsl::errors::errors_observer errs{ &facade };
-  cmsl::exec::global_executor executor{ root_dir_path, facade, errs };
-
-  executor.execute(source);
+  return all_checked ? 0 : 1;
 }
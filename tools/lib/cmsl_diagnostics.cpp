@@ -0,0 +1,65 @@
+#include "cmsl_diagnostics.hpp"
+
+#include "cmsl_parsed_source.hpp"
+
+#include <cstring>
+#include <string>
+
+namespace {
+cmsl_diagnostic_type to_diagnostic_type(cmsl::errors::error_type type)
+{
+  switch (type) {
+    case cmsl::errors::error_type::warning:
+      return diagnostic_warning;
+    case cmsl::errors::error_type::note:
+      return diagnostic_note;
+    default:
+      return diagnostic_error;
+  }
+}
+
+char* copy_string(const std::string& str)
+{
+  auto copy = new char[str.size() + 1u];
+  std::strcpy(copy, str.c_str());
+  return copy;
+}
+}
+
+struct cmsl_diagnostics* cmsl_get_diagnostics(
+  const struct cmsl_parsed_source* parsed_source)
+{
+  if (!parsed_source) {
+    return nullptr;
+  }
+
+  const auto& source_diagnostics = parsed_source->diagnostics;
+
+  auto diagnostics = new cmsl_diagnostics;
+  diagnostics->num_diagnostics =
+    static_cast<unsigned>(source_diagnostics.size());
+  diagnostics->diagnostics = new cmsl_diagnostic[source_diagnostics.size()];
+
+  for (auto i = 0u; i < source_diagnostics.size(); ++i) {
+    const auto& diagnostic = source_diagnostics[i];
+    auto& entry = diagnostics->diagnostics[i];
+    entry.begin_pos = diagnostic.begin_pos;
+    entry.end_pos = diagnostic.end_pos;
+    entry.type = to_diagnostic_type(diagnostic.type);
+    entry.source_path = copy_string(diagnostic.source_path);
+    entry.message = copy_string(diagnostic.message);
+  }
+
+  return diagnostics;
+}
+
+void cmsl_destroy_diagnostics(struct cmsl_diagnostics* diagnostics)
+{
+  for (auto i = 0u; i < diagnostics->num_diagnostics; ++i) {
+    delete[] diagnostics->diagnostics[i].source_path;
+    delete[] diagnostics->diagnostics[i].message;
+  }
+
+  delete[] diagnostics->diagnostics;
+  delete diagnostics;
+}
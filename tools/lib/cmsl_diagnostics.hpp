@@ -0,0 +1,40 @@
+#ifndef CMSL_DIAGNOSTICS_HPP
+#define CMSL_DIAGNOSTICS_HPP
+
+#include "cmsl_parse_source.hpp"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+enum cmsl_diagnostic_type
+{
+  diagnostic_error,
+  diagnostic_warning,
+  diagnostic_note
+};
+
+struct cmsl_diagnostic
+{
+  unsigned begin_pos;
+  unsigned end_pos;
+  enum cmsl_diagnostic_type type;
+  char* source_path;
+  char* message;
+};
+
+struct cmsl_diagnostics
+{
+  struct cmsl_diagnostic* diagnostics;
+  unsigned num_diagnostics;
+};
+
+// Errors reported by the last parse or reparse of the source.
+struct cmsl_diagnostics* cmsl_get_diagnostics(
+  const struct cmsl_parsed_source* parsed_source);
+void cmsl_destroy_diagnostics(struct cmsl_diagnostics* diagnostics);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CMSL_DIAGNOSTICS_HPP
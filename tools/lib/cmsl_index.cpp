@@ -3,29 +3,54 @@
 #include "cmsl_parsed_source.hpp"
 #include "indexing_visitor.hpp"
 
-#include <stack>
+#include <cstring>
 #include <vector>
 
+namespace {
+bool can_be_indexed(const struct cmsl_parsed_source* parsed_source)
+{
+  return parsed_source && parsed_source->ast_tree && parsed_source->sema_tree;
+}
+}
+
 struct cmsl_index_entries* cmsl_index(
   const struct cmsl_parsed_source* parsed_source)
 {
-  if (!parsed_source || !parsed_source->ast_tree ||
-      !parsed_source->sema_tree) {
+  if (!can_be_indexed(parsed_source)) {
     return nullptr;
   }
 
   cmsl::tools::indexer indexer;
   parsed_source->sema_tree->visit(indexer);
   const auto& result = indexer.result();
+  const auto& paths = indexer.source_paths();
 
   auto index_entries = new cmsl_index_entries;
 
-  index_entries->num_entries = result.size();
+  // All paths go to one buffer, one after another. The first path points to
+  // the beginning of the buffer.
+  auto paths_size = std::size_t{ 0u };
+  for (const auto& path : paths) {
+    paths_size += path.size() + 1u;
+  }
+
+  index_entries->num_source_paths = paths.size();
+  index_entries->source_paths = new const char*[paths.size()];
+
+  auto paths_buffer = new char[paths_size];
+  for (auto i = 0u; i < paths.size(); ++i) {
+    std::memcpy(paths_buffer, paths[i].c_str(), paths[i].size() + 1u);
+    index_entries->source_paths[i] = paths_buffer;
+    paths_buffer += paths[i].size() + 1u;
+  }
 
+  index_entries->num_entries = result.size();
   index_entries->entries = new cmsl_index_entry[result.size()];
 
   for (auto i = 0u; i < result.size(); ++i) {
-    index_entries->entries[i] = result[i];
+    auto& entry = index_entries->entries[i];
+    entry = result[i];
+    entry.source_path = index_entries->source_paths[entry.source_path_index];
   }
 
   return index_entries;
@@ -33,10 +58,26 @@ struct cmsl_index_entries* cmsl_index(
 
 void cmsl_destroy_index_entries(struct cmsl_index_entries* index_entries)
 {
-  for (auto i = 0u; i < index_entries->num_entries; ++i) {
-    delete[] index_entries->entries[i].source_path;
+  if (index_entries->num_source_paths > 0u) {
+    delete[] index_entries->source_paths[0];
   }
 
+  delete[] index_entries->source_paths;
   delete[] index_entries->entries;
   delete index_entries;
 }
+
+int cmsl_index_with_callback(const struct cmsl_parsed_source* parsed_source,
+                             cmsl_index_entry_callback callback,
+                             void* user_data)
+{
+  if (!can_be_indexed(parsed_source)) {
+    return 0;
+  }
+
+  cmsl::tools::indexer indexer{ [callback, user_data](const auto& entry) {
+    callback(&entry, user_data);
+  } };
+  parsed_source->sema_tree->visit(indexer);
+  return 1;
+}
@@ -25,20 +25,37 @@ struct cmsl_index_entry
   unsigned begin_pos;
   unsigned end_pos;
   enum cmsl_index_entry_type type;
-  char* source_path;
+  // Points to the interned path, owned by the index entries.
+  const char* source_path;
   unsigned position;
+  // Index of the path in the source paths of the index entries.
+  unsigned source_path_index;
 };
 
+// Entries and source paths are stored in buffers allocated once per index,
+// each distinct source path is stored once.
 struct cmsl_index_entries
 {
   struct cmsl_index_entry* entries;
   unsigned num_entries;
+  const char** source_paths;
+  unsigned num_source_paths;
 };
 
 struct cmsl_index_entries* cmsl_index(
   const struct cmsl_parsed_source* parsed_source);
 void cmsl_destroy_index_entries(struct cmsl_index_entries* index_entries);
 
+// Called for every entry, as soon as it is found. The entry, and its source
+// path, are valid only during the call.
+typedef void (*cmsl_index_entry_callback)(const struct cmsl_index_entry* entry,
+                                          void* user_data);
+
+// Returns zero if the source can not be indexed.
+int cmsl_index_with_callback(const struct cmsl_parsed_source* parsed_source,
+                             cmsl_index_entry_callback callback,
+                             void* user_data);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,13 +1,20 @@
 #include "cmsl_parse_source.hpp"
 #include "cmsl_parsed_source.hpp"
+#include "completion_index.hpp"
+#include "source_import_handler.hpp"
 
 #include "ast/ast_node.hpp"
 #include "ast/parser.hpp"
+#include "ast/translation_unit_node.hpp"
+#include "common/source_files.hpp"
 #include "common/strings_container_impl.hpp"
+#include "errors/error.hpp"
+#include "errors/errors_observer.hpp"
 #include "lexer/lexer.hpp"
 #include "sema/add_declarative_file_semantic_handler.hpp"
 #include "sema/add_subdirectory_semantic_handler.hpp"
 #include "sema/builtin_sema_context.hpp"
+#include "sema/builtin_sema_environment.hpp"
 #include "sema/builtin_token_provider.hpp"
 #include "sema/enum_values_context.hpp"
 #include "sema/factories.hpp"
@@ -17,8 +24,13 @@
 #include "sema/qualified_contextes_refs.hpp"
 #include "sema/sema_builder.hpp"
 #include "sema/sema_function.hpp"
+#include "sema/sema_nodes.hpp"
 #include "sema/types_context.hpp"
 
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
 namespace cmsl::sema::details {
 class add_subdir_handler : public add_subdirectory_semantic_handler
 {
@@ -27,7 +39,9 @@ public:
     cmsl::string_view name,
     const std::vector<std::unique_ptr<expression_node>>& params) override
   {
-    return no_script_found{};
+    // Scripts of subdirectories are not analysed, but the call is valid, so
+    // the function that contains it is built.
+    return contains_old_cmake_script{};
   }
 };
 class add_declaratife_file_handler
@@ -42,11 +56,232 @@ public:
 };
 }
 
+namespace {
+cmsl::source_view view_of(const cmsl_parsed_source& parsed_source)
+{
+  if (parsed_source.source_path.empty()) {
+    return cmsl::source_view{ parsed_source.source };
+  }
+
+  return cmsl::source_view{ parsed_source.source_path, parsed_source.source };
+}
+
+void add_diagnostic(cmsl_parsed_source& parsed_source,
+                    const cmsl::errors::error& err)
+{
+  parsed_source.diagnostics.emplace_back(cmsl_parsed_source::diagnostic{
+    err.range.begin.absolute, err.range.end.absolute, err.type,
+    std::string{ err.source_path }, err.message });
+}
+
+cmsl_parsed_source::sema_state make_sema_state(
+  const cmsl_parsed_source& parsed_source)
+{
+  return cmsl_parsed_source::sema_state{
+    parsed_source.qualified_ctxs.make_checkpoint(),
+    parsed_source.global_context->make_checkpoint(),
+    parsed_source.context.factories.make_checkpoint()
+  };
+}
+
+// Moves declarations out of the trees, so they can be reused.
+void detach_declarations(cmsl_parsed_source& parsed_source)
+{
+  parsed_source.completion_index.reset();
+  parsed_source.exported_contextes.reset();
+
+  if (parsed_source.sema_tree) {
+    auto& translation_unit =
+      static_cast<cmsl::sema::translation_unit_node&>(
+        *parsed_source.sema_tree);
+    parsed_source.sema_nodes = translation_unit.release_nodes();
+    parsed_source.sema_tree.reset();
+  }
+
+  if (parsed_source.ast_tree) {
+    auto& translation_unit =
+      static_cast<cmsl::ast::translation_unit_node&>(*parsed_source.ast_tree);
+    parsed_source.ast_nodes = translation_unit.release_nodes();
+    parsed_source.ast_tree.reset();
+  }
+}
+
+// Lexes the source again, keeping tokens of its unchanged beginning and end.
+// Returns number of leading tokens that have been kept.
+std::size_t relex(cmsl_parsed_source& parsed_source,
+                  const std::string& old_source)
+{
+  const auto& source = parsed_source.source;
+  const auto common_size = std::min(source.size(), old_source.size());
+  const auto prefix_size = static_cast<std::size_t>(std::distance(
+    std::cbegin(source),
+    std::mismatch(std::cbegin(source),
+                  std::next(std::cbegin(source), common_size),
+                  std::cbegin(old_source))
+      .first));
+  const auto suffix_size = static_cast<std::size_t>(std::distance(
+    std::crbegin(source),
+    std::mismatch(std::crbegin(source),
+                  std::next(std::crbegin(source), common_size - prefix_size),
+                  std::crbegin(old_source))
+      .first));
+  const auto changed_end = source.size() - suffix_size;
+  // Wraps around if the source has shrunk, offsets are shifted right anyway.
+  const auto delta = static_cast<std::uint32_t>(source.size()) -
+    static_cast<std::uint32_t>(old_source.size());
+
+  const auto& old_tokens = parsed_source.tokens;
+
+  // Lexer may look a couple of chars past a token, so the last token that
+  // ends before the changed text is lexed again, too.
+  auto kept_count = static_cast<std::size_t>(
+    std::distance(std::cbegin(old_tokens),
+                  std::partition_point(std::cbegin(old_tokens),
+                                       std::cend(old_tokens),
+                                       [prefix_size](const auto& token) {
+                                         return token.end_offset() <
+                                           prefix_size;
+                                       })));
+  kept_count = kept_count > 0u ? kept_count - 1u : 0u;
+
+  auto tokens = cmsl::lexer::token_container_t(
+    std::cbegin(old_tokens), std::next(std::cbegin(old_tokens), kept_count));
+  tokens.reserve(old_tokens.size() + 16u);
+
+  cmsl::lexer::lexer lex{ parsed_source.context.errors_observer,
+                          view_of(parsed_source),
+                          parsed_source.source_registration.id() };
+  lex.seek(tokens.empty() ? 0u : tokens.back().end_offset());
+
+  auto old_it = std::next(std::cbegin(old_tokens), kept_count);
+  while (const auto token = lex.lex_next()) {
+    if (token->offset() >= changed_end) {
+      // Old and new sources are the same from here. If the old source had a
+      // token at the same place, the rest of tokens are the same, too.
+      const auto old_offset = token->offset() - delta;
+      old_it = std::partition_point(
+        old_it, std::cend(old_tokens),
+        [old_offset](const auto& t) { return t.offset() < old_offset; });
+      if (old_it != std::cend(old_tokens) && old_it->offset() == old_offset) {
+        for (; old_it != std::cend(old_tokens); ++old_it) {
+          tokens.emplace_back(
+            old_it->get_type(), old_it->offset() + delta,
+            old_it->end_offset() - old_it->offset(),
+            parsed_source.source_registration.id());
+        }
+        break;
+      }
+    }
+
+    tokens.emplace_back(*token);
+  }
+
+  parsed_source.tokens = std::move(tokens);
+  return kept_count;
+}
+
+// Parses and builds declarations that follow the first kept_count ones. Trees
+// are created only if the whole source parses and builds, same as in a
+// regular parse.
+void build_declarations(cmsl_parsed_source& parsed_source,
+                        std::size_t kept_count)
+{
+  parsed_source.ast_nodes.resize(kept_count);
+  parsed_source.sema_nodes.resize(kept_count);
+  parsed_source.parse_states.resize(kept_count + 1u);
+  parsed_source.sema_states.resize(kept_count + 1u);
+
+  const auto parse_state = parsed_source.parse_states.back();
+  const auto sema_state = parsed_source.sema_states.back();
+  parsed_source.strings_container->truncate(parse_state.strings_count);
+  parsed_source.qualified_ctxs.rollback(sema_state.contextes);
+  parsed_source.global_context->rollback(sema_state.global_context);
+  parsed_source.context.factories.rollback(sema_state.factories);
+
+  const auto& tokens = parsed_source.tokens;
+  cmsl::ast::parser parser{ parsed_source.context.errors_observer,
+                            *parsed_source.strings_container,
+                            view_of(parsed_source),
+                            tokens };
+  parser.skip_to(std::next(std::cbegin(tokens), parse_state.tokens_count));
+
+  while (!parser.is_at_end()) {
+    auto node = parser.parse_top_level_node();
+    if (!node) {
+      return;
+    }
+
+    parsed_source.ast_nodes.emplace_back(std::move(node));
+    parsed_source.parse_states.emplace_back(cmsl_parsed_source::parse_state{
+      static_cast<std::size_t>(
+        std::distance(std::cbegin(tokens), parser.current_iterator())),
+      parsed_source.strings_container->size() });
+  }
+
+  auto ast_tree = std::make_unique<cmsl::ast::translation_unit_node>(
+    std::move(parsed_source.ast_nodes));
+  parsed_source.ast_nodes.clear();
+  const auto& declarations = ast_tree->nodes();
+
+  cmsl::sema::sema_builder sema_builder{
+    *parsed_source.global_context,
+    parsed_source.context.errors_observer,
+    parsed_source.qualified_ctxs,
+    parsed_source.context.factories,
+    *parsed_source.add_subdirectory_handler,
+    *parsed_source.add_declarative_file_handler,
+    *parsed_source.imports_handler,
+    *parsed_source.builtin_token_provider,
+    parsed_source.builtin_environment->builtin_types()
+  };
+
+  parsed_source.ast_tree = std::move(ast_tree);
+
+  for (auto i = parsed_source.sema_nodes.size(); i < declarations.size();
+       ++i) {
+    auto node = sema_builder.build(*declarations[i]);
+    if (!node) {
+      return;
+    }
+
+    parsed_source.sema_nodes.emplace_back(std::move(node));
+    parsed_source.sema_states.emplace_back(make_sema_state(parsed_source));
+  }
+
+  auto sema_tree = std::make_unique<cmsl::sema::translation_unit_node>(
+    *parsed_source.ast_tree, *parsed_source.global_context,
+    std::move(parsed_source.sema_nodes));
+  parsed_source.sema_nodes.clear();
+
+  parsed_source.completion_index =
+    std::make_unique<cmsl::tools::completion_index>(*sema_tree);
+  parsed_source.sema_tree = std::move(sema_tree);
+}
+}
+
 cmsl_parsed_source* cmsl_parse_source(
   const char* source, const char* builtin_types_documentation_path)
+{
+  return cmsl_parse_source_with_imports(
+    source, nullptr, builtin_types_documentation_path, nullptr, nullptr);
+}
+
+cmsl_parsed_source* cmsl_parse_source_with_imports(
+  const char* source, const char* source_path,
+  const char* builtin_types_documentation_path,
+  cmsl_import_callback import_callback, void* user_data)
 {
   auto parsed_source = new cmsl_parsed_source;
   parsed_source->source = source;
+  parsed_source->source_path = source_path != nullptr ? source_path : "";
+  parsed_source->import_callback = import_callback;
+  parsed_source->import_user_data = user_data;
+  parsed_source->context.errors_observer =
+    cmsl::errors::errors_observer{ [parsed_source](const auto& err) {
+      add_diagnostic(*parsed_source, err);
+    } };
+  parsed_source->imports_handler =
+    std::make_unique<cmsl::tools::source_import_handler>(*parsed_source);
   parsed_source->add_subdirectory_handler =
     std::make_unique<cmsl::sema::details::add_subdir_handler>();
   parsed_source->add_declarative_file_handler =
@@ -54,59 +289,79 @@ cmsl_parsed_source* cmsl_parse_source(
   parsed_source->strings_container =
     std::make_unique<cmsl::strings_container_impl>();
 
-  auto builtin_documentation_path = builtin_types_documentation_path != nullptr
+  const auto builtin_documentation_path =
+    builtin_types_documentation_path != nullptr
     ? std::string{ builtin_types_documentation_path }
     : std::string{};
-  parsed_source->builtin_token_provider =
-    std::make_unique<cmsl::sema::builtin_token_provider>(
-      std::move(builtin_documentation_path));
+  const auto& builtin_environment =
+    cmsl::sema::builtin_sema_environment::shared(builtin_documentation_path);
+  parsed_source->builtin_environment = &builtin_environment;
+  parsed_source->builtin_token_provider = &builtin_environment.tokens();
+  parsed_source->builtin_context = &builtin_environment.context();
 
-  cmsl::source_view source_view{ parsed_source->source };
+  const auto source_view = view_of(*parsed_source);
+  parsed_source->source_registration =
+    cmsl::source_files::registration{ source_view };
 
-  cmsl::lexer::lexer lex{ parsed_source->context.errors_observer,
-                          source_view };
-  const auto tokens = lex.lex();
-  cmsl::ast::parser parser{ parsed_source->context.errors_observer,
-                            *parsed_source->strings_container, source_view,
-                            tokens };
-  auto ast_tree = parser.parse_translation_unit();
+  cmsl::lexer::lexer lex{ parsed_source->context.errors_observer, source_view,
+                          parsed_source->source_registration.id() };
+  parsed_source->tokens = lex.lex();
+  parsed_source->lexer_diagnostics_count = parsed_source->diagnostics.size();
 
-  cmsl::sema::identifiers_context_impl ids_ctx;
-  cmsl::sema::enum_values_context_impl enums_context;
-  cmsl::sema::qualified_contextes_refs qualified_ctxs{
-    enums_context, parsed_source->context.functions_ctx, ids_ctx,
-    parsed_source->context.types_ctx
-  };
+  builtin_environment.add_builtins_to(parsed_source->qualified_ctxs,
+                                      parsed_source->context.errors_observer);
+
+  parsed_source->global_context =
+    &parsed_source->context.factories.context_factory().create(
+      "", parsed_source->builtin_context);
+
+  parsed_source->parse_states.emplace_back();
+  parsed_source->sema_states.emplace_back(make_sema_state(*parsed_source));
+  build_declarations(*parsed_source, 0u);
 
-  auto builtin_ctx = std::make_unique<cmsl::sema::builtin_sema_context>(
-    parsed_source->context.factories, parsed_source->context.errors_observer,
-    *(parsed_source->builtin_token_provider), qualified_ctxs);
+  return parsed_source;
+}
 
-  auto builtin_types = builtin_ctx->builtin_types();
+void cmsl_reparse(cmsl_parsed_source* parsed_source,
+                  const cmsl_source_edit* edits, unsigned num_edits)
+{
+  detach_declarations(*parsed_source);
 
-  parsed_source->builtin_context = std::move(builtin_ctx);
+  auto source = parsed_source->source;
+  for (auto i = 0u; i < num_edits; ++i) {
+    const auto& edit = edits[i];
+    const auto end = std::min<std::size_t>(edit.end_pos, source.size());
+    const auto begin = std::min<std::size_t>(edit.begin_pos, end);
+    source.replace(begin, end - begin,
+                   edit.text != nullptr ? edit.text : "");
+  }
 
-  auto& global_context =
-    parsed_source->context.factories.context_factory().create(
-      "", parsed_source->builtin_context.get());
-  cmsl::sema::sema_builder sema_builder{
-    global_context,
-    parsed_source->context.errors_observer,
-    qualified_ctxs,
-    parsed_source->context.factories,
-    *parsed_source->add_subdirectory_handler,
-    *parsed_source->add_declarative_file_handler,
-    *parsed_source->imports_handler,
-    *(parsed_source->builtin_token_provider),
-    builtin_types
-  };
+  const auto old_source =
+    std::exchange(parsed_source->source, std::move(source));
+  cmsl::source_files::replace(parsed_source->source_registration.id(),
+                              view_of(*parsed_source));
 
-  auto sema_tree = sema_builder.build(*ast_tree);
+  // Errors of declarations that are built again are reported again. Lexer
+  // reports errors only for the text it lexes, so if there were any, whole
+  // source is lexed again.
+  const auto relex_all = parsed_source->lexer_diagnostics_count > 0u;
+  parsed_source->diagnostics.clear();
+  const auto kept_tokens =
+    relex(*parsed_source, relex_all ? std::string{} : old_source);
+  parsed_source->lexer_diagnostics_count = parsed_source->diagnostics.size();
 
-  parsed_source->ast_tree = std::move(ast_tree);
-  parsed_source->sema_tree = std::move(sema_tree);
+  // Parser may look at the token that follows a declaration, so it has to be
+  // kept, too.
+  const auto& parse_states = parsed_source->parse_states;
+  const auto reusable_count = std::min(parsed_source->ast_nodes.size(),
+                                       parsed_source->sema_nodes.size());
+  auto kept_count = std::size_t{ 0u };
+  while (kept_count < reusable_count &&
+         parse_states[kept_count + 1u].tokens_count < kept_tokens) {
+    ++kept_count;
+  }
 
-  return parsed_source;
+  build_declarations(*parsed_source, kept_count);
 }
 
 void cmsl_destroy_parsed_source(cmsl_parsed_source* parsed_source)
@@ -11,6 +11,36 @@ struct cmsl_parsed_source* cmsl_parse_source(
   const char* source, const char* builtin_types_documentation_path);
 void cmsl_destroy_parsed_source(struct cmsl_parsed_source* parsed_source);
 
+// Called when a source imports another one. Returns the imported source,
+// or null if it can't be imported. The returned source must not be reparsed
+// nor destroyed while the importing one exists.
+typedef const struct cmsl_parsed_source* (*cmsl_import_callback)(
+  const char* import_path, void* user_data);
+
+// Same as cmsl_parse_source(), but imports are resolved with the callback.
+// Source path is reported in index entries of stuff declared in this source.
+struct cmsl_parsed_source* cmsl_parse_source_with_imports(
+  const char* source, const char* source_path,
+  const char* builtin_types_documentation_path,
+  cmsl_import_callback import_callback, void* user_data);
+
+struct cmsl_source_edit
+{
+  // Replaced range, in absolute positions of the source as it is before the
+  // edit.
+  unsigned begin_pos;
+  unsigned end_pos;
+  // Text that replaces the range.
+  const char* text;
+};
+
+// Applies the edits to the source, one after another, and parses it again.
+// Declarations that precede the first changed one are not parsed again.
+// Results are the same as of cmsl_parse_source() called with the edited
+// source.
+void cmsl_reparse(struct cmsl_parsed_source* parsed_source,
+                  const struct cmsl_source_edit* edits, unsigned num_edits);
+
 #ifdef __cplusplus
 }
 #endif
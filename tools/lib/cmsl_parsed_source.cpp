@@ -1,7 +1,8 @@
 #include "cmsl_parsed_source.hpp"
 
 #include "ast/ast_node.hpp"
-#include "common/strings_container.hpp"
+#include "common/strings_container_impl.hpp"
+#include "completion_index.hpp"
 #include "sema/add_declarative_file_semantic_handler.hpp"
 #include "sema/add_subdirectory_semantic_handler.hpp"
 #include "sema/builtin_token_provider.hpp"
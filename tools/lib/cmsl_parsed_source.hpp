@@ -1,21 +1,37 @@
 #pragma once
 
+#include "cmsl_parse_source.hpp"
+
+#include "common/source_files.hpp"
+#include "errors/error.hpp"
+#include "lexer/token.hpp"
 #include "sema/builtin_types_accessor.hpp"
+#include "sema/enum_values_context.hpp"
+#include "sema/factories_provider.hpp"
+#include "sema/identifiers_context.hpp"
 #include "sema/import_handler.hpp"
+#include "sema/qualified_contextes_refs.hpp"
+#include "sema/sema_context_impl.hpp"
 #include "sema/sema_node.hpp"
 #include "sema/sema_tree_building_context.hpp"
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace cmsl {
-class strings_container;
+class strings_container_impl;
 
 namespace sema {
 class add_declarative_file_semantic_handler;
 class add_subdirectory_semantic_handler;
+class builtin_sema_environment;
 class builtin_token_provider;
 }
+
+namespace tools {
+class completion_index;
+}
 }
 
 struct cmsl_parsed_source
@@ -23,7 +39,9 @@ struct cmsl_parsed_source
   ~cmsl_parsed_source();
 
   std::string source;
-  std::unique_ptr<cmsl::sema::builtin_token_provider> builtin_token_provider;
+  // Builtin stuff is shared by all parsed sources.
+  const cmsl::sema::builtin_sema_environment* builtin_environment{ nullptr };
+  const cmsl::sema::builtin_token_provider* builtin_token_provider{ nullptr };
   cmsl::sema::sema_tree_building_context context;
   std::unique_ptr<cmsl::sema::add_subdirectory_semantic_handler>
     add_subdirectory_handler;
@@ -32,6 +50,61 @@ struct cmsl_parsed_source
   std::unique_ptr<cmsl::sema::import_handler> imports_handler;
   std::unique_ptr<cmsl::ast::ast_node> ast_tree;
   std::unique_ptr<cmsl::sema::sema_node> sema_tree;
-  std::unique_ptr<cmsl::sema::sema_context> builtin_context;
-  std::unique_ptr<cmsl::strings_container> strings_container;
+  const cmsl::sema::sema_context* builtin_context{ nullptr };
+  // Built together with the sema tree.
+  std::unique_ptr<cmsl::tools::completion_index> completion_index;
+  std::unique_ptr<cmsl::strings_container_impl> strings_container;
+
+  std::string source_path;
+  cmsl_import_callback import_callback{ nullptr };
+  void* import_user_data{ nullptr };
+  // Collected when the source is imported for the first time after a parse.
+  mutable std::unique_ptr<cmsl::sema::qualified_contextes> exported_contextes;
+
+  struct diagnostic
+  {
+    unsigned begin_pos;
+    unsigned end_pos;
+    cmsl::errors::error_type type;
+    std::string source_path;
+    std::string message;
+  };
+  // Reported by the last parse or reparse. Ones reported by the lexer come
+  // first.
+  std::vector<diagnostic> diagnostics;
+  std::size_t lexer_diagnostics_count{ 0u };
+
+  // Top level declarations are parsed and built one by one, and the state
+  // after each of them is kept, so cmsl_reparse() can start from the first
+  // declaration, that an edit touches.
+  struct parse_state
+  {
+    std::size_t tokens_count{ 0u };
+    std::size_t strings_count{ 0u };
+  };
+  struct sema_state
+  {
+    cmsl::sema::qualified_contextes_refs::checkpoint contextes;
+    cmsl::sema::sema_context_impl::checkpoint global_context;
+    cmsl::sema::factories_provider::checkpoint factories;
+  };
+
+  // Removes the source from source_files when the parsed source is destroyed.
+  cmsl::source_files::registration source_registration;
+  cmsl::lexer::token_container_t tokens;
+  cmsl::sema::identifiers_context_impl ids_ctx;
+  cmsl::sema::enum_values_context_impl enums_ctx;
+  cmsl::sema::qualified_contextes_refs qualified_ctxs{
+    enums_ctx, context.functions_ctx, ids_ctx, context.types_ctx
+  };
+  cmsl::sema::sema_context_impl* global_context{ nullptr };
+
+  // State after the first i declarations is kept at index i.
+  std::vector<parse_state> parse_states;
+  std::vector<sema_state> sema_states;
+
+  // Declarations that are not owned by trees, e.g. because the source
+  // doesn't parse.
+  std::vector<std::unique_ptr<cmsl::ast::ast_node>> ast_nodes;
+  std::vector<std::unique_ptr<cmsl::sema::sema_node>> sema_nodes;
 };
@@ -0,0 +1,109 @@
+#include "cmsl_project_index.hpp"
+
+#include "project_index.hpp"
+#include "project_indexer.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+struct cmsl_project_index
+{
+  cmsl::tools::project_index index;
+  std::string database_path;
+  std::unique_ptr<cmsl::tools::project_indexer> indexer;
+  unsigned indexed_files_count{ 0u };
+};
+
+struct cmsl_project_index* cmsl_index_project(
+  const char* root_script_path, const char* builtin_types_documentation_path,
+  const char* database_path, unsigned threads_count)
+{
+  auto project_index = new cmsl_project_index;
+  project_index->indexer = std::make_unique<cmsl::tools::project_indexer>(
+    project_index->index, root_script_path,
+    builtin_types_documentation_path != nullptr
+      ? builtin_types_documentation_path
+      : "",
+    threads_count);
+
+  if (database_path != nullptr) {
+    project_index->database_path = database_path;
+    // Indexed from scratch if the database doesn't exist or is not valid.
+    project_index->index.load(project_index->database_path);
+  }
+
+  cmsl_refresh_project_index(project_index);
+  return project_index;
+}
+
+void cmsl_destroy_project_index(struct cmsl_project_index* project_index)
+{
+  delete project_index;
+}
+
+unsigned cmsl_refresh_project_index(struct cmsl_project_index* project_index)
+{
+  project_index->indexed_files_count = project_index->indexer->refresh();
+
+  if (!project_index->database_path.empty() &&
+      project_index->indexed_files_count > 0u) {
+    project_index->index.store(project_index->database_path);
+  }
+
+  return project_index->indexed_files_count;
+}
+
+struct cmsl_project_index_stats cmsl_get_project_index_stats(
+  const struct cmsl_project_index* project_index)
+{
+  const auto& index = project_index->index;
+  return cmsl_project_index_stats{
+    static_cast<unsigned>(index.files().size()),
+    project_index->indexed_files_count,
+    static_cast<unsigned>(index.references_count())
+  };
+}
+
+struct cmsl_references* cmsl_find_references(
+  const struct cmsl_project_index* project_index, const char* source_path,
+  unsigned position)
+{
+  const auto& index = project_index->index;
+  const auto path_id =
+    index.find_string(cmsl::tools::normalized_path(source_path));
+  if (!path_id) {
+    return nullptr;
+  }
+
+  std::vector<cmsl::tools::project_index::reference> found;
+  const auto file = index.find_file(*path_id);
+  const auto entry = file != nullptr ? index.entry_at(*file, position)
+                                     : nullptr;
+  if (entry != nullptr) {
+    found = index.references_to(entry->destination_path,
+                                entry->destination_position);
+  } else {
+    found = index.references_to_declaration_at(*path_id, position);
+  }
+
+  auto references = new cmsl_references;
+  references->num_references = found.size();
+  references->references = new cmsl_reference[found.size()];
+
+  for (auto i = 0u; i < found.size(); ++i) {
+    const auto& ref_entry = *found[i].source_entry;
+    references->references[i] = cmsl_reference{
+      index.string_of(found[i].source->path).c_str(), ref_entry.begin_pos,
+      ref_entry.end_pos, static_cast<cmsl_index_entry_type>(ref_entry.type)
+    };
+  }
+
+  return references;
+}
+
+void cmsl_destroy_references(struct cmsl_references* references)
+{
+  delete[] references->references;
+  delete references;
+}
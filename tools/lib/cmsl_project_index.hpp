@@ -0,0 +1,66 @@
+#ifndef CMSL_PROJECT_INDEX_HPP
+#define CMSL_PROJECT_INDEX_HPP
+
+#include "cmsl_index.hpp"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+struct cmsl_project_index;
+
+// Indexes scripts reachable from the root script: the root, modules it
+// imports and scripts of its subdirectories, recursively. Imports are
+// resolved relatively to the directory of the root script.
+//
+// If database_path is not null, the index is loaded from there, files that
+// have not changed since are not indexed again, and the index is stored
+// back. Zero threads count means a thread per core.
+struct cmsl_project_index* cmsl_index_project(
+  const char* root_script_path, const char* builtin_types_documentation_path,
+  const char* database_path, unsigned threads_count);
+void cmsl_destroy_project_index(struct cmsl_project_index* project_index);
+
+// Indexes again files that have changed on disk. Stores the index, if it
+// has a database. Returns count of files that have been indexed again.
+unsigned cmsl_refresh_project_index(struct cmsl_project_index* project_index);
+
+struct cmsl_project_index_stats
+{
+  unsigned num_files;
+  // By the last refresh.
+  unsigned num_indexed_files;
+  unsigned num_references;
+};
+
+struct cmsl_project_index_stats cmsl_get_project_index_stats(
+  const struct cmsl_project_index* project_index);
+
+struct cmsl_reference
+{
+  // Points to the interned path, owned by the project index.
+  const char* source_path;
+  unsigned begin_pos;
+  unsigned end_pos;
+  enum cmsl_index_entry_type type;
+};
+
+struct cmsl_references
+{
+  struct cmsl_reference* references;
+  unsigned num_references;
+};
+
+// References, in all indexed files, to the stuff that is referred to at the
+// position, or that is declared there. Null if the source has not been
+// indexed. Paths of references are valid as long as the project index is not
+// refreshed or destroyed.
+struct cmsl_references* cmsl_find_references(
+  const struct cmsl_project_index* project_index, const char* source_path,
+  unsigned position);
+void cmsl_destroy_references(struct cmsl_references* references);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CMSL_PROJECT_INDEX_HPP
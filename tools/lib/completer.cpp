@@ -1,7 +1,7 @@
 #include "completer.hpp"
 #include "cmsl_complete.hpp"
 #include "cmsl_parsed_source.hpp"
-#include "completion_context_finder.hpp"
+#include "completion_index.hpp"
 #include "completion_contextes_visitor.hpp"
 
 namespace cmsl::tools {
@@ -14,9 +14,12 @@ completer::completer(const cmsl_parsed_source& parsed_source,
 
 cmsl_complete_results* completer::complete()
 {
-  auto finder = completion_context_finder{ m_absolute_position };
-  m_parsed_source.sema_tree->visit(finder);
-  const auto found_context = finder.result();
+  if (!m_parsed_source.completion_index) {
+    return nullptr;
+  }
+
+  const auto found_context =
+    m_parsed_source.completion_index->find(m_absolute_position);
 
   if (std::holds_alternative<could_not_find_context>(found_context)) {
     return nullptr;
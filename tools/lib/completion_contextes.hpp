@@ -15,6 +15,8 @@ struct standalone_expression_context
 {
   std::reference_wrapper<const sema::sema_node> node;
   unsigned place;
+  // Place of the top level declaration, that contains the node.
+  unsigned top_level_place;
 };
 
 struct top_level_declaration_context
@@ -26,6 +28,7 @@ struct top_level_declaration_context
 struct class_member_declaration_context
 {
   std::reference_wrapper<const sema::class_node> node;
+  unsigned top_level_place;
 };
 
 struct could_not_find_context
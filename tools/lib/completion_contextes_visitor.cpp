@@ -1,6 +1,7 @@
 #include "completion_contextes_visitor.hpp"
 #include "cmsl_complete.hpp"
 #include "completer.hpp"
+#include "completion_index.hpp"
 #include "identifier_names_collector.hpp"
 #include "type_names_collector.hpp"
 
@@ -24,11 +25,13 @@ void completion_contextes_visitor::operator()(
         dynamic_cast<const sema::block_node*>(&ctx.node.get())) {
     add_standalone_expression_keywords();
 
-    const auto type_names =
-      type_names_collector{}.collect(*m_parsed_source.builtin_context, *block);
+    const auto& index = *m_parsed_source.completion_index;
+    const auto type_names = type_names_collector{}.collect(
+      *m_parsed_source.builtin_context, index, ctx.top_level_place);
     add_results(type_names);
 
-    const auto identifiers = identifier_names_collector{}.collect(*block);
+    const auto identifiers = identifier_names_collector{}.collect(
+      index, *block, ctx.top_level_place);
     add_results(identifiers);
   }
 }
@@ -38,8 +41,12 @@ void completion_contextes_visitor::operator()(
 {
   add_top_level_declaration_keywords();
 
-  const auto type_names =
-    type_names_collector{}.collect(*m_parsed_source.builtin_context, ctx.node);
+  // Classes of the whole translation unit.
+  const auto top_level_count =
+    static_cast<unsigned>(ctx.node.get().nodes().size());
+  const auto type_names = type_names_collector{}.collect(
+    *m_parsed_source.builtin_context, *m_parsed_source.completion_index,
+    top_level_count);
   add_results(type_names);
 }
 
@@ -51,8 +58,9 @@ void completion_contextes_visitor::operator()(
 
   m_intermediate_results.emplace_back(ctx.node.get().name().str());
 
-  const auto type_names =
-    type_names_collector{}.collect(*m_parsed_source.builtin_context, ctx.node);
+  const auto type_names = type_names_collector{}.collect(
+    *m_parsed_source.builtin_context, *m_parsed_source.completion_index,
+    ctx.top_level_place);
   add_results(type_names);
 }
 
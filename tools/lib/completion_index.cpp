@@ -0,0 +1,203 @@
+#include "completion_index.hpp"
+
+#include "common/source_location.hpp"
+#include "sema/sema_nodes.hpp"
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+
+namespace cmsl::tools {
+completion_index::completion_index(
+  const sema::translation_unit_node& translation_unit)
+{
+  m_entries.emplace_back(make_entry(translation_unit));
+  m_entries.back().kind = node_kind::translation_unit;
+  add_children(0u, translation_unit.nodes());
+  add_top_level_names(translation_unit);
+}
+
+completion_index::entry completion_index::make_entry(
+  const sema::sema_node& node)
+{
+  auto kind = node_kind::other;
+  if (dynamic_cast<const sema::block_node*>(&node)) {
+    kind = node_kind::block;
+  } else if (dynamic_cast<const sema::function_node*>(&node)) {
+    kind = node_kind::function;
+  } else if (dynamic_cast<const sema::class_node*>(&node)) {
+    kind = node_kind::class_;
+  }
+
+  return entry{ &node, kind, node.begin_location().absolute,
+                node.end_location().absolute };
+}
+
+template <typename Nodes>
+void completion_index::add_children(unsigned parent, const Nodes& nodes)
+{
+  const auto first_child = static_cast<unsigned>(m_entries.size());
+  m_entries[parent].first_child = first_child;
+  m_entries[parent].children_count = static_cast<unsigned>(nodes.size());
+
+  for (const auto& node : nodes) {
+    m_entries.emplace_back(make_entry(*node));
+  }
+
+  // Entries are added while iterating, so they're accessed by index.
+  for (auto i = 0u; i < nodes.size(); ++i) {
+    const auto child = first_child + i;
+    const auto node = m_entries[child].node;
+
+    switch (m_entries[child].kind) {
+      case node_kind::function: {
+        const auto& function = static_cast<const sema::function_node&>(*node);
+        const auto body = std::array<const sema::sema_node*, 1u>{
+          &function.body()
+        };
+        add_children(child, body);
+      } break;
+      case node_kind::class_: {
+        add_children(child,
+                     static_cast<const sema::class_node&>(*node).functions());
+      } break;
+      case node_kind::block: {
+        add_children(child,
+                     static_cast<const sema::block_node&>(*node).nodes());
+      } break;
+
+      default:
+        break;
+    }
+  }
+}
+
+void completion_index::add_top_level_names(
+  const sema::translation_unit_node& translation_unit)
+{
+  auto place = 0u;
+  for (const auto& node : translation_unit.nodes()) {
+    if (const auto class_ =
+          dynamic_cast<const sema::class_node*>(node.get())) {
+      m_class_names.push_back(
+        top_level_name{ place, std::string{ class_->name().str() } });
+    } else if (const auto variable_decl =
+                 dynamic_cast<const sema::variable_declaration_node*>(
+                   node.get())) {
+      m_identifier_names.push_back(
+        top_level_name{ place, std::string{ variable_decl->name().str() } });
+    } else if (const auto function =
+                 dynamic_cast<const sema::function_node*>(node.get())) {
+      m_identifier_names.push_back(
+        top_level_name{ place,
+                        std::string{ function->signature().name.str() } });
+    }
+
+    ++place;
+  }
+}
+
+completion_context_t completion_index::find(unsigned absolute_position) const
+{
+  auto current = 0u;
+  auto top_level_place = 0u;
+
+  while (true) {
+    const auto& current_entry = m_entries[current];
+
+    switch (current_entry.kind) {
+      case node_kind::translation_unit:
+      case node_kind::block: {
+        const auto place =
+          first_child_ending_after(current_entry, absolute_position);
+
+        // Position is between two nodes, or before the first one.
+        if (place == current_entry.children_count ||
+            absolute_position <=
+              m_entries[current_entry.first_child + place].begin) {
+          if (current_entry.kind == node_kind::block) {
+            return standalone_expression_context{ *current_entry.node, place,
+                                                  top_level_place };
+          }
+
+          return top_level_declaration_context{
+            static_cast<const sema::translation_unit_node&>(
+              *current_entry.node),
+            place
+          };
+        }
+
+        if (current_entry.kind == node_kind::translation_unit) {
+          top_level_place = place;
+        }
+        current = current_entry.first_child + place;
+      } break;
+
+      case node_kind::function: {
+        // Go straight to the body.
+        current = current_entry.first_child;
+      } break;
+
+      case node_kind::class_: {
+        // For now, only member functions bodies are supported. Anywhere else
+        // in a class, a member declaration is expected.
+        const auto index =
+          first_child_ending_after(current_entry, absolute_position);
+        if (index == current_entry.children_count ||
+            absolute_position <
+              m_entries[current_entry.first_child + index].begin) {
+          return class_member_declaration_context{
+            static_cast<const sema::class_node&>(*current_entry.node),
+            top_level_place
+          };
+        }
+
+        current = current_entry.first_child + index;
+      } break;
+
+      default:
+        return could_not_find_context{};
+    }
+  }
+}
+
+unsigned completion_index::first_child_ending_after(
+  const entry& parent, unsigned absolute_position) const
+{
+  const auto begin = std::next(std::cbegin(m_entries), parent.first_child);
+  const auto end = std::next(begin, parent.children_count);
+  const auto found =
+    std::lower_bound(begin, end, absolute_position,
+                     [](const entry& child, unsigned position) {
+                       return child.end < position;
+                     });
+  return static_cast<unsigned>(std::distance(begin, found));
+}
+
+std::vector<std::string> completion_index::class_names_before(
+  unsigned place) const
+{
+  return names_before(m_class_names, place);
+}
+
+std::vector<std::string> completion_index::identifier_names_before(
+  unsigned place) const
+{
+  return names_before(m_identifier_names, place);
+}
+
+std::vector<std::string> completion_index::names_before(
+  const std::vector<top_level_name>& names, unsigned place)
+{
+  const auto end =
+    std::lower_bound(std::cbegin(names), std::cend(names), place,
+                     [](const top_level_name& name, unsigned value) {
+                       return name.place < value;
+                     });
+
+  std::vector<std::string> result;
+  std::transform(std::cbegin(names), end, std::back_inserter(result),
+                 [](const top_level_name& name) { return name.name; });
+  return result;
+}
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "completion_contextes.hpp"
+
+#include <string>
+#include <vector>
+
+namespace cmsl {
+namespace sema {
+class sema_node;
+class translation_unit_node;
+}
+
+namespace tools {
+// Source ranges of nodes, that completion can descend to, built once per
+// parse. Children of a node are stored contiguously and ordered by position,
+// so the innermost node containing a position is found by a binary search at
+// every level, instead of computing locations of all nodes on the way.
+class completion_index
+{
+public:
+  explicit completion_index(
+    const sema::translation_unit_node& translation_unit);
+
+  completion_context_t find(unsigned absolute_position) const;
+
+  // Names declared by the first `place` top level declarations.
+  std::vector<std::string> class_names_before(unsigned place) const;
+  std::vector<std::string> identifier_names_before(unsigned place) const;
+
+private:
+  enum class node_kind
+  {
+    translation_unit,
+    function,
+    class_,
+    block,
+    other
+  };
+
+  struct entry
+  {
+    const sema::sema_node* node{ nullptr };
+    node_kind kind{ node_kind::other };
+    unsigned begin{ 0u };
+    unsigned end{ 0u };
+    unsigned first_child{ 0u };
+    unsigned children_count{ 0u };
+  };
+
+  struct top_level_name
+  {
+    unsigned place;
+    std::string name;
+  };
+
+  static entry make_entry(const sema::sema_node& node);
+  template <typename Nodes>
+  void add_children(unsigned parent, const Nodes& nodes);
+  void add_top_level_names(
+    const sema::translation_unit_node& translation_unit);
+
+  unsigned first_child_ending_after(const entry& parent,
+                                    unsigned absolute_position) const;
+
+  static std::vector<std::string> names_before(
+    const std::vector<top_level_name>& names, unsigned place);
+
+private:
+  std::vector<entry> m_entries;
+  std::vector<top_level_name> m_class_names;
+  std::vector<top_level_name> m_identifier_names;
+};
+}
+}
@@ -1,4 +1,5 @@
 #include "identifier_names_collector.hpp"
+#include "completion_index.hpp"
 
 #include "sema/sema_context.hpp"
 #include "sema/sema_nodes.hpp"
@@ -57,38 +58,22 @@ public:
     }
   }
 
-  void visit(const sema::translation_unit_node& node) override
-  {
-    for (const auto& sub_node : node.nodes()) {
-      if (sub_node.get() == &m_last_node) {
-        return;
-      }
-
-      if (const auto variable_decl =
-            dynamic_cast<const sema::variable_declaration_node*>(
-              sub_node.get())) {
-        m_result.emplace(variable_decl->name().str());
-      } else if (const auto function_decl =
-                   dynamic_cast<const sema::function_node*>(sub_node.get())) {
-        m_result.emplace(function_decl->signature().name.str());
-      }
-    }
-  }
-
 private:
   const sema::sema_node& m_last_node;
   std::unordered_set<std::string>& m_result;
 };
 
 std::unordered_set<std::string> identifier_names_collector::collect(
-  const sema::sema_node& start_node) const
+  const completion_index& index, const sema::sema_node& start_node,
+  unsigned top_level_place) const
 {
   std::unordered_set<std::string> result;
 
   auto current_node = &start_node;
   auto last_node = current_node;
 
-  while (current_node != nullptr) {
+  // The root is the translation unit. Its names are taken from the index.
+  while (current_node->parent() != nullptr) {
     auto collector = identifiers_collector_visitor{ *last_node, result };
 
     current_node->visit(collector);
@@ -97,6 +82,10 @@ std::unordered_set<std::string> identifier_names_collector::collect(
     current_node = current_node->parent();
   }
 
+  for (auto& name : index.identifier_names_before(top_level_place)) {
+    result.emplace(std::move(name));
+  }
+
   return result;
 }
 }
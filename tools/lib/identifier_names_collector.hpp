@@ -6,15 +6,17 @@
 namespace cmsl {
 namespace sema {
 class sema_node;
-class sema_context;
 }
 
 namespace tools {
+class completion_index;
+
 class identifier_names_collector
 {
 public:
-  std::unordered_set<std::string> collect(
-    const sema::sema_node& start_node) const;
+  std::unordered_set<std::string> collect(const completion_index& index,
+                                          const sema::sema_node& start_node,
+                                          unsigned top_level_place) const;
 };
 }
 }
@@ -3,6 +3,11 @@
 #include "ast/infix_nodes.hpp"
 
 namespace cmsl::tools {
+indexer::indexer(entry_callback_t callback)
+  : m_callback{ std::move(callback) }
+{
+}
+
 void indexer::visit(const sema::translation_unit_node& node)
 {
   m_identifiers_context.enter_local_ctx();
@@ -230,6 +235,11 @@ const std::vector<cmsl_index_entry>& indexer::result() const
   return m_intermediate_entries;
 }
 
+const std::deque<std::string>& indexer::source_paths() const
+{
+  return m_source_paths;
+}
+
 void indexer::visit_call_node(const sema::call_node& node)
 {
   const auto& signature = node.function().signature();
@@ -283,11 +293,14 @@ void indexer::add_qualified_type_access_entries(
   };
 
   while (!namespaces.empty()) {
+    // Builtin namespaces are not declared in the source.
     const auto declaration_token =
       m_identifiers_context.declaration_token_of_ctx(namespaces);
-    add_entry(namespaces.back().name, cmsl_index_entry_type::namespace_,
-              declaration_token->source().path(),
-              declaration_token->src_range().begin.absolute);
+    if (declaration_token) {
+      add_entry(namespaces.back().name, cmsl_index_entry_type::namespace_,
+                declaration_token->source().path(),
+                declaration_token->src_range().begin.absolute);
+    }
 
     namespaces.pop_back();
   }
@@ -305,7 +318,11 @@ void indexer::add_entry(const lexer::token& entry_token,
 {
   const auto entry =
     make_entry(entry_token, type, destination_path, destination_position);
-  m_intermediate_entries.emplace_back(entry);
+  if (m_callback) {
+    m_callback(entry);
+  } else {
+    m_intermediate_entries.emplace_back(entry);
+  }
 }
 
 cmsl_index_entry indexer::make_entry(const lexer::token& entry_token,
@@ -320,14 +337,27 @@ cmsl_index_entry indexer::make_entry(const lexer::token& entry_token,
 
   entry.type = type;
 
-  entry.source_path = new char[destination_path.size() + 1u];
-  std::strcpy(entry.source_path, destination_path.data());
+  entry.source_path_index = intern_source_path(destination_path);
+  entry.source_path = m_source_paths[entry.source_path_index].c_str();
 
   entry.position = destination_position;
 
   return entry;
 }
 
+unsigned indexer::intern_source_path(string_view path)
+{
+  const auto found = m_source_path_indices.find(path);
+  if (found != std::cend(m_source_path_indices)) {
+    return found->second;
+  }
+
+  const auto index = static_cast<unsigned>(m_source_paths.size());
+  const auto& interned = m_source_paths.emplace_back(path);
+  m_source_path_indices.emplace(interned, index);
+  return index;
+}
+
 void indexer::visit(const sema::implicit_return_node&)
 {
   // Do nothing.
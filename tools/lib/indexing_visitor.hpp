@@ -12,12 +12,21 @@
 #include "cmsl_index.hpp"
 #include "cmsl_parsed_source.hpp"
 
-#include <cstring>
+#include <deque>
+#include <functional>
+#include <string>
+#include <unordered_map>
 
 namespace cmsl::tools {
 class indexer : public sema::sema_node_visitor
 {
 public:
+  using entry_callback_t = std::function<void(const cmsl_index_entry&)>;
+
+  indexer() = default;
+  // Entries are passed to the callback, instead of being collected.
+  explicit indexer(entry_callback_t callback);
+
   void visit(const sema::add_declarative_file_node& node) override;
   void visit(const sema::add_subdirectory_node& node) override;
   void visit(
@@ -60,6 +69,8 @@ public:
   void visit(const sema::while_node& node) override;
 
   const std::vector<cmsl_index_entry>& result() const;
+  // Distinct paths, that entries point to.
+  const std::deque<std::string>& source_paths() const;
 
 private:
   void visit_call_node(const sema::call_node& node);
@@ -87,8 +98,14 @@ private:
                               string_view destination_path,
                               unsigned destination_position);
 
+  unsigned intern_source_path(string_view path);
+
 private:
+  entry_callback_t m_callback;
   std::vector<cmsl_index_entry> m_intermediate_entries;
+  // Deque doesn't move its elements, so entries can point to the paths.
+  std::deque<std::string> m_source_paths;
+  std::unordered_map<string_view, unsigned> m_source_path_indices;
   sema::identifiers_context_impl m_identifiers_context;
   const sema::sema_type* expected_type{ nullptr };
 };
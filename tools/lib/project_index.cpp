@@ -0,0 +1,418 @@
+#include "project_index.hpp"
+
+#include "cmsl_index.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <tuple>
+
+namespace cmsl::tools {
+namespace {
+// Bump when the database format or the indexer output changes.
+constexpr auto database_format_version = std::uint32_t{ 1u };
+constexpr char database_magic[8] = { 'c', 'm', 's', 'l', 'i', 'd', 'x', '\0' };
+
+std::uint32_t entry_types_count()
+{
+  return static_cast<std::uint32_t>(cmsl_index_entry_type::add_subdirectory) +
+    1u;
+}
+
+template <typename T>
+void write_value(std::ostream& out, T value)
+{
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Reads values from the buffer of the whole database. Once a read fails,
+// all following ones fail, too.
+class database_reader
+{
+public:
+  explicit database_reader(cmsl::string_view buffer)
+    : m_buffer{ buffer }
+  {
+  }
+
+  template <typename T>
+  bool read(T& value)
+  {
+    if (!m_ok || m_buffer.size() - m_pos < sizeof(T)) {
+      m_ok = false;
+      return false;
+    }
+
+    std::memcpy(&value, m_buffer.data() + m_pos, sizeof(T));
+    m_pos += sizeof(T);
+    return true;
+  }
+
+  bool read_string(std::string& str)
+  {
+    std::uint32_t size;
+    if (!read(size) || m_buffer.size() - m_pos < size) {
+      m_ok = false;
+      return false;
+    }
+
+    str.assign(m_buffer.data() + m_pos, size);
+    m_pos += size;
+    return true;
+  }
+
+  bool read_magic()
+  {
+    if (m_buffer.size() < sizeof(database_magic) ||
+        std::memcmp(m_buffer.data(), database_magic,
+                    sizeof(database_magic)) != 0) {
+      m_ok = false;
+      return false;
+    }
+
+    m_pos += sizeof(database_magic);
+    return true;
+  }
+
+  // Count of values that follow, each taking at least value_size bytes.
+  bool read_count(std::uint32_t& count, std::size_t value_size)
+  {
+    if (!read(count) || (m_buffer.size() - m_pos) / value_size < count) {
+      m_ok = false;
+      return false;
+    }
+
+    return true;
+  }
+
+  bool at_end() const { return m_ok && m_pos == m_buffer.size(); }
+
+private:
+  cmsl::string_view m_buffer;
+  std::size_t m_pos{ 0u };
+  bool m_ok{ true };
+};
+}
+
+project_index::string_id_t project_index::intern(cmsl::string_view str)
+{
+  const auto [it, inserted] = m_string_ids.emplace(
+    std::string{ str }, static_cast<string_id_t>(m_strings.size()));
+  if (inserted) {
+    m_strings.emplace_back(str);
+  }
+
+  return it->second;
+}
+
+std::optional<project_index::string_id_t> project_index::find_string(
+  cmsl::string_view str) const
+{
+  const auto found = m_string_ids.find(std::string{ str });
+  if (found == std::cend(m_string_ids)) {
+    return std::nullopt;
+  }
+
+  return found->second;
+}
+
+const std::string& project_index::string_of(string_id_t id) const
+{
+  return m_strings[id];
+}
+
+const project_index::file* project_index::find_file(string_id_t path) const
+{
+  const auto found = m_files.find(path);
+  return found != std::cend(m_files) ? &found->second : nullptr;
+}
+
+project_index::file* project_index::find_file(string_id_t path)
+{
+  const auto found = m_files.find(path);
+  return found != std::end(m_files) ? &found->second : nullptr;
+}
+
+project_index::file& project_index::add_file(file f)
+{
+  const auto path = f.path;
+  auto& added = m_files[path];
+  added = std::move(f);
+  return added;
+}
+
+void project_index::keep_files(const std::unordered_set<string_id_t>& paths)
+{
+  for (auto it = std::begin(m_files); it != std::end(m_files);) {
+    it = paths.count(it->first) > 0u ? std::next(it) : m_files.erase(it);
+  }
+}
+
+const std::unordered_map<project_index::string_id_t, project_index::file>&
+project_index::files() const
+{
+  return m_files;
+}
+
+void project_index::build_references()
+{
+  m_references.clear();
+
+  for (const auto& [path, f] : m_files) {
+    for (const auto& e : f.entries) {
+      m_references.emplace_back(reference{ &f, &e });
+    }
+  }
+
+  std::sort(std::begin(m_references), std::end(m_references),
+            [](const reference& lhs, const reference& rhs) {
+              const auto& l = *lhs.source_entry;
+              const auto& r = *rhs.source_entry;
+              return std::tie(l.destination_path, l.destination_position,
+                              lhs.source->path, l.begin_pos) <
+                std::tie(r.destination_path, r.destination_position,
+                         rhs.source->path, r.begin_pos);
+            });
+}
+
+std::size_t project_index::references_count() const
+{
+  return m_references.size();
+}
+
+project_index::references_t::const_iterator project_index::first_reference_to(
+  string_id_t destination_path, std::uint32_t position) const
+{
+  return std::partition_point(
+    std::cbegin(m_references), std::cend(m_references),
+    [destination_path, position](const reference& ref) {
+      const auto& e = *ref.source_entry;
+      return std::tie(e.destination_path, e.destination_position) <
+        std::tie(destination_path, position);
+    });
+}
+
+std::vector<project_index::reference> project_index::references_to(
+  string_id_t destination_path, std::uint32_t position) const
+{
+  std::vector<reference> result;
+
+  for (auto it = first_reference_to(destination_path, position);
+       it != std::cend(m_references) &&
+       it->source_entry->destination_path == destination_path &&
+       it->source_entry->destination_position == position;
+       ++it) {
+    result.emplace_back(*it);
+  }
+
+  return result;
+}
+
+std::vector<project_index::reference>
+project_index::references_to_declaration_at(string_id_t path,
+                                            std::uint32_t position) const
+{
+  // The last reference to a declaration that starts at the position or
+  // before it.
+  auto it = first_reference_to(path, position + 1u);
+  if (it == std::cbegin(m_references)) {
+    return {};
+  }
+
+  const auto& e = *std::prev(it)->source_entry;
+  if (e.destination_path != path ||
+      position >= e.destination_position + (e.end_pos - e.begin_pos)) {
+    return {};
+  }
+
+  return references_to(path, e.destination_position);
+}
+
+const project_index::entry* project_index::entry_at(
+  const file& f, std::uint32_t position) const
+{
+  const auto found = std::partition_point(
+    std::cbegin(f.entries), std::cend(f.entries),
+    [position](const entry& e) { return e.end_pos < position; });
+  if (found == std::cend(f.entries) || found->begin_pos > position) {
+    return nullptr;
+  }
+
+  return &*found;
+}
+
+bool project_index::load(const std::string& path)
+{
+  std::ifstream in{ path, std::ios::binary };
+  if (!in) {
+    return false;
+  }
+
+  std::stringstream content;
+  content << in.rdbuf();
+  const auto buffer = content.str();
+
+  database_reader reader{ buffer };
+  std::uint32_t version, types_count, strings_count;
+  if (!reader.read_magic() || !reader.read(version) ||
+      version != database_format_version || !reader.read(types_count) ||
+      types_count != entry_types_count() ||
+      !reader.read_count(strings_count, sizeof(std::uint32_t))) {
+    return false;
+  }
+
+  std::vector<std::string> strings(strings_count);
+  for (auto& str : strings) {
+    if (!reader.read_string(str)) {
+      return false;
+    }
+  }
+
+  const auto read_id = [&reader, strings_count](string_id_t& id) {
+    return reader.read(id) && id < strings_count;
+  };
+  const auto read_ids = [&reader, &read_id](std::vector<string_id_t>& ids) {
+    std::uint32_t count;
+    if (!reader.read_count(count, sizeof(string_id_t))) {
+      return false;
+    }
+
+    ids.resize(count);
+    return std::all_of(std::begin(ids), std::end(ids), read_id);
+  };
+
+  std::uint32_t files_count;
+  if (!reader.read_count(files_count, sizeof(std::uint32_t))) {
+    return false;
+  }
+
+  std::unordered_map<string_id_t, file> files;
+  for (auto i = 0u; i < files_count; ++i) {
+    file f;
+    std::uint32_t entries_count;
+    if (!read_id(f.path) || !reader.read(f.modification_time) ||
+        !reader.read(f.size) || !reader.read(f.hash) ||
+        !read_ids(f.imports) || !read_ids(f.subdirectories) ||
+        !reader.read_count(entries_count, sizeof(entry))) {
+      return false;
+    }
+
+    f.entries.resize(entries_count);
+    for (auto& e : f.entries) {
+      if (!reader.read(e.begin_pos) || !reader.read(e.end_pos) ||
+          !reader.read(e.type) || e.type >= types_count ||
+          !read_id(e.destination_path) ||
+          !reader.read(e.destination_position)) {
+        return false;
+      }
+    }
+
+    const auto f_path = f.path;
+    files[f_path] = std::move(f);
+  }
+
+  if (!reader.at_end()) {
+    return false;
+  }
+
+  m_strings = std::move(strings);
+  m_string_ids.clear();
+  for (auto i = 0u; i < m_strings.size(); ++i) {
+    m_string_ids.emplace(m_strings[i], i);
+  }
+  m_files = std::move(files);
+  build_references();
+  return true;
+}
+
+bool project_index::store(const std::string& path) const
+{
+  // Only strings that are still in use are stored.
+  std::unordered_map<string_id_t, string_id_t> new_ids;
+  std::vector<string_id_t> stored_strings;
+  const auto new_id = [&new_ids, &stored_strings](string_id_t id) {
+    const auto [it, inserted] =
+      new_ids.emplace(id, static_cast<string_id_t>(stored_strings.size()));
+    if (inserted) {
+      stored_strings.emplace_back(id);
+    }
+    return it->second;
+  };
+
+  for (const auto& [f_path, f] : m_files) {
+    new_id(f_path);
+    std::for_each(std::cbegin(f.imports), std::cend(f.imports), new_id);
+    std::for_each(std::cbegin(f.subdirectories), std::cend(f.subdirectories),
+                  new_id);
+    for (const auto& e : f.entries) {
+      new_id(e.destination_path);
+    }
+  }
+
+  // Write to a temporary file first, so other processes never see a partially
+  // written database.
+  const auto tmp_path =
+    path + ".tmp." + std::to_string(std::random_device{}());
+
+  {
+    std::ofstream out{ tmp_path, std::ios::binary | std::ios::trunc };
+    if (!out) {
+      return false;
+    }
+
+    out.write(database_magic, sizeof(database_magic));
+    write_value(out, database_format_version);
+    write_value(out, entry_types_count());
+
+    write_value(out, static_cast<std::uint32_t>(stored_strings.size()));
+    for (const auto id : stored_strings) {
+      const auto& str = m_strings[id];
+      write_value(out, static_cast<std::uint32_t>(str.size()));
+      out.write(str.data(), str.size());
+    }
+
+    const auto write_ids = [&out, &new_ids](const auto& ids) {
+      write_value(out, static_cast<std::uint32_t>(ids.size()));
+      for (const auto id : ids) {
+        write_value(out, new_ids[id]);
+      }
+    };
+
+    write_value(out, static_cast<std::uint32_t>(m_files.size()));
+    for (const auto& [f_path, f] : m_files) {
+      write_value(out, new_ids[f_path]);
+      write_value(out, f.modification_time);
+      write_value(out, f.size);
+      write_value(out, f.hash);
+      write_ids(f.imports);
+      write_ids(f.subdirectories);
+
+      write_value(out, static_cast<std::uint32_t>(f.entries.size()));
+      for (const auto& e : f.entries) {
+        write_value(out, e.begin_pos);
+        write_value(out, e.end_pos);
+        write_value(out, e.type);
+        write_value(out, new_ids[e.destination_path]);
+        write_value(out, e.destination_position);
+      }
+    }
+
+    if (!out) {
+      out.close();
+      std::remove(tmp_path.c_str());
+      return false;
+    }
+  }
+
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+    return false;
+  }
+
+  return true;
+}
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "common/string.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace cmsl::tools {
+// Index entries of all scripts of a project. Paths are interned and referred
+// to by ids. Can be stored to, and loaded from, a database file.
+//
+// The database starts with a header, followed by the strings table and then
+// by files. Strings are prefixed with their lengths, everything else is made
+// of fixed size 32 and 64 bit values, so the whole database is read at once
+// and decoded in place.
+class project_index
+{
+public:
+  using string_id_t = std::uint32_t;
+
+  struct entry
+  {
+    std::uint32_t begin_pos;
+    std::uint32_t end_pos;
+    std::uint32_t type;
+    string_id_t destination_path;
+    std::uint32_t destination_position;
+  };
+
+  struct file
+  {
+    string_id_t path;
+    std::uint64_t modification_time{ 0u };
+    std::uint64_t size{ 0u };
+    std::uint64_t hash{ 0u };
+    // Paths of imported modules.
+    std::vector<string_id_t> imports;
+    // Paths of directories added with add_subdirectory().
+    std::vector<string_id_t> subdirectories;
+    // Sorted by begin_pos.
+    std::vector<entry> entries;
+  };
+
+  struct reference
+  {
+    const file* source;
+    const entry* source_entry;
+  };
+
+  string_id_t intern(cmsl::string_view str);
+  std::optional<string_id_t> find_string(cmsl::string_view str) const;
+  const std::string& string_of(string_id_t id) const;
+
+  const file* find_file(string_id_t path) const;
+  file* find_file(string_id_t path);
+  // Replaces the file with the same path, if there is one.
+  file& add_file(file f);
+  // Removes files that are not in the given paths.
+  void keep_files(const std::unordered_set<string_id_t>& paths);
+  const std::unordered_map<string_id_t, file>& files() const;
+
+  // Has to be called after files are modified, before references are looked
+  // up.
+  void build_references();
+  std::size_t references_count() const;
+
+  // References to the stuff declared at the position.
+  std::vector<reference> references_to(string_id_t destination_path,
+                                       std::uint32_t position) const;
+  // References to the stuff declared at a token that contains the position.
+  // Lengths of the references are taken as the length of the declaration.
+  std::vector<reference> references_to_declaration_at(
+    string_id_t path, std::uint32_t position) const;
+
+  // An entry of the file, that contains the position.
+  const entry* entry_at(const file& f, std::uint32_t position) const;
+
+  bool load(const std::string& path);
+  bool store(const std::string& path) const;
+
+private:
+  using references_t = std::vector<reference>;
+  references_t::const_iterator first_reference_to(
+    string_id_t destination_path, std::uint32_t position) const;
+
+private:
+  std::vector<std::string> m_strings;
+  std::unordered_map<std::string, string_id_t> m_string_ids;
+  std::unordered_map<string_id_t, file> m_files;
+  // Sorted by destination.
+  references_t m_references;
+};
+}
@@ -0,0 +1,478 @@
+#include "project_indexer.hpp"
+#include "cmsl_index.hpp"
+#include "cmsl_parse_source.hpp"
+#include "cmsl_parsed_source.hpp"
+#include "source_import_handler.hpp"
+
+#include "common/source_view.hpp"
+#include "errors/errors_observer.hpp"
+#include "lexer/lexer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <unordered_set>
+
+namespace cmsl::tools {
+namespace {
+namespace fs = std::filesystem;
+
+std::uint64_t hash_source(cmsl::string_view source)
+{
+  // FNV-1a, same as the compilation cache.
+  auto hash = std::uint64_t{ 14695981039346656037ull };
+  for (const auto c : source) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= std::uint64_t{ 1099511628211ull };
+  }
+  return hash;
+}
+
+std::string string_literal_value(const lexer::token& token)
+{
+  // Token contains the quotation marks.
+  const auto str = token.str();
+  return std::string{ str.substr(1u, str.size() - 2u) };
+}
+
+bool is_declarative(const std::string& path)
+{
+  return fs::path{ path }.extension() == ".dcmsl";
+}
+
+// Calls function for every index from 0 to count, on up to threads_count
+// threads, including the calling one.
+template <typename Function>
+void run_parallel(std::size_t count, unsigned threads_count,
+                  const Function& function)
+{
+  std::atomic<std::size_t> next{ 0u };
+  const auto work = [&next, count, &function] {
+    for (auto i = next++; i < count; i = next++) {
+      function(i);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  const auto additional_threads_count =
+    std::min<std::size_t>(threads_count, count);
+  for (auto i = 1u; i < additional_threads_count; ++i) {
+    threads.emplace_back(work);
+  }
+
+  work();
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+struct import_context
+{
+  project_indexer* indexer;
+  unsigned importer_level;
+};
+}
+
+std::string normalized_path(const std::filesystem::path& path)
+{
+  std::error_code ec;
+  const auto absolute = fs::absolute(path, ec);
+  return (ec ? path : absolute).lexically_normal().string();
+}
+
+project_indexer::project_indexer(project_index& index,
+                                 std::string root_script_path,
+                                 std::string builtin_documentation_path,
+                                 unsigned threads_count)
+  : m_index{ index }
+  , m_root_script_path{ normalized_path(root_script_path) }
+  , m_imports_root_dir{ fs::path{ m_root_script_path }.parent_path().string() }
+  , m_builtin_documentation_path{ std::move(builtin_documentation_path) }
+  , m_threads_count{ threads_count > 0u
+                       ? threads_count
+                       : std::max(std::thread::hardware_concurrency(), 1u) }
+{
+}
+
+unsigned project_indexer::refresh()
+{
+  m_sources.clear();
+  m_source_indices.clear();
+
+  discover();
+  find_sources_to_index();
+
+  auto max_level = 0u;
+  for (auto& s : m_sources) {
+    if (s.needs_parsing) {
+      max_level = std::max(max_level, level_of(s));
+    }
+  }
+
+  for (auto level = 0u; level <= max_level; ++level) {
+    std::vector<source*> to_parse;
+    for (auto& s : m_sources) {
+      if (s.needs_parsing && s.level == level) {
+        to_parse.emplace_back(&s);
+      }
+    }
+
+    run_parallel(to_parse.size(), m_threads_count,
+                 [this, &to_parse](auto i) { parse_and_index(*to_parse[i]); });
+  }
+
+  destroy_parsed_sources();
+  update_index();
+
+  return static_cast<unsigned>(std::count_if(
+    std::cbegin(m_sources), std::cend(m_sources),
+    [](const source& s) { return s.exists && s.needs_indexing; }));
+}
+
+void project_indexer::discover()
+{
+  std::vector<std::string> to_discover{ m_root_script_path };
+
+  while (!to_discover.empty()) {
+    const auto first_new = m_sources.size();
+    for (auto& path : to_discover) {
+      if (m_source_indices.count(path) == 0u) {
+        m_source_indices.emplace(path, m_sources.size());
+        m_sources.emplace_back().path = std::move(path);
+      }
+    }
+    to_discover.clear();
+
+    const auto new_count = m_sources.size() - first_new;
+    run_parallel(new_count, m_threads_count, [this, first_new](auto i) {
+      scan(m_sources[first_new + i]);
+    });
+
+    for (auto i = first_new; i < m_sources.size(); ++i) {
+      const auto& s = m_sources[i];
+      to_discover.insert(std::end(to_discover), std::cbegin(s.imports),
+                         std::cend(s.imports));
+      to_discover.insert(std::end(to_discover),
+                         std::cbegin(s.subdirectory_scripts),
+                         std::cend(s.subdirectory_scripts));
+    }
+  }
+}
+
+void project_indexer::scan(source& s) const
+{
+  std::error_code ec;
+  const auto modification_time = fs::last_write_time(s.path, ec);
+  const auto size = ec ? 0u : fs::file_size(s.path, ec);
+
+  const auto path_id = m_index.find_string(s.path);
+  const auto record = path_id ? m_index.find_file(*path_id) : nullptr;
+
+  if (ec) {
+    // A file that has been removed changes its importers.
+    s.changed = record != nullptr;
+    return;
+  }
+
+  s.exists = true;
+  s.modification_time =
+    static_cast<std::uint64_t>(modification_time.time_since_epoch().count());
+  s.size = size;
+
+  const auto same_as_record = [this, &s, record] {
+    s.hash = record->hash;
+    for (const auto id : record->imports) {
+      s.imports.emplace_back(m_index.string_of(id));
+    }
+    for (const auto id : record->subdirectories) {
+      s.subdirectories.emplace_back(m_index.string_of(id));
+    }
+  };
+
+  if (record != nullptr && record->size == s.size &&
+      record->modification_time == s.modification_time) {
+    same_as_record();
+  } else {
+    s.text = read_text(s);
+    s.hash = hash_source(*s.text);
+    s.changed = record == nullptr || record->size != s.size ||
+      record->hash != s.hash;
+
+    if (!s.changed) {
+      same_as_record();
+    } else if (!is_declarative(s.path)) {
+      // Errors are reported when the source is parsed.
+      errors::errors_observer errs{ [](const auto&) {} };
+      lexer::lexer lex{ errs, source_view{ s.path, *s.text } };
+      const auto tokens = lex.lex();
+
+      using token_type_t = lexer::token_type;
+      const auto script_dir = fs::path{ s.path }.parent_path();
+      for (auto i = 0u; i + 1u < tokens.size(); ++i) {
+        const auto& token = tokens[i];
+        if (token.get_type() == token_type_t::kw_import &&
+            tokens[i + 1u].get_type() == token_type_t::string) {
+          s.imports.emplace_back(
+            import_path_of(string_literal_value(tokens[i + 1u])));
+        } else if (token.get_type() == token_type_t::identifier &&
+                   token.str() == "add_subdirectory" &&
+                   i + 2u < tokens.size() &&
+                   tokens[i + 1u].get_type() == token_type_t::open_paren &&
+                   tokens[i + 2u].get_type() == token_type_t::string) {
+          s.subdirectories.emplace_back(normalized_path(
+            script_dir / string_literal_value(tokens[i + 2u])));
+        }
+      }
+    }
+  }
+
+  // Same precedence as in global_executor::handle_add_subdirectory.
+  for (const auto& subdirectory : s.subdirectories) {
+    for (const auto name : { "CMakeLists.dcmsl", "CMakeLists.cmsl" }) {
+      auto script = normalized_path(fs::path{ subdirectory } / name);
+      if (fs::exists(script, ec)) {
+        s.subdirectory_scripts.emplace_back(std::move(script));
+        break;
+      }
+    }
+  }
+}
+
+void project_indexer::find_sources_to_index()
+{
+  std::unordered_map<std::string, std::vector<source*>> importers;
+  for (auto& s : m_sources) {
+    for (const auto& imported : s.imports) {
+      importers[imported].emplace_back(&s);
+    }
+  }
+
+  // Changed sources and their importers, direct or not, are indexed.
+  std::vector<source*> to_visit;
+  for (auto& s : m_sources) {
+    if (s.changed) {
+      to_visit.emplace_back(&s);
+    }
+  }
+
+  while (!to_visit.empty()) {
+    auto& s = *to_visit.back();
+    to_visit.pop_back();
+    if (s.needs_indexing) {
+      continue;
+    }
+
+    s.needs_indexing = true;
+    const auto found = importers.find(s.path);
+    if (found != std::cend(importers)) {
+      to_visit.insert(std::end(to_visit), std::cbegin(found->second),
+                      std::cend(found->second));
+    }
+  }
+
+  // Indexed sources and modules they import, direct or not, are parsed.
+  for (auto& s : m_sources) {
+    if (s.needs_indexing) {
+      to_visit.emplace_back(&s);
+    }
+  }
+
+  while (!to_visit.empty()) {
+    auto& s = *to_visit.back();
+    to_visit.pop_back();
+    if (s.needs_parsing || !s.exists) {
+      continue;
+    }
+
+    s.needs_parsing = true;
+    for (const auto& imported : s.imports) {
+      if (const auto found = find_source(imported)) {
+        to_visit.emplace_back(found);
+      }
+    }
+  }
+}
+
+unsigned project_indexer::level_of(source& s)
+{
+  if (s.level) {
+    return *s.level;
+  }
+
+  // Set before the imports are visited, to break import cycles. A source in
+  // a cycle sees the modules, that import it, as not found.
+  s.level = 0u;
+
+  auto level = 0u;
+  for (const auto& imported : s.imports) {
+    const auto found = find_source(imported);
+    if (found != nullptr && found->needs_parsing) {
+      level = std::max(level, level_of(*found) + 1u);
+    }
+  }
+
+  s.level = level;
+  return level;
+}
+
+void project_indexer::parse_and_index(source& s)
+{
+  if (is_declarative(s.path)) {
+    // Declarative files are not supported by the indexer.
+    return;
+  }
+
+  if (!s.text) {
+    s.text = read_text(s);
+  }
+
+  const auto builtin_documentation_path = m_builtin_documentation_path.empty()
+    ? nullptr
+    : m_builtin_documentation_path.c_str();
+  auto context = import_context{ this, *s.level };
+  s.parsed = cmsl_parse_source_with_imports(
+    s.text->c_str(), s.path.c_str(), builtin_documentation_path,
+    &project_indexer::import_source, &context);
+
+  // Collected now, so sources parsed later only read it.
+  exported_contextes_of(*s.parsed);
+
+  if (!s.needs_indexing) {
+    return;
+  }
+
+  std::unordered_map<std::string, project_index::string_id_t> path_ids;
+  auto add_entry = [&s, &path_ids](const cmsl_index_entry& entry) {
+    const auto [it, inserted] = path_ids.emplace(
+      entry.source_path,
+      static_cast<project_index::string_id_t>(s.destination_paths.size()));
+    if (inserted) {
+      s.destination_paths.emplace_back(entry.source_path);
+    }
+
+    s.entries.emplace_back(project_index::entry{
+      entry.begin_pos, entry.end_pos, static_cast<std::uint32_t>(entry.type),
+      it->second, entry.position });
+  };
+
+  cmsl_index_with_callback(
+    s.parsed,
+    [](const cmsl_index_entry* entry, void* user_data) {
+      (*static_cast<decltype(add_entry)*>(user_data))(*entry);
+    },
+    &add_entry);
+
+  std::stable_sort(std::begin(s.entries), std::end(s.entries),
+                   [](const auto& lhs, const auto& rhs) {
+                     return lhs.begin_pos < rhs.begin_pos;
+                   });
+}
+
+void project_indexer::update_index()
+{
+  std::vector<project_index::string_id_t> existing;
+
+  for (auto& s : m_sources) {
+    if (!s.exists) {
+      continue;
+    }
+
+    const auto path_id = m_index.intern(s.path);
+    existing.emplace_back(path_id);
+
+    if (!s.needs_indexing) {
+      // Content is the same, but the file could have been touched.
+      m_index.find_file(path_id)->modification_time = s.modification_time;
+      continue;
+    }
+
+    project_index::file f;
+    f.path = path_id;
+    f.modification_time = s.modification_time;
+    f.size = s.size;
+    f.hash = s.hash;
+    for (const auto& imported : s.imports) {
+      f.imports.emplace_back(m_index.intern(imported));
+    }
+    for (const auto& subdirectory : s.subdirectories) {
+      f.subdirectories.emplace_back(m_index.intern(subdirectory));
+    }
+
+    f.entries = std::move(s.entries);
+    for (auto& e : f.entries) {
+      e.destination_path =
+        m_index.intern(s.destination_paths[e.destination_path]);
+    }
+
+    m_index.add_file(std::move(f));
+  }
+
+  m_index.keep_files(
+    std::unordered_set<project_index::string_id_t>{ std::cbegin(existing),
+                                                     std::cend(existing) });
+  m_index.build_references();
+}
+
+void project_indexer::destroy_parsed_sources()
+{
+  // Importers go first, while stuff they have imported still exists.
+  std::vector<source*> parsed;
+  for (auto& s : m_sources) {
+    if (s.parsed != nullptr) {
+      parsed.emplace_back(&s);
+    }
+  }
+
+  std::sort(std::begin(parsed), std::end(parsed),
+            [](const source* lhs, const source* rhs) {
+              return *lhs->level > *rhs->level;
+            });
+
+  for (const auto s : parsed) {
+    cmsl_destroy_parsed_source(s->parsed);
+    s->parsed = nullptr;
+  }
+}
+
+project_indexer::source* project_indexer::find_source(const std::string& path)
+{
+  const auto found = m_source_indices.find(path);
+  return found != std::cend(m_source_indices) ? &m_sources[found->second]
+                                              : nullptr;
+}
+
+std::string project_indexer::read_text(const source& s) const
+{
+  std::ifstream file{ s.path, std::ios::binary };
+  return std::string(std::istreambuf_iterator<char>{ file }, {});
+}
+
+const cmsl_parsed_source* project_indexer::import_source(
+  const char* import_path, void* user_data)
+{
+  const auto& context = *static_cast<const import_context*>(user_data);
+  auto& indexer = *context.indexer;
+
+  // Only modules with lower levels have been parsed already. Others are
+  // parsed right now, on other threads, or are in an import cycle.
+  const auto imported =
+    indexer.find_source(indexer.import_path_of(import_path));
+  if (imported == nullptr || !imported->needs_parsing ||
+      *imported->level >= context.importer_level) {
+    return nullptr;
+  }
+
+  return imported->parsed;
+}
+
+std::string project_indexer::import_path_of(
+  cmsl::string_view import_path) const
+{
+  return normalized_path(fs::path{ m_imports_root_dir } /
+                         std::string{ import_path });
+}
+}
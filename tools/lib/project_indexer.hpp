@@ -0,0 +1,94 @@
+#pragma once
+
+#include "project_index.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct cmsl_parsed_source;
+
+namespace cmsl::tools {
+// Absolute and normalized path, as paths are kept in the project index.
+std::string normalized_path(const std::filesystem::path& path);
+
+// Brings a project index up to date with scripts on disk. Scripts are
+// discovered from the root one, following imports and add_subdirectory()
+// calls. A file is indexed again only if its content has changed, or stuff
+// it imports has changed. Content of a file is read only if its size or
+// modification time differ from the ones in the index.
+//
+// Work is spread on threads in two phases. First, files are read and scanned
+// for scripts they refer to, one wave of newly discovered files at a time.
+// Then they are parsed in order of imports. A module is parsed, and its
+// exported stuff collected, before sources that import it, so all sources
+// parsed at the same time only read stuff they share.
+class project_indexer
+{
+public:
+  // Imports are resolved relatively to the directory of the root script.
+  explicit project_indexer(project_index& index, std::string root_script_path,
+                           std::string builtin_documentation_path,
+                           unsigned threads_count);
+
+  // Returns count of files that have been indexed again.
+  unsigned refresh();
+
+private:
+  struct source
+  {
+    std::string path;
+    bool exists{ false };
+    std::uint64_t modification_time{ 0u };
+    std::uint64_t size{ 0u };
+    std::uint64_t hash{ 0u };
+    // Read only if it is needed.
+    std::optional<std::string> text;
+    std::vector<std::string> imports;
+    std::vector<std::string> subdirectories;
+    // Paths of scripts of the subdirectories.
+    std::vector<std::string> subdirectory_scripts;
+    bool changed{ false };
+    bool needs_indexing{ false };
+    bool needs_parsing{ false };
+    // Sources are parsed after sources they import, that have lower levels.
+    std::optional<unsigned> level;
+    cmsl_parsed_source* parsed{ nullptr };
+
+    // Result of indexing. Destination paths are interned into the index
+    // after all sources are indexed.
+    std::vector<project_index::entry> entries;
+    std::vector<std::string> destination_paths;
+  };
+
+  void discover();
+  void scan(source& s) const;
+  void find_sources_to_index();
+  unsigned level_of(source& s);
+  void parse_and_index(source& s);
+  void update_index();
+  void destroy_parsed_sources();
+
+  source* find_source(const std::string& path);
+  std::string read_text(const source& s) const;
+
+  static const cmsl_parsed_source* import_source(const char* import_path,
+                                                 void* user_data);
+  std::string import_path_of(cmsl::string_view import_path) const;
+
+private:
+  project_index& m_index;
+  const std::string m_root_script_path;
+  const std::string m_imports_root_dir;
+  const std::string m_builtin_documentation_path;
+  const unsigned m_threads_count;
+
+  // Sources are created before the work on threads starts, so slots are not
+  // moved while threads use them.
+  std::vector<source> m_sources;
+  std::unordered_map<std::string, std::size_t> m_source_indices;
+};
+}
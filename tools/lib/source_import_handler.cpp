@@ -0,0 +1,49 @@
+#include "source_import_handler.hpp"
+#include "cmsl_parsed_source.hpp"
+
+#include "sema/enum_values_context.hpp"
+#include "sema/functions_context.hpp"
+#include "sema/identifiers_context.hpp"
+#include "sema/qualified_contextes.hpp"
+#include "sema/types_context.hpp"
+
+#include <string>
+
+namespace cmsl::tools {
+const sema::qualified_contextes* exported_contextes_of(
+  const cmsl_parsed_source& parsed_source)
+{
+  if (!parsed_source.sema_tree) {
+    return nullptr;
+  }
+
+  if (!parsed_source.exported_contextes) {
+    parsed_source.exported_contextes =
+      std::make_unique<sema::qualified_contextes>(sema::qualified_contextes{
+        parsed_source.enums_ctx.collect_exported_stuff(),
+        parsed_source.context.functions_ctx.collect_exported_stuff(),
+        parsed_source.ids_ctx.collect_exported_stuff(),
+        parsed_source.context.types_ctx.collect_exported_stuff() });
+  }
+
+  return parsed_source.exported_contextes.get();
+}
+
+source_import_handler::source_import_handler(
+  const cmsl_parsed_source& importer)
+  : m_importer{ importer }
+{
+}
+
+const sema::qualified_contextes* source_import_handler::handle_import(
+  cmsl::string_view path)
+{
+  if (m_importer.import_callback == nullptr) {
+    return nullptr;
+  }
+
+  const auto imported = m_importer.import_callback(
+    std::string{ path }.c_str(), m_importer.import_user_data);
+  return imported != nullptr ? exported_contextes_of(*imported) : nullptr;
+}
+}
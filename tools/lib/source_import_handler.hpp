@@ -0,0 +1,26 @@
+#pragma once
+
+#include "sema/import_handler.hpp"
+
+struct cmsl_parsed_source;
+
+namespace cmsl::tools {
+// Exported stuff of a source, collected on the first call after a parse.
+// Null if the source has no sema tree.
+const sema::qualified_contextes* exported_contextes_of(
+  const cmsl_parsed_source& parsed_source);
+
+// Resolves imports with the callback of the importing source. Exported stuff
+// is collected once per parse of the imported source, and kept in it.
+class source_import_handler : public sema::import_handler
+{
+public:
+  explicit source_import_handler(const cmsl_parsed_source& importer);
+
+  const sema::qualified_contextes* handle_import(
+    cmsl::string_view path) override;
+
+private:
+  const cmsl_parsed_source& m_importer;
+};
+}
@@ -5,17 +5,18 @@
 
 namespace cmsl {
 namespace sema {
-class sema_node;
 class sema_context;
 }
 
 namespace tools {
+class completion_index;
+
 class type_names_collector
 {
 public:
   std::unordered_set<std::string> collect(
-    const sema::sema_context& builtin_context,
-    const sema::sema_node& start_node) const;
+    const sema::sema_context& builtin_context, const completion_index& index,
+    unsigned top_level_place) const;
 };
 }
 }
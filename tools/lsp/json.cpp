@@ -0,0 +1,514 @@
+#include "json.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace cmsl::lsp {
+namespace {
+class json_parser
+{
+public:
+  explicit json_parser(std::string_view text)
+    : m_text{ text }
+  {
+  }
+
+  std::optional<json_value> parse()
+  {
+    auto value = parse_value();
+    skip_whitespaces();
+    if (!value || m_pos != m_text.size()) {
+      return std::nullopt;
+    }
+
+    return value;
+  }
+
+private:
+  std::optional<json_value> parse_value()
+  {
+    // Protects the stack from deeply nested garbage.
+    constexpr auto max_depth = 256u;
+    if (m_depth > max_depth) {
+      return std::nullopt;
+    }
+
+    skip_whitespaces();
+    if (m_pos == m_text.size()) {
+      return std::nullopt;
+    }
+
+    switch (m_text[m_pos]) {
+      case '{':
+        return parse_object();
+      case '[':
+        return parse_array();
+      case '"': {
+        auto str = parse_string();
+        if (!str) {
+          return std::nullopt;
+        }
+        return json_value{ std::move(*str) };
+      }
+      case 't':
+        return parse_literal("true", json_value{ true });
+      case 'f':
+        return parse_literal("false", json_value{ false });
+      case 'n':
+        return parse_literal("null", json_value{});
+      default:
+        return parse_number();
+    }
+  }
+
+  std::optional<json_value> parse_object()
+  {
+    ++m_pos;
+    ++m_depth;
+    json_value::object_t object;
+
+    skip_whitespaces();
+    if (consume('}')) {
+      --m_depth;
+      return json_value{ std::move(object) };
+    }
+
+    while (true) {
+      skip_whitespaces();
+      auto key = parse_string();
+      skip_whitespaces();
+      if (!key || !consume(':')) {
+        return std::nullopt;
+      }
+
+      auto value = parse_value();
+      if (!value) {
+        return std::nullopt;
+      }
+      object[std::move(*key)] = std::move(*value);
+
+      skip_whitespaces();
+      if (consume('}')) {
+        break;
+      }
+      if (!consume(',')) {
+        return std::nullopt;
+      }
+    }
+
+    --m_depth;
+    return json_value{ std::move(object) };
+  }
+
+  std::optional<json_value> parse_array()
+  {
+    ++m_pos;
+    ++m_depth;
+    json_value::array_t array;
+
+    skip_whitespaces();
+    if (consume(']')) {
+      --m_depth;
+      return json_value{ std::move(array) };
+    }
+
+    while (true) {
+      auto value = parse_value();
+      if (!value) {
+        return std::nullopt;
+      }
+      array.emplace_back(std::move(*value));
+
+      skip_whitespaces();
+      if (consume(']')) {
+        break;
+      }
+      if (!consume(',')) {
+        return std::nullopt;
+      }
+    }
+
+    --m_depth;
+    return json_value{ std::move(array) };
+  }
+
+  std::optional<std::string> parse_string()
+  {
+    if (!consume('"')) {
+      return std::nullopt;
+    }
+
+    std::string result;
+    while (m_pos < m_text.size()) {
+      const auto c = m_text[m_pos++];
+      if (c == '"') {
+        return result;
+      }
+      if (c != '\\') {
+        result += c;
+        continue;
+      }
+
+      if (m_pos == m_text.size()) {
+        return std::nullopt;
+      }
+
+      const auto escaped = m_text[m_pos++];
+      switch (escaped) {
+        case '"':
+        case '\\':
+        case '/':
+          result += escaped;
+          break;
+        case 'b':
+          result += '\b';
+          break;
+        case 'f':
+          result += '\f';
+          break;
+        case 'n':
+          result += '\n';
+          break;
+        case 'r':
+          result += '\r';
+          break;
+        case 't':
+          result += '\t';
+          break;
+        case 'u': {
+          auto code_point = parse_hex4();
+          if (!code_point) {
+            return std::nullopt;
+          }
+
+          // Surrogate pair.
+          if (*code_point >= 0xd800u && *code_point < 0xdc00u &&
+              consume('\\') && consume('u')) {
+            const auto low = parse_hex4();
+            if (!low || *low < 0xdc00u || *low >= 0xe000u) {
+              return std::nullopt;
+            }
+            code_point =
+              0x10000u + ((*code_point - 0xd800u) << 10u) + (*low - 0xdc00u);
+          }
+
+          append_utf8(result, *code_point);
+        } break;
+        default:
+          return std::nullopt;
+      }
+    }
+
+    return std::nullopt;
+  }
+
+  std::optional<unsigned> parse_hex4()
+  {
+    if (m_text.size() - m_pos < 4u) {
+      return std::nullopt;
+    }
+
+    auto value = 0u;
+    for (auto i = 0u; i < 4u; ++i) {
+      const auto c = m_text[m_pos++];
+      value <<= 4u;
+      if (c >= '0' && c <= '9') {
+        value += static_cast<unsigned>(c - '0');
+      } else if (c >= 'a' && c <= 'f') {
+        value += static_cast<unsigned>(c - 'a' + 10);
+      } else if (c >= 'A' && c <= 'F') {
+        value += static_cast<unsigned>(c - 'A' + 10);
+      } else {
+        return std::nullopt;
+      }
+    }
+
+    return value;
+  }
+
+  static void append_utf8(std::string& out, unsigned code_point)
+  {
+    if (code_point < 0x80u) {
+      out += static_cast<char>(code_point);
+    } else if (code_point < 0x800u) {
+      out += static_cast<char>(0xc0u | (code_point >> 6u));
+      out += static_cast<char>(0x80u | (code_point & 0x3fu));
+    } else if (code_point < 0x10000u) {
+      out += static_cast<char>(0xe0u | (code_point >> 12u));
+      out += static_cast<char>(0x80u | ((code_point >> 6u) & 0x3fu));
+      out += static_cast<char>(0x80u | (code_point & 0x3fu));
+    } else {
+      out += static_cast<char>(0xf0u | (code_point >> 18u));
+      out += static_cast<char>(0x80u | ((code_point >> 12u) & 0x3fu));
+      out += static_cast<char>(0x80u | ((code_point >> 6u) & 0x3fu));
+      out += static_cast<char>(0x80u | (code_point & 0x3fu));
+    }
+  }
+
+  std::optional<json_value> parse_number()
+  {
+    const auto begin = m_pos;
+    while (m_pos < m_text.size() &&
+           std::string_view{ "+-0123456789.eE" }.find(m_text[m_pos]) !=
+             std::string_view::npos) {
+      ++m_pos;
+    }
+
+    if (begin == m_pos) {
+      return std::nullopt;
+    }
+
+    const auto number = std::string{ m_text.substr(begin, m_pos - begin) };
+    char* end = nullptr;
+    const auto value = std::strtod(number.c_str(), &end);
+    if (end != number.c_str() + number.size()) {
+      return std::nullopt;
+    }
+
+    return json_value{ value };
+  }
+
+  std::optional<json_value> parse_literal(std::string_view literal,
+                                          json_value value)
+  {
+    if (m_text.substr(m_pos, literal.size()) != literal) {
+      return std::nullopt;
+    }
+
+    m_pos += literal.size();
+    return value;
+  }
+
+  void skip_whitespaces()
+  {
+    while (m_pos < m_text.size() &&
+           (m_text[m_pos] == ' ' || m_text[m_pos] == '\t' ||
+            m_text[m_pos] == '\n' || m_text[m_pos] == '\r')) {
+      ++m_pos;
+    }
+  }
+
+  bool consume(char c)
+  {
+    if (m_pos < m_text.size() && m_text[m_pos] == c) {
+      ++m_pos;
+      return true;
+    }
+
+    return false;
+  }
+
+private:
+  std::string_view m_text;
+  std::size_t m_pos{ 0u };
+  unsigned m_depth{ 0u };
+};
+
+void dump_string(std::string& out, const std::string& str)
+{
+  out += '"';
+  for (const auto c : str) {
+    switch (c) {
+      case '"':
+        out += "\\\"";
+        break;
+      case '\\':
+        out += "\\\\";
+        break;
+      case '\n':
+        out += "\\n";
+        break;
+      case '\r':
+        out += "\\r";
+        break;
+      case '\t':
+        out += "\\t";
+        break;
+      default: {
+        if (static_cast<unsigned char>(c) < 0x20u) {
+          char escaped[8];
+          std::snprintf(escaped, sizeof(escaped), "\\u%04x",
+                        static_cast<unsigned>(c));
+          out += escaped;
+        } else {
+          out += c;
+        }
+      }
+    }
+  }
+  out += '"';
+}
+}
+
+json_value::json_value(std::nullptr_t)
+{
+}
+
+json_value::json_value(bool value)
+  : m_value{ value }
+{
+}
+
+json_value::json_value(int value)
+  : m_value{ static_cast<double>(value) }
+{
+}
+
+json_value::json_value(unsigned value)
+  : m_value{ static_cast<double>(value) }
+{
+}
+
+json_value::json_value(double value)
+  : m_value{ value }
+{
+}
+
+json_value::json_value(const char* value)
+  : m_value{ std::string{ value } }
+{
+}
+
+json_value::json_value(std::string value)
+  : m_value{ std::move(value) }
+{
+}
+
+json_value::json_value(array_t value)
+  : m_value{ std::move(value) }
+{
+}
+
+json_value::json_value(object_t value)
+  : m_value{ std::move(value) }
+{
+}
+
+bool json_value::is_null() const
+{
+  return std::holds_alternative<std::nullptr_t>(m_value);
+}
+
+bool json_value::is_object() const
+{
+  return std::holds_alternative<object_t>(m_value);
+}
+
+std::optional<bool> json_value::as_bool() const
+{
+  if (const auto value = std::get_if<bool>(&m_value)) {
+    return *value;
+  }
+
+  return std::nullopt;
+}
+
+std::optional<double> json_value::as_number() const
+{
+  if (const auto value = std::get_if<double>(&m_value)) {
+    return *value;
+  }
+
+  return std::nullopt;
+}
+
+const std::string* json_value::as_string() const
+{
+  return std::get_if<std::string>(&m_value);
+}
+
+const json_value::array_t* json_value::as_array() const
+{
+  return std::get_if<array_t>(&m_value);
+}
+
+const json_value::object_t* json_value::as_object() const
+{
+  return std::get_if<object_t>(&m_value);
+}
+
+const json_value* json_value::find(std::string_view key) const
+{
+  const auto object = as_object();
+  if (object == nullptr) {
+    return nullptr;
+  }
+
+  const auto found = object->find(key);
+  return found != std::cend(*object) ? &found->second : nullptr;
+}
+
+json_value& json_value::operator[](const std::string& key)
+{
+  if (!is_object()) {
+    m_value = object_t{};
+  }
+
+  return std::get<object_t>(m_value)[key];
+}
+
+bool json_value::operator==(const json_value& other) const
+{
+  return m_value == other.m_value;
+}
+
+bool json_value::operator!=(const json_value& other) const
+{
+  return !(*this == other);
+}
+
+std::string json_value::dump() const
+{
+  std::string out;
+  dump(out);
+  return out;
+}
+
+void json_value::dump(std::string& out) const
+{
+  if (is_null()) {
+    out += "null";
+  } else if (const auto b = std::get_if<bool>(&m_value)) {
+    out += *b ? "true" : "false";
+  } else if (const auto number = std::get_if<double>(&m_value)) {
+    double integral;
+    if (std::modf(*number, &integral) == 0.0 && std::fabs(*number) < 1e15) {
+      out += std::to_string(static_cast<long long>(*number));
+    } else {
+      char buffer[32];
+      std::snprintf(buffer, sizeof(buffer), "%.17g", *number);
+      out += buffer;
+    }
+  } else if (const auto str = std::get_if<std::string>(&m_value)) {
+    dump_string(out, *str);
+  } else if (const auto array = std::get_if<array_t>(&m_value)) {
+    out += '[';
+    for (auto i = 0u; i < array->size(); ++i) {
+      if (i > 0u) {
+        out += ',';
+      }
+      (*array)[i].dump(out);
+    }
+    out += ']';
+  } else if (const auto object = std::get_if<object_t>(&m_value)) {
+    out += '{';
+    auto first = true;
+    for (const auto& [key, value] : *object) {
+      if (!first) {
+        out += ',';
+      }
+      first = false;
+      dump_string(out, key);
+      out += ':';
+      value.dump(out);
+    }
+    out += '}';
+  }
+}
+
+std::optional<json_value> json_value::parse(std::string_view text)
+{
+  return json_parser{ text }.parse();
+}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace cmsl::lsp {
+// Just enough of JSON to speak the language server protocol.
+class json_value
+{
+public:
+  using array_t = std::vector<json_value>;
+  using object_t = std::map<std::string, json_value, std::less<>>;
+
+  json_value() = default;
+  json_value(std::nullptr_t);
+  json_value(bool value);
+  json_value(int value);
+  json_value(unsigned value);
+  json_value(double value);
+  json_value(const char* value);
+  json_value(std::string value);
+  json_value(array_t value);
+  json_value(object_t value);
+
+  bool is_null() const;
+  bool is_object() const;
+
+  std::optional<bool> as_bool() const;
+  std::optional<double> as_number() const;
+  const std::string* as_string() const;
+  const array_t* as_array() const;
+  const object_t* as_object() const;
+
+  // Null if this is not an object or there is no such member.
+  const json_value* find(std::string_view key) const;
+  // Makes this an object, if it's not already.
+  json_value& operator[](const std::string& key);
+
+  bool operator==(const json_value& other) const;
+  bool operator!=(const json_value& other) const;
+
+  std::string dump() const;
+  static std::optional<json_value> parse(std::string_view text);
+
+private:
+  void dump(std::string& out) const;
+
+private:
+  std::variant<std::nullptr_t, bool, double, std::string, array_t, object_t>
+    m_value{ nullptr };
+};
+}
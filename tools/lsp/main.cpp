@@ -0,0 +1,16 @@
+#include "server.hpp"
+
+#include <iostream>
+#include <string>
+
+// Language server for CMakeSL scripts, speaking over stdin and stdout.
+//
+// Usage: cmakesl-lsp [builtin types documentation path]
+int main(int argc, const char* argv[])
+{
+  const auto builtin_documentation_path =
+    argc > 1 ? std::string{ argv[1] } : std::string{};
+
+  cmsl::lsp::server server{ std::cout, builtin_documentation_path };
+  return server.run(std::cin);
+}
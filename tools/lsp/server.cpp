@@ -0,0 +1,618 @@
+#include "server.hpp"
+#include "text_positions.hpp"
+#include "transport.hpp"
+#include "uri.hpp"
+
+#include "lib/cmsl_complete.hpp"
+#include "lib/cmsl_diagnostics.hpp"
+#include "lib/cmsl_index.hpp"
+#include "lib/cmsl_parsed_source.hpp"
+
+#include "sema/dumper.hpp"
+#include "sema/sema_node.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <thread>
+
+namespace cmsl::lsp {
+namespace {
+namespace error_code {
+constexpr auto parse_error = -32700;
+constexpr auto invalid_request = -32600;
+constexpr auto method_not_found = -32601;
+constexpr auto server_not_initialized = -32002;
+constexpr auto request_cancelled = -32800;
+constexpr auto content_modified = -32801;
+}
+
+// Values of textDocumentSync.change.
+constexpr auto incremental_sync = 2;
+
+// Values of Diagnostic.severity.
+constexpr auto error_severity = 1;
+constexpr auto warning_severity = 2;
+constexpr auto information_severity = 3;
+
+const std::string* string_at(const json_value& value, std::string_view key)
+{
+  const auto found = value.find(key);
+  return found != nullptr ? found->as_string() : nullptr;
+}
+
+std::string document_uri_of(const json_value& params)
+{
+  const auto text_document = params.find("textDocument");
+  if (text_document == nullptr) {
+    return {};
+  }
+
+  const auto uri = string_at(*text_document, "uri");
+  return uri != nullptr ? *uri : std::string{};
+}
+
+std::optional<text_position> text_position_of(const json_value& position)
+{
+  const auto line = position.find("line");
+  const auto character = position.find("character");
+  if (line == nullptr || character == nullptr || !line->as_number() ||
+      !character->as_number()) {
+    return std::nullopt;
+  }
+
+  return text_position{ static_cast<unsigned>(*line->as_number()),
+                        static_cast<unsigned>(*character->as_number()) };
+}
+
+json_value to_json(text_position position)
+{
+  json_value result;
+  result["line"] = position.line;
+  result["character"] = position.character;
+  return result;
+}
+
+json_value range_json(std::string_view text, unsigned begin, unsigned end)
+{
+  json_value range;
+  range["start"] = to_json(position_of(text, begin));
+  range["end"] = to_json(position_of(text, end));
+  return range;
+}
+
+json_value location_json(const std::string& path, std::string_view text,
+                         unsigned position)
+{
+  json_value location;
+  location["uri"] = uri_of_path(path);
+  location["range"] = range_json(text, position, position);
+  return location;
+}
+}
+
+server::server(std::ostream& out, std::string builtin_documentation_path)
+  : m_out{ out }
+  , m_workspace{ std::move(builtin_documentation_path) }
+{
+}
+
+int server::run(std::istream& in)
+{
+  std::thread reader{ [this, &in] {
+    while (const auto message = read_message(in)) {
+      enqueue(*message);
+    }
+    close_input();
+  } };
+
+  while (process_next()) {
+  }
+
+  std::unique_lock<std::mutex> lock{ m_mutex };
+  if (m_input_closed) {
+    lock.unlock();
+    reader.join();
+  } else {
+    // Client may keep the input open after the exit notification. Process is
+    // about to end anyway.
+    reader.detach();
+  }
+
+  return exit_code();
+}
+
+void server::enqueue(const std::string& content)
+{
+  auto message = json_value::parse(content);
+  auto queued = queued_message{};
+
+  if (message) {
+    const auto method = string_at(*message, "method");
+    const auto params = message->find("params");
+
+    if (method != nullptr && *method == "$/cancelRequest") {
+      if (const auto id = params != nullptr ? params->find("id") : nullptr) {
+        cancel(id->dump());
+      }
+      return;
+    }
+
+    if (const auto id = message->find("id")) {
+      queued.id = id->dump();
+    }
+
+    if (params != nullptr) {
+      queued.document_uri = document_uri_of(*params);
+    }
+
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    if (method != nullptr && !queued.document_uri.empty()) {
+      if (*method == "textDocument/didOpen" ||
+          *method == "textDocument/didChange") {
+        m_document_changes[queued.document_uri] = ++m_changes_count;
+      } else if (*method == "textDocument/didClose") {
+        m_document_changes.erase(queued.document_uri);
+      }
+
+      const auto found = m_document_changes.find(queued.document_uri);
+      queued.document_change =
+        found != std::cend(m_document_changes) ? found->second : 0u;
+    }
+
+    queued.message = std::move(*message);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    m_queue.emplace_back(std::move(queued));
+  }
+  m_queue_changed.notify_one();
+}
+
+void server::close_input()
+{
+  {
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    m_input_closed = true;
+  }
+  m_queue_changed.notify_one();
+}
+
+bool server::process_next()
+{
+  queued_message queued;
+
+  {
+    std::unique_lock<std::mutex> lock{ m_mutex };
+    m_queue_changed.wait(
+      lock, [this] { return !m_queue.empty() || m_input_closed; });
+    if (m_queue.empty()) {
+      return false;
+    }
+
+    queued = std::move(m_queue.front());
+    m_queue.pop_front();
+  }
+
+  handle(queued);
+  return !m_exit_code.has_value();
+}
+
+int server::exit_code() const
+{
+  // Exit without shutdown, including the end of the input, is an error.
+  return m_exit_code.value_or(1);
+}
+
+void server::handle(const queued_message& queued)
+{
+  const auto& message = queued.message;
+  if (message.is_null()) {
+    reply_error(json_value{}, error_code::parse_error, "Parse error");
+    return;
+  }
+
+  const auto method = string_at(message, "method");
+  const auto id = message.find("id");
+  if (method == nullptr) {
+    // Responses to requests of the server. It doesn't send any.
+    return;
+  }
+
+  const auto found_params = message.find("params");
+  const auto params = found_params != nullptr ? *found_params : json_value{};
+
+  if (id == nullptr) {
+    handle_notification(*method, params);
+    return;
+  }
+
+  if (queued.cancelled) {
+    reply_error(*id, error_code::request_cancelled, "Request cancelled");
+  } else if (is_stale(queued)) {
+    reply_error(*id, error_code::content_modified,
+                "Document has been changed");
+  } else {
+    handle_request(*id, *method, params);
+  }
+}
+
+void server::cancel(const std::string& id)
+{
+  // Only requests that are still queued can be cancelled. Ids of requests
+  // that are being processed or have been answered are not kept.
+  std::lock_guard<std::mutex> lock{ m_mutex };
+  for (auto& queued : m_queue) {
+    if (queued.id == id) {
+      queued.cancelled = true;
+      return;
+    }
+  }
+}
+
+bool server::is_stale(const queued_message& queued)
+{
+  if (queued.document_uri.empty()) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock{ m_mutex };
+  const auto found = m_document_changes.find(queued.document_uri);
+  const auto last_change =
+    found != std::cend(m_document_changes) ? found->second : 0u;
+  return last_change != queued.document_change;
+}
+
+void server::handle_request(const json_value& id, const std::string& method,
+                            const json_value& params)
+{
+  if (method == "initialize") {
+    reply(id, initialize(params));
+    return;
+  }
+
+  if (!m_initialized) {
+    reply_error(id, error_code::server_not_initialized,
+                "Server is not initialized");
+    return;
+  }
+
+  if (m_shutdown) {
+    reply_error(id, error_code::invalid_request, "Server is shut down");
+    return;
+  }
+
+  if (method == "shutdown") {
+    m_shutdown = true;
+    reply(id, json_value{});
+  } else if (method == "textDocument/completion") {
+    reply(id, complete(params));
+  } else if (method == "textDocument/definition") {
+    reply(id, find_definition(params));
+  } else if (method == "cmakesl/dumpSema") {
+    reply(id, dump_sema(params));
+  } else {
+    reply_error(id, error_code::method_not_found,
+                "Unknown method: " + method);
+  }
+}
+
+void server::handle_notification(const std::string& method,
+                                 const json_value& params)
+{
+  if (method == "exit") {
+    m_exit_code = m_shutdown ? 0 : 1;
+    return;
+  }
+
+  if (!m_initialized || m_shutdown) {
+    return;
+  }
+
+  if (method == "textDocument/didOpen") {
+    did_open(params);
+  } else if (method == "textDocument/didChange") {
+    did_change(params);
+  } else if (method == "textDocument/didClose") {
+    did_close(params);
+  } else if (method == "workspace/didChangeWatchedFiles") {
+    did_change_watched_files(params);
+  }
+}
+
+json_value server::initialize(const json_value& params)
+{
+  if (const auto root_uri = string_at(params, "rootUri")) {
+    m_workspace.set_root_path(path_of_uri(*root_uri));
+  } else if (const auto root_path = string_at(params, "rootPath")) {
+    m_workspace.set_root_path(*root_path);
+  }
+
+  m_initialized = true;
+
+  json_value sync;
+  sync["openClose"] = true;
+  sync["change"] = incremental_sync;
+
+  json_value capabilities;
+  capabilities["textDocumentSync"] = std::move(sync);
+  capabilities["completionProvider"] = json_value::object_t{};
+  capabilities["definitionProvider"] = true;
+
+  json_value result;
+  result["capabilities"] = std::move(capabilities);
+  result["serverInfo"]["name"] = "cmakesl-lsp";
+  return result;
+}
+
+json_value server::complete(const json_value& params)
+{
+  json_value::array_t items;
+
+  const auto parsed_source =
+    m_workspace.find(path_of_uri(document_uri_of(params)));
+  const auto position = params.find("position");
+  if (parsed_source == nullptr || position == nullptr) {
+    return items;
+  }
+
+  const auto text_position = text_position_of(*position);
+  if (!text_position) {
+    return items;
+  }
+
+  const auto offset = offset_of(parsed_source->source, *text_position);
+  const auto results = cmsl_complete_at(parsed_source, offset);
+  if (results == nullptr) {
+    return items;
+  }
+
+  std::vector<std::string> labels{ results->results,
+                                   results->results + results->num_results };
+  cmsl_destroy_complete_results(results);
+  std::sort(std::begin(labels), std::end(labels));
+
+  for (auto& label : labels) {
+    json_value item;
+    item["label"] = std::move(label);
+    items.emplace_back(std::move(item));
+  }
+
+  return items;
+}
+
+json_value server::find_definition(const json_value& params)
+{
+  const auto path = path_of_uri(document_uri_of(params));
+  const auto parsed_source = m_workspace.find(path);
+  const auto position = params.find("position");
+  if (parsed_source == nullptr || position == nullptr) {
+    return json_value{};
+  }
+
+  const auto text_position = text_position_of(*position);
+  if (!text_position) {
+    return json_value{};
+  }
+
+  struct definition_search
+  {
+    unsigned offset;
+    std::optional<cmsl_index_entry> found;
+    std::string destination_path;
+  };
+
+  auto search = definition_search{};
+  search.offset = offset_of(parsed_source->source, *text_position);
+  const auto visit_entry = [](const cmsl_index_entry* entry, void* user_data) {
+    auto& search = *static_cast<definition_search*>(user_data);
+    if (search.found || search.offset < entry->begin_pos ||
+        search.offset > entry->end_pos || entry->type == add_subdirectory) {
+      return;
+    }
+
+    // The path is valid only during the call.
+    search.found = *entry;
+    search.destination_path = entry->source_path;
+  };
+
+  cmsl_index_with_callback(parsed_source, visit_entry, &search);
+  if (!search.found) {
+    return json_value{};
+  }
+
+  if (search.found->type == file) {
+    return location_json(search.destination_path, {}, 0u);
+  }
+
+  // Stuff declared in this source has its path, builtin stuff doesn't.
+  const auto destination = m_workspace.find(search.destination_path);
+  if (destination == nullptr) {
+    return json_value{};
+  }
+
+  return location_json(search.destination_path, destination->source,
+                       search.found->position);
+}
+
+json_value server::dump_sema(const json_value& params)
+{
+  const auto parsed_source =
+    m_workspace.find(path_of_uri(document_uri_of(params)));
+  if (parsed_source == nullptr || !parsed_source->sema_tree) {
+    return json_value{};
+  }
+
+  std::ostringstream out;
+  sema::dumper dumper{ out };
+  parsed_source->sema_tree->visit(dumper);
+  return out.str();
+}
+
+void server::did_open(const json_value& params)
+{
+  const auto text_document = params.find("textDocument");
+  const auto text = text_document != nullptr
+    ? string_at(*text_document, "text")
+    : nullptr;
+  if (text == nullptr) {
+    return;
+  }
+
+  const auto path = path_of_uri(document_uri_of(params));
+  publish_diagnostics(m_workspace.open(path, *text));
+}
+
+void server::did_change(const json_value& params)
+{
+  const auto path = path_of_uri(document_uri_of(params));
+  const auto parsed_source = m_workspace.find(path);
+  const auto content_changes = params.find("contentChanges");
+  if (parsed_source == nullptr || content_changes == nullptr ||
+      content_changes->as_array() == nullptr) {
+    return;
+  }
+
+  // Ranges of a change are in the text after previous changes.
+  auto text = parsed_source->source;
+  std::vector<text_change> changes;
+
+  for (const auto& content_change : *content_changes->as_array()) {
+    const auto change_text = string_at(content_change, "text");
+    if (change_text == nullptr) {
+      continue;
+    }
+
+    auto change = text_change{ std::nullopt, *change_text };
+    const auto range = content_change.find("range");
+    const auto start = range != nullptr ? range->find("start") : nullptr;
+    const auto end = range != nullptr ? range->find("end") : nullptr;
+    const auto start_position =
+      start != nullptr ? text_position_of(*start) : std::nullopt;
+    const auto end_position =
+      end != nullptr ? text_position_of(*end) : std::nullopt;
+
+    if (start_position && end_position) {
+      const auto begin_offset = offset_of(text, *start_position);
+      const auto end_offset =
+        std::max(begin_offset, offset_of(text, *end_position));
+      text.replace(begin_offset, end_offset - begin_offset, change.text);
+      change.range = std::make_pair(begin_offset, end_offset);
+    } else {
+      text = change.text;
+    }
+
+    changes.emplace_back(std::move(change));
+  }
+
+  publish_diagnostics(m_workspace.change(path, changes));
+}
+
+void server::did_close(const json_value& params)
+{
+  const auto uri = document_uri_of(params);
+  const auto reparsed = m_workspace.close(path_of_uri(uri));
+
+  json_value diagnostics;
+  diagnostics["uri"] = uri;
+  diagnostics["diagnostics"] = json_value::array_t{};
+  notify("textDocument/publishDiagnostics", std::move(diagnostics));
+
+  publish_diagnostics(reparsed);
+}
+
+void server::did_change_watched_files(const json_value& params)
+{
+  const auto changes = params.find("changes");
+  if (changes == nullptr || changes->as_array() == nullptr) {
+    return;
+  }
+
+  for (const auto& change : *changes->as_array()) {
+    if (const auto uri = string_at(change, "uri")) {
+      publish_diagnostics(m_workspace.reload(path_of_uri(*uri)));
+    }
+  }
+}
+
+void server::publish_diagnostics(const std::vector<std::string>& paths)
+{
+  for (const auto& path : paths) {
+    if (m_workspace.is_opened(path)) {
+      publish_diagnostics(path);
+    }
+  }
+}
+
+void server::publish_diagnostics(const std::string& path)
+{
+  const auto parsed_source = m_workspace.find(path);
+  if (parsed_source == nullptr) {
+    return;
+  }
+
+  json_value::array_t diagnostics;
+
+  const auto source_diagnostics = cmsl_get_diagnostics(parsed_source);
+  for (auto i = 0u; i < source_diagnostics->num_diagnostics; ++i) {
+    const auto& source_diagnostic = source_diagnostics->diagnostics[i];
+    if (source_diagnostic.source_path != path) {
+      continue;
+    }
+
+    json_value diagnostic;
+    diagnostic["range"] =
+      range_json(parsed_source->source, source_diagnostic.begin_pos,
+                 source_diagnostic.end_pos);
+    diagnostic["severity"] = source_diagnostic.type == diagnostic_error
+      ? error_severity
+      : source_diagnostic.type == diagnostic_warning ? warning_severity
+                                                     : information_severity;
+    diagnostic["source"] = "cmakesl";
+    diagnostic["message"] = std::string{ source_diagnostic.message };
+    diagnostics.emplace_back(std::move(diagnostic));
+  }
+  cmsl_destroy_diagnostics(source_diagnostics);
+
+  json_value params;
+  params["uri"] = uri_of_path(path);
+  params["diagnostics"] = std::move(diagnostics);
+  notify("textDocument/publishDiagnostics", std::move(params));
+}
+
+void server::reply(const json_value& id, json_value result)
+{
+  json_value response;
+  response["jsonrpc"] = "2.0";
+  response["id"] = id;
+  response["result"] = std::move(result);
+  send(response);
+}
+
+void server::reply_error(const json_value& id, int code, std::string message)
+{
+  json_value error;
+  error["code"] = code;
+  error["message"] = std::move(message);
+
+  json_value response;
+  response["jsonrpc"] = "2.0";
+  response["id"] = id;
+  response["error"] = std::move(error);
+  send(response);
+}
+
+void server::notify(std::string method, json_value params)
+{
+  json_value notification;
+  notification["jsonrpc"] = "2.0";
+  notification["method"] = std::move(method);
+  notification["params"] = std::move(params);
+  send(notification);
+}
+
+void server::send(const json_value& message)
+{
+  write_message(m_out, message.dump());
+}
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "json.hpp"
+#include "workspace.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <iosfwd>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace cmsl::lsp {
+// Language server speaking the protocol over streams.
+//
+// Messages are read on a separate thread and queued. Requests that became
+// stale while waiting in the queue are answered without doing the work:
+// cancelled ones, and ones about a document that has been changed since.
+class server
+{
+public:
+  explicit server(std::ostream& out,
+                  std::string builtin_documentation_path = {});
+
+  // Processes messages until the exit notification or the end of the input.
+  // Returns the process exit code.
+  int run(std::istream& in);
+
+  // Queue used by run(). Can be called from any thread.
+  void enqueue(const std::string& message);
+  void close_input();
+
+  // Processes the next queued message, waits for one if there are none.
+  // Returns false if there is nothing more to process.
+  bool process_next();
+
+  int exit_code() const;
+
+private:
+  struct queued_message
+  {
+    // Null if the message couldn't be parsed.
+    json_value message;
+    // Dumped id, if the message is a request.
+    std::string id;
+    // Set if the request is cancelled while it is queued.
+    bool cancelled{ false };
+    // Uri of the document that the message is about, if any.
+    std::string document_uri;
+    // Number of the last change of the document, queued before the message.
+    // Zero if the document is not open.
+    unsigned long document_change{ 0u };
+  };
+
+  void handle(const queued_message& queued);
+  void cancel(const std::string& id);
+  bool is_stale(const queued_message& queued);
+
+  void handle_request(const json_value& id, const std::string& method,
+                      const json_value& params);
+  void handle_notification(const std::string& method,
+                           const json_value& params);
+
+  json_value initialize(const json_value& params);
+  json_value complete(const json_value& params);
+  json_value find_definition(const json_value& params);
+  json_value dump_sema(const json_value& params);
+
+  void did_open(const json_value& params);
+  void did_change(const json_value& params);
+  void did_close(const json_value& params);
+  void did_change_watched_files(const json_value& params);
+
+  void publish_diagnostics(const std::vector<std::string>& paths);
+  void publish_diagnostics(const std::string& path);
+
+  void reply(const json_value& id, json_value result);
+  void reply_error(const json_value& id, int code, std::string message);
+  void notify(std::string method, json_value params);
+  void send(const json_value& message);
+
+private:
+  std::ostream& m_out;
+  workspace m_workspace;
+
+  bool m_initialized{ false };
+  bool m_shutdown{ false };
+  std::optional<int> m_exit_code;
+
+  std::mutex m_mutex;
+  std::condition_variable m_queue_changed;
+  std::deque<queued_message> m_queue;
+  bool m_input_closed{ false };
+  // Changes of all documents, received so far.
+  unsigned long m_changes_count{ 0u };
+  // Number of the last change of every open document, by uri.
+  std::map<std::string, unsigned long> m_document_changes;
+};
+}
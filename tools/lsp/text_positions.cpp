@@ -0,0 +1,64 @@
+#include "text_positions.hpp"
+
+#include <algorithm>
+
+namespace cmsl::lsp {
+namespace {
+bool is_continuation_byte(char c)
+{
+  return (static_cast<unsigned char>(c) & 0xc0u) == 0x80u;
+}
+
+// Code points that take four bytes in UTF-8 need a surrogate pair in UTF-16.
+unsigned utf16_length(char lead_byte)
+{
+  return (static_cast<unsigned char>(lead_byte) & 0xf8u) == 0xf0u ? 2u : 1u;
+}
+}
+
+unsigned offset_of(std::string_view text, text_position position)
+{
+  auto offset = std::size_t{ 0u };
+  for (auto line = 0u; line < position.line; ++line) {
+    const auto new_line = text.find('\n', offset);
+    if (new_line == std::string_view::npos) {
+      return static_cast<unsigned>(text.size());
+    }
+    offset = new_line + 1u;
+  }
+
+  auto units = 0u;
+  while (offset < text.size() && text[offset] != '\n' &&
+         units < position.character) {
+    units += utf16_length(text[offset]);
+    ++offset;
+    while (offset < text.size() && is_continuation_byte(text[offset])) {
+      ++offset;
+    }
+  }
+
+  return static_cast<unsigned>(offset);
+}
+
+text_position position_of(std::string_view text, unsigned offset)
+{
+  const auto end = std::min<std::size_t>(offset, text.size());
+
+  text_position position;
+  auto line_start = std::size_t{ 0u };
+  for (auto i = std::size_t{ 0u }; i < end; ++i) {
+    if (text[i] == '\n') {
+      ++position.line;
+      line_start = i + 1u;
+    }
+  }
+
+  for (auto i = line_start; i < end; ++i) {
+    if (!is_continuation_byte(text[i])) {
+      position.character += utf16_length(text[i]);
+    }
+  }
+
+  return position;
+}
+}
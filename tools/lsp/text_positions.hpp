@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string_view>
+
+namespace cmsl::lsp {
+// Position as the protocol sees it. Character is counted in UTF-16 code
+// units.
+struct text_position
+{
+  unsigned line{ 0u };
+  unsigned character{ 0u };
+};
+
+// Positions past the end of a line or of the text are clamped.
+unsigned offset_of(std::string_view text, text_position position);
+text_position position_of(std::string_view text, unsigned offset);
+}
@@ -0,0 +1,59 @@
+#include "transport.hpp"
+
+#include <istream>
+#include <ostream>
+#include <string_view>
+
+namespace cmsl::lsp {
+namespace {
+constexpr auto content_length_header = std::string_view{ "Content-Length:" };
+}
+
+std::optional<std::string> read_message(std::istream& in)
+{
+  std::optional<std::size_t> content_length;
+
+  std::string line;
+  while (std::getline(in, line)) {
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+
+    // Empty line ends the header.
+    if (line.empty()) {
+      if (!content_length) {
+        continue;
+      }
+      break;
+    }
+
+    if (line.compare(0u, content_length_header.size(),
+                     content_length_header) == 0) {
+      try {
+        content_length =
+          std::stoul(line.substr(content_length_header.size()));
+      } catch (const std::exception&) {
+        return std::nullopt;
+      }
+    }
+  }
+
+  if (!in || !content_length) {
+    return std::nullopt;
+  }
+
+  std::string content(*content_length, '\0');
+  in.read(content.data(), static_cast<std::streamsize>(*content_length));
+  if (static_cast<std::size_t>(in.gcount()) != *content_length) {
+    return std::nullopt;
+  }
+
+  return content;
+}
+
+void write_message(std::ostream& out, const std::string& content)
+{
+  out << "Content-Length: " << content.size() << "\r\n\r\n" << content;
+  out.flush();
+}
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <iosfwd>
+#include <optional>
+#include <string>
+
+namespace cmsl::lsp {
+// Reads content of a message framed with the Content-Length header. Returns
+// nullopt at the end of the stream or if the framing is broken.
+std::optional<std::string> read_message(std::istream& in);
+
+void write_message(std::ostream& out, const std::string& content);
+}
@@ -0,0 +1,71 @@
+#include "uri.hpp"
+
+#include <cctype>
+#include <cstdio>
+#include <string_view>
+
+namespace cmsl::lsp {
+namespace {
+constexpr auto file_scheme = std::string_view{ "file://" };
+
+int hex_value(char c)
+{
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+}
+
+std::string path_of_uri(const std::string& uri)
+{
+  if (uri.compare(0u, file_scheme.size(), file_scheme) != 0) {
+    return uri;
+  }
+
+  std::string path;
+  for (auto i = file_scheme.size(); i < uri.size(); ++i) {
+    if (uri[i] == '%' && i + 2u < uri.size()) {
+      const auto high = hex_value(uri[i + 1u]);
+      const auto low = hex_value(uri[i + 2u]);
+      if (high >= 0 && low >= 0) {
+        path += static_cast<char>(high * 16 + low);
+        i += 2u;
+        continue;
+      }
+    }
+
+    path += uri[i];
+  }
+
+  return path;
+}
+
+std::string uri_of_path(const std::string& path)
+{
+  if (path.empty() || path.front() != '/') {
+    return path;
+  }
+
+  std::string uri{ file_scheme };
+  for (const auto c : path) {
+    const auto uc = static_cast<unsigned char>(c);
+    if (std::isalnum(uc) ||
+        std::string_view{ "/-._~" }.find(c) != std::string_view::npos) {
+      uri += c;
+    } else {
+      char escaped[4];
+      std::snprintf(escaped, sizeof(escaped), "%%%02X", uc);
+      uri += escaped;
+    }
+  }
+
+  return uri;
+}
+}
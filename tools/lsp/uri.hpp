@@ -0,0 +1,9 @@
+#pragma once
+
+#include <string>
+
+namespace cmsl::lsp {
+// Only file URIs are supported. Other URIs are kept as they are.
+std::string path_of_uri(const std::string& uri);
+std::string uri_of_path(const std::string& path);
+}
@@ -0,0 +1,292 @@
+#include "workspace.hpp"
+
+#include "lib/cmsl_parse_source.hpp"
+#include "lib/cmsl_parsed_source.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace cmsl::lsp {
+namespace {
+void apply_changes(std::string& text, const std::vector<text_change>& changes)
+{
+  for (const auto& change : changes) {
+    if (!change.range) {
+      text = change.text;
+      continue;
+    }
+
+    const auto end = std::min<std::size_t>(change.range->second, text.size());
+    const auto begin = std::min<std::size_t>(change.range->first, end);
+    text.replace(begin, end - begin, change.text);
+  }
+}
+}
+
+void workspace::parsed_source_deleter::operator()(
+  cmsl_parsed_source* parsed_source) const
+{
+  cmsl_destroy_parsed_source(parsed_source);
+}
+
+workspace::workspace(std::string builtin_documentation_path)
+  : m_builtin_documentation_path{ std::move(builtin_documentation_path) }
+{
+}
+
+workspace::~workspace()
+{
+  std::vector<document*> documents;
+  for (auto& [path, doc] : m_documents) {
+    documents.emplace_back(&doc);
+  }
+
+  destroy(documents);
+}
+
+void workspace::set_root_path(std::string root_path)
+{
+  m_root_path = std::move(root_path);
+}
+
+std::vector<std::string> workspace::open(const std::string& path,
+                                         std::string text)
+{
+  const auto found = m_documents.find(path);
+  if (found == std::end(m_documents)) {
+    auto& doc = add_document(path, std::move(text));
+    doc.opened = true;
+    parse(doc);
+    return { path };
+  }
+
+  auto& doc = found->second;
+  doc.opened = true;
+  return update(doc, { text_change{ std::nullopt, std::move(text) } });
+}
+
+std::vector<std::string> workspace::change(
+  const std::string& path, const std::vector<text_change>& changes)
+{
+  const auto found = m_documents.find(path);
+  if (found == std::end(m_documents)) {
+    return {};
+  }
+
+  return update(found->second, changes);
+}
+
+std::vector<std::string> workspace::close(const std::string& path)
+{
+  const auto found = m_documents.find(path);
+  if (found == std::end(m_documents)) {
+    return {};
+  }
+
+  auto& doc = found->second;
+  doc.opened = false;
+
+  const auto imported =
+    std::any_of(std::cbegin(m_documents), std::cend(m_documents),
+                [&path](const auto& entry) {
+                  return entry.second.imports.count(path) > 0u;
+                });
+  if (imported) {
+    // Importers see the file as it is on disk.
+    return reload(path);
+  }
+
+  destroy({ &doc });
+  m_documents.erase(found);
+  return {};
+}
+
+std::vector<std::string> workspace::reload(const std::string& path)
+{
+  const auto found = m_documents.find(path);
+  if (found == std::end(m_documents) || found->second.opened) {
+    return {};
+  }
+
+  auto text = read_file(path);
+  if (!text) {
+    return {};
+  }
+
+  return update(found->second,
+                { text_change{ std::nullopt, std::move(*text) } });
+}
+
+const cmsl_parsed_source* workspace::find(const std::string& path) const
+{
+  const auto found = m_documents.find(path);
+  return found != std::cend(m_documents) ? found->second.parsed.get()
+                                         : nullptr;
+}
+
+bool workspace::is_opened(const std::string& path) const
+{
+  const auto found = m_documents.find(path);
+  return found != std::cend(m_documents) && found->second.opened;
+}
+
+const cmsl_parsed_source* workspace::import_source(const char* import_path,
+                                                   void* user_data)
+{
+  auto& importer = *static_cast<document*>(user_data);
+  return importer.owner->import_source(importer, import_path);
+}
+
+const cmsl_parsed_source* workspace::import_source(
+  document& importer, const std::string& import_path)
+{
+  const auto path =
+    m_root_path.empty() ? import_path : m_root_path + '/' + import_path;
+  importer.imports.emplace(path);
+
+  if (m_parsing.count(path) > 0u) {
+    // Import cycle.
+    return nullptr;
+  }
+
+  auto found = m_documents.find(path);
+  if (found == std::end(m_documents)) {
+    auto text = read_file(path);
+    if (!text) {
+      return nullptr;
+    }
+
+    auto& doc = add_document(path, std::move(*text));
+    parse(doc);
+    return doc.parsed.get();
+  }
+
+  auto& doc = found->second;
+  if (!doc.parsed) {
+    parse(doc);
+  }
+
+  return doc.parsed.get();
+}
+
+workspace::document& workspace::add_document(const std::string& path,
+                                             std::string text)
+{
+  auto& doc = m_documents[path];
+  doc.owner = this;
+  doc.path = path;
+  doc.text = std::move(text);
+  return doc;
+}
+
+void workspace::parse(document& doc)
+{
+  doc.parsed.reset();
+  doc.imports.clear();
+
+  m_parsing.emplace(doc.path);
+  const auto builtin_documentation_path = m_builtin_documentation_path.empty()
+    ? nullptr
+    : m_builtin_documentation_path.c_str();
+  doc.parsed.reset(cmsl_parse_source_with_imports(
+    doc.text.c_str(), doc.path.c_str(), builtin_documentation_path,
+    &workspace::import_source, &doc));
+  m_parsing.erase(doc.path);
+
+  doc.parse_sequence = ++m_parses_count;
+}
+
+std::vector<std::string> workspace::update(
+  document& doc, const std::vector<text_change>& changes)
+{
+  auto importers = transitive_importers(doc.path);
+  destroy(importers);
+
+  if (doc.parsed) {
+    // Declarations before the first change are kept. They may hold imported
+    // stuff, so imports are not forgotten.
+    std::vector<cmsl_source_edit> edits;
+    for (const auto& change : changes) {
+      const auto range = change.range.value_or(std::make_pair(
+        0u, static_cast<unsigned>(doc.parsed->source.size())));
+      edits.emplace_back(
+        cmsl_source_edit{ range.first, range.second, change.text.c_str() });
+    }
+
+    m_parsing.emplace(doc.path);
+    cmsl_reparse(doc.parsed.get(), edits.data(),
+                 static_cast<unsigned>(edits.size()));
+    m_parsing.erase(doc.path);
+
+    doc.text = doc.parsed->source;
+    doc.parse_sequence = ++m_parses_count;
+  } else {
+    apply_changes(doc.text, changes);
+    parse(doc);
+  }
+
+  std::vector<std::string> reparsed{ doc.path };
+  for (const auto importer : importers) {
+    // Could have been parsed already, when imported by another one.
+    if (!importer->parsed) {
+      parse(*importer);
+    }
+
+    if (importer != &doc) {
+      reparsed.emplace_back(importer->path);
+    }
+  }
+
+  return reparsed;
+}
+
+std::vector<workspace::document*> workspace::transitive_importers(
+  const std::string& path)
+{
+  std::vector<document*> importers;
+  std::vector<const std::string*> to_visit{ &path };
+
+  while (!to_visit.empty()) {
+    const auto imported = *to_visit.back();
+    to_visit.pop_back();
+
+    for (auto& [importer_path, doc] : m_documents) {
+      const auto already_found =
+        std::find(std::cbegin(importers), std::cend(importers), &doc) !=
+        std::cend(importers);
+      if (doc.parsed && !already_found && doc.imports.count(imported) > 0u) {
+        importers.emplace_back(&doc);
+        to_visit.emplace_back(&doc.path);
+      }
+    }
+  }
+
+  return importers;
+}
+
+void workspace::destroy(std::vector<document*> documents)
+{
+  // Importers go first, while stuff they have imported still exists.
+  std::sort(std::begin(documents), std::end(documents),
+            [](const document* lhs, const document* rhs) {
+              return lhs->parse_sequence > rhs->parse_sequence;
+            });
+
+  for (const auto doc : documents) {
+    doc->parsed.reset();
+  }
+}
+
+std::optional<std::string> workspace::read_file(const std::string& path) const
+{
+  std::ifstream file{ path, std::ios::binary };
+  if (!file) {
+    return std::nullopt;
+  }
+
+  std::stringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+struct cmsl_parsed_source;
+
+namespace cmsl::lsp {
+// Replaces the whole text if there is no range. Offsets are in the text as
+// it is before the change.
+struct text_change
+{
+  std::optional<std::pair<unsigned, unsigned>> range;
+  std::string text;
+};
+
+// Parsed sources of documents opened by the client, and of files they import.
+// Imported files, that are not opened, are read from disk once and kept, so
+// exported stuff of a module is built once for all its importers.
+//
+// An importer holds pointers to exported stuff of imported sources, so when
+// a source changes, sources that import it, directly or not, are destroyed
+// before the change, and parsed again after it.
+//
+// Operations return paths of documents that have been parsed again.
+class workspace
+{
+public:
+  explicit workspace(std::string builtin_documentation_path = {});
+  ~workspace();
+
+  workspace(const workspace&) = delete;
+  workspace& operator=(const workspace&) = delete;
+
+  // Imports are resolved relatively to the root path.
+  void set_root_path(std::string root_path);
+
+  std::vector<std::string> open(const std::string& path, std::string text);
+  std::vector<std::string> change(const std::string& path,
+                                  const std::vector<text_change>& changes);
+  std::vector<std::string> close(const std::string& path);
+  // Reads again a file, that is not opened, e.g. because it has been
+  // modified on disk.
+  std::vector<std::string> reload(const std::string& path);
+
+  // Null if the path is neither opened nor imported.
+  const cmsl_parsed_source* find(const std::string& path) const;
+  bool is_opened(const std::string& path) const;
+
+private:
+  struct parsed_source_deleter
+  {
+    void operator()(cmsl_parsed_source* parsed_source) const;
+  };
+
+  struct document
+  {
+    workspace* owner{ nullptr };
+    std::string path;
+    std::string text;
+    bool opened{ false };
+    std::unique_ptr<cmsl_parsed_source, parsed_source_deleter> parsed;
+    // Paths imported while the document was parsed.
+    std::set<std::string> imports;
+    // Sources are parsed after sources they import, so importers have
+    // greater sequence numbers.
+    unsigned long parse_sequence{ 0u };
+  };
+
+  static const cmsl_parsed_source* import_source(const char* import_path,
+                                                 void* user_data);
+  const cmsl_parsed_source* import_source(document& importer,
+                                          const std::string& import_path);
+
+  document& add_document(const std::string& path, std::string text);
+  void parse(document& doc);
+  std::vector<std::string> update(document& doc,
+                                  const std::vector<text_change>& changes);
+  std::vector<document*> transitive_importers(const std::string& path);
+  void destroy(std::vector<document*> documents);
+  std::optional<std::string> read_file(const std::string& path) const;
+
+private:
+  std::string m_builtin_documentation_path;
+  std::string m_root_path;
+  // Nodes of map are never moved, so documents can be passed to callbacks.
+  std::map<std::string, document> m_documents;
+  // Paths being parsed right now, to detect import cycles.
+  std::set<std::string> m_parsing;
+  unsigned long m_parses_count{ 0u };
+};
+}